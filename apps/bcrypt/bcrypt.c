@@ -0,0 +1,366 @@
+/*
+*******************************************************************************
+\file bcrypt.c
+\brief A utility for encrypting files into bcnt containers
+\project bee2/apps/bcrypt
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/defs.h>
+#include <bee2/core/blob.h>
+#include <bee2/core/dec.h>
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/rng.h>
+#include <bee2/core/str.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bcnt.h>
+
+#include <stdio.h>
+#ifdef OS_UNIX
+	#include <sys/types.h>
+#endif
+
+/*
+*******************************************************************************
+Утилита bcrypt
+
+Утилита зашифровывает файлы в контейнеры bcnt (см. bcnt.h) и расшифровывает
+их. Ключ (32 октета) читается из файла key_file.
+
+Данные обрабатываются окнами по threads * BCRYPT_WINDOW фрагментов:
+окно читается, фрагменты окна обрабатываются в threads потоках, результат
+записывается. Поэтому объем используемой памяти не зависит от длины файла.
+Чтобы определить, содержит ли окно последний фрагмент, после полного окна
+проверяется, не достигнут ли конец файла.
+
+При расшифровании с опцией -n расшифровывается только фрагмент
+с указанным номером.
+
+При ошибке расшифрования выходной файл удаляется.
+*******************************************************************************
+*/
+
+#define BCRYPT_WINDOW 16
+#define BCRYPT_CHUNK_DEFAULT 64
+#define BCRYPT_MAX_THREADS 256
+
+int bcryptUsage()
+{
+	printf(
+		"bee2/bcrypt: STB 34.101.31/77 file encryption [bee2 version %s]\n"
+		"Usage:\n"
+		"  bcrypt -e [options] <key_file> <in_file> <out_file>\n"
+		"  bcrypt -d [options] <key_file> <in_file> <out_file>\n"
+		"  options:\n"
+		"    -a <alg>  belt-dwp (by default) or bash-ae [-e]\n"
+		"    -s <kb>   chunk size in KiB (64 by default) [-e]\n"
+		"    -n <i>    decrypt only chunk i [-d]\n"
+		"    -j <n>    process chunks in n threads (1 by default)\n",
+		utilVersion());
+	return -1;
+}
+
+static bool_t bcryptParseSize(size_t* val, const char* str, size_t max)
+{
+	if (!decIsValid(str) || !strLen(str) || strLen(str) > 9 ||
+		decCLZ(str) && strLen(str) > 1)
+		return FALSE;
+	*val = (size_t)decToU32(str);
+	return *val <= max;
+}
+
+static bool_t bcryptReadKey(octet key[32], const char* filename)
+{
+	FILE* fp;
+	bool_t ret;
+	fp = fopen(filename, "rb");
+	if (!fp)
+		return FALSE;
+	ret = fread(key, 1, 32, fp) == 32 && fgetc(fp) == EOF;
+	fclose(fp);
+	return ret;
+}
+
+static bool_t bcryptIsEOF(FILE* fp)
+{
+	int c = fgetc(fp);
+	if (c == EOF)
+		return TRUE;
+	ungetc(c, fp);
+	return FALSE;
+}
+
+static bool_t bcryptSeek(FILE* fp, size_t chunk, size_t len)
+{
+#ifdef OS_UNIX
+	return fseeko(fp, (off_t)BCNT_HDR_LEN + (off_t)chunk * (off_t)len,
+		SEEK_SET) == 0;
+#elif defined(_MSC_VER)
+	return _fseeki64(fp, (__int64)BCNT_HDR_LEN + (__int64)chunk *
+		(__int64)len, SEEK_SET) == 0;
+#else
+	return fseek(fp, (long)(BCNT_HDR_LEN + chunk * len), SEEK_SET) == 0;
+#endif
+}
+
+/*
+*******************************************************************************
+Зашифрование
+*******************************************************************************
+*/
+
+int bcryptEncr(size_t alg, size_t cs, size_t threads, const octet key[32],
+	const char* in, const char* out)
+{
+	const size_t window = threads * BCRYPT_WINDOW;
+	octet header[BCNT_HDR_LEN];
+	void* state;
+	octet* pt;
+	octet* ct;
+	FILE* fin;
+	FILE* fout;
+	size_t index, count, n, tl;
+	bool_t final;
+	err_t code;
+	// подготовить память
+	state = blobCreate(bcnt_keep() + window * cs + window * (cs + 32));
+	if (state == 0)
+	{
+		printf("%s: FAILED [memory]\n", out);
+		return -1;
+	}
+	pt = (octet*)state + bcnt_keep();
+	ct = pt + window * cs;
+	// начать зашифрование
+	code = rngCreate(0, 0);
+	if (code == ERR_OK)
+		code = bcntEncrStart(state, header, alg, cs, key, rngStepR, 0);
+	if (code != ERR_OK)
+	{
+		blobClose(state);
+		printf("%s: FAILED [code %u]\n", out, (unsigned)code);
+		return -1;
+	}
+	tl = bcntTagLen(state);
+	// открыть файлы
+	fin = fopen(in, "rb");
+	if (!fin)
+	{
+		blobClose(state);
+		printf("%s: FAILED [open]\n", in);
+		return -1;
+	}
+	fout = fopen(out, "wb");
+	if (!fout)
+	{
+		fclose(fin);
+		blobClose(state);
+		printf("%s: FAILED [open]\n", out);
+		return -1;
+	}
+	// зашифровать
+	code = fwrite(header, 1, BCNT_HDR_LEN, fout) == BCNT_HDR_LEN ?
+		ERR_OK : ERR_FILE_WRITE;
+	for (index = 0, final = FALSE; code == ERR_OK && !final; index += n)
+	{
+		count = fread(pt, 1, window * cs, fin);
+		if (ferror(fin))
+		{
+			code = ERR_FILE_READ;
+			break;
+		}
+		final = count < window * cs || bcryptIsEOF(fin);
+		n = count ? (count - 1) / cs + 1 : 1;
+		code = bcntEncr(ct, pt, count, index, final, state, threads);
+		if (code == ERR_OK &&
+			fwrite(ct, 1, count + n * tl, fout) != count + n * tl)
+			code = ERR_FILE_WRITE;
+	}
+	// завершить
+	fclose(fin);
+	if (fclose(fout) != 0 && code == ERR_OK)
+		code = ERR_FILE_WRITE;
+	blobClose(state);
+	if (code != ERR_OK)
+	{
+		remove(out);
+		printf("%s: FAILED [code %u]\n", out, (unsigned)code);
+		return -1;
+	}
+	printf("%s: OK\n", out);
+	return 0;
+}
+
+/*
+*******************************************************************************
+Расшифрование
+*******************************************************************************
+*/
+
+int bcryptDecr(size_t chunk, size_t threads, const octet key[32],
+	const char* in, const char* out)
+{
+	octet header[BCNT_HDR_LEN];
+	octet state[256];
+	void* buf;
+	octet* pt;
+	octet* ct;
+	FILE* fin;
+	FILE* fout;
+	size_t window, index, count, n, cs, tl;
+	bool_t final;
+	err_t code;
+	ASSERT(sizeof(state) >= bcnt_keep());
+	// прочитать заголовок
+	fin = fopen(in, "rb");
+	if (!fin)
+	{
+		printf("%s: FAILED [open]\n", in);
+		return -1;
+	}
+	if (fread(header, 1, BCNT_HDR_LEN, fin) != BCNT_HDR_LEN ||
+		(code = bcntDecrStart(state, header, key)) != ERR_OK)
+	{
+		fclose(fin);
+		printf("%s: FAILED [format]\n", in);
+		return -1;
+	}
+	cs = bcntChunkSize(state), tl = bcntTagLen(state);
+	// подготовить память
+	window = chunk == SIZE_MAX ? threads * BCRYPT_WINDOW : 1;
+	buf = blobCreate(window * cs + window * (cs + tl));
+	if (buf == 0)
+	{
+		fclose(fin);
+		printf("%s: FAILED [memory]\n", out);
+		return -1;
+	}
+	pt = (octet*)buf;
+	ct = pt + window * cs;
+	// перейти к фрагменту
+	if (chunk != SIZE_MAX && !bcryptSeek(fin, chunk, cs + tl))
+	{
+		fclose(fin);
+		blobClose(buf);
+		printf("%s: FAILED [chunk]\n", in);
+		return -1;
+	}
+	fout = fopen(out, "wb");
+	if (!fout)
+	{
+		fclose(fin);
+		blobClose(buf);
+		printf("%s: FAILED [open]\n", out);
+		return -1;
+	}
+	// расшифровать
+	code = ERR_OK;
+	index = chunk == SIZE_MAX ? 0 : chunk;
+	for (final = FALSE; code == ERR_OK && !final; index += n)
+	{
+		count = fread(ct, 1, window * (cs + tl), fin);
+		if (ferror(fin))
+		{
+			code = ERR_FILE_READ;
+			break;
+		}
+		final = count < window * (cs + tl) || bcryptIsEOF(fin);
+		n = count ? (count - 1) / (cs + tl) + 1 : 1;
+		code = bcntDecr(pt, ct, count, index, final, state, threads);
+		if (code == ERR_OK &&
+			fwrite(pt, 1, count - n * tl, fout) != count - n * tl)
+			code = ERR_FILE_WRITE;
+		// только один фрагмент?
+		if (chunk != SIZE_MAX)
+			break;
+	}
+	// завершить
+	fclose(fin);
+	if (fclose(fout) != 0 && code == ERR_OK)
+		code = ERR_FILE_WRITE;
+	blobClose(buf);
+	memSetZero(state, sizeof(state));
+	if (code != ERR_OK)
+	{
+		remove(out);
+		printf("%s: FAILED [code %u]\n", in, (unsigned)code);
+		return -1;
+	}
+	printf("%s: OK\n", out);
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	octet key[32];
+	bool_t encr;
+	size_t alg = BCNT_BELT_DWP;
+	size_t cs = BCRYPT_CHUNK_DEFAULT;
+	size_t chunk = SIZE_MAX;
+	size_t threads = 1;
+	int ret;
+	// mode
+	if (argc < 5)
+		return bcryptUsage();
+	if (strEq(argv[1], "-e"))
+		encr = TRUE;
+	else if (strEq(argv[1], "-d"))
+		encr = FALSE;
+	else
+		return bcryptUsage();
+	argc -= 2, argv += 2;
+	// options
+	while (argc > 3)
+	{
+		if (strEq(argv[0], "-a") && encr)
+		{
+			if (strEq(argv[1], "belt-dwp"))
+				alg = BCNT_BELT_DWP;
+			else if (strEq(argv[1], "bash-ae"))
+				alg = BCNT_BASH_AE;
+			else
+				return bcryptUsage();
+		}
+		else if (strEq(argv[0], "-s") && encr)
+		{
+			if (!bcryptParseSize(&cs, argv[1], BCNT_CHUNK_MAX >> 10) ||
+				cs == 0)
+				return bcryptUsage();
+		}
+		else if (strEq(argv[0], "-n") && !encr)
+		{
+			if (!bcryptParseSize(&chunk, argv[1], SIZE_MAX - 1))
+				return bcryptUsage();
+		}
+		else if (strEq(argv[0], "-j"))
+		{
+			if (!bcryptParseSize(&threads, argv[1], BCRYPT_MAX_THREADS) ||
+				threads == 0)
+				return bcryptUsage();
+		}
+		else
+			return bcryptUsage();
+		argc -= 2, argv += 2;
+	}
+	if (argc != 3)
+		return bcryptUsage();
+	// key
+	if (!bcryptReadKey(key, argv[0]))
+	{
+		printf("%s: FAILED [key]\n", argv[0]);
+		return -1;
+	}
+	// encrypt / decrypt
+	if (encr)
+		ret = bcryptEncr(alg, cs << 10, threads, key, argv[1], argv[2]);
+	else
+		ret = bcryptDecr(chunk, threads, key, argv[1], argv[2]);
+	memSetZero(key, sizeof(key));
+	return ret;
+}
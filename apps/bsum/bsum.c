@@ -5,24 +5,33 @@
 \project bee2/apps/bsum 
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.10.28
-\version 2017.01.17
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
 #include <bee2/defs.h>
+#include <bee2/core/blob.h>
 #include <bee2/core/dec.h>
 #include <bee2/core/hex.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/mt.h>
 #include <bee2/core/str.h>
+#include <bee2/core/tm.h>
 #include <bee2/core/util.h>
 #include <bee2/crypto/bash.h>
 #include <bee2/crypto/belt.h>
+#include <bee2/crypto/bmt.h>
 
 #include <stdio.h>
 #ifdef OS_WIN
 	#include <locale.h>
 #endif
+#ifdef OS_UNIX
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
 
 /*
 *******************************************************************************
@@ -30,6 +39,28 @@ version 3. See Copyright Notices in bee2/info.h.
 
 Максимально точно поддержан интерфейс командной строки утилиты sha1sum.
 
+Файлы хэшируются пулом из N рабочих потоков (опция -j N). Рабочие потоки 
+выбирают файлы из общего списка по очереди, а основной поток печатает 
+результаты строго в порядке списка (по мере готовности очередного файла). 
+Поэтому вывод не зависит от N и совпадает с выводом sha1sum. По умолчанию 
+N = 1: файлы обрабатываются в основном потоке.
+
+Файлы читаются порциями по BSUM_BUF_SIZE октетов. В Unix ядру сообщается 
+о последовательном чтении (POSIX_FADV_SEQUENTIAL). Файлы не отображаются 
+в память: если файл укорачивается во время хэширования, то обращение 
+к отображенной памяти за новым концом файла приводит к сигналу SIGBUS 
+и аварийному завершению всей утилиты, а ошибка read() касается только 
+одного файла.
+
+При указании опции --tree вычисляется результат древовидного хэширования 
+(см. bmt.h) с длиной листа BSUM_TREE_LEAF. Длина листа фиксирована, так как 
+в checksum_file она не записывается. В этом режиме файлы обрабатываются 
+последовательно, а N потоков используются для параллельного хэширования 
+листьев одного файла.
+
+При указании опции --stats в stderr выводится сводка: число файлов, объем 
+данных, время и пропускная способность.
+
 \warning В Windows имена файлов на русском языке будут записаны в checksum_file 
 в кодировке cp1251. В Linux -- в кодировке UTF8.
 
@@ -37,17 +68,35 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#define BSUM_BUF_SIZE ((size_t)64 << 10)
+#define BSUM_MAX_THREADS 256
+#define BSUM_TREE_LEAF ((size_t)1 << 20)
+
+#define BSUM_ERR_OPEN 1
+#define BSUM_ERR_READ 2
+
+typedef struct
+{
+	size_t hid;				/*< алгоритм хэширования */
+	size_t tree;			/*< потоки древовидного хэширования (или 0) */
+	size_t bad_files;		/*< число непрочитанных файлов */
+	size_t bad_hashes;		/*< число несовпавших хэш-значений */
+} bsum_ctx;
 
 int bsumUsage()
 {
 	printf(
 		"bee2/bsum: STB 34.101.31/77 hashing utility [bee2 version %s]\n"
 		"Usage:\n" 
-        "  bsum [hash_alg] <file_to_hash> <file_to_hash> ...\n"
-        "  bsum [hash_alg] -c <checksum_file>\n"
+        "  bsum [hash_alg] [options] <file_to_hash> <file_to_hash> ...\n"
+        "  bsum [hash_alg] [options] -c <checksum_file>\n"
 		"  hash_alg:\n" 
         "    belt-hash (STB 34.101.31, by default)\n"
-        "    bash32, bash64, ..., bash512 (STB 34.101.77)\n",
+        "    bash32, bash64, ..., bash512 (STB 34.101.77)\n"
+		"  options:\n" 
+        "    -j <n>  hash files in n threads (1 by default)\n"
+        "    --tree  use tree hashing with 1 MiB leaves (threads hash leaves)\n"
+        "    --stats print throughput statistics to stderr\n",
 		utilVersion());
 	return -1;
 }
@@ -69,77 +118,377 @@ size_t bsumParseHid(const char* alg_name)
 	return SIZE_MAX;
 }
 
-int bsumHashFile(octet hash[], size_t hid, const char* filename)
+/*
+*******************************************************************************
+Хэширование файла
+
+Функция bsumHashFile() ничего не печатает: сообщения об ошибках выводятся 
+в порядке списка файлов функцией, которая обрабатывает результаты.
+
+Если ctx->tree > 0, то выполняется древовидное хэширование с обработкой 
+листьев в ctx->tree потоках.
+*******************************************************************************
+*/
+
+static void bsumStart(void* state, const bsum_ctx* ctx)
+{
+	if (ctx->tree)
+		bmtHashStart(state, ctx->hid / 2, BSUM_TREE_LEAF, ctx->tree);
+	else
+		ctx->hid ? bashHashStart(state, ctx->hid / 2) : 
+			beltHashStart(state);
+}
+
+static void bsumStepH(const void* buf, size_t count, void* state, 
+	const bsum_ctx* ctx)
 {
+	if (ctx->tree)
+		bmtHashStepH(buf, count, state);
+	else
+		ctx->hid ? bashHashStepH(buf, count, state) : 
+			beltHashStepH(buf, count, state);
+}
+
+static void bsumStepG(octet hash[], void* state, const bsum_ctx* ctx)
+{
+	if (ctx->tree)
+		bmtHashStepG(hash, state);
+	else
+		ctx->hid ? bashHashStepG(hash, ctx->hid / 8, state) : 
+			beltHashStepG(hash, state);
+}
+
+size_t bsumHashFile_deep()
+{
+	return BSUM_BUF_SIZE + 
+		utilMax(3, beltHash_keep(), bashHash_keep(), bmtHash_keep());
+}
+
+int bsumHashFile(octet hash[], double* size, const bsum_ctx* ctx, 
+	const char* filename, void* stack)
+{
+	octet* buf = (octet*)stack;
+	void* state = buf + BSUM_BUF_SIZE;
+#ifdef OS_UNIX
+	int fd;
+	ssize_t count;
+#else
 	FILE* fp;
-	octet state[4096];
-	octet buf[4096];
 	size_t count;
+#endif
+	*size = 0;
+#ifdef OS_UNIX
 	// открыть файл
-	fp = fopen(filename, "rb");
-	if (!fp)
+	fd = open(filename, O_RDONLY);
+	if (fd == -1)
+		return BSUM_ERR_OPEN;
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+	// хэшировать порциями
+	bsumStart(state, ctx);
+	while (1)
 	{
-		printf("%s: FAILED [open]\n", filename);
-		return -1;
+		count = read(fd, buf, BSUM_BUF_SIZE);
+		if (count == 0)
+			break;
+		if (count < 0)
+		{
+			close(fd);
+			return BSUM_ERR_READ;
+		}
+		bsumStepH(buf, (size_t)count, state, ctx);
+		*size += (double)count;
 	}
-	// хэшировать
-	ASSERT(beltHash_keep() <= sizeof(state));
-	ASSERT(bashHash_keep() <= sizeof(state));
-	hid ? bashHashStart(state, hid / 2) : beltHashStart(state);
+	// завершить
+	close(fd);
+#else
+	// открыть файл
+	fp = fopen(filename, "rb");
+	if (!fp)
+		return BSUM_ERR_OPEN;
+	// хэшировать порциями
+	bsumStart(state, ctx);
 	while (1)
 	{
-		count = fread(buf, 1, sizeof(buf), fp);
+		count = fread(buf, 1, BSUM_BUF_SIZE, fp);
 		if (count == 0)
 		{
 			if (ferror(fp))
 			{
 				fclose(fp);
-				printf("%s: FAILED [read]\n", filename);
-				return -1;
+				return BSUM_ERR_READ;
 			}
 			break;
 		}
-		hid ? bashHashStepH(buf, count, state) : 
-			beltHashStepH(buf, count, state);
+		bsumStepH(buf, count, state, ctx);
+		*size += (double)count;
 	}
 	// завершить
 	fclose(fp);
-	hid ? bashHashStepG(hash, hid / 8, state) : beltHashStepG(hash, state);
+#endif
+	bsumStepG(hash, state, ctx);
 	return 0;
 }
 
-int bsumPrint(size_t hid, int argc, char* argv[])
+/*
+*******************************************************************************
+Пул потоков
+
+Задания (файлы) размещаются в массиве items. Исполнители выбирают очередной 
+номер задания и отмечают выполненные задания признаком done. Если создан 
+мьютекс, то выбор и отметка выполняются под его защитой.
+
+Основной поток также является исполнителем. Он обрабатывает результаты 
+в порядке номеров. Пока очередное задание не выполнено, основной поток 
+выполняет очередные невыбранные задания. Если невыбранных заданий не 
+осталось, то основной поток дожидается завершения рабочих потоков 
+(mtThrdJoin()), после чего выполнены все задания. Таким образом, основной 
+поток не опрашивает признаки готовности в цикле ожидания.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	const char* name;		/*< имя файла */
+	const char* check;		/*< контрольное хэш-значение (или 0) */
+	octet hash[64];			/*< хэш-значение */
+	double size;			/*< объем данных */
+	int code;				/*< код ошибки */
+	bool_t done;			/*< задание выполнено? */
+} bsum_item;
+
+typedef struct
+{
+	bsum_item* items;		/*< задания */
+	size_t count;			/*< число заданий */
+	const bsum_ctx* ctx;	/*< контекст */
+	size_t next;			/*< следующее задание */
+	bool_t mt;				/*< создан мьютекс? */
+	mt_mtx_t mtx;			/*< мьютекс */
+} bsum_pool;
+
+typedef struct
+{
+	bsum_pool* pool;		/*< пул */
+	void* stack;			/*< буфер чтения и состояние */
+	mt_thrd_t thrd;			/*< поток */
+	bool_t in_thrd;			/*< выполняется в отдельном потоке? */
+} bsum_worker;
+
+static size_t bsumTake(bsum_pool* pool)
+{
+	size_t i;
+	if (pool->mt)
+		mtMtxLock(&pool->mtx);
+	i = pool->next < pool->count ? pool->next++ : SIZE_MAX;
+	if (pool->mt)
+		mtMtxUnlock(&pool->mtx);
+	return i;
+}
+
+static void bsumDo(bsum_worker* worker, size_t i)
 {
-	octet hash[64];
-	char str[64 * 2 + 8];
+	bsum_pool* pool = worker->pool;
+	pool->items[i].code = bsumHashFile(pool->items[i].hash, 
+		&pool->items[i].size, pool->ctx, pool->items[i].name, 
+		worker->stack);
+	if (pool->mt)
+		mtMtxLock(&pool->mtx);
+	pool->items[i].done = TRUE;
+	if (pool->mt)
+		mtMtxUnlock(&pool->mtx);
+}
+
+static bool_t bsumIsDone(bsum_pool* pool, size_t i)
+{
+	bool_t done;
+	if (pool->mt)
+		mtMtxLock(&pool->mtx);
+	done = pool->items[i].done;
+	if (pool->mt)
+		mtMtxUnlock(&pool->mtx);
+	return done;
+}
+
+static void bsumWorkerRun(void* arg)
+{
+	bsum_worker* worker = (bsum_worker*)arg;
+	size_t i;
+	while ((i = bsumTake(worker->pool)) != SIZE_MAX)
+		bsumDo(worker, i);
+}
+
+static void bsumJoin(bsum_worker workers[], size_t threads)
+{
+	size_t i;
+	for (i = 0; i < threads; ++i)
+		if (workers[i].in_thrd)
+		{
+			mtThrdJoin(&workers[i].thrd);
+			workers[i].in_thrd = FALSE;
+		}
+}
+
+typedef int (*bsum_report_i)(
+	const bsum_item* item,	/* [in] выполненное задание */
+	bsum_ctx* ctx			/* [in/out] контекст */
+);
+
+int bsumRun(bsum_item items[], size_t count, bsum_ctx* ctx, size_t threads, 
+	bsum_report_i report, double* size)
+{
+	bsum_pool pool[1];
+	bsum_worker* workers;
+	size_t i, j;
 	int ret = 0;
-	for (; argc--; argv++)
+	// подготовить пул
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, MAX2(count, 1));
+	workers = (bsum_worker*)blobCreate(threads * 
+		(sizeof(bsum_worker) + bsumHashFile_deep()));
+	if (!workers)
 	{
-		if (bsumHashFile(hash, hid, argv[0]) != 0)
-		{
+		printf("bsum: FAILED [memory]\n");
+		return -1;
+	}
+	pool->items = items, pool->count = count, pool->ctx = ctx;
+	pool->next = 0;
+	for (i = 0; i < count; ++i)
+		items[i].done = FALSE;
+	for (i = 0; i < threads; ++i)
+	{
+		workers[i].pool = pool;
+		workers[i].stack = (octet*)(workers + threads) + 
+			i * bsumHashFile_deep();
+		workers[i].in_thrd = FALSE;
+	}
+	*size = 0;
+	// запустить рабочие потоки (workers[0] -- основной поток)
+	pool->mt = threads > 1 && mtMtxCreate(&pool->mtx);
+	if (pool->mt)
+		for (i = 1; i < threads; ++i)
+			workers[i].in_thrd = 
+				mtThrdCreate(&workers[i].thrd, bsumWorkerRun, workers + i);
+	// обработать результаты
+	for (i = 0; i < count; ++i)
+	{
+		// ожидать выполнения задания i, выполняя другие задания
+		while (!bsumIsDone(pool, i))
+			if ((j = bsumTake(pool)) != SIZE_MAX)
+				bsumDo(workers, j);
+			else
+				bsumJoin(workers, threads);
+		if (report(items + i, ctx) != 0)
 			ret = -1;
-			continue;
-		}
-		hexFrom(str, hash, hid ? hid / 8 : 32);
-		hexLower(str);
-		printf("%s  %s\n", str, argv[0]);
+		*size += items[i].size;
 	}
+	// завершить
+	if (pool->mt)
+	{
+		bsumJoin(workers, threads);
+		mtMtxClose(&pool->mtx);
+	}
+	blobClose(workers);
 	return ret;
 }
 
-int bsumCheck(size_t hid, const char* filename)
+/*
+*******************************************************************************
+Печать и проверка хэш-значений
+*******************************************************************************
+*/
+
+static int bsumReportError(const bsum_item* item)
+{
+	printf(item->code == BSUM_ERR_OPEN ? "%s: FAILED [open]\n" : 
+		"%s: FAILED [read]\n", item->name);
+	return -1;
+}
+
+static int bsumReportPrint(const bsum_item* item, bsum_ctx* ctx)
+{
+	char str[64 * 2 + 8];
+	if (item->code)
+		return bsumReportError(item);
+	hexFrom(str, item->hash, ctx->hid ? ctx->hid / 8 : 32);
+	hexLower(str);
+	printf("%s  %s\n", str, item->name);
+	return 0;
+}
+
+static int bsumReportCheck(const bsum_item* item, bsum_ctx* ctx)
+{
+	if (item->code)
+	{
+		ctx->bad_files++;
+		return bsumReportError(item);
+	}
+	if (!hexEq(item->hash, item->check))
+	{
+		ctx->bad_hashes++;
+		printf("%s: FAILED [checksum]\n", item->name);
+		return -1;
+	}
+	printf("%s: OK\n", item->name);
+	return 0;
+}
+
+static void bsumStats(size_t files, double size, tm_ticks_t ticks)
+{
+	double secs = (double)ticks / (double)tmFreq();
+	fprintf(stderr, "bsum: %lu files, %.0f bytes, %.3f s, %.2f MB/s\n",
+		(unsigned long)files, size, secs, 
+		secs > 0 ? size / secs / 1048576.0 : 0.0);
+}
+
+int bsumPrint(bsum_ctx* ctx, size_t threads, bool_t stats, int argc, 
+	char* argv[])
+{
+	bsum_item* items;
+	double size;
+	tm_ticks_t ticks;
+	int i, ret;
+	// подготовить задания
+	items = (bsum_item*)blobCreate(sizeof(bsum_item) * MAX2(argc, 1));
+	if (!items)
+	{
+		printf("bsum: FAILED [memory]\n");
+		return -1;
+	}
+	for (i = 0; i < argc; ++i)
+		items[i].name = argv[i];
+	// хэшировать
+	ticks = tmTicks();
+	ret = bsumRun(items, (size_t)argc, ctx, threads, bsumReportPrint, &size);
+	ticks = tmTicks() - ticks;
+	if (stats)
+		bsumStats((size_t)argc, size, ticks);
+	blobClose(items);
+	return ret;
+}
+
+int bsumCheck(bsum_ctx* ctx, size_t threads, bool_t stats, 
+	const char* filename)
 {
-	octet hash[64];
 	size_t hash_len;
 	char str[1024];
 	size_t str_len;
 	FILE* fp;
+	bsum_item* items = 0;
+	size_t count = 0;
+	size_t capacity = 0;
+	char* names = 0;
+	void* ptr;
+	size_t names_len = 0;
+	size_t names_capacity = 0;
+	double size;
+	tm_ticks_t ticks;
+	size_t i;
 	size_t all_lines = 0;
 	size_t bad_lines = 0;
-	size_t bad_files = 0;
-	size_t bad_hashes = 0;
 	// длина хэш-значения в байтах
-	hash_len = hid ? hid / 8 : 32;
+	hash_len = ctx->hid ? ctx->hid / 8 : 32;
 	// открыть checksum_file
 	fp = fopen(filename, "rb");
 	if (!fp)
@@ -147,6 +496,7 @@ int bsumCheck(size_t hid, const char* filename)
 		printf("%s: No such file\n", filename);
 		return -1;
 	}
+	// прочитать checksum_file
 	for (; fgets(str, sizeof(str), fp); ++all_lines)
     {
 		// проверить строку
@@ -164,66 +514,108 @@ int bsumCheck(size_t hid, const char* filename)
 			str[--str_len] = 0;
 		if(str[str_len - 1] == '\r') 
 			str[--str_len] = 0;
-		// хэшировать
-		if (bsumHashFile(hash, hid, str + 2 * hash_len + 2) == -1)
+		// расширить массивы (при ошибке прежние блобы сохраняются)
+		ptr = items;
+		if (count == capacity)
 		{
-			bad_files++;
-			continue;
+			capacity = capacity ? 2 * capacity : 256;
+			ptr = blobResize(items, capacity * sizeof(bsum_item));
+			if (ptr)
+				items = (bsum_item*)ptr;
 		}
-		if (!hexEq(hash, str))
+		if (ptr && names_len + str_len + 1 > names_capacity)
 		{
-			bad_hashes++;
-			printf("%s: FAILED [checksum]\n", str + 2 * hash_len + 2);
-			continue;
+			names_capacity = MAX2(2 * names_capacity, 
+				names_len + str_len + 1);
+			ptr = blobResize(names, names_capacity);
+			if (ptr)
+				names = (char*)ptr;
+		}
+		if (!ptr)
+		{
+			fclose(fp);
+			blobClose(items), blobClose(names);
+			printf("%s: FAILED [memory]\n", filename);
+			return -1;
 		}
-		printf("%s: OK\n", str + 2 * hash_len + 2);
+		// запомнить строку (указатели будут установлены позже)
+		memCopy(names + names_len, str, str_len + 1);
+		names_len += str_len + 1, count++;
     }
     fclose(fp);
+	// установить указатели
+	for (i = 0, str_len = 0; i < count; ++i)
+	{
+		items[i].check = names + str_len;
+		items[i].name = items[i].check + 2 * hash_len + 2;
+		str_len = (size_t)(items[i].name - names) + strLen(items[i].name) + 1;
+	}
+	// проверить
+	ctx->bad_files = ctx->bad_hashes = 0;
+	ticks = tmTicks();
+	bsumRun(items, count, ctx, threads, bsumReportCheck, &size);
+	ticks = tmTicks() - ticks;
+	if (stats)
+		bsumStats(count, size, ticks);
+	blobClose(items), blobClose(names);
 	if (bad_lines)
 		fprintf(stderr, bad_lines == 1 ? 
 			"WARNING: %lu input line (out of %lu) is improperly formatted\n" :
 			"WARNING: %lu input lines (out of %lu) are improperly formatted\n",
 			(unsigned long)bad_lines, (unsigned long)all_lines);
-	if (bad_files)
-		fprintf(stderr, bad_files == 1 ? 
+	if (ctx->bad_files)
+		fprintf(stderr, ctx->bad_files == 1 ? 
 			"WARNING: %lu listed file could not be opened or read\n" :
 			"WARNING: %lu listed files could not be opened or read\n", 
-			(unsigned long)bad_files);
-	if (bad_hashes)
-		fprintf(stderr, bad_hashes == 1 ? 
+			(unsigned long)ctx->bad_files);
+	if (ctx->bad_hashes)
+		fprintf(stderr, ctx->bad_hashes == 1 ? 
 			"WARNING: %lu computed checksum did not match\n":  
 			"WARNING: %lu computed checksums did not match\n",  
-			(unsigned long)bad_hashes);
-	return (bad_lines || bad_files || bad_hashes) ? - 1 : 0;
+			(unsigned long)ctx->bad_hashes);
+	return (bad_lines || ctx->bad_files || ctx->bad_hashes) ? - 1 : 0;
 }
 
 int main(int argc, char* argv[])
 {
-	size_t hid = 0;
+	bsum_ctx ctx[1];
+	size_t threads = 1;
+	bool_t stats = FALSE;
 #ifdef OS_WIN
 	setlocale(LC_ALL, "russian_belarus.1251");
 #endif
 	if (argc < 2)
 		return bsumUsage();
-	// check mode?
-	if (3 <= argc && argc <= 4 && strEq(argv[argc - 2], "-c"))
-	{
-		if (argc == 4)
+	argc--, argv++;
+	memSetZero(ctx, sizeof(bsum_ctx));
+	// hash_alg?
+	if (argc > 1 && bsumParseHid(argv[0]) != SIZE_MAX)
+		ctx->hid = bsumParseHid(argv[0]), argc--, argv++;
+	// options?
+	while (argc > 1)
+		if (strEq(argv[0], "-j"))
 		{
-			hid = bsumParseHid(argv[1]);
-			if (hid == SIZE_MAX)
+			if (!decIsValid(argv[1]) || !strLen(argv[1]) || 
+				strLen(argv[1]) > 3 || decCLZ(argv[1]) ||
+				(threads = (size_t)decToU32(argv[1])) == 0 ||
+				threads > BSUM_MAX_THREADS)
 				return bsumUsage();
+			argc -= 2, argv += 2;
 		}
-		return bsumCheck(hid, argv[argc - 1]);
-	}
-	// print mode
-	if (argc > 2)
-	{
-		hid = bsumParseHid(argv[1]);
-		if (hid != SIZE_MAX)
-			argc--, argv++;
+		else if (strEq(argv[0], "--tree"))
+			ctx->tree = 1, argc--, argv++;
+		else if (strEq(argv[0], "--stats"))
+			stats = TRUE, argc--, argv++;
 		else
-			hid = 0;
-	}
-	return bsumPrint(hid, argc - 1, argv + 1);
+			break;
+	// tree mode: потоки обрабатывают листья
+	if (ctx->tree)
+		ctx->tree = threads, threads = 1;
+	// check mode?
+	if (argc == 2 && strEq(argv[0], "-c"))
+		return bsumCheck(ctx, threads, stats, argv[1]);
+	if (argc == 3 && strEq(argv[1], "-c"))
+		return bsumUsage();
+	// print mode
+	return bsumPrint(ctx, threads, stats, argc, argv);
 }
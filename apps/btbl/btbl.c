@@ -0,0 +1,201 @@
+﻿/*
+*******************************************************************************
+\file btbl.c
+\brief A utility for generating bign precomputation tables
+\project bee2/apps/btbl
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/defs.h>
+#include <bee2/core/blob.h>
+#include <bee2/core/err.h>
+#include <bee2/core/str.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bign.h>
+
+#include <stdio.h>
+#ifdef OS_UNIX
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+/*
+*******************************************************************************
+Утилита btbl
+
+Утилита строит образы таблиц предвычислений bign (см. bignTblCreate())
+и проверяет их. Построенный файл предназначен для отображения в память
+рабочими процессами (mmap(PROT_READ, MAP_SHARED)). В режиме проверки
+утилита сама загружает файл таким способом (в Unix).
+*******************************************************************************
+*/
+
+int btblUsage()
+{
+	printf(
+		"bee2/btbl: STB 34.101.45 precomputation tables [bee2 version %s]\n"
+		"Usage:\n"
+		"  btbl <params> <tbl_file>\n"
+		"  btbl -c <params> <tbl_file>\n"
+		"  params:\n"
+		"    bign-curve256v1 (1.2.112.0.2.0.34.101.45.3.1)\n"
+		"    bign-curve384v1 (1.2.112.0.2.0.34.101.45.3.2)\n"
+		"    bign-curve512v1 (1.2.112.0.2.0.34.101.45.3.3)\n",
+		utilVersion());
+	return -1;
+}
+
+err_t btblParams(bign_params* params, const char* name)
+{
+	if (strEq(name, "bign-curve256v1"))
+		name = "1.2.112.0.2.0.34.101.45.3.1";
+	else if (strEq(name, "bign-curve384v1"))
+		name = "1.2.112.0.2.0.34.101.45.3.2";
+	else if (strEq(name, "bign-curve512v1"))
+		name = "1.2.112.0.2.0.34.101.45.3.3";
+	return bignStdParams(params, name);
+}
+
+int btblCreate(const bign_params* params, const char* filename)
+{
+	err_t code;
+	size_t count;
+	void* tbl;
+	FILE* fp;
+	// построить образ
+	code = bignTblCreate(0, &count, params);
+	if (code != ERR_OK)
+	{
+		printf("%s: FAILED [code %u]\n", filename, (unsigned)code);
+		return -1;
+	}
+	tbl = blobCreate(count);
+	if (!tbl)
+	{
+		printf("%s: FAILED [code %u]\n", filename, 
+			(unsigned)ERR_OUTOFMEMORY);
+		return -1;
+	}
+	code = bignTblCreate(tbl, &count, params);
+	if (code != ERR_OK)
+	{
+		blobClose(tbl);
+		printf("%s: FAILED [code %u]\n", filename, (unsigned)code);
+		return -1;
+	}
+	// записать образ
+	fp = fopen(filename, "wb");
+	if (!fp)
+	{
+		blobClose(tbl);
+		printf("%s: FAILED [open]\n", filename);
+		return -1;
+	}
+	if (fwrite(tbl, 1, count, fp) != count)
+	{
+		fclose(fp);
+		blobClose(tbl);
+		printf("%s: FAILED [write]\n", filename);
+		return -1;
+	}
+	fclose(fp);
+	blobClose(tbl);
+	printf("%s: OK [%lu octets]\n", filename, (unsigned long)count);
+	return 0;
+}
+
+int btblCheck(const bign_params* params, const char* filename)
+{
+	err_t code;
+#ifdef OS_UNIX
+	int fd;
+	struct stat st;
+	void* tbl;
+	// отобразить файл в память
+	fd = open(filename, O_RDONLY);
+	if (fd == -1)
+	{
+		printf("%s: FAILED [open]\n", filename);
+		return -1;
+	}
+	if (fstat(fd, &st) == -1 || st.st_size == 0)
+	{
+		close(fd);
+		printf("%s: FAILED [read]\n", filename);
+		return -1;
+	}
+	tbl = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (tbl == MAP_FAILED)
+	{
+		printf("%s: FAILED [mmap]\n", filename);
+		return -1;
+	}
+	// проверить образ
+	code = bignTblVal(params, tbl, (size_t)st.st_size);
+	munmap(tbl, (size_t)st.st_size);
+#else
+	long size;
+	void* tbl;
+	FILE* fp;
+	// прочитать файл
+	fp = fopen(filename, "rb");
+	if (!fp)
+	{
+		printf("%s: FAILED [open]\n", filename);
+		return -1;
+	}
+	if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) <= 0 ||
+		fseek(fp, 0, SEEK_SET) || (tbl = blobCreate((size_t)size)) == 0)
+	{
+		fclose(fp);
+		printf("%s: FAILED [read]\n", filename);
+		return -1;
+	}
+	if (fread(tbl, 1, (size_t)size, fp) != (size_t)size)
+	{
+		blobClose(tbl);
+		fclose(fp);
+		printf("%s: FAILED [read]\n", filename);
+		return -1;
+	}
+	fclose(fp);
+	// проверить образ
+	code = bignTblVal(params, tbl, (size_t)size);
+	blobClose(tbl);
+#endif
+	if (code != ERR_OK)
+	{
+		printf("%s: FAILED [code %u]\n", filename, (unsigned)code);
+		return -1;
+	}
+	printf("%s: OK\n", filename);
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	bign_params params[1];
+	// check mode?
+	if (argc == 4 && strEq(argv[1], "-c"))
+	{
+		if (btblParams(params, argv[2]) != ERR_OK)
+			return btblUsage();
+		return btblCheck(params, argv[3]);
+	}
+	// create mode
+	if (argc == 3)
+	{
+		if (btblParams(params, argv[1]) != ERR_OK)
+			return btblUsage();
+		return btblCreate(params, argv[2]);
+	}
+	return btblUsage();
+}
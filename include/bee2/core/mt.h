@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.10.10
-\version 2017.01.11
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -125,9 +125,95 @@ void mtMtxClose(
 
 Управление потоками реализуется по схемам, заданным в новом стандарте
 языка Си ISO/IEC 9899:2011 (см. заголовочный файл threads.h).
+
+Интерфейс потоков упрощен по сравнению со стандартом: поток выполняет 
+функцию типа mt_thrd_i, результат работы потока не возвращается 
+(его можно передать через аргумент функции). Запущенный поток обязательно 
+должен быть присоединен с помощью mtThrdJoin(). 
+
+Если операционная система не распознана, то функция потока выполняется 
+непосредственно при вызове mtThrdCreate(), а mtThrdJoin() ничего не делает. 
+Результаты вычислений при этом не меняются.
+
+\typedef mt_thrd_i
+\brief Функция потока
+
+\typedef mt_thrd_t
+\brief Поток
 *******************************************************************************
 */
 
+typedef void (*mt_thrd_i)(
+	void* arg		/*!< [in/out] аргумент */
+);
+
+#ifdef OS_WIN
+	typedef struct
+	{
+		HANDLE handle;	/*!< дескриптор */
+		mt_thrd_i fn;	/*!< функция */
+		void* arg;		/*!< аргумент функции */
+	} mt_thrd_t;
+#elif defined OS_UNIX
+	typedef struct
+	{
+		pthread_t id;	/*!< идентификатор */
+		mt_thrd_i fn;	/*!< функция */
+		void* arg;		/*!< аргумент функции */
+	} mt_thrd_t;
+#else
+	typedef struct
+	{
+		mt_thrd_i fn;	/*!< функция */
+		void* arg;		/*!< аргумент функции */
+	} mt_thrd_t;
+#endif
+
+/*!	\brief Создание потока
+
+	Создается поток thrd, который выполняет функцию fn с аргументом arg.
+	\return Признак успеха.
+	\remark Структура thrd должна оставаться доступной вплоть до вызова 
+	mtThrdJoin().
+	\remark Если поток создать не удалось, то вызывающая программа может 
+	выполнить fn(arg) самостоятельно.
+*/
+bool_t mtThrdCreate(
+	mt_thrd_t* thrd,	/*!< [out] поток */
+	mt_thrd_i fn,		/*!< [in] функция потока */
+	void* arg			/*!< [in/out] аргумент функции */
+);
+
+/*!	\brief Присоединение потока
+
+	Ожидается завершение потока thrd, после чего ресурсы потока 
+	освобождаются.
+	\pre Поток thrd успешно создан функцией mtThrdCreate() и еще не 
+	присоединен.
+*/
+void mtThrdJoin(
+	mt_thrd_t* thrd		/*!< [in] поток */
+);
+
+/*!	\brief Выполнение заданий
+
+	Функция run вызывается для каждого из заданий массива jobs 
+	из count элементов длины job_size. Нулевое задание выполняется 
+	в вызывающем потоке, для остальных заданий создаются отдельные потоки. 
+	Если поток создать не удалось, то его задание выполняется в вызывающем 
+	потоке. Функция возвращает управление после завершения всех заданий.
+	\pre Задания могут выполняться параллельно: они не используют общих 
+	ресурсов, которые изменяются без синхронизации.
+	\remark Для потоков выделяется память. Если ее выделить не удалось, 
+	то все задания выполняются в вызывающем потоке.
+*/
+void mtRunJobs(
+	mt_thrd_i run,		/*!< [in] функция задания */
+	void* jobs,			/*!< [in/out] задания */
+	size_t job_size,	/*!< [in] длина задания (в октетах) */
+	size_t count		/*!< [in] число заданий */
+);
+
 /*!	\brief Приостановка потока
 
 	Текущий поток приостанавливается на ms миллисекунд.
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.15
-\version 2019.07.19
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -466,6 +466,72 @@ void bashAEDecr(
 	void* state			/*!< [in/out] состояние */
 );
 
+/*!	\brief Пакетная установка защиты
+
+	Выполняется установка защиты num пакетов разных сессий. Пакет j
+	состоит из открытых данных [hdr_counts[j]]hdrs[j] и критических данных
+	[counts[j]]bufs[j] и обрабатывается на состоянии states[j]: данные
+	bufs[j] зашифровываются на месте, имитовставка пакета записывается
+	в [mac_len](macs + mac_len * j).
+	\expect{ERR_BAD_INPUT}
+	-	0 < mac_len <= 64;
+	-	все указатели, кроме, возможно, hdrs, действительны.
+	.
+	\pre Состояния states[j] подготовлены функцией bashAEStart().
+	\return ERR_OK, если защита установлена, и код ошибки в противном
+	случае.
+	\remark При нулевом указателе hdrs открытые данные пакетов не
+	загружаются, а указатель hdr_counts не используется.
+	\remark Для каждого j результат совпадает с результатом обращений
+	\code
+		bashAEAbsorb(BASH_AE_DATA, hdrs[j], hdr_counts[j], states[j]);
+		bashAEEncr(bufs[j], counts[j], states[j]);
+		bashAESqueeze(BASH_AE_MAC, macs + mac_len * j, mac_len, states[j]);
+	\endcode
+*/
+err_t bashAEWrapBurst(
+	void* bufs[],				/*!< [in/out] критические данные */
+	const size_t counts[],		/*!< [in] длины критических данных */
+	const void* hdrs[],			/*!< [in] открытые данные */
+	const size_t hdr_counts[],	/*!< [in] длины открытых данных */
+	octet macs[],				/*!< [out] имитовставки */
+	size_t mac_len,				/*!< [in] длина имитовставки */
+	void* states[],				/*!< [in/out] состояния */
+	size_t num					/*!< [in] число пакетов */
+);
+
+/*!	\brief Пакетное снятие защиты
+
+	Выполняется снятие защиты num пакетов разных сессий. Пакет j
+	состоит из открытых данных [hdr_counts[j]]hdrs[j], зашифрованных
+	критических данных [counts[j]]bufs[j] и имитовставки
+	[mac_len](macs + mac_len * j) и обрабатывается на состоянии states[j]:
+	данные bufs[j] расшифровываются на месте и проверяется имитовставка.
+	Если имитовставка неверна, то bufs[j] обнуляется. Признак
+	корректности имитовставки пакета j записывается в oks[j].
+	\expect{ERR_BAD_INPUT}
+	-	0 < mac_len <= 64;
+	-	все указатели, кроме, возможно, hdrs и oks, действительны.
+	.
+	\pre Состояния states[j] подготовлены функцией bashAEStart().
+	\return ERR_OK, если защита снята со всех пакетов, ERR_BAD_MAC, если
+	имитовставка хотя бы одного пакета неверна, и другой код ошибки
+	в остальных случаях.
+	\remark При нулевом указателе hdrs открытые данные пакетов не
+	загружаются. При нулевом указателе oks признаки не возвращаются.
+*/
+err_t bashAEUnwrapBurst(
+	void* bufs[],				/*!< [in/out] критические данные */
+	const size_t counts[],		/*!< [in] длины критических данных */
+	const void* hdrs[],			/*!< [in] открытые данные */
+	const size_t hdr_counts[],	/*!< [in] длины открытых данных */
+	const octet macs[],			/*!< [in] имитовставки */
+	size_t mac_len,				/*!< [in] длина имитовставки */
+	void* states[],				/*!< [in/out] состояния */
+	size_t num,					/*!< [in] число пакетов */
+	bool_t oks[]				/*!< [out] признаки корректности */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
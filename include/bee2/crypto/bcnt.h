@@ -0,0 +1,219 @@
+/*
+*******************************************************************************
+\file bcnt.h
+\brief Chunked authenticated encryption containers
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+/*!
+*******************************************************************************
+\file bcnt.h
+\brief Контейнеры аутентифицированного шифрования
+*******************************************************************************
+*/
+
+#ifndef __BEE2_BCNT_H
+#define __BEE2_BCNT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bee2/defs.h"
+
+/*!
+*******************************************************************************
+\file bcnt.h
+
+\section bcnt-common Общие положения
+
+Реализован формат контейнера, в котором данные произвольной длины
+защищаются алгоритмом аутентифицированного шифрования belt-dwp
+(СТБ 34.101.31) или bash-ae (СТБ 34.101.77). Данные разбиваются на
+фрагменты (chunks) фиксированной длины chunk_size, последний фрагмент
+может быть короче, в том числе пустым. Каждый фрагмент зашифровывается
+и имитозащищается независимо, что позволяет:
+-	обрабатывать данные потоком в памяти постоянного объема;
+-	зашифровывать и расшифровывать фрагменты параллельно;
+-	расшифровывать отдельные фрагменты (произвольный доступ).
+
+Контейнер состоит из заголовка и защищенных фрагментов:
+	header || Y_0 || T_0 || Y_1 || T_1 || ...,
+где Y_i -- зашифрованный фрагмент i, T_i -- его имитовставка.
+Длина T_i равняется 8 октетам для belt-dwp и 32 октетам для bash-ae.
+Защищенный фрагмент i начинается со смещения
+BCNT_HDR_LEN + i * (chunk_size + tag_len).
+
+Заголовок из BCNT_HDR_LEN октетов включает сигнатуру "bcnt", номер версии
+формата (1), идентификатор алгоритма, длину фрагмента и случайную
+синхропосылку S из 16 октетов. По 32-октетному ключу K с помощью beltKRP 
+(СТБ 34.101.31) строятся два ключа файла:
+	K_iv = beltKRP(K, <1>_8 || 0^88, S),
+	K_ae = beltKRP(K, <2>_8 || 0^88, S).
+Синхропосылка фрагмента i строится на ключе K_iv:
+	iv_i = beltKRP(K_iv, <i>_64 || <final>_8 || 0^24, 0^128)[:16],
+где final -- признак последнего фрагмента. Фрагмент зашифровывается 
+и имитозащищается на ключе K_ae. В качестве открытых
+(ассоциированных) данных фрагмента используются заголовок, <i>_64
+и <final>_8.
+
+Номер фрагмента и признак последнего фрагмента входят в синхропосылку
+и открытые данные. Поэтому фрагменты нельзя переставить, а контейнер
+нельзя незаметно обрезать по границе фрагмента: прежний предпоследний
+фрагмент будет расшифровываться как последний и не пройдет проверку.
+
+При расшифровании последним считается фрагмент, которым заканчивается
+контейнер.
+
+\expect{ERR_BAD_INPUT} Все входные указатели действительны.
+
+\pre Если не оговорено противное, то входные буферы функций не
+пересекаются.
+*******************************************************************************
+*/
+
+/*!	\brief Длина заголовка контейнера */
+#define BCNT_HDR_LEN 32
+
+/*!	\brief Идентификатор алгоритма belt-dwp */
+#define BCNT_BELT_DWP 1
+
+/*!	\brief Идентификатор алгоритма bash-ae */
+#define BCNT_BASH_AE 2
+
+/*!	\brief Максимальная длина фрагмента */
+#define BCNT_CHUNK_MAX ((size_t)1 << 30)
+
+/*!	\brief Длина состояния
+
+	Возвращается длина состояния (в октетах) функций обработки контейнеров.
+	\return Длина состояния.
+*/
+size_t bcnt_keep();
+
+/*!	\brief Начало зашифрования
+
+	В state формируются структуры данных, необходимые для зашифрования
+	данных на ключе key алгоритмом alg с длиной фрагмента chunk_size.
+	Синхропосылка контейнера вырабатывается генератором rng, заголовок
+	контейнера записывается в header.
+	\expect{ERR_BAD_PARAMS} alg == BCNT_BELT_DWP || alg == BCNT_BASH_AE.
+	\expect{ERR_BAD_PARAMS} 0 < chunk_size <= BCNT_CHUNK_MAX.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\pre По адресу state зарезервировано bcnt_keep() октетов.
+	\return ERR_OK, если состояние подготовлено, и код ошибки
+	в противном случае.
+*/
+err_t bcntEncrStart(
+	void* state,				/*!< [out] состояние */
+	octet header[BCNT_HDR_LEN],	/*!< [out] заголовок */
+	size_t alg,					/*!< [in] алгоритм */
+	size_t chunk_size,			/*!< [in] длина фрагмента */
+	const octet key[32],		/*!< [in] ключ */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in/out] состояние генератора */
+);
+
+/*!	\brief Начало расшифрования
+
+	По заголовку header и ключу key в state формируются структуры данных,
+	необходимые для расшифрования контейнера.
+	\expect{ERR_BAD_FORMAT} Заголовок корректен.
+	\pre По адресу state зарезервировано bcnt_keep() октетов.
+	\return ERR_OK, если состояние подготовлено, и код ошибки
+	в противном случае.
+*/
+err_t bcntDecrStart(
+	void* state,					/*!< [out] состояние */
+	const octet header[BCNT_HDR_LEN],/*!< [in] заголовок */
+	const octet key[32]				/*!< [in] ключ */
+);
+
+/*!	\brief Длина фрагмента
+
+	Возвращается длина фрагмента открытых данных.
+	\expect bcntEncrStart() < bcntChunkSize() ||
+	bcntDecrStart() < bcntChunkSize().
+	\return Длина фрагмента.
+*/
+size_t bcntChunkSize(
+	const void* state			/*!< [in] состояние */
+);
+
+/*!	\brief Длина имитовставки
+
+	Возвращается длина имитовставки фрагмента.
+	\expect bcntEncrStart() < bcntTagLen() || bcntDecrStart() < bcntTagLen().
+	\return Длина имитовставки.
+*/
+size_t bcntTagLen(
+	const void* state			/*!< [in] состояние */
+);
+
+/*!	\brief Зашифрование фрагментов
+
+	Данные [count]src разбиваются на фрагменты длины chunk_size, которые
+	получают номера index, index + 1,... Фрагменты зашифровываются
+	и имитозащищаются в threads потоках, защищенные фрагменты записываются
+	в dest. Если final == TRUE, то последний фрагмент считается
+	последним фрагментом контейнера: он может быть короче chunk_size или
+	пустым (при count == 0).
+	\expect{ERR_BAD_INPUT} Если final == FALSE, то count > 0 и count
+	кратно chunk_size.
+	\return ERR_OK, если фрагменты зашифрованы, и код ошибки
+	в противном случае.
+	\remark Длина dest равняется count + n * tag_len, где n -- число
+	фрагментов, tag_len -- длина имитовставки (см. bcntTagLen()).
+	\remark Состояние state не изменяется. Поэтому функцию можно
+	вызывать одновременно для разных фрагментов одного контейнера.
+*/
+err_t bcntEncr(
+	octet dest[],				/*!< [out] защищенные фрагменты */
+	const void* src,			/*!< [in] открытые данные */
+	size_t count,				/*!< [in] число октетов данных */
+	size_t index,				/*!< [in] номер первого фрагмента */
+	bool_t final,				/*!< [in] последний фрагмент в src? */
+	const void* state,			/*!< [in] состояние */
+	size_t threads				/*!< [in] число потоков */
+);
+
+/*!	\brief Расшифрование фрагментов
+
+	Защищенные фрагменты [count]src с номерами index, index + 1,...
+	расшифровываются в threads потоках, открытые данные записываются
+	в dest. Если final == TRUE, то последний фрагмент src считается
+	последним фрагментом контейнера.
+	\expect{ERR_BAD_INPUT} Если final == FALSE, то count > 0 и count
+	кратно chunk_size + tag_len. Если final == TRUE, то длина последнего
+	фрагмента не меньше tag_len.
+	\return ERR_OK, если все фрагменты расшифрованы, ERR_BAD_MAC, если
+	имитовставка хотя бы одного фрагмента неверна, и другой код ошибки
+	в остальных случаях.
+	\remark Длина dest равняется count - n * tag_len, где n -- число
+	фрагментов. Открытые данные фрагментов, которые не прошли проверку,
+	обнуляются.
+	\remark Для расшифрования отдельного фрагмента i достаточно передать
+	в функцию этот фрагмент и index == i.
+	\remark Состояние state не изменяется.
+*/
+err_t bcntDecr(
+	void* dest,					/*!< [out] открытые данные */
+	const octet src[],			/*!< [in] защищенные фрагменты */
+	size_t count,				/*!< [in] число октетов src */
+	size_t index,				/*!< [in] номер первого фрагмента */
+	bool_t final,				/*!< [in] последний фрагмент в src? */
+	const void* state,			/*!< [in] состояние */
+	size_t threads				/*!< [in] число потоков */
+);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __BEE2_BCNT_H */
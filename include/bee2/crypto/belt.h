@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.12.18
-\version 2019.07.10
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -1016,6 +1016,70 @@ err_t beltDWPUnwrap(
 	const octet iv[16]		/*!< [in] синхропосылка */
 );
 
+/*!	\brief Пакетная установка защиты в режиме DWP
+
+	Выполняется установка защиты num пакетов разных сессий. Пакет j
+	состоит из открытых данных [hdr_counts[j]]hdrs[j] и критических данных
+	[counts[j]]bufs[j] и обрабатывается на состоянии states[j]: данные
+	bufs[j] зашифровываются на месте, имитовставка пакета записывается
+	в [8](macs + 8 * j).
+	\expect{ERR_BAD_INPUT} Все указатели действительны.
+	\pre Состояния states[j] попарно различны и подготовлены функцией
+	beltDWPStart(), как правило, с уникальными для пакетов
+	синхропосылками.
+	\return ERR_OK, если защита установлена, и код ошибки в противном
+	случае.
+	\remark При нулевом указателе hdrs открытые данные пакетов считаются
+	пустыми, а указатель hdr_counts не используется.
+	\remark Для каждого j результат совпадает с результатом обращений
+	\code
+		beltDWPStepI(hdrs[j], hdr_counts[j], states[j]);
+		beltDWPStepE(bufs[j], counts[j], states[j]);
+		beltDWPStepA(bufs[j], counts[j], states[j]);
+		beltDWPStepG(macs + 8 * j, states[j]);
+	\endcode
+	Гамма для пар пакетов вырабатывается совместно.
+*/
+err_t beltDWPWrapBurst(
+	void* bufs[],				/*!< [in/out] критические данные */
+	const size_t counts[],		/*!< [in] длины критических данных */
+	const void* hdrs[],			/*!< [in] открытые данные */
+	const size_t hdr_counts[],	/*!< [in] длины открытых данных */
+	octet macs[],				/*!< [out] имитовставки */
+	void* states[],				/*!< [in/out] состояния */
+	size_t num					/*!< [in] число пакетов */
+);
+
+/*!	\brief Пакетное снятие защиты в режиме DWP
+
+	Выполняется снятие защиты num пакетов разных сессий. Пакет j
+	состоит из открытых данных [hdr_counts[j]]hdrs[j], зашифрованных
+	критических данных [counts[j]]bufs[j] и имитовставки [8](macs + 8 * j)
+	и обрабатывается на состоянии states[j]. Если имитовставка верна, то
+	данные bufs[j] расшифровываются на месте. Если нет, то bufs[j]
+	обнуляется. Признак корректности имитовставки пакета j записывается
+	в oks[j].
+	\expect{ERR_BAD_INPUT} Все указатели, кроме, возможно, hdrs и oks,
+	действительны.
+	\pre Состояния states[j] попарно различны и подготовлены функцией
+	beltDWPStart().
+	\return ERR_OK, если защита снята со всех пакетов, ERR_BAD_MAC, если
+	имитовставка хотя бы одного пакета неверна, и другой код ошибки
+	в остальных случаях.
+	\remark При нулевом указателе hdrs открытые данные пакетов считаются
+	пустыми. При нулевом указателе oks признаки не возвращаются.
+*/
+err_t beltDWPUnwrapBurst(
+	void* bufs[],				/*!< [in/out] критические данные */
+	const size_t counts[],		/*!< [in] длины критических данных */
+	const void* hdrs[],			/*!< [in] открытые данные */
+	const size_t hdr_counts[],	/*!< [in] длины открытых данных */
+	const octet macs[],			/*!< [in] имитовставки */
+	void* states[],				/*!< [in/out] состояния */
+	size_t num,					/*!< [in] число пакетов */
+	bool_t oks[]				/*!< [out] признаки корректности */
+);
+
 /*
 *******************************************************************************
 Шифрование и имитозащита ключей (belt-kwp, KWP)
@@ -1077,6 +1141,35 @@ err_t beltKWPUnwrap(
 	size_t len				/*!< [in] длина key в октетах */
 );
 
+/*!	\brief Пакетная установка защиты в режиме KWP
+
+	На ключе [len]key устанавливается защита ключей [count]src,
+	[count](src + count),..., [count](src + (num - 1) * count) с заголовками
+	[16]headers, [16](headers + 16),... Защищенные ключи размещаются
+	в буфере [num * (count + 16)]dest в том же порядке. Ключи
+	обрабатываются в threads потоках.
+	\expect{ERR_BAD_INPUT}
+	-	len == 16 || len == 24 || len == 32;
+	-	count >= 16.
+	.
+	\return ERR_OK, если защита успешно установлена, и код ошибки
+	в противном случае.
+	\remark При нулевом указателе headers используются нулевые заголовки.
+	\remark Результат совпадает с результатом num обращений
+	к beltKWPWrap(). Расписание ключа защиты строится один раз, а ключи
+	зашифровываются парами с совмещением тактов.
+*/
+err_t beltKWPWrapBatch(
+	octet dest[],			/*!< [out] защищенные ключи */
+	const octet src[],		/*!< [in] защищаемые ключи */
+	size_t count,			/*!< [in] длина защищаемого ключа в октетах */
+	size_t num,				/*!< [in] число ключей */
+	const octet headers[],	/*!< [in] заголовки ключей */
+	const octet key[],		/*!< [in] ключ защиты */
+	size_t len,				/*!< [in] длина key в октетах */
+	size_t threads			/*!< [in] число потоков */
+);
+
 /*
 *******************************************************************************
 Хэширование (belt-hash, Hash)
@@ -1497,6 +1590,74 @@ err_t beltFMTDecr(
 	const octet iv[16]		/*!< [in] синхропосылка */
 );
 
+/*!	\brief Пакетное зашифрование в режиме FMT
+
+	Строки [count]src, [count](src + count),..., [count](src + (num - 1)
+	* count) в алфавите {0, 1,..., mod - 1} зашифровываются на ключе
+	[len]key и синхропосылках [16]iv, [16](iv + 16),... Результаты
+	зашифрования размещаются в буфере [num * count]dest в том же порядке.
+	При нулевом указателе iv для всех строк используется нулевая
+	синхропосылка. Строки обрабатываются в threads потоках.
+	\expect{ERR_BAD_INPUT}
+	- 2 <= mod && mod <= 65536;
+	- 2 <= count;
+	- len == 16 || len == 24 || len == 32;
+	- если iv ненулевой, то буферы [16 * num]iv и [num * count]dest
+	  не пересекаются.
+	.
+	\expect{ERR_NOT_IMPLEMENTED} count <= 600.
+	\expect Символы src принадлежат алфавиту {0, 1,..., mod - 1}.
+	\return ERR_OK, если зашифрование успешно выполнено, и код ошибки в 
+	противном случае.
+	\remark Результат совпадает с результатом num обращений к beltFMTEncr().
+	\remark Буферы src и dest могут пересекаться.
+*/
+err_t beltFMTEncrBatch(
+	u16 dest[],				/*!< [out] шифртексты */
+	u32 mod,				/*!< [in] размер алфавита */
+	const u16 src[],		/*!< [in] открытые тексты */
+	size_t count,			/*!< [in] длина открытого текста / шифртекста */
+	size_t num,				/*!< [in] число текстов */
+	const octet key[],		/*!< [in] ключ */
+	size_t len,				/*!< [in] длина key в октетах */
+	const octet iv[],		/*!< [in] синхропосылки */
+	size_t threads			/*!< [in] число потоков */
+);
+
+/*!	\brief Пакетное расшифрование в режиме FMT
+
+	Строки [count]src, [count](src + count),..., [count](src + (num - 1)
+	* count) в алфавите {0, 1,..., mod - 1} расшифровываются на ключе
+	[len]key и синхропосылках [16]iv, [16](iv + 16),... Результаты
+	расшифрования размещаются в буфере [num * count]dest в том же порядке.
+	При нулевом указателе iv для всех строк используется нулевая
+	синхропосылка. Строки обрабатываются в threads потоках.
+	\expect{ERR_BAD_INPUT}
+	- 2 <= mod && mod <= 65536;
+	- 2 <= count;
+	- len == 16 || len == 24 || len == 32;
+	- если iv ненулевой, то буферы [16 * num]iv и [num * count]dest
+	  не пересекаются.
+	.
+	\expect{ERR_NOT_IMPLEMENTED} count <= 600.
+	\expect Символы src принадлежат алфавиту {0, 1,..., mod - 1}.
+	\return ERR_OK, если расшифрование успешно выполнено, и код ошибки в 
+	противном случае.
+	\remark Результат совпадает с результатом num обращений к beltFMTDecr().
+	\remark Буферы src и dest могут пересекаться.
+*/
+err_t beltFMTDecrBatch(
+	u16 dest[],				/*!< [out] открытые тексты */
+	u32 mod,				/*!< [in] размер алфавита */
+	const u16 src[],		/*!< [in] шифртексты */
+	size_t count,			/*!< [in] длина шифртекста / открытого текста */
+	size_t num,				/*!< [in] число текстов */
+	const octet key[],		/*!< [in] ключ */
+	size_t len,				/*!< [in] длина key в октетах */
+	const octet iv[],		/*!< [in] синхропосылки */
+	size_t threads			/*!< [in] число потоков */
+);
+
 /*
 *******************************************************************************
 Преобразование ключа (belt-keyrep, KRP)
@@ -1561,6 +1722,34 @@ err_t beltKRP(
 	const octet header[16]		/*!< [in] заголовок ключа dest */
 );
 
+/*!	\brief Пакетное преобразование ключа
+
+	По ключу [n]src строятся ключи [m]dest, [m](dest + m),...,
+	[m](dest + (num - 1) * m). Ключ с номером i строится так, как если бы
+	ключ src имел уровень [12](levels + 12 * i), а ключ dest -- заголовок
+	[16](headers + 16 * i). Ключи строятся в threads потоках.
+	\expect{ERR_BAD_INPUT}
+	-	n == 16 || n == 24 || n == 32;
+	-	m == 16 || m == 24 || m == 32;
+	-	m <= n.
+	.
+	\return ERR_OK, если преобразование успешно завершено, и код ошибки
+	в противном случае.
+	\remark Результат совпадает с результатом num обращений к beltKRP().
+	Ключи строятся парами с совмещением тактов belt-compr.
+	\remark Буфер src может пересекаться с другими буферами.
+*/
+err_t beltKRPBatch(
+	octet dest[],				/*!< [out] преобразованные ключи */
+	size_t m,					/*!< [in] длина ключа dest в октетах */
+	const octet src[],			/*!< [in] исходный ключ */
+	size_t n,					/*!< [in] длина src в октетах */
+	const octet levels[],		/*!< [in] уровни ключа src */
+	const octet headers[],		/*!< [in] заголовки ключей dest */
+	size_t num,					/*!< [in] число ключей */
+	size_t threads				/*!< [in] число потоков */
+);
+
 /*
 *******************************************************************************
 Ключезавимое хэширование (hmac-hbelt, HMAC, алгоритм 6.1.4 СТБ 34.101.47)
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2018.07.04
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include "bee2/defs.h"
+#include "bee2/core/tm.h"
 
 /*!
 *******************************************************************************
@@ -96,11 +97,43 @@ err_t bignStdParams(
 	\return ERR_OK, если параметры корректны, и код ошибки
 	в противном случае.
 	\remark Реализован алгоритм 6.1.4.
+	\remark Вызов эквивалентен bignValParams2(params, 1, 0).
 */
 err_t bignValParams(
 	const bign_params* params	/*!< [in] долговременные параметры */
 );
 
+/*!	\brief Число проверок параметров */
+#define BIGN_VAL_CHECKS 4
+
+/*!	\brief Проверка долговременных параметров в нескольких потоках
+
+	Проверяется корректность долговременных параметров params. Проверка
+	разбивается на BIGN_VAL_CHECKS независимых проверок, которые
+	выполняются threads потоками:
+	-	0: пересчет b по затравочному значению seed, b != 0;
+	-	1: простота p, невырожденность кривой;
+	-	2: простота q, q != p, MOV-условие;
+	-	3: (b / p) = 1, G = (0, b^{(p + 1) / 4}), qG = O.
+	.
+	Если ticks != 0, то в ticks[i] возвращается продолжительность
+	проверки i в тактах таймера (см. tmTicks()). Для невыполненных
+	проверок возвращается 0.
+	\return ERR_OK, если параметры корректны, и код ошибки
+	в противном случае.
+	\remark Если кэш проверенных параметров создан (см. vcache.h)
+	и содержит params, то проверки не выполняются и возвращается ERR_OK.
+	Параметры, которые прошли проверку, добавляются в кэш.
+	\remark Значения threads == 0 и threads == 1 равносильны: проверки
+	выполняются в вызывающем потоке. Поток прекращает работу после первой
+	неудачной проверки.
+*/
+err_t bignValParams2(
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	size_t threads,				/*!< [in] число потоков */
+	tm_ticks_t ticks[BIGN_VAL_CHECKS]	/*!< [out] продолжительность */
+);
+
 /*!
 *******************************************************************************
 \file bign.h
@@ -138,6 +171,56 @@ err_t bignOidToDER(
 	const char* oid		/*!< [in] строковое представление идентификатора */
 );
 
+/*
+*******************************************************************************
+Таблицы предвычислений
+*******************************************************************************
+*/
+
+/*!	\brief Создание образа таблицы предвычислений
+
+	При долговременных параметрах params строится образ [?count]tbl таблицы 
+	кратных базовой точки. Образ используется функциями 
+	bignGenKeypairBatch2() и bignKeyWrapBatch2() вместо построения таблицы 
+	при каждом вызове.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если образ успешно построен или его длина успешно 
+	рассчитана, и код ошибки в противном случае.
+	\remark Образ не содержит указателей. Его можно сохранить в файле, 
+	а затем отобразить в память (например, с помощью 
+	mmap(PROT_READ, MAP_SHARED)) и использовать в нескольких процессах. 
+	Образ зависит от параметров, разрядности машинного слова 
+	и порядка октетов в слове. Эти данные записываются в заголовок образа.
+	\remark Образ содержит тег (хэш-значение bash256). Тег не защищает 
+	от намеренной подмены образа и служит только для обнаружения 
+	случайных искажений.
+*/
+err_t bignTblCreate(
+	octet tbl[],				/*!< [out] образ таблицы */
+	size_t* count,				/*!< [in/out] длина буфера tbl / длина образа */
+	const bign_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Проверка образа таблицы предвычислений
+
+	Проверяется, что образ [count]tbl построен функцией bignTblCreate() 
+	при долговременных параметрах params на платформе с той же разрядностью 
+	машинного слова и тем же порядком октетов, что образ не изменялся 
+	и что все точки таблицы лежат на кривой.
+	\return ERR_OK, если образ корректен, и код ошибки в противном случае.
+	\remark Возвращается ERR_BAD_FORMAT, если нарушен формат образа, 
+	ERR_BAD_PARAMS, если образ построен для других параметров, 
+	ERR_BAD_HASH, если не совпадает тег, и ERR_BAD_POINT, если 
+	некорректна одна из точек таблицы.
+	\remark Такая же проверка выполняется в функциях, которые принимают 
+	образ. Она занимает малую долю времени построения таблицы.
+*/
+err_t bignTblVal(
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet tbl[],			/*!< [in] образ таблицы */
+	size_t count				/*!< [in] длина образа */
+);
+
 /*
 *******************************************************************************
 Управление ключами
@@ -164,6 +247,62 @@ err_t bignGenKeypair(
 	void* rng_state				/*!< [in/out] состояние генератора */
 );
 
+/*!	\brief Пакетная генерация пар ключей
+
+	При долговременных параметрах params генерируются count пар ключей: 
+	личные [l / 4]privkeys[i] и открытые [l / 2]pubkeys[i] ключи, 
+	i = 0, 1,..., count - 1. Ключи размещаются в privkeys и pubkeys 
+	последовательно. При генерации используется генератор rng и его 
+	состояние rng_state. В codes[i] возвращается код генерации i-й пары.
+	Открытые ключи вычисляются threads потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если все пары ключей успешно сгенерированы, и код ошибки
+	первой неудачной пары (или общий код ошибки) в противном случае.
+	\remark Генератор rng вызывается только в вызывающем потоке. 
+	Последовательность личных ключей совпадает с той, которая получается 
+	при count вызовах bignGenKeypair() с теми же rng и rng_state.
+	\remark Пары с codes[i] != ERR_OK не определяются.
+	\remark Значения threads == 0 и threads == 1 равносильны: вычисления 
+	выполняются в вызывающем потоке.
+*/
+err_t bignGenKeypairBatch(
+	octet privkeys[],			/*!< [out] личные ключи */
+	octet pubkeys[],			/*!< [out] открытые ключи */
+	err_t codes[],				/*!< [out] коды генерации */
+	size_t count,				/*!< [in] число пар ключей */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	size_t threads				/*!< [in] число потоков */
+);
+
+/*!	\brief Пакетная генерация пар ключей по образу таблицы
+
+	Выполняются те же действия, что и в функции bignGenKeypairBatch(). 
+	Если tbl != 0, то вместо построения таблицы кратных базовой точки 
+	используется ее образ, созданный функцией bignTblCreate(). 
+	Если tbl == 0, то таблица строится.
+	\expect{ERR_BAD_INPUT} Образ tbl выровнен на границу машинного слова.
+	\return ERR_OK, если все пары ключей успешно сгенерированы, и код ошибки
+	первой неудачной пары (или общий код ошибки) в противном случае.
+	\remark Образ проверяется так же, как в функции bignTblVal(). 
+	Если образ некорректен, то ключи не генерируются и возвращается 
+	код ошибки bignTblVal().
+*/
+err_t bignGenKeypairBatch2(
+	octet privkeys[],			/*!< [out] личные ключи */
+	octet pubkeys[],			/*!< [out] открытые ключи */
+	err_t codes[],				/*!< [out] коды генерации */
+	size_t count,				/*!< [in] число пар ключей */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet tbl[],			/*!< [in] образ таблицы (или 0) */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	size_t threads				/*!< [in] число потоков */
+);
+
 /*!	\brief Проверка открытого ключа
 
 	При долговременных параметрах params проверяется корректность 
@@ -177,6 +316,94 @@ err_t bignValPubkey(
 	const octet pubkey[]		/*!< [in] проверяемый ключ */
 );
 
+/*!	\brief Пакетная проверка открытых ключей
+
+	При долговременных параметрах params проверяется корректность
+	открытых ключей [l / 2]pubkeys[i], i = 0, 1,..., count - 1, которые
+	размещены в pubkeys последовательно. В codes[i] возвращается код
+	проверки i-го ключа. Проверки выполняются threads потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если все ключи корректны, и код ошибки первого
+	некорректного ключа (или общий код ошибки) в противном случае.
+	\remark Значение codes[i] совпадает с результатом
+	bignValPubkey(params, pubkeys + i * l / 2).
+	\remark Значения threads == 0 и threads == 1 равносильны: проверки
+	выполняются в вызывающем потоке.
+*/
+err_t bignValPubkeyBatch(
+	err_t codes[],				/*!< [out] коды проверки */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet pubkeys[],		/*!< [in] проверяемые ключи */
+	size_t count,				/*!< [in] число ключей */
+	size_t threads				/*!< [in] число потоков */
+);
+
+/*!	\brief Сжатие открытого ключа
+
+	При долговременных параметрах params открытый ключ [l / 2]pubkey 
+	сжимается в ключ [l / 4 + 1]xpubkey. Первые l / 4 октетов xpubkey 
+	совпадают с x-координатой ключа (первой половиной pubkey), последний 
+	октет равен младшему разряду y-координаты (0 или 1).
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если ключ сжат, и код ошибки в противном случае.
+	\remark Проверяется, что pubkey является точкой кривой 
+	(см. bignValPubkey()).
+	\remark Буферы pubkey и xpubkey могут пересекаться.
+*/
+err_t bignCompressPubkey(
+	octet xpubkey[],			/*!< [out] сжатый ключ */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet pubkey[]		/*!< [in] открытый ключ */
+);
+
+/*!	\brief Восстановление открытого ключа
+
+	При долговременных параметрах params открытый ключ [l / 2]pubkey 
+	восстанавливается по сжатому ключу [l / 4 + 1]xpubkey 
+	(см. bignCompressPubkey()).
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если ключ восстановлен, и код ошибки в противном 
+	случае.
+	\remark Код ERR_OK гарантирует, что восстановленный ключ корректен 
+	(см. bignValPubkey()).
+	\remark y-координата определяется как квадратный корень 
+	из x^3 + a x + b по модулю p \equiv 3 \mod 4 возведением в степень 
+	(p + 1) / 4. Для стандартных модулей p = 2^{2l} - c возведение выполняется
+	по специальной аддитивной цепочке.
+	\remark Буферы pubkey и xpubkey могут пересекаться.
+*/
+err_t bignDecompressPubkey(
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet xpubkey[]		/*!< [in] сжатый ключ */
+);
+
+/*!	\brief Пакетное восстановление открытых ключей
+
+	При долговременных параметрах params открытые ключи [l / 2]pubkeys[i] 
+	восстанавливаются по сжатым ключам [l / 4 + 1]xpubkeys[i], 
+	i = 0, 1,..., count - 1. Ключи размещаются в pubkeys и xpubkeys 
+	последовательно. В codes[i] возвращается код восстановления i-го 
+	ключа. Ключи восстанавливаются threads потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если все ключи восстановлены, и код ошибки первого 
+	невосстановленного ключа (или общий код ошибки) в противном случае.
+	\remark Значение codes[i] совпадает с результатом 
+	bignDecompressPubkey(). При codes[i] != ERR_OK ключ pubkeys[i] 
+	обнуляется.
+	\remark Значения threads == 0 и threads == 1 равносильны: вычисления 
+	выполняются в вызывающем потоке.
+	\pre Буферы pubkeys и xpubkeys не пересекаются.
+*/
+err_t bignDecompressPubkeyBatch(
+	octet pubkeys[],			/*!< [out] открытые ключи */
+	err_t codes[],				/*!< [out] коды восстановления */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet xpubkeys[],		/*!< [in] сжатые ключи */
+	size_t count,				/*!< [in] число ключей */
+	size_t threads				/*!< [in] число потоков */
+);
+
 /*!	\brief Построение открытого ключа по личному
 
 	При долговременных параметрах params по личному ключу [l / 4]privkey 
@@ -213,6 +440,30 @@ err_t bignDH(
 	size_t key_len				/*!< [in] длина key в октетах */
 );
 
+/*!	\brief Построение общего ключа протокола Диффи -- Хеллмана:
+	лесенка Монтгомери
+
+	Общий ключ [key_len]key строится так же, как в функции bignDH(), 
+	но privkey-кратное ключа pubkey определяется с помощью лесенки 
+	Монтгомери (функция ecpMulLadderA()).
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\expect{ERR_BAD_PUBKEY} Открытый ключ pubkey корректен.
+	\expect{ERR_BAD_SHAREKEY} key_len <= l / 2.
+	\return ERR_OK, если общий ключ успешно построен, и код ошибки
+	в противном случае.
+	\remark Функция работает медленнее bignDH(), но время ее выполнения 
+	не зависит от privkey. Дополнительная память под таблицу кратных 
+	точек не требуется.
+*/
+err_t bignDHLadder(
+	octet key[],				/*!< [out] общий ключ */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet privkey[],		/*!< [in] личный ключ */
+	const octet pubkey[],		/*!< [in] открытый ключ (другой стороны) */
+	size_t key_len				/*!< [in] длина key в октетах */
+);
+
 /*
 *******************************************************************************
 Электронная цифровая подпись (ЭЦП)
@@ -354,6 +605,106 @@ err_t bignKeyUnwrap(
 	const octet privkey[]		/*!< [in] личный ключ получателя */
 );
 
+/*!	\brief Пакетное создание токенов ключей
+
+	Создаются токены tokens[i] ключей keys[i] для получателей с открытыми 
+	ключами [l / 2]pubkeys[i], i = 0, 1,..., count - 1. Если 
+	keys_count == 1, то всем получателям транспортируется один ключ 
+	[len]keys. Если keys_count == count, то i-му получателю транспортируется 
+	ключ [len]keys[i]. Все ключи имеют заголовок [16]header. Ключи 
+	keys[i], открытые ключи pubkeys[i] и токены 
+	[l / 4 + 16 + len]tokens[i] размещаются в соответствующих массивах 
+	последовательно. При создании токенов используются долговременные 
+	параметры params и генератор rng с состоянием rng_state. В codes[i] 
+	возвращается код создания i-го токена. Вычисления выполняются threads 
+	потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_INPUT} len >= 16.
+	\expect{ERR_BAD_INPUT} keys_count == 1 || keys_count == count.
+	\expect{ERR_BAD_INPUT} Буфер tokens не пересекается с буферами keys,
+	header и pubkeys.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если все токены успешно созданы, и код ошибки первого 
+	неудачного токена (или общий код ошибки) в противном случае.
+	\remark Каждый токен создается по алгоритму 7.2.3 со своим одноразовым 
+	личным ключом, как при вызове bignKeyWrap(). Генератор rng вызывается 
+	только в вызывающем потоке.
+	\remark Токены с codes[i] != ERR_OK обнуляются.
+	\remark Может передаваться нулевой указатель header. В этом случае будет
+	использоваться заголовок из всех нулей.
+*/
+err_t bignKeyWrapBatch(
+	octet tokens[],				/*!< [out] токены ключей */
+	err_t codes[],				/*!< [out] коды создания */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet keys[],			/*!< [in] транспортируемые ключи */
+	size_t keys_count,			/*!< [in] число ключей (1 или count) */
+	size_t len,					/*!< [in] длина ключа в октетах */
+	const octet header[16],		/*!< [in] заголовок ключей */
+	const octet pubkeys[],		/*!< [in] открытые ключи получателей */
+	size_t count,				/*!< [in] число получателей */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	size_t threads				/*!< [in] число потоков */
+);
+
+/*!	\brief Пакетное создание токенов ключа по образу таблицы
+
+	Выполняются те же действия, что и в функции bignKeyWrapBatch(). 
+	Образ tbl используется так же, как в функции bignGenKeypairBatch2().
+	\return ERR_OK, если все токены успешно созданы, и код ошибки первого 
+	неудачного токена (или общий код ошибки) в противном случае.
+*/
+err_t bignKeyWrapBatch2(
+	octet tokens[],				/*!< [out] токены ключей */
+	err_t codes[],				/*!< [out] коды создания */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet tbl[],			/*!< [in] образ таблицы (или 0) */
+	const octet keys[],			/*!< [in] транспортируемые ключи */
+	size_t keys_count,			/*!< [in] число ключей (1 или count) */
+	size_t len,					/*!< [in] длина ключа в октетах */
+	const octet header[16],		/*!< [in] заголовок ключей */
+	const octet pubkeys[],		/*!< [in] открытые ключи получателей */
+	size_t count,				/*!< [in] число получателей */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	size_t threads				/*!< [in] число потоков */
+);
+
+/*!	\brief Пакетный разбор токенов ключей
+
+	Определяются ключи [len - (l / 4 + 16)]keys[i], которые имеют заголовок 
+	[16]header и содержатся в токенах [len]tokens[i], 
+	i = 0, 1,..., count - 1. Токены и ключи размещаются в массивах tokens 
+	и keys последовательно. При разборе токенов используются 
+	долговременные параметры params и личный ключ [l / 2]privkey. В codes[i] 
+	возвращается код разбора i-го токена (такой же, как у bignKeyUnwrap()).
+	Вычисления выполняются threads потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\expect{ERR_BAD_INPUT} Буферы keys и tokens не пересекаются.
+	\return ERR_OK, если все токены успешно разобраны, и код ошибки первого 
+	неудачного токена (или общий код ошибки) в противном случае.
+	\remark Функция предназначена для серверов, которые принимают 
+	много токенов на одном личном ключе. Описание кривой строится один раз, 
+	переход к аффинным координатам выполняется с одним обращением в базовом 
+	поле на порцию токенов.
+	\remark Ключи, соответствующие токенам с codes[i] != ERR_OK, обнуляются.
+	\remark Если len < 32 + l / 4, то возвращается код ERR_BAD_KEYTOKEN.
+*/
+err_t bignKeyUnwrapBatch(
+	octet keys[],				/*!< [out] ключи */
+	err_t codes[],				/*!< [out] коды разбора */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet tokens[],		/*!< [in] токены ключей */
+	size_t len,					/*!< [in] длина токена в октетах */
+	size_t count,				/*!< [in] число токенов */
+	const octet header[16],		/*!< [in] заголовок ключей */
+	const octet privkey[],		/*!< [in] личный ключ получателя */
+	size_t threads				/*!< [in] число потоков */
+);
+
 /*!
 *******************************************************************************
 \file bign.h
@@ -394,6 +745,47 @@ err_t bignIdExtract(
 	octet pubkey[]				/*!< [in] открытый ключ доверенной стороны */
 );
 
+/*!	\brief Пакетное извлечение пар ключей
+
+	Из подписей [3 * l / 8]sigs[i] идентификаторов с хэш-значениями
+	[l / 4]id_hashes[i] извлекаются личные [l / 4]id_privkeys[i] и открытые
+	[l / 2]id_pubkeys[i] ключи, i = 0, 1,..., count - 1. Элементы массивов
+	размещаются последовательно. Используются долговременные параметры
+	params и открытый ключ [l / 2]pubkey доверенной стороны. Хэш-значения
+	получены с помощью алгоритма с идентификатором [oid_len]oid_der.
+	В codes[i] возвращается код извлечения i-й пары (такой же, как
+	у bignIdExtract()). Вычисления выполняются threads потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_OID} Идентификатор oid_der корректен.
+	\expect{ERR_BAD_PUBKEY} Открытый ключ pubkey корректен.
+	\expect{ERR_BAD_INPUT} Буферы id_privkeys и id_pubkeys не пересекаются.
+	\return ERR_OK, если все пары успешно извлечены, и код ошибки первой
+	неудачной пары (или общий код ошибки) в противном случае.
+	\remark Функция предназначена для доверенной стороны, которая выдает
+	ключи многим абонентам. Описание кривой и таблицы кратных точек строятся
+	один раз, переход к аффинным координатам выполняется с одним обращением
+	в базовом поле на порцию подписей.
+	\remark В отличие от bignIdExtract() проверяется, что pubkey лежит
+	на кривой.
+	\remark Ключи, соответствующие подписям с codes[i] != ERR_OK,
+	обнуляются.
+	\remark Значения threads == 0 и threads == 1 равносильны: вычисления
+	выполняются в вызывающем потоке.
+*/
+err_t bignIdExtractBatch(
+	octet id_privkeys[],		/*!< [out] личные ключи */
+	octet id_pubkeys[],			/*!< [out] открытые ключи */
+	err_t codes[],				/*!< [out] коды извлечения */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	const octet id_hashes[],	/*!< [in] хэш-значения идентификаторов */
+	const octet sigs[],			/*!< [in] подписи идентификаторов */
+	const octet pubkey[],		/*!< [in] открытый ключ доверенной стороны */
+	size_t count,				/*!< [in] число пар */
+	size_t threads				/*!< [in] число потоков */
+);
+
 /*!	\brief Выработка идентификационной ЭЦП
 
 	Вырабатывается идентификационная подпись [3 * l / 8]id_sig сообщения с 
@@ -487,6 +879,44 @@ err_t bignIdVerify(
 	const octet pubkey[]		/*!< [in] открытый ключ доверенной стороны */
 );
 
+/*!	\brief Пакетная проверка идентификационной ЭЦП
+
+	Проверяются идентификационные ЭЦП [3 * l / 8]id_sigs[i] сообщений
+	с хэш-значениями [l / 4]hashes[i], выработанные сторонами с открытыми
+	ключами [l / 2]id_pubkeys[i] и хэш-значениями идентификаторов
+	[l / 4]id_hashes[i], i = 0, 1,..., count - 1. Элементы массивов
+	размещаются последовательно. При проверке используются долговременные
+	параметры params и открытый ключ доверенной стороны [l / 2]pubkey.
+	Хэш-значения получены с помощью алгоритма с идентификатором
+	[oid_len]oid_der. В codes[i] возвращается код проверки i-й подписи
+	(такой же, как у bignIdVerify()). Проверки выполняются threads потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_OID} Идентификатор oid_der корректен.
+	\expect{ERR_BAD_PUBKEY} Открытый ключ pubkey корректен.
+	\return ERR_OK, если все подписи корректны, и код ошибки первой
+	некорректной подписи (или общий код ошибки) в противном случае.
+	\remark Описание кривой и таблицы кратных точек строятся один раз,
+	переход к аффинным координатам выполняется с одним обращением
+	в базовом поле на порцию подписей.
+	\remark В отличие от bignIdVerify() проверяется, что pubkey лежит
+	на кривой.
+	\remark Значения threads == 0 и threads == 1 равносильны: проверки
+	выполняются в вызывающем потоке.
+*/
+err_t bignIdVerifyBatch(
+	err_t codes[],				/*!< [out] коды проверки */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	const octet id_hashes[],	/*!< [in] хэш-значения идентификаторов */
+	const octet hashes[],		/*!< [in] хэш-значения сообщений */
+	const octet id_sigs[],		/*!< [in] подписи */
+	const octet id_pubkeys[],	/*!< [in] открытые ключи */
+	const octet pubkey[],		/*!< [in] открытый ключ доверенной стороны */
+	size_t count,				/*!< [in] число подписей */
+	size_t threads				/*!< [in] число потоков */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,236 @@
+/*
+*******************************************************************************
+\file bmt.h
+\brief Merkle tree hashing over belt-hash and bash
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+/*!
+*******************************************************************************
+\file bmt.h
+\brief Древовидное хэширование
+*******************************************************************************
+*/
+
+#ifndef __BEE2_BMT_H
+#define __BEE2_BMT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bee2/defs.h"
+
+/*!
+*******************************************************************************
+\file bmt.h
+
+\section bmt-common Общие положения
+
+Реализовано древовидное хэширование (хэширование по Мерклу) на основе
+алгоритма belt-hash (СТБ 34.101.31) или алгоритмов bash (СТБ 34.101.77).
+Древовидное хэширование позволяет обрабатывать фрагменты одного большого
+файла параллельно, а также проверять отдельный фрагмент, не обрабатывая
+файл целиком.
+
+Используемый алгоритм хэширования h задается уровнем стойкости l:
+l == 0 -- belt-hash, l > 0 -- bash уровня l. Длина хэш-значений h
+(и результата древовидного хэширования) составляет 32 октета для belt-hash
+и l / 4 октетов для bash.
+
+Хэшируемые данные X разбиваются на листья -- последовательные фрагменты
+из leaf_size октетов. Последний лист может быть короче, в том числе пустым
+(если X пусто). Хэш-значением листа L является h(00 || L).
+
+Над листьями строится дерево с фиксированной степенью ветвления
+BMT_ARITY. Последовательность хэш-значений одного уровня разбивается
+на группы из BMT_ARITY элементов (последняя группа может быть короче).
+Группа c_1, c_2,..., c_k заменяется хэш-значением узла h(01 || c_1 || ...
+|| c_k). Уровни строятся до тех пор, пока не останется одно хэш-значение
+t (вершина). Результатом хэширования является
+	h(02 || <leaf_size>_64 || <|X|>_64 || t),
+где <u>_64 -- 8-октетное представление u по правилам little-endian.
+
+Префиксы 00, 01, 02 разделяют области применения h (domain separation):
+хэш-значение листа невозможно выдать за хэш-значение узла и наоборот.
+Длина листа и длина X входят в результат хэширования, поэтому деревья
+с различной нарезкой на листья не дают совпадающих результатов.
+
+Древовидное хэширование реализуется связкой функций bmtHashStart(),
+bmtHashStepH(), bmtHashStepG(), bmtHashStepV(). Функции связки используют
+общее состояние, память для которого готовит вызывающая программа. Данные
+обрабатываются инкрементально, в памяти состояния хранятся только
+незавершенные узлы (по одному на уровень). Если в bmtHashStart() передано
+число потоков threads > 1, то полные листья, которые целиком входят
+в обрабатываемый фрагмент данных, хэшируются параллельно. Результат
+хэширования не зависит от числа потоков и от разбиения данных на
+фрагменты.
+
+Связка покрывается высокоуровневой функцией bmtHash(). Функции bmtProve(),
+bmtVerify() позволяют построить и проверить доказательство принадлежности
+отдельного листа дереву.
+
+\expect{ERR_BAD_INPUT} Все входные указатели высокоуровневых функций
+действительны.
+
+\pre Все входные указатели низкоуровневых функций действительны.
+
+\pre Если не оговорено противное, то входные буферы функций не
+пересекаются.
+*******************************************************************************
+*/
+
+/*!	\brief Степень ветвления дерева */
+#define BMT_ARITY 2
+
+/*!	\brief Длина состояния функций древовидного хэширования
+
+	Возвращается длина состояния (в октетах) функций древовидного
+	хэширования.
+	\return Длина состояния.
+*/
+size_t bmtHash_keep();
+
+/*!	\brief Инициализация древовидного хэширования
+
+	В state формируются структуры данных, необходимые для древовидного
+	хэширования на основе алгоритма уровня стойкости l с длиной листа
+	leaf_size. Полные листья обрабатываются в threads потоках.
+	\pre l == 0 || l % 16 == 0 && l <= 256.
+	\pre leaf_size > 0.
+	\pre По адресу state зарезервировано bmtHash_keep() октетов.
+	\remark При threads <= 1 дополнительные потоки не создаются.
+*/
+void bmtHashStart(
+	void* state,		/*!< [out] состояние */
+	size_t l,			/*!< [in] уровень стойкости (0 -- belt-hash) */
+	size_t leaf_size,	/*!< [in] длина листа */
+	size_t threads		/*!< [in] число потоков */
+);
+
+/*!	\brief Древовидное хэширование фрагмента данных
+
+	Текущее состояние state древовидного хэширования пересчитывается
+	с учетом нового фрагмента данных [count]buf.
+	\expect bmtHashStart() < bmtHashStepH()*.
+	\remark Если создать потоки или выделить память для хэш-значений
+	листьев не удается, то листья хэшируются последовательно.
+*/
+void bmtHashStepH(
+	const void* buf,	/*!< [in] данные */
+	size_t count,		/*!< [in] число октетов данных */
+	void* state			/*!< [in/out] состояние */
+);
+
+/*!	\brief Определение результата древовидного хэширования
+
+	Определяется результат hash древовидного хэширования всех данных,
+	обработанных до этого функцией bmtHashStepH(). Длина hash составляет
+	32 октета (l == 0) или l / 4 октетов (l > 0), где l -- уровень
+	стойкости, ранее переданный в bmtHashStart().
+	\expect bmtHashStepH()* < bmtHashStepG().
+	\remark Функция завершает незавершенные узлы дерева. Продолжение
+	хэширования после ее вызова не допускается.
+*/
+void bmtHashStepG(
+	octet hash[],		/*!< [out] результат хэширования */
+	void* state			/*!< [in/out] состояние */
+);
+
+/*!	\brief Проверка результата древовидного хэширования
+
+	Проверяется, что результат древовидного хэширования всех данных,
+	обработанных до этого функцией bmtHashStepH(), совпадает с hash.
+	\expect bmtHashStepH()* < bmtHashStepV().
+	\return Признак успеха.
+	\remark Продолжение хэширования после вызова функции не допускается.
+*/
+bool_t bmtHashStepV(
+	const octet hash[],	/*!< [in] контрольный результат хэширования */
+	void* state			/*!< [in/out] состояние */
+);
+
+/*!	\brief Древовидное хэширование
+
+	Определяется результат hash древовидного хэширования буфера [count]src
+	на основе алгоритма уровня стойкости l с длиной листа leaf_size.
+	Листья обрабатываются в threads потоках.
+	\expect{ERR_BAD_PARAMS} l == 0 || l % 16 == 0 && l <= 256.
+	\expect{ERR_BAD_PARAMS} leaf_size > 0.
+	\return ERR_OK, если хэширование завершено успешно, и код ошибки
+	в противном случае.
+	\remark Буферы могут пересекаться.
+*/
+err_t bmtHash(
+	octet hash[],		/*!< [out] результат хэширования */
+	size_t l,			/*!< [in] уровень стойкости (0 -- belt-hash) */
+	size_t leaf_size,	/*!< [in] длина листа */
+	const void* src,	/*!< [in] данные */
+	size_t count,		/*!< [in] число октетов данных */
+	size_t threads		/*!< [in] число потоков */
+);
+
+/*!	\brief Построение доказательства принадлежности листа
+
+	Для листа с номером index дерева, построенного над буфером [count]src
+	(см. bmtHash()), строится доказательство [proof_len]proof его
+	принадлежности дереву. Доказательство состоит из хэш-значений соседей
+	(других элементов группы) листа и его предков, которые перечисляются
+	по уровням снизу вверх, на каждом уровне -- слева направо.
+	Листья обрабатываются в threads потоках.
+	\expect{ERR_BAD_PARAMS} l == 0 || l % 16 == 0 && l <= 256.
+	\expect{ERR_BAD_PARAMS} leaf_size > 0.
+	\expect{ERR_BAD_INPUT} index меньше числа листьев.
+	\return ERR_OK, если доказательство построено, и код ошибки
+	в противном случае.
+	\remark Если proof == 0, то определяется только длина доказательства.
+	\remark Длина доказательства зависит только от count, leaf_size, index
+	и длины хэш-значений.
+*/
+err_t bmtProve(
+	octet proof[],		/*!< [out] доказательство */
+	size_t* proof_len,	/*!< [out] длина доказательства */
+	size_t l,			/*!< [in] уровень стойкости (0 -- belt-hash) */
+	size_t leaf_size,	/*!< [in] длина листа */
+	const void* src,	/*!< [in] данные */
+	size_t count,		/*!< [in] число октетов данных */
+	size_t index,		/*!< [in] номер листа */
+	size_t threads		/*!< [in] число потоков */
+);
+
+/*!	\brief Проверка доказательства принадлежности листа
+
+	Проверяется, что [leaf_len]leaf является листом с номером index
+	дерева, построенного над данными длины count, результат хэширования
+	которых равняется hash. Проверка выполняется с помощью доказательства
+	[proof_len]proof, построенного функцией bmtProve().
+	\expect{ERR_BAD_PARAMS} l == 0 || l % 16 == 0 && l <= 256.
+	\expect{ERR_BAD_PARAMS} leaf_size > 0.
+	\expect{ERR_BAD_INPUT} index меньше числа листьев.
+	\return ERR_OK, если лист принадлежит дереву, ERR_BAD_HASH, если не
+	принадлежит (в том числе если leaf_len или proof_len не соответствуют
+	index и count), и другой код ошибки в остальных случаях.
+*/
+err_t bmtVerify(
+	const octet hash[],	/*!< [in] результат хэширования */
+	size_t l,			/*!< [in] уровень стойкости (0 -- belt-hash) */
+	size_t leaf_size,	/*!< [in] длина листа */
+	size_t count,		/*!< [in] длина хэшируемых данных */
+	size_t index,		/*!< [in] номер листа */
+	const void* leaf,	/*!< [in] лист */
+	size_t leaf_len,	/*!< [in] длина листа */
+	const octet proof[],/*!< [in] доказательство */
+	size_t proof_len	/*!< [in] длина доказательства */
+);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __BEE2_BMT_H */
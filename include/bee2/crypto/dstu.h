@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2017.01.11
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -22,6 +22,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #define __BEE2_DSTU_H
 
 #include "bee2/defs.h"
+#include "bee2/core/tm.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -127,11 +128,39 @@ err_t dstuStdParams(
 	\return ERR_OK, если параметры корректны, и код ошибки в противном
 	случае.
 	\remark Проверяется корректность в том числе и базовой точки P.
+	\remark Вызов эквивалентен dstuValParams2(params, 1, 0).
 */
 err_t dstuValParams(
 	const dstu_params* params	/*!< [in] параметры */
 );
 
+/*!	\brief Число проверок параметров */
+#define DSTU_VAL_CHECKS 4
+
+/*!	\brief Проверка долговременных параметров в нескольких потоках
+
+	Проверяется корректность долговременных параметров params. Проверка
+	разбивается на DSTU_VAL_CHECKS независимых проверок, которые
+	выполняются threads потоками:
+	-	0: order > 2^160, корректность поля и кривой (B != 0);
+	-	1: граница Хассе, базовая точка лежит на кривой;
+	-	2: order -- простое, условие Семаева, MOV-условие с порогом 32;
+	-	3: базовая точка имеет порядок order.
+	.
+	Если ticks != 0, то в ticks[i] возвращается продолжительность
+	проверки i в тактах таймера (см. tmTicks()). Для невыполненных
+	проверок возвращается 0.
+	\return ERR_OK, если параметры корректны, и код ошибки в противном
+	случае.
+	\remark Кэш проверенных параметров (см. vcache.h) и потоки
+	используются так же, как в bignValParams2().
+*/
+err_t dstuValParams2(
+	const dstu_params* params,	/*!< [in] параметры */
+	size_t threads,				/*!< [in] число потоков */
+	tm_ticks_t ticks[DSTU_VAL_CHECKS]	/*!< [out] продолжительность */
+);
+
 /*
 *******************************************************************************
 Управление точками ЭК
@@ -165,6 +194,15 @@ err_t dstuGenPoint(
 	\return ERR_OK, если точка корректна, и код ошибки в противном
 	случае.
 	\remark Реализован алгоритм из раздела 10.1 ДСТУ.
+	\remark При кофакторе 2 или 4 принадлежность точки подгруппе порядка 
+	params->n проверяется не умножением на params->n, а вычислением 
+	следов x-координат точки и ее половины.
+	\warning Проверка по следам верна, только если params->n -- простое 
+	число и произведение params->n на кофактор равняется порядку группы 
+	точек кривой. Функция эти условия не проверяет: вызывающая сторона 
+	должна получить параметры с помощью dstuStdParams() или предварительно 
+	проверить их с помощью dstuValParams(). Иначе может быть принята 
+	точка, которая не лежит в подгруппе порядка params->n.
 */
 err_t dstuValPoint(
 	const dstu_params* params,		/*!< [in] долговременные параметры */
@@ -202,6 +240,72 @@ err_t dstuRecoverPoint(
 	const octet xpoint[]			/*!< [in] сжатая точка */
 );
 
+/*!	\brief Пакетное восстановление точек
+
+	Точки points[i] эллиптической кривой, заданной долговременными 
+	параметрами params, восстанавливаются из сжатых представлений 
+	xpoints[i], i = 0, 1,..., count - 1. Точки points[i] размещаются 
+	в points последовательно, каждая занимает 2 * O_OF_B(m) октетов.
+	Сжатые точки xpoints[i] размещаются в xpoints последовательно, 
+	каждая занимает O_OF_B(m) октетов. В codes[i] возвращается код 
+	восстановления i-й точки.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если все точки восстановлены, и код ошибки первой 
+	невосстановленной точки (или общий код ошибки) в противном случае.
+	\remark Значение codes[i] совпадает с результатом 
+	dstuRecoverPoint(points + 2 * i * O_OF_B(m), params, 
+	xpoints + i * O_OF_B(m)). Если codes[i] != ERR_OK, то points[i] 
+	обнуляется.
+	\remark Описание кривой создается один раз. К описанию поля 
+	присоединяется таблица решений квадратных уравнений (см. 
+	gf2CreateQT()), с помощью которой вычисления полуследа, характерные 
+	для dstuRecoverPoint(), заменяются сложениями элементов таблицы. 
+	Построение таблицы сопоставимо по трудоемкости с 10 -- 20 
+	вызовами dstuRecoverPoint(), поэтому функцию имеет смысл 
+	использовать при восстановлении больших серий точек (например, 
+	открытых ключей из набора сертификатов).
+	\remark Буферы points и xpoints могут пересекаться, если начинаются 
+	с одного адреса.
+*/
+err_t dstuRecoverPointBatch(
+	octet points[],					/*!< [out] восстановленные точки */
+	err_t codes[],					/*!< [out] коды восстановления */
+	const dstu_params* params,		/*!< [in] параметры */
+	const octet xpoints[],			/*!< [in] сжатые точки */
+	size_t count					/*!< [in] число точек */
+);
+
+/*!	\brief Пакетная проверка точек
+
+	Проверяется, что точки points[i], i = 0, 1,..., count - 1, 
+	эллиптической кривой, заданной долговременными параметрами params, 
+	удовлетворяют требованиям ДСТУ. Точки размещаются в points 
+	последовательно, каждая занимает 2 * O_OF_B(m) октетов. В codes[i] 
+	возвращается код проверки i-й точки. Проверки выполняются threads 
+	потоками.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если все точки корректны, и код ошибки первой 
+	некорректной точки (или общий код ошибки) в противном случае.
+	\remark Значение codes[i] совпадает с результатом 
+	dstuValPoint(params, points + 2 * i * O_OF_B(m)).
+	\remark Описание кривой создается один раз. Принадлежность точки 
+	подгруппе порядка params->n при кофакторе 2 или 4 проверяется 
+	не умножением на params->n, а вычислением следов (см. dstuValPoint()).
+	При кофакторе 4 решается квадратное уравнение, для чего при проверке 
+	больших серий точек строится таблица решений (см. gf2CreateQT()).
+	\warning Параметры params должны быть предварительно проверены так же, 
+	как для dstuValPoint().
+	\remark Значения threads == 0 и threads == 1 равносильны: проверки
+	выполняются в вызывающем потоке.
+*/
+err_t dstuValPointBatch(
+	err_t codes[],					/*!< [out] коды проверки */
+	const dstu_params* params,		/*!< [in] долговременные параметры */
+	const octet points[],			/*!< [in] проверяемые точки */
+	size_t count,					/*!< [in] число точек */
+	size_t threads					/*!< [in] число потоков */
+);
+
 /*
 *******************************************************************************
 Управление ключами
@@ -261,6 +365,35 @@ err_t dstuSign(
 	void* rng_state					/*!< [in/out] состояние генератора */
 );
 
+/*!	\brief Выработка ЭЦП: лесенка Монтгомери
+
+	Подпись [ld / 8]sig вырабатывается так же, как в функции dstuSign(),
+	но кратная базовой точки, построенная по эфемерному личному ключу,
+	определяется с помощью лесенки Монтгомери (функция ec2MulLadderA()).
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_INPUT}:
+	-	ld делится на 16;
+	-	два вычета по модулю params->n укладываются в ld битов.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если подпись выработана, и код ошибки в противном
+	случае.
+	\remark Время вычисления кратной точки не зависит от эфемерного 
+	личного ключа. Дополнительная память под таблицу кратных точек 
+	не требуется.
+*/
+err_t dstuSignLadder(
+	octet sig[],					/*!< [out] подпись */
+	const dstu_params* params,		/*!< [in] долговременные параметры */
+	size_t ld,						/*!< [in] длина подписи в битах */
+	const octet hash[],				/*!< [in] хэш-значение */
+	size_t hash_len,				/*!< [in] длина хэш-значения в октетах */
+	const octet privkey[],			/*!< [in] личный ключ */
+	gen_i rng,						/*!< [in] генератор случайных чисел */
+	void* rng_state					/*!< [in/out] состояние генератора */
+);
+
 /*!	\brief Проверка ЭЦП
 
 	Проверяется подпись [ld / 8]sig сообщения с хэш-значением 
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2015.08.27
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -22,6 +22,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #define __BEE2_G12S_H
 
 #include "bee2/defs.h"
+#include "bee2/core/tm.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -128,11 +129,39 @@ err_t g12sStdParams(
 	Проверяется корректность долговременных параметров params.
 	\return ERR_OK, если параметры корректны, и код ошибки в противном
 	случае.
+	\remark Вызов эквивалентен g12sValParams2(params, 1, 0).
 */
 err_t g12sValParams(
 	const g12s_params* params	/*!< [in] параметры */
 );
 
+/*!	\brief Число проверок параметров */
+#define G12S_VAL_CHECKS 4
+
+/*!	\brief Проверка долговременных параметров в нескольких потоках
+
+	Проверяется корректность долговременных параметров params. Проверка
+	разбивается на G12S_VAL_CHECKS независимых проверок, которые
+	выполняются threads потоками:
+	-	0: a, b != 0, простота p, невырожденность кривой;
+	-	1: точка P лежит на кривой, граница Хассе;
+	-	2: простота q, q != p, MOV-условие;
+	-	3: qP = O.
+	.
+	Если ticks != 0, то в ticks[i] возвращается продолжительность
+	проверки i в тактах таймера (см. tmTicks()). Для невыполненных
+	проверок возвращается 0.
+	\return ERR_OK, если параметры корректны, и код ошибки в противном
+	случае.
+	\remark Кэш проверенных параметров (см. vcache.h) и потоки
+	используются так же, как в bignValParams2().
+*/
+err_t g12sValParams2(
+	const g12s_params* params,	/*!< [in] параметры */
+	size_t threads,				/*!< [in] число потоков */
+	tm_ticks_t ticks[G12S_VAL_CHECKS]	/*!< [out] продолжительность */
+);
+
 /*!
 *******************************************************************************
 \file g12s.h
@@ -226,6 +255,118 @@ err_t g12sVerify(
 	const octet pubkey[]		/*!< [in] открытый ключ */
 );
 
+/*!
+*******************************************************************************
+\file g12s.h
+\section g12s-ctx Долговременный контекст
+
+При выработке и проверке большого числа подписей на одних и тех же 
+долговременных параметрах целесообразно использовать контекст. В контексте 
+однократно создаются описания базового поля и эллиптической кривой и строится 
+таблица кратных базовой точки P (см. ecTblCreateA()). Таблица ускоряет 
+расчет kP при выработке подписи. 
+
+Для модулей p длины 256 битов в базовом поле автоматически используется 
+специализированная арифметика (см. zmCreate()): модули вида 2^256 - c 
+(параметры КриптоПро, набор A) обрабатываются редукцией Крэндалла, 
+остальные нечетные модули -- редукцией Монтгомери.
+
+Контекст поддерживает пакетную проверку подписей. При пакетной проверке
+общими являются обращения в базовом поле при переходе к аффинным 
+координатам.
+
+Контекст размещается в памяти state, длина которой определяется функцией
+g12sCtx_keep(). В этой же памяти размещается стек, поэтому контекст 
+нельзя одновременно использовать в нескольких потоках.
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста
+
+	Возвращается длина контекста g12s для уровня стойкости l.
+	\return Длина контекста или SIZE_MAX, если l \notin {256, 512}.
+*/
+size_t g12sCtx_keep(
+	size_t l					/*!< [in] уровень стойкости */
+);
+
+/*!	\brief Создание контекста
+
+	По долговременным параметрам params создается контекст state.
+	\pre По адресу state зарезервировано g12sCtx_keep(params->l) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если контекст создан, и код ошибки в противном случае.
+	\remark Проводится только минимальная проверка параметров. Полная 
+	проверка выполняется функцией g12sValParams().
+	\remark Контекст является объектом (см. obj.h) и может перемещаться 
+	в памяти с помощью функции objCopy().
+*/
+err_t g12sCtxStart(
+	void* state,				/*!< [out] контекст */
+	const g12s_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Выработка ЭЦП с помощью контекста
+
+	Вырабатывается подпись sig сообщения с хэш-значением hash. Подпись 
+	вырабатывается на личном ключе privkey с использованием контекста 
+	state и генератора rng с состоянием rng_state.
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Генератор rng является криптографически стойким.
+	\return ERR_OK, если подпись выработана, и код ошибки в противном
+	случае.
+	\remark Результат совпадает с результатом g12sSign() для тех же 
+	параметров и того же состояния генератора.
+*/
+err_t g12sCtxSign(
+	octet sig[],				/*!< [out] подпись */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet privkey[],		/*!< [in] личный ключ */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state,			/*!< [in/out] состояние генератора */
+	void* state					/*!< [in/out] контекст */
+);
+
+/*!	\brief Проверка ЭЦП с помощью контекста
+
+	Проверяется ЭЦП sig сообщения с хэш-значением hash на открытом ключе 
+	pubkey с использованием контекста state.
+	\expect{ERR_BAD_PUBKEY} Открытый ключ pubkey корректен.
+	\return ERR_OK, если подпись корректна, и код ошибки в противном случае.
+	\remark Коды возврата совпадают с кодами g12sVerify().
+*/
+err_t g12sCtxVerify(
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet sig[],			/*!< [in] подпись */
+	const octet pubkey[],		/*!< [in] открытый ключ */
+	void* state					/*!< [in/out] контекст */
+);
+
+/*!	\brief Пакетная проверка ЭЦП
+
+	Проверяются count подписей: i-я подпись sigs[i] сообщения 
+	с хэш-значением hashes[i] проверяется на открытом ключе pubkeys[i]. 
+	Используется контекст state. Массивы hashes, sigs и pubkeys состоят 
+	из элементов длины l / 8, l / 4 и 2 * no октетов соответственно
+	(см. g12s-keys, g12s-sign).
+	Если codes != 0, то в codes[i] возвращается код проверки i-й подписи 
+	(такой же, как у g12sCtxVerify()).
+	\return ERR_OK, если все подписи корректны, и код ошибки первой 
+	некорректной подписи в противном случае.
+	\remark Подписи обрабатываются порциями. Переход к аффинным координатам 
+	при проверке подписей порции выполняется с одним обращением в базовом 
+	поле.
+*/
+err_t g12sCtxVerifyBatch(
+	err_t codes[],				/*!< [out] коды проверки (или 0) */
+	const octet hashes[],		/*!< [in] хэш-значения */
+	const octet sigs[],			/*!< [in] подписи */
+	const octet pubkeys[],		/*!< [in] открытые ключи */
+	size_t count,				/*!< [in] число подписей */
+	void* state					/*!< [in/out] контекст */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
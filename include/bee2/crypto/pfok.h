@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.06.30
-\version 2017.10.10
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include "bee2/defs.h"
+#include "bee2/core/tm.h"
 
 /*!
 *******************************************************************************
@@ -184,11 +185,38 @@ err_t pfokGenParams(
 	.
 	\return ERR_OK, если параметры корректны, и код ошибки в противном случае.
 	\warning Не проверяется, что p построен по алгоритму 5.2.
+	\remark Вызов эквивалентен pfokValParams2(params, 1, 0).
 */
 err_t pfokValParams(
 	const pfok_params* params	/*!< [in] долговременные параметры */
 );
 
+/*!	\brief Число проверок параметров */
+#define PFOK_VAL_CHECKS 3
+
+/*!	\brief Проверка долговременных параметров в нескольких потоках
+
+	Проверяется, что долговременные параметры params корректны. После
+	проверки размерностей остальные условия разбиваются на PFOK_VAL_CHECKS
+	независимых проверок, которые выполняются threads потоками:
+	-	0: p -- простое;
+	-	1: q = (p - 1) / 2 -- простое;
+	-	2: g является образующим группы B_p.
+	.
+	Если ticks != 0, то в ticks[i] возвращается продолжительность
+	проверки i в тактах таймера (см. tmTicks()). Для невыполненных
+	проверок возвращается 0.
+	\return ERR_OK, если параметры корректны, и код ошибки в противном
+	случае.
+	\remark Кэш проверенных параметров (см. vcache.h) и потоки
+	используются так же, как в bignValParams2().
+*/
+err_t pfokValParams2(
+	const pfok_params* params,	/*!< [in] долговременные параметры */
+	size_t threads,				/*!< [in] число потоков */
+	tm_ticks_t ticks[PFOK_VAL_CHECKS]	/*!< [out] продолжительность */
+);
+
 /*
 *******************************************************************************
 Управление ключами
@@ -0,0 +1,155 @@
+/*
+*******************************************************************************
+\file vcache.h
+\brief Cache of validated domain parameters
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+/*!
+*******************************************************************************
+\file vcache.h
+\brief Кэш проверенных параметров
+*******************************************************************************
+*/
+
+#ifndef __BEE2_VCACHE_H
+#define __BEE2_VCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bee2/defs.h"
+
+/*!
+*******************************************************************************
+\file vcache.h
+
+\section vcache-common Общие положения
+
+Проверка долговременных параметров (bignValParams(), dstuValParams(),
+g12sValParams(), pfokValParams()) включает проверку простоты больших
+чисел, MOV-условия и вычисление кратных точек. Если одни и те же
+параметры проверяются многократно (например, при каждом сеансе
+протокола), то результаты проверок можно сохранять в кэше.
+
+Кэш хранит ключи параметров, которые успешно прошли проверку. Ключом
+служит хэш-значение belt-hash (СТБ 34.101.31) от метки алгоритма и
+описания параметров (см. vcacheKey()). Параметры, которые не прошли
+проверку, в кэш не попадают.
+
+Кэш является глобальным объектом. Он создается функцией vcacheCreate()
+и закрывается функцией vcacheClose(). Так же, как и в случае
+с генератором rng (см. rng.h), кэш можно создавать несколько раз,
+при этом закрывать его нужно столько же раз. Если кэш не создан,
+то функции проверки параметров обращаются к нему вхолостую.
+
+Кэш имеет фиксированное число ячеек size. Ключ может находиться в одной
+из VCACHE_WAYS ячеек, номера которых определяются первыми октетами
+ключа. Поэтому поиск и добавление ключа выполняются за время,
+не зависящее от size. При переполнении ячеек новый ключ вытесняет
+один из ранее сохраненных.
+
+Функции vcacheHas(), vcacheAdd() и vcacheWipe() можно вызывать из разных
+потоков: доступ к ячейкам кэша защищается мьютексом. Создание и закрытие
+кэша, как и в rng.h, не защищены: последнее закрытие разрушает сам
+мьютекс. Поэтому vcacheCreate() и vcacheClose() не должны выполняться
+одновременно с другими функциями кэша. В частности, vcacheClose()
+следует вызывать только после завершения всех обращений к кэшу
+из других потоков.
+*******************************************************************************
+*/
+
+/*!	\brief Число ячеек, доступных ключу */
+#define VCACHE_WAYS 4
+
+/*!	\brief Максимальное число ячеек кэша */
+#define VCACHE_MAX_SIZE ((size_t)1 << 16)
+
+/*!	\brief Создание кэша
+
+	Создается кэш из size ячеек.
+	\expect{ERR_BAD_INPUT} 0 < size <= VCACHE_MAX_SIZE.
+	\return ERR_OK, если кэш успешно создан, и код ошибки в противном
+	случае.
+	\remark Если кэш уже создан, то size игнорируется.
+*/
+err_t vcacheCreate(
+	size_t size				/*!< [in] число ячеек */
+);
+
+/*!	\brief Работоспособный кэш?
+
+	Проверяется работоспособность кэша.
+	\return Признак работоспособности.
+*/
+bool_t vcacheIsValid();
+
+/*!	\brief Очистка кэша
+
+	Все ключи удаляются из кэша, ячейки кэша обнуляются.
+	\expect vcacheCreate() < vcacheWipe() < vcacheClose().
+	\remark Функцию следует вызывать, например, при смене политики
+	проверки параметров.
+*/
+void vcacheWipe();
+
+/*!	\brief Закрытие кэша
+
+	Кэш закрывается (если он был создан один раз) или уменьшается число
+	его созданий. При закрытии ячейки кэша обнуляются.
+	\expect vcacheCreate() < vcacheClose().
+	\expect Вызовы других функций кэша из других потоков завершены.
+*/
+void vcacheClose();
+
+/*!	\brief Ключ параметров
+
+	По метке алгоритма tag и описанию параметров [count]params строится
+	ключ [32]key:
+	\code
+		key <- belt-hash(<strLen(tag)>_32 || tag || params).
+	\endcode
+	\pre Строка tag корректна, буфер params корректен.
+	\remark Описание params обрабатывается побайтово. Поэтому одинаковые
+	параметры получат одинаковые ключи, если только описания совпадают
+	и в неиспользуемых октетах (выравнивание, неиспользуемые части
+	массивов). Различие в неиспользуемых октетах приводит только
+	к промаху кэша.
+*/
+void vcacheKey(
+	octet key[32],			/*!< [out] ключ */
+	const char* tag,		/*!< [in] метка алгоритма */
+	const void* params,		/*!< [in] описание параметров */
+	size_t count			/*!< [in] длина описания в октетах */
+);
+
+/*!	\brief Поиск ключа
+
+	Проверяется, что ключ key содержится в кэше.
+	\return Признак наличия ключа. Если кэш не создан, то FALSE.
+*/
+bool_t vcacheHas(
+	const octet key[32]		/*!< [in] ключ */
+);
+
+/*!	\brief Добавление ключа
+
+	Ключ key добавляется в кэш. Если кэш не создан, то ничего
+	не делается.
+*/
+void vcacheAdd(
+	const octet key[32]		/*!< [in] ключ */
+);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __BEE2_VCACHE_H */
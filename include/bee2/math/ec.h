@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.19
-\version 2019.06.13
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -99,10 +99,19 @@ ec->order задается 2 * ec->f->n + 1 машинным словом. Ко
 криптографические вычисления на эллиптической кривой. 
 
 Описание ec эллиптической кривой включает указатели на функции арифметики 
-в группе точек этой кривой. Функцию интерфейса ec_tpl_i
+в группе точек этой кривой. Функции интерфейсов ec_toab_i и ec_tpl_i
 можно не поддерживать. Указатель на неподдерживаемую функцию 
 должен быть нулевым.
 
+Поле inv_ratio описания кривой содержит оценку отношения времени обращения 
+к времени умножения в базовом поле. Оценка используется для выбора стратегии 
+вычисления кратных точек (см. ecMulA()). Нулевое значение означает, 
+что оценка не известна или что обращение слишком дорогое, чтобы 
+использовать аффинные малые кратные. Функции создания кривых ecpCreateJ() 
+и ec2CreateLD() устанавливают нулевое значение: для типичных полей 
+аффинные малые кратные экспериментально не дают выигрыша. Если поле 
+допускает быстрое обращение, то оценку можно установить впоследствии.
+
 Описание кольца организовано как объект, и можно применять функции, 
 описанные в заголовочном файле obj.h.
 
@@ -353,12 +362,42 @@ typedef void (*ec_tpl_i)(
 	void* stack				/*!< [in] вспомогательная память */
 );
 
+/*!	\brief Пакетный экспорт в аффинные точки
+
+	По точкам [count * ec->d * ec->f->n]a эллиптической кривой ec строятся 
+	аффинные точки [count * 2 * ec->f->n]b. Переход выполняется с общим 
+	обращением Z-координат (трюк Монтгомери, см. qrInvBatch()): вместо count 
+	обращений в базовом поле выполняется одно обращение и около 3 * count 
+	умножений.
+	\pre Описание ec работоспособно.
+	\pre count > 0.
+	\pre Буферы a и b либо не пересекаются, либо указатели a и b совпадают.
+	\pre Координаты точек a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точки a лежат на кривой.
+	\return TRUE, если все точки a отличны от O, и FALSE в противном случае. 
+	Аффинные точки b, которые соответствуют точкам a, равным O, 
+	не определяются.
+	\remark Глубина стека функции не превосходит 
+	ecToABatch_deep(ec->f->n, ec->d, ec->deep, count).
+*/
+typedef bool_t (*ec_toab_i)(
+	word b[],				/*!< [out] аффинные точки */
+	const word a[],			/*!< [in] входные точки */
+	size_t count,			/*!< [in] число точек */
+	const struct ec_o* ec,	/*!< [in] описание эллиптической кривой */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
 /*!	\brief Описание эллиптической кривой
 
 	Описывается эллиптическая кривая, правила представления ее элементов, 
 	группа точек и функции, реализующие операции в группе.
 	\remark В таблицу указателей описания кривой как объекта входят поля 
 	f, A, B, base, order, params. Поле f является указателем на объект.
+	\remark В версии 2026.10.17 после поля tpl добавлено поле toab. 
+	Раскладка структуры изменилась: программы, которые обращаются к полям 
+	inv_ratio, deep и descr напрямую, должны быть перекомпилированы.
 */
 typedef struct ec_o
 {
@@ -383,6 +422,8 @@ typedef struct ec_o
 	ec_dbl_i dbl;			/*!< функция удвоения */
 	ec_dbla_i dbla;			/*!< функция удвоения аффинной точки */
 	ec_tpl_i tpl;			/*!< функция утроения */
+	ec_toab_i toab;			/*!< функция пакетного экспорта */
+	size_t inv_ratio;		/*!< отношение стоимостей обращения и умножения */
 	size_t deep;			/*!< максимальная глубина стека функций */
 	octet descr[];			/*!< память для размещения данных */
 } ec_o;
@@ -569,6 +610,60 @@ bool_t ecMulA(
 
 size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
 
+/*!	\brief Регулярная кратная точка
+
+	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной аффинной точки [2 * ec->f->n]a:
+	\code
+		b <- d a.
+	\endcode
+	В отличие от ecMulA() последовательность операций с точками и адреса 
+	обращений к памяти не зависят от d. Функция предназначена для 
+	секретных кратностей (личных ключей, одноразовых ключей). Для 
+	открытых кратностей следует использовать более быструю ecMulA().
+	\pre Описание ec работоспособно.
+	\pre Координаты a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec и имеет простой порядок q > 128.
+	\expect d < q. Иначе регулярность может нарушаться в формулах 
+	сложения, обрабатывающих исключительные случаи.
+	\return TRUE, если кратная точка является аффинной, и FALSE в противном
+	случае (b == O).
+	\deep{stack} ecMulRegA_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+bool_t ecMulRegA(
+	word b[],			/*!< [out] кратная точка */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulRegA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
+/*!	\brief Регулярная кратная точка: проективный результат
+
+	Определяется точка [ec->d * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной аффинной точки [2 * ec->f->n]a.
+	\pre Выполняются условия ecMulRegA().
+	\return TRUE, если b != O, и FALSE в противном случае.
+	\remark Функция отличается от ecMulRegA() только тем, что не выполняет 
+	заключительный переход к аффинным координатам. Несколько полученных 
+	точек можно перевести в аффинные координаты одним вызовом ecToABatch().
+	\deep{stack} ecMulReg_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+bool_t ecMulReg(
+	word b[],			/*!< [out] кратная точка */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulReg_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
 /*!	\brief Имеет порядок?
 
 	Проверяется, что аффинная точка [2 * ec->f->n]a имеет порядок [m]q 
@@ -621,6 +716,224 @@ bool_t ecAddMulA(
 
 size_t ecAddMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k,...);
 
+/*!	\brief Сумма кратных точек в проективных координатах
+
+	Определяется точка [ec->d * ec->f->n]b эллиптической кривой ec, которая 
+	является суммой [m[i]]d[i]-кратных точек [2n]a[i], i = 1, 2,.., k:
+	\code
+		b <- d[1] a[1] + d[2] a[2] + ... + d[k] a[k].
+	\endcode
+	Тройки a[i], d[i], m[i] передаются как дополнительные параметры
+	типов const word[], const word[], size_t соответственно.
+	\pre Описание ec работоспособно.
+	\pre k > 0.
+	\pre Координаты точек a[1], a[2],..., a[k] лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точки a[1], a[2],..., a[k] лежат на ec.
+	\return TRUE, если b != O, и FALSE в противном случае.
+	\remark Функция отличается от ecAddMulA() только тем, что не выполняет 
+	заключительный переход к аффинным координатам. Несколько полученных 
+	точек можно перевести в аффинные координаты одним вызовом ecToABatch().
+	\deep{stack} ecAddMul_deep(ec->f->n, ec->d, ec->deep, m[1], ..., m[k]).
+*/
+bool_t ecAddMul(
+	word b[],			/*!< [out] кратная точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	void* stack,		/*!< [in] вспомогательная память */
+	size_t k,			/*!< [in] число троек (a[i], d[i], m[i]) */
+	...					/*!< [in] тройки (a[i], d[i], m[i]) */
+);
+
+size_t ecAddMul_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k,...);
+
+/*!	\brief Сумма кратных точек: массивы
+
+	Определяется точка [ec->d * ec->f->n]b эллиптической кривой ec, которая 
+	является суммой [m]d[i]-кратных аффинных точек [2 * ec->f->n]a[i], 
+	i = 0, 1,..., k - 1:
+	\code
+		b <- d[0] a[0] + d[1] a[1] + ... + d[k - 1] a[k - 1].
+	\endcode
+	Точки a[i] и кратности d[i] располагаются в массивах a и d друг за 
+	другом. При небольшом k используется тот же алгоритм, что и в 
+	ecAddMul(), при большом k (сотни и тысячи слагаемых) -- метод 
+	Пиппенджера. Вычисления по методу Пиппенджера распределяются между 
+	threads потоками.
+	\pre Описание ec работоспособно.
+	\pre k > 0 && m > 0.
+	\pre Координаты точек a[i] лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точки a[i] лежат на ec.
+	\return TRUE, если b != O, и FALSE в противном случае.
+	\remark Значения threads == 0 и threads == 1 равносильны: вычисления 
+	выполняются в вызывающем потоке. Число потоков ограничивается числом 
+	окон метода Пиппенджера и не влияет на результат. При небольшом k 
+	дополнительные потоки не создаются.
+	\remark Функции ec не должны изменять общее состояние (выполняется 
+	для кривых, описания которых созданы функциями ecpCreateJ() 
+	и ec2CreateLD()).
+	\deep{stack} ecAddMulArr_deep(ec->f->n, ec->d, ec->deep, k, m, threads).
+*/
+bool_t ecAddMulArr(
+	word b[],			/*!< [out] сумма кратных точек */
+	const word a[],		/*!< [in] точки */
+	const word d[],		/*!< [in] кратности */
+	size_t k,			/*!< [in] число слагаемых */
+	size_t m,			/*!< [in] длина кратностей в машинных словах */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t threads,		/*!< [in] число потоков */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecAddMulArr_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, 
+	size_t m, size_t threads);
+
+/*!	\brief Сумма кратных точек: массивы, аффинный результат
+
+	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
+	которая является суммой [m]d[i]-кратных аффинных точек 
+	[2 * ec->f->n]a[i], i = 0, 1,..., k - 1.
+	\pre Выполняются условия ecAddMulArr().
+	\return TRUE, если полученная точка является аффинной, и FALSE
+	в противном случае (b == O).
+	\remark Функция отличается от ecAddMulArr() только тем, что выполняет 
+	заключительный переход к аффинным координатам.
+	\deep{stack} ecAddMulArrA_deep(ec->f->n, ec->d, ec->deep, k, m, threads).
+*/
+bool_t ecAddMulArrA(
+	word b[],			/*!< [out] сумма кратных точек */
+	const word a[],		/*!< [in] точки */
+	const word d[],		/*!< [in] кратности */
+	size_t k,			/*!< [in] число слагаемых */
+	size_t m,			/*!< [in] длина кратностей в машинных словах */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t threads,		/*!< [in] число потоков */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecAddMulArrA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, 
+	size_t m, size_t threads);
+
+/*!	\brief Пакетный переход к аффинным координатам
+
+	Точки [count * ec->d * ec->f->n]a эллиптической кривой ec переводятся 
+	в аффинные точки [count * 2 * ec->f->n]b. Если кривая поддерживает 
+	пакетный экспорт (ec->toab != 0), то используется функция ec->toab
+	с общим обращением в базовом поле. Иначе к каждой точке применяется 
+	функция ec->toa.
+	\pre Описание ec работоспособно.
+	\pre Буферы a и b либо не пересекаются, либо указатели a и b совпадают.
+	\pre Координаты точек a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точки a лежат на ec.
+	\return TRUE, если все точки a отличны от O, и FALSE в противном случае. 
+	Аффинные точки b, которые соответствуют точкам a, равным O, 
+	не определяются.
+	\deep{stack} ecToABatch_deep(ec->f->n, ec->d, ec->deep, count).
+*/
+bool_t ecToABatch(
+	word b[],			/*!< [out] аффинные точки */
+	const word a[],		/*!< [in] проективные точки */
+	size_t count,		/*!< [in] число точек */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecToABatch_deep(size_t n, size_t ec_d, size_t ec_deep, size_t count);
+
+/*
+*******************************************************************************
+Кратные точки с предвычислениями
+*******************************************************************************
+*/
+
+/*!	\brief Построение таблицы кратных
+
+	По аффинной точке [2 * ec->f->n]a эллиптической кривой ec строится 
+	таблица tbl кратных точек a, с помощью которой ускоряется вычисление
+	da для [m]d (см. ecMulTblA()). Таблица содержит аффинные точки 
+	(2j + 1) 2^{4i} a, 0 <= j < 8, 0 <= i <= B_OF_W(m) / 4.
+	\pre Описание ec работоспособно.
+	\pre Координаты a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec и имеет простой порядок, больший 15.
+	\return TRUE, если таблица построена, и FALSE, если одна из кратных 
+	точек оказалась равной O.
+	\keep{tbl} ecTblCreateA_keep(ec->f->n, m).
+	\deep{stack} ecTblCreateA_deep(ec->f->n, ec->d, ec->deep).
+*/
+bool_t ecTblCreateA(
+	word tbl[],			/*!< [out] таблица кратных */
+	const word a[],		/*!< [in] точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t m,			/*!< [in] длина кратностей в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecTblCreateA_keep(size_t n, size_t m);
+size_t ecTblCreateA_deep(size_t n, size_t ec_d, size_t ec_deep);
+
+/*!	\brief Кратная точка по таблице: проективный результат
+
+	Определяется точка [ec->d * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной точки a, представленной таблицей tbl:
+	\code
+		b <- d a.
+	\endcode
+	\pre Выполняются условия ecMulTblA().
+	\return TRUE, если b != O, и FALSE в противном случае.
+	\remark Функция отличается от ecMulTblA() только тем, что не выполняет 
+	заключительный переход к аффинным координатам. Несколько полученных 
+	точек можно перевести в аффинные координаты одним вызовом ecToABatch().
+	\deep{stack} ecMulTbl_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+bool_t ecMulTbl(
+	word b[],			/*!< [out] кратная точка */
+	const word tbl[],	/*!< [in] таблица кратных */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulTbl_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
+/*!	\brief Кратная точка по таблице
+
+	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной точки a, представленной таблицей tbl:
+	\code
+		b <- d a.
+	\endcode
+	Удвоения не выполняются: точка b является суммой B_OF_W(m) / 4 + 1 
+	точек таблицы.
+	\pre Описание ec работоспособно.
+	\pre Таблица tbl построена функцией ecTblCreateA() для кривой ec 
+	и длины m.
+	\pre Функция ec->neg не изменяет Z-координату (выполняется для 
+	кривых, описания которых созданы функциями ecpCreateJ() 
+	и ec2CreateLD()).
+	\expect Описание ec корректно.
+	\return TRUE, если кратная точка является аффинной, и FALSE в противном
+	случае (b == O).
+	\remark Вычисления регулярны на уровне операций с точками: число 
+	и последовательность сложений не зависят от d, точки таблицы 
+	выбираются маскированием без обращения по секретным индексам. 
+	Исключения составляют редкие случаи совпадения слагаемых, которые 
+	обрабатываются функцией ec->adda отдельно.
+	\deep{stack} ecMulTblA_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+bool_t ecMulTblA(
+	word b[],			/*!< [out] кратная точка */
+	const word tbl[],	/*!< [in] таблица кратных */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulTblA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
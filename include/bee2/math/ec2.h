@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.19
-\version 2014.04.17
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -59,6 +59,8 @@ O -- бесконечно удаленная точка.
 	Создается описание ec эллиптической кривой в координатах Лопеса -- Дахаба
 	над полем f с коэффициентами [f->no]A и [f->no]B.
 	\return Признак успеха.
+	\remark Если A \in {0, 1}, то умножения на A в функциях удвоения
+	и сложения не выполняются.
 	\post ec->d == 3.
 	\post Буферы ec->order и ec->base подготовлены для ecCreateGroup().
 	\keep{ec} ec2CreateLD_keep(f->n).
@@ -228,6 +230,54 @@ bool_t ec2SubAA(
 
 size_t ec2SubAA_deep(size_t n, size_t f_deep);
 
+/*
+*******************************************************************************
+Лесенка Монтгомери
+*******************************************************************************
+*/
+
+/*!	\brief Кратная точка: лесенка Монтгомери
+
+	Определяется кратная точка [2 * ec->f->n]b аффинной точки 
+	[2 * ec->f->n]a кривой ec:
+	\code
+		b <- d a.
+	\endcode
+	Используется лесенка Монтгомери над x-координатами точек 
+	в проективных координатах Лопеса -- Дахаба.
+	После завершения лесенки восстанавливается y-координата b.
+	\pre Описание ec работоспособно, группа точек ec описана.
+	\pre Координаты a лежат в базовом поле.
+	\pre Число [m]d меньше ec->order.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec.
+	\return TRUE, если кратная точка является аффинной, и FALSE 
+	в противном случае (b == O).
+	\remark Число шагов лесенки равняется битовой длине ec->order.
+	Перед лесенкой d копируется в stack и дополняется нулями до длины
+	ec->order. Поэтому m может быть меньше длины ec->order в словах.
+	Таблицы кратных точек не используются.
+	\remark Функция ec2MulLadderA() предназначена для работы с секретными 
+	кратностями d. На стандартных кривых ДСТУ 4145 она работает быстрее 
+	ecMulA() (см. ec2Bench()).
+	\safe Функция регулярна: время выполнения и последовательность
+	обращений к памяти не зависят от d (за исключением
+	случаев da == O и (d + 1)a == O, которые не возникают 
+	при 0 < d < ec->order
+	и a порядка ec->order). 
+	\deep{stack} ec2MulLadderA_deep(ec->f->n, ec->f->deep).
+*/
+bool_t ec2MulLadderA(
+	word b[],			/*!< [out] кратная точка */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ec2MulLadderA_deep(size_t n, size_t f_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
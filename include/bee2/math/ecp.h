@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.06.24
-\version 2017.01.11
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -75,6 +75,21 @@ bool_t ecpCreateJ(
 size_t ecpCreateJ_keep(size_t n);
 size_t ecpCreateJ_deep(size_t n, size_t f_deep);
 
+/*! \brief Управление использованием специализированных формул
+
+	Использование в ecpCreateJ() специализированных формул для полей, 
+	элементы которых занимают 4, 6 или 8 машинных слов, разрешается 
+	(use == TRUE, по умолчанию) или запрещается (use == FALSE). При запрете 
+	используются общие формулы. Настройка влияет только на кривые, 
+	создаваемые после вызова функции.
+	\remark Функция предназначена для тестирования общих формул 
+	и сравнения скорости. Ее не следует вызывать одновременно с созданием 
+	кривых в других потоках.
+*/
+void ecpUseFixed(
+	bool_t use		/*!< [in] признак разрешения */
+);
+
 /*
 *******************************************************************************
 Свойства кривой и группы точек
@@ -228,6 +243,54 @@ bool_t ecpSubAA(
 
 size_t ecpSubAA_deep(size_t n, size_t f_deep);
 
+/*
+*******************************************************************************
+Лесенка Монтгомери
+*******************************************************************************
+*/
+
+/*!	\brief Кратная точка: лесенка Монтгомери
+
+	Определяется кратная точка [2 * ec->f->n]b аффинной точки 
+	[2 * ec->f->n]a кривой ec:
+	\code
+		b <- d a.
+	\endcode
+	Используется лесенка Монтгомери над x-координатами точек (формулы 
+	Бриера -- Жойе).
+	После завершения лесенки восстанавливается y-координата b.
+	\pre Описание ec работоспособно, группа точек ec описана.
+	\pre Координаты a лежат в базовом поле.
+	\pre Число [m]d меньше ec->order.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec.
+	\return TRUE, если кратная точка является аффинной, и FALSE 
+	в противном случае (b == O).
+	\remark Число шагов лесенки равняется битовой длине ec->order.
+	Перед лесенкой d копируется в stack и дополняется нулями до длины
+	ec->order. Поэтому m может быть меньше длины ec->order в словах.
+	Таблицы кратных точек не используются.
+	\remark Кратную точку можно рассчитать быстрее (примерно в 2.5 раза,
+	см. ecpBench()) с помощью ecMulA(). Функция ecpMulLadderA() 
+	предназначена для работы с секретными кратностями d.
+	\safe Функция регулярна: время выполнения и последовательность
+	обращений к памяти не зависят от d (за исключением
+	случаев da == O и (d + 1)a == O, которые не возникают 
+	при 0 < d < ec->order
+	и a порядка ec->order). 
+	\deep{stack} ecpMulLadderA_deep(ec->f->n, ec->f->deep).
+*/
+bool_t ecpMulLadderA(
+	word b[],			/*!< [out] кратная точка */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecpMulLadderA_deep(size_t n, size_t f_deep);
+
 /*!	\brief Преобразование элемента поля в аффинную точку
 
 	Элемент [ec->f->n]a поля ec->f преобразуется в аффинную точку 
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.17
-\version 2015.02.01
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -55,9 +55,28 @@ extern "C" {
 Поле создается с помощью функции gf2Create(). При создании поля 
 анализируется p(x) и в зависимости от его вида выбирается одна 
 из общих функций редукции ppRedTrinomial() или ppRedPentanomial().
+Если p(x) -- один из стандартных многочленов ДСТУ 4145-2002 
+(m = 163, 167, 173, 179, 191, 233, 257, 307, 367, 431), то выбираются
+специальные функции умножения и возведения в квадрат с редукцией,
+в которых параметры p(x) зафиксированы. Для стандартных многочленов 
+обращение и деление выполняются по алгоритму Итоха -- Цудзии 
+(через возведения в квадрат и умножения), а не с помощью расширенного 
+алгоритма Евклида.
+
+С помощью функции gf2CreateIT() можно создать описание поля, 
+в котором обращение Итоха -- Цудзии ускорено предвычисленными 
+таблицами многократного возведения в квадрат. Таблицы занимают 
+значительный объем памяти (от десятков до сотен килобайт), 
+их имеет смысл строить для долгоживущих описаний поля.
+
+С помощью функции gf2CreateQT() можно создать описание поля, к которому 
+присоединена таблица решений квадратных уравнений. Таблица ускоряет 
+функцию gf2QSolve().
 
 Массив p, описывающий p(x), при создании поля фиксируется  
-по адресу params (см. описание типа qr_o). При создании поля 
+по адресу params (см. описание типа qr_o). Непосредственно перед params
+размещается маска следа -- элемент поля, i-й разряд которого равняется 
+следу t^i. Маска используется в функции gf2Tr(). При создании поля 
 также формируется модуль mod. Модуль представляется либо n 
 машинными словами (степень p(x) кратна B_PER_W), либо n + 1 словом 
 (степень p(x) не кратна B_PER_W).  
@@ -103,6 +122,65 @@ bool_t gf2Create(
 size_t gf2Create_keep(size_t m);
 size_t gf2Create_deep(size_t m);
 
+/*!	\brief Создание описания поля GF(2^m) с таблицами обращения
+
+	По описанию p многочлена p(x) создается описание f поля 
+	GF(2^m) = GF(2)/(p(x)). Описание строится так же, как 
+	в функции gf2Create(), и дополнительно к нему присоединяются 
+	таблицы многократного возведения в квадрат x -> x^{2^k}, 
+	которые используются при обращении и делении по алгоритму 
+	Итоха -- Цудзии.
+	\expect p(x) -- неприводим.
+	\return Признак успеха.
+	\post Cтепень расширения m совпадает с p[0].
+	\post f->n == W_OF_B(m) и f->no == O_OF_B(m).
+	\remark Таблицы строятся для шагов цепочки сложений для m - 1, 
+	на которых k >= 8. Каждая таблица содержит по 16 элементов поля 
+	для каждой тетрады элемента. Для m = 163 таблицы занимают около 
+	60 Кб, для m = 431 -- около 480 Кб.
+	\safe При обращении и делении выполняются обращения к таблицам
+	по адресам, которые зависят от обращаемого элемента. Функции 
+	обращения и деления становятся нерегулярными.
+	\keep{f} gf2CreateIT_keep(m).
+	\deep{stack} gf2CreateIT_deep(m).
+*/
+bool_t gf2CreateIT(
+	qr_o* f,			/*!< [out] описание поля */
+	const size_t p[4],	/*!< [in] описание p(x) */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t gf2CreateIT_keep(size_t m);
+size_t gf2CreateIT_deep(size_t m);
+
+/*!	\brief Создание описания поля GF(2^m) с таблицей решений
+
+	По описанию p многочлена p(x) создается описание f поля 
+	GF(2^m) = GF(2)/(p(x)). Описание строится так же, как 
+	в функции gf2Create(), и дополнительно к нему присоединяется 
+	таблица решений квадратных уравнений, которая используется 
+	в функции gf2QSolve().
+	\expect p(x) -- неприводим.
+	\return Признак успеха. Если m -- четное, то возвращается FALSE.
+	\post Cтепень расширения m совпадает с p[0].
+	\post f->n == W_OF_B(m) и f->no == O_OF_B(m).
+	\remark Таблица состоит из m элементов поля и строится методом 
+	Гаусса -- Жордана за O(m^2 f->n) операций со словами. Таблицу имеет 
+	смысл строить для долгоживущих описаний поля или при решении серии 
+	уравнений (например, при восстановлении серии сжатых точек 
+	эллиптической кривой).
+	\keep{f} gf2CreateQT_keep(m).
+	\deep{stack} gf2CreateQT_deep(m).
+*/
+bool_t gf2CreateQT(
+	qr_o* f,			/*!< [out] описание поля */
+	const size_t p[4],	/*!< [in] описание p(x) */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t gf2CreateQT_keep(size_t m);
+size_t gf2CreateQT_deep(size_t m);
+
 /*!	\brief Описание поля GF(2^m) работоспособно?
 
 	Проверяется работоспособность описания f поля GF(2^m). Проверяются
@@ -194,10 +272,13 @@ qr_sub_i, qr_neg_i идут прямые обращения к wwXor(), wwXor2()
 		\tr(a) <- \sum {i = 0}^{m - 1} a^{2^i}.
 	\endcode
 	След совпадает либо с нулем, либо с единицей поля.
+	\remark След вычисляется как четность веса a & T, где T -- маска следа,
+	рассчитанная в gf2Create().
 	\pre Описание f работоспособно.
 	\pre Элемент a принадлежит f.
 	\expect Описание f корректно.
 	\return FALSE, если след равняется 0, и TRUE, если след равняется 1.
+	\safe Функция регулярна.
 	\deep{stack} gf2Tr_deep(f->n, f->deep).
 */
 bool_t gf2Tr(
@@ -222,6 +303,13 @@ size_t gf2Tr_deep(size_t n, size_t f_deep);
 	\expect Описание f корректно.
 	\return TRUE, если решение есть, и FALSE в противном случае.
 	\remark Если x -- решение, то и x + a -- решение.
+	\remark Если описание f создано функцией gf2CreateQT(), то вместо 
+	вычисления полуследа, которое требует (m - 1) возведений в квадрат, 
+	используется таблица решений. Найденное решение при этом может 
+	отличаться от решения, найденного без таблицы, на a.
+	\safe При a, b \neq 0 и наличии таблицы ее элементы складываются 
+	регулярно: просматриваются все элементы, выбор слагаемых выполняется 
+	с помощью масок.
 	\deep{stack} gf2QSolve_deep(f->n, f->deep).
 */
 bool_t gf2QSolve(
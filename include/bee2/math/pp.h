@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.03.01
-\version 2016.05.18
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -142,6 +142,15 @@ void ppMul(
 
 size_t ppMul_deep(size_t n, size_t m);
 
+/*! \brief Используется команда PCLMULQDQ?
+
+	Проверяется, что при умножении многочленов используется команда 
+	PCLMULQDQ процессоров x86-64. Команда используется, если она 
+	поддерживается процессором.
+	\return Признак использования.
+*/
+bool_t ppHasCLMUL();
+
 /*! \brief Возведение многочлена в квадрат
 
 	Определяется квадрат [2n]b многочлена [n]a:
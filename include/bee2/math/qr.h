@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.08.09
-\version 2015.09.01
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -446,6 +446,35 @@ void qrPower(
 
 size_t qrPower_deep(size_t n, size_t m, size_t r_deep);
 
+/*! \brief Пакетное обращение в кольце вычетов
+
+	В кольце вычетов r для элементов [r->n]a_0, [r->n]a_1,..., 
+	[r->n]a_{count - 1}, размещенных в a последовательно, определяются 
+	обратные элементы [r->n]b_i:
+	\code
+		b_i <- a_i^{-1}, i = 0, 1,..., count - 1.
+	\endcode
+	Элементы b_i размещаются в b последовательно.
+	\pre Описание кольца r работоспособно.
+	\pre Элементы a_i принадлежат r.
+	\pre Буферы a и b либо совпадают, либо не пересекаются.
+	\expect Описание кольца r корректно.
+	\expect Элементы a_i обратимы. Если хотя бы один из элементов 
+	необратим, то результаты для всех элементов будут неверными.
+	\remark Используется прием Монтгомери: вместо count обращений 
+	выполняется одно обращение и 3(count - 1) умножений.
+	\deep{stack} qrInvBatch_deep(r->n, count, r->deep).
+*/
+void qrInvBatch(
+	word b[],				/*!< [out] обратные элементы */
+	const word a[],			/*!< [in] обращаемые элементы */
+	size_t count,			/*!< [in] число элементов */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrInvBatch_deep(size_t n, size_t count, size_t r_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
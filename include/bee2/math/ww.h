@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.18
-\version 2019.06.27
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -126,6 +126,25 @@ void wwSwap(
 	size_t n		/*!< [in] длина a и b в машинных словах */
 );
 
+/*!	\brief Условная перестановка слов
+
+	Если cond == TRUE, то слова [n]a и [n]b меняются местами:
+	\code
+		if (cond) a <-> b.
+	\endcode
+	Если cond == FALSE, то слова не меняются.
+	\pre Буфер b не пересекается с буфером a.
+	\pre cond \in {FALSE, TRUE}.
+	\safe Функция регулярна: время выполнения и обращения к памяти
+	не зависят от cond.
+*/
+void wwCondSwap(
+	word a[],		/*!< [in/out] первое слово */
+	word b[],		/*!< [in/out] второе слово */
+	size_t n,		/*!< [in] длина a и b в машинных словах */
+	bool_t cond		/*!< [in] условие перестановки */
+);
+
 /*!	\brief Проверка совпадения слов
 
 	Проверяется совпадение слов [n]a и [n]b.
@@ -5,12 +5,13 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.10.10
-\version 2015.08.27
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include "bee2/core/blob.h"
 #include "bee2/core/mem.h"
 #include "bee2/core/mt.h"
 #include "bee2/core/util.h"
@@ -126,6 +127,28 @@ void mtSleep(u32 ms)
 	Sleep(ms);
 }
 
+static DWORD WINAPI mtThrdMain(LPVOID arg)
+{
+	mt_thrd_t* thrd = (mt_thrd_t*)arg;
+	thrd->fn(thrd->arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i fn, void* arg)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	thrd->fn = fn, thrd->arg = arg;
+	thrd->handle = CreateThread(0, 0, mtThrdMain, thrd, 0, 0);
+	return thrd->handle != NULL;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	WaitForSingleObject(thrd->handle, INFINITE);
+	CloseHandle(thrd->handle);
+}
+
 #elif defined OS_UNIX
 
 #include <time.h>
@@ -139,11 +162,88 @@ void mtSleep(u32 ms)
 	nanosleep(&ts, 0);
 }
 
+static void* mtThrdMain(void* arg)
+{
+	mt_thrd_t* thrd = (mt_thrd_t*)arg;
+	thrd->fn(thrd->arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i fn, void* arg)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	thrd->fn = fn, thrd->arg = arg;
+	return pthread_create(&thrd->id, 0, mtThrdMain, thrd) == 0;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	pthread_join(thrd->id, 0);
+}
+
 #else
 
 void mtSleep(u32 ms)
 {
 }
 
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i fn, void* arg)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	thrd->fn = fn, thrd->arg = arg;
+	fn(arg);
+	return TRUE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+}
+
 #endif // OS
 
+/*
+*******************************************************************************
+Выполнение заданий
+
+Для потоков выделяется память. Если ее выделить не удалось, то все задания 
+выполняются в вызывающем потоке. Результаты при этом не меняются.
+*******************************************************************************
+*/
+
+void mtRunJobs(mt_thrd_i run, void* jobs, size_t job_size, size_t count)
+{
+	mt_thrd_t* thrds;
+	bool_t* in_thrd;
+	size_t i;
+	// pre
+	ASSERT(run != 0);
+	ASSERT(memIsValid(jobs, count * job_size));
+	// выделить память для потоков
+	thrds = 0;
+	if (count > 1)
+		thrds = (mt_thrd_t*)blobCreate(
+			(count - 1) * (sizeof(mt_thrd_t) + sizeof(bool_t)));
+	// выполнить задания в вызывающем потоке
+	if (thrds == 0)
+	{
+		for (i = 0; i < count; ++i)
+			run((octet*)jobs + i * job_size);
+		return;
+	}
+	in_thrd = (bool_t*)(thrds + count - 1);
+	// запустить потоки
+	for (i = 1; i < count; ++i)
+		in_thrd[i - 1] = mtThrdCreate(thrds + i - 1, run,
+			(octet*)jobs + i * job_size);
+	// выполнить первое задание
+	run(jobs);
+	// присоединить потоки / выполнить задания без потоков
+	for (i = 1; i < count; ++i)
+		if (in_thrd[i - 1])
+			mtThrdJoin(thrds + i - 1);
+		else
+			run((octet*)jobs + i * job_size);
+	blobClose(thrds);
+}
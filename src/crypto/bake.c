@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.04.14
-\version 2017.11.03
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -22,6 +22,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/math/gfp.h"
 #include "bee2/math/ecp.h"
 #include "bee2/math/ww.h"
+#include "bee2/math/zm.h"
 #include "bee2/math/zz.h"
 
 /*
@@ -273,7 +274,7 @@ err_t bakeBMQVStep2(octet out[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Vb <- ub G
-	if (!ecMulA(Vb, s->ec->base, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Vb, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	// out <- <Vb>
 	qrTo(out, ecX(Vb), s->ec->f, stack);
@@ -290,7 +291,7 @@ static size_t bakeBMQVStep2_deep(size_t n, size_t f_deep, size_t ec_d,
 	return O_OF_W(2 * n) +
 		utilMax(2,
 			f_deep,
-			ecMulA_deep(n, ec_d, ec_deep, n));
+			ecMulRegA_deep(n, ec_d, ec_deep, n));
 }
 
 err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
@@ -308,6 +309,7 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 	octet* K;			/* [no] (совпадает с Qb) */
 	octet* block0;		/* [16] (совпадает с t) */
 	octet* block1;		/* [16] (следует за block0) */
+	qr_o* r;			/* [bignCreateRing_keep(n)] (в stack) */
 	void* stack;
 	// проверить входные данные
 	if (!objIsOperable(s))
@@ -349,7 +351,7 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Va <- ua G
-	if (!ecMulA(Va, s->ec->base, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Va, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)Va, ecX(Va), s->ec->f, stack);
 	qrTo((octet*)Va + no, ecY(Va, n), s->ec->f, stack);
@@ -362,10 +364,13 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 	// out <- <Va>_4l
 	memCopy(out, Va, 2 * no);
 	// sa <- (ua - (2^l + t)da) \mod q
-	zzMul(sa, t, n / 2, s->d, n, stack);
-	sa[n + n / 2] = zzAdd2(sa + n / 2, s->d, n);
-	zzMod(sa, sa, n + n / 2 + 1, s->ec->order, n, stack);
-	zzSubMod(sa, s->u, sa, s->ec->order, n);
+	r = (qr_o*)stack;
+	bignCreateRing(r, s->ec, (octet*)r + bignCreateRing_keep(n));
+	wwCopy(sa, t, n / 2);
+	sa[n / 2] = 1;
+	wwSetZero(sa + n / 2 + 1, n - n / 2 - 1);
+	qrMul(sa, sa, s->d, r, (octet*)r + bignCreateRing_keep(n));
+	zmSub(sa, s->u, sa, r);
 	// K <- sa(Vb - (2^l + t)Qb), K == O => K <- G
 	t[n / 2] = 1;
 	if (!ecMulA(Qb, Qb, s->ec, t, n / 2 + 1, stack))
@@ -374,7 +379,7 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 		qrTo(K, s->ec->base, s->ec->f, stack);
 	else
 	{
-		if (!ecMulA(Vb, Vb, s->ec, sa, n, stack))
+		if (!ecMulRegA(Vb, Vb, s->ec, sa, n, stack))
 			return ERR_BAD_PARAMS;
 		qrTo(K, ecX(Vb), s->ec->f, stack);
 	}
@@ -418,10 +423,10 @@ static size_t bakeBMQVStep3_deep(size_t n, size_t f_deep, size_t ec_d,
 		utilMax(9,
 			f_deep,
 			ecpIsOnA_deep(n, f_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulA_deep(n, ec_d, ec_deep, n / 2 + 1),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n),
+			bignCreateRing_keep(n) + bignCreateRing_deep(n),
 			ecpSubAA_deep(n, f_deep),
 			beltKRP_keep(),
 			beltMAC_keep());
@@ -441,6 +446,7 @@ err_t bakeBMQVStep4(octet out[], const octet in[], const bake_cert* certa,
 	octet* K;			/* [no] (совпадает с Qa) */
 	octet* block0;		/* [16] (совпадает с t) */
 	octet* block1;		/* [16] (следует за block0) */
+	qr_o* r;			/* [bignCreateRing_keep(n)] (в stack) */
 	void* stack;
 	// проверить входные данные
 	if (!objIsOperable(s))
@@ -482,10 +488,13 @@ err_t bakeBMQVStep4(octet out[], const octet in[], const bake_cert* certa,
 	beltHashStepG2((octet*)t, no / 2, stack);
 	wwFrom(t, t, no / 2);
 	// sb <- (ub - (2^l + t)db) \mod q
-	zzMul(sb, t, n / 2, s->d, n, stack);
-	sb[n + n / 2] = zzAdd2(sb + n / 2, s->d, n);
-	zzMod(sb, sb, n + n / 2 + 1, s->ec->order, n, stack);
-	zzSubMod(sb, s->u, sb, s->ec->order, n);
+	r = (qr_o*)stack;
+	bignCreateRing(r, s->ec, (octet*)r + bignCreateRing_keep(n));
+	wwCopy(sb, t, n / 2);
+	sb[n / 2] = 1;
+	wwSetZero(sb + n / 2 + 1, n - n / 2 - 1);
+	qrMul(sb, sb, s->d, r, (octet*)r + bignCreateRing_keep(n));
+	zmSub(sb, s->u, sb, r);
 	// K <- sb(Va - (2^l + t)Qa), K == O => K <- G
 	t[n / 2] = 1;
 	if (!ecMulA(Qa, Qa, s->ec, t, n / 2 + 1, stack))
@@ -494,7 +503,7 @@ err_t bakeBMQVStep4(octet out[], const octet in[], const bake_cert* certa,
 		qrTo(K, s->ec->base, s->ec->f, stack);
 	else
 	{
-		if (!ecMulA(Va, Va, s->ec, sb, n, stack))
+		if (!ecMulRegA(Va, Va, s->ec, sb, n, stack))
 			return ERR_BAD_PARAMS;
 		qrTo(K, ecX(Va), s->ec->f, stack);
 	}
@@ -546,10 +555,10 @@ static size_t bakeBMQVStep4_deep(size_t n, size_t f_deep, size_t ec_d,
 		utilMax(9,
 			f_deep,
 			ecpIsOnA_deep(n, f_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulA_deep(n, ec_d, ec_deep, n / 2 + 1),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n),
+			bignCreateRing_keep(n) + bignCreateRing_deep(n),
 			ecpSubAA_deep(n, f_deep),
 			beltKRP_keep(),
 			beltMAC_keep());
@@ -838,7 +847,7 @@ err_t bakeBSTSStep2(octet out[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Vb <- ub G
-	if (!ecMulA(s->Vb, s->ec->base, s->ec, s->u, n, stack))
+	if (!ecMulRegA(s->Vb, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	// out <- <Vb>
 	qrTo(out, ecX(s->Vb), s->ec->f, stack);
@@ -852,7 +861,7 @@ static size_t bakeBSTSStep2_deep(size_t n, size_t f_deep, size_t ec_d,
 {
 	return utilMax(2,
 			f_deep,
-			ecMulA_deep(n, ec_d, ec_deep, n));
+			ecMulRegA_deep(n, ec_d, ec_deep, n));
 }
 
 err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
@@ -866,6 +875,7 @@ err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
 	octet* K;			/* [no] (совпадает с Va) */
 	octet* block0;		/* [16] (следует за sa) */
 	octet* block1;		/* [16] (следует за block0) */
+	qr_o* r;			/* [bignCreateRing_keep(n)] (в stack) */
 	void* stack;
 	// проверить входные данные
 	if (!objIsOperable(s))
@@ -893,7 +903,7 @@ err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Va <- ua G
-	if (!ecMulA(Va, s->ec->base, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Va, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)Va, ecX(Va), s->ec->f, stack);
 	qrTo((octet*)Va + no, ecY(Va, n), s->ec->f, stack);
@@ -906,15 +916,18 @@ err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
 	// out ||.. <- <Va>_4l
 	memCopy(out, Va, 2 * no);
 	// sa <- (ua - (2^l + t)da) \mod q
-	zzMul(sa, t, n / 2, s->d, n, stack);
-	sa[n + n / 2] = zzAdd2(sa + n / 2, s->d, n);
-	zzMod(sa, sa, n + n / 2 + 1, s->ec->order, n, stack);
-	zzSubMod(sa, s->u, sa, s->ec->order, n);
+	r = (qr_o*)stack;
+	bignCreateRing(r, s->ec, (octet*)r + bignCreateRing_keep(n));
+	wwCopy(sa, t, n / 2);
+	sa[n / 2] = 1;
+	wwSetZero(sa + n / 2 + 1, n - n / 2 - 1);
+	qrMul(sa, sa, s->d, r, (octet*)r + bignCreateRing_keep(n));
+	zmSub(sa, s->u, sa, r);
 	// ..|| out ||.. <- sa || certa
 	wwTo(out + 2 * no, no, sa);
 	memCopy(out + 3 * no, s->cert->data, s->cert->len);
 	// K <- beltHash(<ua Vb>_2l || helloa || hellob)
-	if (!ecMulA(Va, s->Vb, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Va, s->Vb, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo(K, ecX(Va), s->ec->f, stack);
 	beltHashStart(stack);
@@ -955,13 +968,12 @@ static size_t bakeBSTSStep3_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(4 * n + 2) + 32 +
-		utilMax(9,
+		utilMax(8,
 			f_deep,
 			ecpIsOnA_deep(n, f_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n),
+			bignCreateRing_keep(n) + bignCreateRing_deep(n),
 			beltKRP_keep(),
 			beltCFB_keep(),
 			beltMAC_keep());
@@ -982,6 +994,7 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 	octet* K;			/* [no] (совпадает с Qa) */
 	octet* block0;		/* [16] (следует за sb) */
 	octet* block1;		/* [16] (следует за block0) */
+	qr_o* r;			/* [bignCreateRing_keep(n)] (в stack) */
 	void* stack;
 	// проверить входные данные
 	if (!objIsOperable(s))
@@ -1008,7 +1021,7 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 		!ecpIsOnA(Va, s->ec, stack))
 		return ERR_BAD_POINT;
 	// K <- beltHash(<ub Va>_2l || helloa || hellob)
-	if (!ecMulA(Qa, Va, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Qa, Va, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo(K, ecX(Qa), s->ec->f, stack);
 	beltHashStart(stack);
@@ -1077,10 +1090,13 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 	if (!wwEq(Qa, Va, 2 * n))
 		return ERR_BAD_AUTH;
 	// sb <- (ub - (2^l + t)db) \mod q
-	zzMul(sb, t, n / 2, s->d, n, stack);
-	sb[n + n / 2] = zzAdd2(sb + n / 2, s->d, n);
-	zzMod(sb, sb, n + n / 2 + 1, s->ec->order, n, stack);
-	zzSubMod(sb, s->u, sb, s->ec->order, n);
+	r = (qr_o*)stack;
+	bignCreateRing(r, s->ec, (octet*)r + bignCreateRing_keep(n));
+	wwCopy(sb, t, n / 2);
+	sb[n / 2] = 1;
+	wwSetZero(sb + n / 2 + 1, n - n / 2 - 1);
+	qrMul(sb, sb, s->d, r, (octet*)r + bignCreateRing_keep(n));
+	zmSub(sb, s->u, sb, r);
 	// out ||.. <- beltCFBEncr(sb || certb)
 	wwTo(out, no, sb);
 	memCopy(out + no, s->cert->data, s->cert->len);
@@ -1099,13 +1115,12 @@ static size_t bakeBSTSStep4_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(6 * n + 2) + 32 +
-		utilMax(10,
+		utilMax(9,
 			f_deep,
 			ecpIsOnA_deep(n, f_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n),
+			bignCreateRing_keep(n) + bignCreateRing_deep(n),
 			ecAddMulA_deep(n, ec_d, ec_deep, 2, n, n / 2 + 1),
 			beltKRP_keep(),
 			beltCFB_keep(),
@@ -1547,7 +1562,7 @@ err_t bakeBPACEStep3(octet out[], const octet in[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Va <- ua W
-	if (!ecMulA(Va, s->W, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Va, s->W, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	// ...|| out <- <Va>
 	qrTo(out + no / 2, ecX(Va), s->ec->f, stack);
@@ -1565,7 +1580,7 @@ static size_t bakeBPACEStep3_deep(size_t n, size_t f_deep, size_t ec_d,
 		utilMax(4,
 			beltECB_keep(),
 			bakeSWU2_deep(n, f_deep, ec_d, ec_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			f_deep);
 }
 
@@ -1614,11 +1629,11 @@ err_t bakeBPACEStep4(octet out[], const octet in[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// K <- ub Va
-	if (!ecMulA(K, Va, s->ec, s->u, n, stack))
+	if (!ecMulRegA(K, Va, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)K, ecX(K), s->ec->f, stack);
 	// Vb <- ub W
-	if (!ecMulA(Vb, s->W, s->ec, s->u, n, stack))
+	if (!ecMulRegA(Vb, s->W, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)ecX(Vb), ecX(Vb), s->ec->f, stack);
 	qrTo((octet*)ecY(Vb, n), ecY(Vb, n), s->ec->f, stack);
@@ -1665,7 +1680,7 @@ static size_t bakeBPACEStep4_deep(size_t n, size_t f_deep, size_t ec_d,
 			f_deep,
 			beltECB_keep(),
 			bakeSWU2_deep(n, f_deep, ec_d, ec_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
 			beltKRP_keep(),
 			beltMAC_keep());
@@ -1704,7 +1719,7 @@ err_t bakeBPACEStep5(octet out[], const octet in[], void* state)
 		!ecpIsOnA(Vb, s->ec, stack))
 		return ERR_BAD_POINT;
 	// K <- ua Vb
-	if (!ecMulA(K, Vb, s->ec, s->u, n, stack))
+	if (!ecMulRegA(K, Vb, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)K, ecX(K), s->ec->f, stack);
 	qrTo((octet*)Vb, ecX(Vb), s->ec->f, stack);
@@ -1756,7 +1771,7 @@ static size_t bakeBPACEStep5_deep(size_t n, size_t f_deep, size_t ec_d,
 	return O_OF_W(3 * n) +
 		utilMax(5,
 			f_deep,
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
 			beltKRP_keep(),
 			beltMAC_keep());
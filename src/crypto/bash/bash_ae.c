@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2018.10.30
-\version 2019.07.09
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -420,3 +420,92 @@ void bashAEDecr(void* buf, size_t count, void* state)
 	bashAEDecrStep(buf, count, state);
 	bashAEDecrStop(state);
 }
+
+/*
+*******************************************************************************
+Пакетная обработка (burst)
+
+Пакеты разных сессий обрабатываются одним вызовом, но последовательно.
+Совмещение bash-f для двух состояний не ускоряет обработку: каждый такт
+bash-f уже содержит 8 независимых вызовов bash-s, а 48 слов двух
+состояний не помещаются в регистры x64. Выигрыш дает только устранение
+накладных расходов на отдельные вызовы.
+*******************************************************************************
+*/
+
+static bool_t bashAEBurstIsValid(void* bufs[], const size_t counts[],
+	const void* hdrs[], const size_t hdr_counts[], size_t mac_len,
+	void* states[], size_t num)
+{
+	size_t j;
+	if (mac_len == 0 || mac_len > 64 ||
+		num > SIZE_MAX / 64 ||
+		!memIsValid(bufs, num * sizeof(void*)) ||
+		!memIsValid(counts, num * sizeof(size_t)) ||
+		!memIsNullOrValid(hdrs, num * sizeof(void*)) ||
+		hdrs && !memIsValid(hdr_counts, num * sizeof(size_t)) ||
+		!memIsValid(states, num * sizeof(void*)))
+		return FALSE;
+	for (j = 0; j < num; ++j)
+		if (!memIsValid(states[j], bashAE_keep()) ||
+			!memIsValid(bufs[j], counts[j]) ||
+			hdrs && !memIsValid(hdrs[j], hdr_counts[j]))
+			return FALSE;
+	return TRUE;
+}
+
+err_t bashAEWrapBurst(void* bufs[], const size_t counts[],
+	const void* hdrs[], const size_t hdr_counts[], octet macs[],
+	size_t mac_len, void* states[], size_t num)
+{
+	size_t j;
+	// проверить входные данные
+	if (!bashAEBurstIsValid(bufs, counts, hdrs, hdr_counts, mac_len,
+			states, num) ||
+		!memIsValid(macs, mac_len * num))
+		return ERR_BAD_INPUT;
+	// обработать пакеты
+	for (j = 0; j < num; ++j)
+	{
+		if (hdrs)
+			bashAEAbsorb(BASH_AE_DATA, hdrs[j], hdr_counts[j], states[j]);
+		bashAEEncr(bufs[j], counts[j], states[j]);
+		bashAESqueeze(BASH_AE_MAC, macs + mac_len * j, mac_len, states[j]);
+	}
+	return ERR_OK;
+}
+
+err_t bashAEUnwrapBurst(void* bufs[], const size_t counts[],
+	const void* hdrs[], const size_t hdr_counts[], const octet macs[],
+	size_t mac_len, void* states[], size_t num, bool_t oks[])
+{
+	octet mac[64];
+	size_t j;
+	err_t code = ERR_OK;
+	// проверить входные данные
+	if (!bashAEBurstIsValid(bufs, counts, hdrs, hdr_counts, mac_len,
+			states, num) ||
+		!memIsValid(macs, mac_len * num) ||
+		!memIsNullOrValid(oks, num * sizeof(bool_t)))
+		return ERR_BAD_INPUT;
+	// обработать пакеты
+	for (j = 0; j < num; ++j)
+	{
+		bool_t ok;
+		if (hdrs)
+			bashAEAbsorb(BASH_AE_DATA, hdrs[j], hdr_counts[j], states[j]);
+		bashAEDecr(bufs[j], counts[j], states[j]);
+		bashAESqueeze(BASH_AE_MAC, mac, mac_len, states[j]);
+		ok = memEq(mac, macs + mac_len * j, mac_len);
+		if (oks)
+			oks[j] = ok;
+		if (!ok)
+		{
+			memSetZero(bufs[j], counts[j]);
+			code = ERR_BAD_MAC;
+		}
+	}
+	// завершить
+	memSetZero(mac, sizeof(mac));
+	return code;
+}
@@ -0,0 +1,365 @@
+/*
+*******************************************************************************
+\file bcnt.c
+\brief Chunked authenticated encryption containers
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include "bee2/core/blob.h"
+#include "bee2/core/err.h"
+#include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
+#include "bee2/core/u32.h"
+#include "bee2/core/util.h"
+#include "bee2/crypto/bash.h"
+#include "bee2/crypto/belt.h"
+#include "bee2/crypto/bcnt.h"
+
+/*
+*******************************************************************************
+Состояние
+
+Заголовок:
+	[4]"bcnt" || [1]version || [1]alg || [2]0 || [4]chunk_size || [4]0 ||
+	[16]S,
+где chunk_size записывается по правилам little-endian.
+
+В состоянии хранится заголовок (он входит в открытые данные фрагментов)
+и ключи файла: ключ K_iv для построения синхропосылок фрагментов и ключ 
+K_ae алгоритма аутентифицированного шифрования. Ключи строятся с помощью 
+beltKRP на разных уровнях, поэтому ни один из них не используется 
+в двух алгоритмах.
+*******************************************************************************
+*/
+
+#define BCNT_VERSION 1
+#define BCNT_BELT_DWP_TAG 8
+#define BCNT_BASH_AE_TAG 32
+
+typedef struct
+{
+	size_t alg;					/*< алгоритм */
+	size_t chunk_size;			/*< длина фрагмента */
+	size_t tag_len;				/*< длина имитовставки */
+	octet header[BCNT_HDR_LEN];	/*< заголовок */
+	octet key_iv[32];			/*< ключ синхропосылок */
+	octet key_ae[32];			/*< ключ шифрования */
+} bcnt_st;
+
+size_t bcnt_keep()
+{
+	return sizeof(bcnt_st);
+}
+
+static err_t bcntStart(bcnt_st* s, const octet key[32])
+{
+	u32 chunk_size;
+	octet level[12];
+	err_t code;
+	// проверить заголовок
+	if (!memEq(s->header, "bcnt", 4) ||
+		s->header[4] != BCNT_VERSION ||
+		s->header[5] != BCNT_BELT_DWP && s->header[5] != BCNT_BASH_AE ||
+		!memIsZero(s->header + 6, 2) || !memIsZero(s->header + 12, 4))
+		return ERR_BAD_FORMAT;
+	u32From(&chunk_size, s->header + 8, 4);
+	if (chunk_size == 0 || chunk_size > BCNT_CHUNK_MAX)
+		return ERR_BAD_FORMAT;
+	// разобрать заголовок
+	s->alg = s->header[5];
+	s->chunk_size = (size_t)chunk_size;
+	s->tag_len = s->alg == BCNT_BELT_DWP ?
+		BCNT_BELT_DWP_TAG : BCNT_BASH_AE_TAG;
+	// K_iv <- beltKRP(K, <1>_8 || 0^88, S)
+	memSetZero(level, sizeof(level));
+	level[0] = 1;
+	code = beltKRP(s->key_iv, 32, key, 32, level, s->header + 16);
+	ERR_CALL_CHECK(code);
+	// K_ae <- beltKRP(K, <2>_8 || 0^88, S)
+	level[0] = 2;
+	return beltKRP(s->key_ae, 32, key, 32, level, s->header + 16);
+}
+
+err_t bcntEncrStart(void* state, octet header[BCNT_HDR_LEN], size_t alg,
+	size_t chunk_size, const octet key[32], gen_i rng, void* rng_state)
+{
+	bcnt_st* s = (bcnt_st*)state;
+	u32 len;
+	err_t code;
+	// проверить входные данные
+	if (alg != BCNT_BELT_DWP && alg != BCNT_BASH_AE ||
+		chunk_size == 0 || chunk_size > BCNT_CHUNK_MAX)
+		return ERR_BAD_PARAMS;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	if (!memIsValid(s, bcnt_keep()) || !memIsValid(header, BCNT_HDR_LEN) ||
+		!memIsValid(key, 32))
+		return ERR_BAD_INPUT;
+	// сформировать заголовок
+	memCopy(s->header, "bcnt", 4);
+	s->header[4] = BCNT_VERSION;
+	s->header[5] = (octet)alg;
+	memSetZero(s->header + 6, 10);
+	len = (u32)chunk_size;
+	u32To(s->header + 8, 4, &len);
+	rng(s->header + 16, 16, rng_state);
+	// построить ключ файла
+	code = bcntStart(s, key);
+	ERR_CALL_CHECK(code);
+	memCopy(header, s->header, BCNT_HDR_LEN);
+	return ERR_OK;
+}
+
+err_t bcntDecrStart(void* state, const octet header[BCNT_HDR_LEN],
+	const octet key[32])
+{
+	bcnt_st* s = (bcnt_st*)state;
+	if (!memIsValid(s, bcnt_keep()) || !memIsValid(header, BCNT_HDR_LEN) ||
+		!memIsValid(key, 32))
+		return ERR_BAD_INPUT;
+	memCopy(s->header, header, BCNT_HDR_LEN);
+	return bcntStart(s, key);
+}
+
+size_t bcntChunkSize(const void* state)
+{
+	const bcnt_st* s = (const bcnt_st*)state;
+	ASSERT(memIsValid(s, bcnt_keep()));
+	return s->chunk_size;
+}
+
+size_t bcntTagLen(const void* state)
+{
+	const bcnt_st* s = (const bcnt_st*)state;
+	ASSERT(memIsValid(s, bcnt_keep()));
+	return s->tag_len;
+}
+
+/*
+*******************************************************************************
+Защита фрагмента
+
+Функция bcntChunkStart() строит синхропосылку фрагмента и загружает
+в состояние алгоритма аутентифицированного шифрования открытые данные.
+Для belt-dwp имитовставка проверяется до расшифрования. Для bash-ae
+имитовставка определяется только после расшифрования, поэтому при ошибке
+открытые данные обнуляются.
+*******************************************************************************
+*/
+
+static size_t bcntChunk_deep()
+{
+	return beltKRP_keep() + MAX2(beltDWP_keep(), bashAE_keep());
+}
+
+static void bcntChunkStart(const bcnt_st* s, size_t index, bool_t final,
+	void* stack)
+{
+	octet level[12];
+	octet header[16];
+	octet iv[16];
+	octet ad[BCNT_HDR_LEN + 9];
+	size_t i;
+	void* state = (octet*)stack + beltKRP_keep();
+	// level <- <index>_64 || <final>_8 || 0^24
+	memSetZero(level, sizeof(level));
+	for (i = 0; i < MIN2(sizeof(size_t), 8); ++i)
+		level[i] = (octet)(index >> 8 * i);
+	level[8] = final ? 1 : 0;
+	// iv <- beltKRP(K_iv, level, 0^128)[:16]
+	memSetZero(header, sizeof(header));
+	beltKRPStart(stack, s->key_iv, 32, level);
+	beltKRPStepG(iv, 16, header, stack);
+	// ad <- header || <index>_64 || <final>_8
+	memCopy(ad, s->header, BCNT_HDR_LEN);
+	memCopy(ad + BCNT_HDR_LEN, level, 9);
+	// начать защиту
+	if (s->alg == BCNT_BELT_DWP)
+	{
+		beltDWPStart(state, s->key_ae, 32, iv);
+		beltDWPStepI(ad, sizeof(ad), state);
+	}
+	else
+	{
+		bashAEStart(state, s->key_ae, 32, iv, 16);
+		bashAEAbsorb(BASH_AE_DATA, ad, sizeof(ad), state);
+	}
+	memSetZero(iv, sizeof(iv));
+}
+
+static void bcntChunkEncr(octet dest[], const octet src[], size_t count,
+	size_t index, bool_t final, const bcnt_st* s, void* stack)
+{
+	void* state = (octet*)stack + beltKRP_keep();
+	bcntChunkStart(s, index, final, stack);
+	memCopy(dest, src, count);
+	if (s->alg == BCNT_BELT_DWP)
+	{
+		beltDWPStepE(dest, count, state);
+		beltDWPStepA(dest, count, state);
+		beltDWPStepG(dest + count, state);
+	}
+	else
+	{
+		bashAEEncr(dest, count, state);
+		bashAESqueeze(BASH_AE_MAC, dest + count, s->tag_len, state);
+	}
+}
+
+static bool_t bcntChunkDecr(octet dest[], const octet src[], size_t count,
+	size_t index, bool_t final, const bcnt_st* s, void* stack)
+{
+	void* state = (octet*)stack + beltKRP_keep();
+	octet tag[BCNT_BASH_AE_TAG];
+	bool_t ok;
+	bcntChunkStart(s, index, final, stack);
+	if (s->alg == BCNT_BELT_DWP)
+	{
+		beltDWPStepA(src, count, state);
+		if (!beltDWPStepV(src + count, state))
+		{
+			memSetZero(dest, count);
+			return FALSE;
+		}
+		memCopy(dest, src, count);
+		beltDWPStepD(dest, count, state);
+		return TRUE;
+	}
+	memCopy(dest, src, count);
+	bashAEDecr(dest, count, state);
+	bashAESqueeze(BASH_AE_MAC, tag, s->tag_len, state);
+	ok = memEq(tag, src + count, s->tag_len);
+	if (!ok)
+		memSetZero(dest, count);
+	return ok;
+}
+
+/*
+*******************************************************************************
+Параллельная обработка фрагментов
+
+Фрагменты распределяются между потоками по принципу "поток i обрабатывает
+фрагменты i, i + threads,...". Каждому потоку выделяется собственная
+память для состояний beltKRP и алгоритма аутентифицированного шифрования.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	const bcnt_st* s;		/*< состояние контейнера */
+	octet* dest;			/*< выходные данные */
+	const octet* src;		/*< входные данные */
+	size_t count;			/*< длина открытых данных */
+	size_t n;				/*< число фрагментов */
+	size_t index;			/*< номер первого фрагмента */
+	bool_t final;			/*< последний фрагмент входит в src? */
+	bool_t encr;			/*< зашифрование? */
+	size_t start;			/*< первый фрагмент задания */
+	size_t step;			/*< шаг по фрагментам */
+	bool_t ok;				/*< все фрагменты расшифрованы? */
+	void* stack;			/*< вспомогательная память */
+} bcnt_job;
+
+static void bcntRun(void* arg)
+{
+	bcnt_job* job = (bcnt_job*)arg;
+	const size_t cs = job->s->chunk_size;
+	const size_t tl = job->s->tag_len;
+	size_t i, len;
+	bool_t final;
+	for (i = job->start; i < job->n; i += job->step)
+	{
+		len = MIN2(cs, job->count - i * cs);
+		final = job->final && i + 1 == job->n;
+		if (job->encr)
+			bcntChunkEncr(job->dest + i * (cs + tl), job->src + i * cs,
+				len, job->index + i, final, job->s, job->stack);
+		else if (!bcntChunkDecr(job->dest + i * cs, job->src + i * (cs + tl),
+			len, job->index + i, final, job->s, job->stack))
+			job->ok = FALSE;
+	}
+}
+
+static err_t bcntExec(octet dest[], const octet src[], size_t count,
+	size_t n, size_t index, bool_t final, bool_t encr, const bcnt_st* s,
+	size_t threads)
+{
+	size_t i;
+	err_t code = ERR_OK;
+	void* stack;
+	bcnt_job* jobs;
+	// число потоков
+	threads = MIN2(MAX2(threads, 1), n);
+	// выделить память
+	stack = blobCreate(threads * (bcntChunk_deep() + sizeof(bcnt_job)));
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	jobs = (bcnt_job*)((octet*)stack + threads * bcntChunk_deep());
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].s = s;
+		jobs[i].dest = dest, jobs[i].src = src, jobs[i].count = count;
+		jobs[i].n = n, jobs[i].index = index;
+		jobs[i].final = final, jobs[i].encr = encr;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].ok = TRUE;
+		jobs[i].stack = (octet*)stack + i * bcntChunk_deep();
+	}
+	// выполнить задания
+	mtRunJobs(bcntRun, jobs, sizeof(bcnt_job), threads);
+	// результат
+	for (i = 0; i < threads; ++i)
+		if (!jobs[i].ok)
+			code = ERR_BAD_MAC;
+	// завершить
+	blobClose(stack);
+	return code;
+}
+
+err_t bcntEncr(octet dest[], const void* src, size_t count, size_t index,
+	bool_t final, const void* state, size_t threads)
+{
+	const bcnt_st* s = (const bcnt_st*)state;
+	size_t n;
+	// проверить входные данные
+	if (!memIsValid(s, bcnt_keep()) || !memIsValid(src, count))
+		return ERR_BAD_INPUT;
+	if (!final && (count == 0 || count % s->chunk_size))
+		return ERR_BAD_INPUT;
+	// число фрагментов
+	n = count ? (count - 1) / s->chunk_size + 1 : 1;
+	if (!memIsValid(dest, count + n * s->tag_len) ||
+		!memIsDisjoint2(dest, count + n * s->tag_len, src, count))
+		return ERR_BAD_INPUT;
+	// зашифровать
+	return bcntExec(dest, src, count, n, index, final, TRUE, s, threads);
+}
+
+err_t bcntDecr(void* dest, const octet src[], size_t count, size_t index,
+	bool_t final, const void* state, size_t threads)
+{
+	const bcnt_st* s = (const bcnt_st*)state;
+	size_t len, n;
+	// проверить входные данные
+	if (!memIsValid(s, bcnt_keep()) || !memIsValid(src, count))
+		return ERR_BAD_INPUT;
+	len = s->chunk_size + s->tag_len;
+	if (!final && (count == 0 || count % len) ||
+		final && (count == 0 || count % len && count % len < s->tag_len))
+		return ERR_BAD_INPUT;
+	// число фрагментов
+	n = (count - 1) / len + 1;
+	if (!memIsValid(dest, count - n * s->tag_len) ||
+		!memIsDisjoint2(dest, count - n * s->tag_len, src, count))
+		return ERR_BAD_INPUT;
+	// расшифровать
+	return bcntExec(dest, src, count - n * s->tag_len, n, index, final,
+		FALSE, s, threads);
+}
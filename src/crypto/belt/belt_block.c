@@ -375,6 +375,49 @@ void beltBlockEncr3(u32* a, u32* b, u32* c, u32* d, const u32 key[8])
 	E(a, b, c, d, key);
 }
 
+/*
+*******************************************************************************
+Зашифрование пары блоков
+
+Такты зашифрования двух блоков чередуются. Поскольку блоки обрабатываются
+независимо, процессор может совмещать обращения к таблицам H* для разных
+блоков. Регистры a, b, c, d размещаются в локальных переменных, что
+избавляет компилятор от перезагрузки данных из памяти после каждой записи
+(запись в блок могла бы изменить ключ).
+*******************************************************************************
+*/
+
+#define E_PAIR(a1, b1, c1, d1, K1, a2, b2, c2, d2, K2)\
+	R(a1, b1, c1, d1, K1, 1, subkey_e);\
+	R(a2, b2, c2, d2, K2, 1, subkey_e);\
+	R(b1, d1, a1, c1, K1, 2, subkey_e);\
+	R(b2, d2, a2, c2, K2, 2, subkey_e);\
+	R(d1, c1, b1, a1, K1, 3, subkey_e);\
+	R(d2, c2, b2, a2, K2, 3, subkey_e);\
+	R(c1, a1, d1, b1, K1, 4, subkey_e);\
+	R(c2, a2, d2, b2, K2, 4, subkey_e);\
+	R(a1, b1, c1, d1, K1, 5, subkey_e);\
+	R(a2, b2, c2, d2, K2, 5, subkey_e);\
+	R(b1, d1, a1, c1, K1, 6, subkey_e);\
+	R(b2, d2, a2, c2, K2, 6, subkey_e);\
+	R(d1, c1, b1, a1, K1, 7, subkey_e);\
+	R(d2, c2, b2, a2, K2, 7, subkey_e);\
+	R(c1, a1, d1, b1, K1, 8, subkey_e);\
+	R(c2, a2, d2, b2, K2, 8, subkey_e);\
+
+void beltBlockEncrPair(u32 block1[4], const u32 key1[8], u32 block2[4],
+	const u32 key2[8])
+{
+	u32 a1 = block1[0], b1 = block1[1], c1 = block1[2], d1 = block1[3];
+	u32 a2 = block2[0], b2 = block2[1], c2 = block2[2], d2 = block2[3];
+	ASSERT(memIsDisjoint2(block1, 16, block2, 16));
+	E_PAIR(&a1, &b1, &c1, &d1, key1, &a2, &b2, &c2, &d2, key2);
+	// окончательная перестановка abcd -> bdac
+	block1[0] = b1, block1[1] = d1, block1[2] = a1, block1[3] = c1;
+	block2[0] = b2, block2[1] = d2, block2[2] = a2, block2[3] = c2;
+	a1 = b1 = c1 = d1 = a2 = b2 = c2 = d2 = 0;
+}
+
 /*
 *******************************************************************************
 Расшифрование блока
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.12.18
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -92,6 +92,44 @@ void beltCTRStepE(void* buf, size_t count, void* state)
 	}
 }
 
+void beltCTRStepEPair(void* buf1, size_t count1, void* state1,
+	void* buf2, size_t count2, void* state2)
+{
+	belt_ctr_st* s1 = (belt_ctr_st*)state1;
+	belt_ctr_st* s2 = (belt_ctr_st*)state2;
+	size_t t;
+	ASSERT(memIsDisjoint2(buf1, count1, state1, beltCTR_keep()));
+	ASSERT(memIsDisjoint2(buf2, count2, state2, beltCTR_keep()));
+	ASSERT(memIsDisjoint2(state1, beltCTR_keep(), state2, beltCTR_keep()));
+	// израсходовать резервы гаммы
+	t = MIN2(s1->reserved, count1);
+	beltCTRStepE(buf1, t, state1);
+	buf1 = (octet*)buf1 + t, count1 -= t;
+	t = MIN2(s2->reserved, count2);
+	beltCTRStepE(buf2, t, state2);
+	buf2 = (octet*)buf2 + t, count2 -= t;
+	// цикл по парам полных блоков
+	while (count1 >= 16 && count2 >= 16)
+	{
+		beltBlockIncU32(s1->ctr);
+		beltBlockIncU32(s2->ctr);
+		beltBlockCopy(s1->block, s1->ctr);
+		beltBlockCopy(s2->block, s2->ctr);
+		beltBlockEncrPair((u32*)s1->block, s1->key, (u32*)s2->block, s2->key);
+#if (OCTET_ORDER == BIG_ENDIAN)
+		beltBlockRevU32(s1->block);
+		beltBlockRevU32(s2->block);
+#endif
+		beltBlockXor2(buf1, s1->block);
+		beltBlockXor2(buf2, s2->block);
+		buf1 = (octet*)buf1 + 16, count1 -= 16;
+		buf2 = (octet*)buf2 + 16, count2 -= 16;
+	}
+	// остатки
+	beltCTRStepE(buf1, count1, state1);
+	beltCTRStepE(buf2, count2, state2);
+}
+
 err_t beltCTR(void* dest, const void* src, size_t count,
 	const octet key[], size_t len, const octet iv[16])
 {
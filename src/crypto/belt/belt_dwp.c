@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.12.18
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -298,3 +298,107 @@ err_t beltDWPUnwrap(void* dest, const void* src1, size_t count1,
 	return ERR_OK;
 }
 
+/*
+*******************************************************************************
+Пакетная обработка (burst)
+
+Пакеты разных сессий обрабатываются совместно. Гамма CTR для пар пакетов
+вырабатывается функцией beltCTRStepEPair(): такты зашифрования счетчиков
+двух сессий чередуются. Имитовставки вычисляются для каждого пакета
+отдельно: умножения в GF(2^128) внутри пакета связаны цепочкой
+зависимостей, а совмещение умножений разных пакетов через обращения
+к beltDWPStepA() не дает выигрыша.
+
+При снятии защиты пакет расшифровывается только после проверки
+имитовставки. Пары составляются из пакетов, которые прошли проверку.
+*******************************************************************************
+*/
+
+static bool_t beltDWPBurstIsValid(void* bufs[], const size_t counts[],
+	const void* hdrs[], const size_t hdr_counts[], void* states[],
+	size_t num)
+{
+	size_t j;
+	if (!memIsValid(bufs, num * sizeof(void*)) ||
+		!memIsValid(counts, num * sizeof(size_t)) ||
+		!memIsNullOrValid(hdrs, num * sizeof(void*)) ||
+		hdrs && !memIsValid(hdr_counts, num * sizeof(size_t)) ||
+		!memIsValid(states, num * sizeof(void*)))
+		return FALSE;
+	for (j = 0; j < num; ++j)
+		if (!memIsValid(states[j], beltDWP_keep()) ||
+			!memIsValid(bufs[j], counts[j]) ||
+			hdrs && !memIsValid(hdrs[j], hdr_counts[j]))
+			return FALSE;
+	return TRUE;
+}
+
+err_t beltDWPWrapBurst(void* bufs[], const size_t counts[],
+	const void* hdrs[], const size_t hdr_counts[], octet macs[],
+	void* states[], size_t num)
+{
+	size_t j;
+	// проверить входные данные
+	if (num > SIZE_MAX / 8 ||
+		!beltDWPBurstIsValid(bufs, counts, hdrs, hdr_counts, states, num) ||
+		!memIsValid(macs, 8 * num))
+		return ERR_BAD_INPUT;
+	// обработать открытые данные
+	if (hdrs)
+		for (j = 0; j < num; ++j)
+			beltDWPStepI(hdrs[j], hdr_counts[j], states[j]);
+	// зашифровать парами
+	for (j = 0; j + 1 < num; j += 2)
+		beltCTRStepEPair(bufs[j], counts[j], states[j],
+			bufs[j + 1], counts[j + 1], states[j + 1]);
+	if (j < num)
+		beltDWPStepE(bufs[j], counts[j], states[j]);
+	// выработать имитовставки
+	for (j = 0; j < num; ++j)
+	{
+		beltDWPStepA(bufs[j], counts[j], states[j]);
+		beltDWPStepG(macs + 8 * j, states[j]);
+	}
+	return ERR_OK;
+}
+
+err_t beltDWPUnwrapBurst(void* bufs[], const size_t counts[],
+	const void* hdrs[], const size_t hdr_counts[], const octet macs[],
+	void* states[], size_t num, bool_t oks[])
+{
+	size_t j, p;
+	err_t code = ERR_OK;
+	// проверить входные данные
+	if (num > SIZE_MAX / 8 ||
+		!beltDWPBurstIsValid(bufs, counts, hdrs, hdr_counts, states, num) ||
+		!memIsValid(macs, 8 * num) ||
+		!memIsNullOrValid(oks, num * sizeof(bool_t)))
+		return ERR_BAD_INPUT;
+	// проверить имитовставки и расшифровать парами
+	for (j = 0, p = SIZE_MAX; j < num; ++j)
+	{
+		bool_t ok;
+		if (hdrs)
+			beltDWPStepI(hdrs[j], hdr_counts[j], states[j]);
+		beltDWPStepA(bufs[j], counts[j], states[j]);
+		ok = beltDWPStepV(macs + 8 * j, states[j]);
+		if (oks)
+			oks[j] = ok;
+		if (!ok)
+		{
+			memSetZero(bufs[j], counts[j]);
+			code = ERR_BAD_MAC;
+		}
+		else if (p == SIZE_MAX)
+			p = j;
+		else
+		{
+			beltCTRStepEPair(bufs[p], counts[p], states[p],
+				bufs[j], counts[j], states[j]);
+			p = SIZE_MAX;
+		}
+	}
+	if (p != SIZE_MAX)
+		beltDWPStepD(bufs[p], counts[p], states[p]);
+	return code;
+}
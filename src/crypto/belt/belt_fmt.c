@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2017.09.28
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,6 +14,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/u16.h"
 #include "bee2/core/u32.h"
 #include "bee2/core/util.h"
@@ -175,14 +176,33 @@ void belt32BlockEncr(octet block[24], const u32 key[8])
 /*
 *******************************************************************************
 Конвертации
+
+Цифры обрабатываются порциями по k штук, где k -- максимальное число,
+для которого modk = mod^k умещается в машинное слово. Порция цифр
+переводится в слово (слово -- в порцию цифр) обычной арифметикой,
+а длинное число умножается на modk (делится на modk с остатком) один раз
+на порцию. Без порций на каждую цифру приходилось одно умножение (одно
+взятие остатка и одно деление) длинного числа.
+
+Длина строк не превосходит 600, длина чисел -- 75 64-битовых слов.
+На таких длинах алгоритмы "разделяй и властвуй" не дают выигрыша.
 *******************************************************************************
 */
 
-static void beltStr2Bin(octet bin[], size_t b, u32 mod, 
+static size_t beltFMTCalcK(word* modk, u32 mod)
+{
+	size_t k = 1;
+	ASSERT(2 <= mod && mod < 65536);
+	for (*modk = (word)mod; *modk <= WORD_MAX / mod; *modk *= mod, ++k);
+	return k;
+}
+
+static void beltStr2Bin(octet bin[], size_t b, u32 mod, size_t k, word modk,
 	const u16 str[], size_t count)
 {
 	word* a;
-	size_t m;
+	size_t m, t, i;
+	register word v;
 	// подготовить память
 	memSetZero(bin, 8 * b);
 	// особый случай: mod может не уложиться в word
@@ -194,26 +214,32 @@ static void beltStr2Bin(octet bin[], size_t b, u32 mod,
 	// конвертировать
 	ASSERT(2 <= mod && mod < 65536);
 	ASSERT(count >= 1);
-	--count;
-	EXPECT(str[count] < mod);
 	a = (word*)bin;
 	m = W_OF_O(8 * b);
-	a[0] = (word)str[count];
-	while (count--)
+	for (t = (count - 1) % k + 1; count; count -= t, t = k)
 	{
-		zzMulW(a, a, m, mod);
-		EXPECT(str[count] < mod);
-		zzAddW2(a, m, (word)str[count]);
+		// v <- str[count - 1] mod^{t - 1} + ... + str[count - t]
+		for (v = 0, i = count; i > count - t;)
+		{
+			--i;
+			EXPECT(str[i] < mod);
+			v = v * mod + str[i];
+		}
+		// a <- a * mod^t + v (t < k только для первой порции, a = 0)
+		zzMulW(a, a, m, modk);
+		zzAddW2(a, m, v);
 	}
 	wwTo(bin, 8 * b, a);
+	v = 0;
 }
 
-static void beltBin2StrAdd(u32 mod, u16 str[], size_t count, 
-	octet bin[], size_t b)
+static void beltBin2StrAdd(u32 mod, size_t k, word modk, u16 str[], 
+	size_t count, octet bin[], size_t b)
 {
 	register u32 t;
+	register word r;
 	word* a;
-	size_t m;
+	size_t m, i;
 	// особый случай: mod может не уложиться в word
 	if (mod == 65536)
 	{
@@ -229,22 +255,26 @@ static void beltBin2StrAdd(u32 mod, u16 str[], size_t count,
 	wwFrom(a, bin, 8 * b);
 	// конвертировать и сложить
 	ASSERT(2 <= mod && mod < 65536);
-	while (count--)
+	while (count)
 	{
-		t = (u32)zzModW(a, m, mod);
-		t += str[0], t %= mod;
-		str[0] = (u16)t, ++str;
-		zzDivW(a, a, m, mod);
+		r = zzDivW(a, a, m, modk);
+		for (i = MIN2(k, count), count -= i; i--; r /= mod)
+		{
+			t = (u32)(r % mod);
+			t += str[0], t %= mod;
+			str[0] = (u16)t, ++str;
+		}
 	}
-	t = 0;
+	t = 0, r = 0;
 }
 
-static void beltBin2StrSub(word mod, u16 str[], size_t count, 
-	octet bin[], size_t b)
+static void beltBin2StrSub(word mod, size_t k, word modk, u16 str[], 
+	size_t count, octet bin[], size_t b)
 {
 	register u32 t;
+	register word r;
 	word* a;
-	size_t m;
+	size_t m, i;
 	// особый случай: mod может не уложиться в word
 	if (mod == 65536)
 	{
@@ -260,14 +290,17 @@ static void beltBin2StrSub(word mod, u16 str[], size_t count,
 	wwFrom(a, bin, 8 * b);
 	// конвертировать и вычесть
 	ASSERT(2 <= mod && mod <= 65536);
-	while (count--)
+	while (count)
 	{
-		t = (u32)zzModW(a, m, mod);
-		t = str[0] + mod - t, t %= mod;
-		str[0] = (u16)t, ++str;
-		zzDivW(a, a, m, mod);
+		r = zzDivW(a, a, m, modk);
+		for (i = MIN2(k, count), count -= i; i--; r /= mod)
+		{
+			t = (u32)(r % mod);
+			t = str[0] + (u32)mod - t, t %= mod;
+			str[0] = (u16)t, ++str;
+		}
 	}
-	t = 0;
+	t = 0, r = 0;
 }
 
 /*
@@ -287,6 +320,8 @@ typedef struct
 {
 	belt_wbl_st wbl[1];		/*< состояние механизма WBL */
 	u32 mod;				/*< модуль */
+	size_t k;				/*< число цифр в порции */
+	word modk;				/*< mod^k */
 	size_t n1;				/*< длина левой половинки */
 	size_t n2;				/*< длина правой половинки */
 	size_t b1;				/*< число блоков для обработки левой половинки */
@@ -312,6 +347,10 @@ void beltFMTStart(void* state, u32 mod, size_t count, const octet key[],
 	// инициализировать состояние
 	beltWBLStart(s->wbl, key, len);
 	s->mod = mod;
+	if (mod < 65536)
+		s->k = beltFMTCalcK(&s->modk, mod);
+	else
+		s->k = 1, s->modk = 0;
 	s->n1 = (count + 1) / 2;
 	s->n2 = count / 2;
 	s->b1 = beltFMTCalcB(mod, s->n1);
@@ -343,7 +382,8 @@ void beltFMTStepE(u16 buf[], const octet iv[16], void* state)
 	for (i = 0; i < 3; ++i)
 	{
 		// первая половинка
-		beltStr2Bin(s->buf, s->b2, s->mod, buf + s->n1, s->n2);
+		beltStr2Bin(s->buf, s->b2, s->mod, s->k, s->modk,
+			buf + s->n1, s->n2);
 		memCopy(s->buf + s->b2 * 8, beltH() + 8 * i, 4);
 		memCopy(s->buf + s->b2 * 8 + 4, s->iv + 8 * i, 4);
 		if (s->b2 == 1)
@@ -352,9 +392,11 @@ void beltFMTStepE(u16 buf[], const octet iv[16], void* state)
 			belt32BlockEncr(s->buf, s->wbl->key);
 		else
 			beltWBLStepE(s->buf, 8 * s->b2 + 8, s->wbl);
-		beltBin2StrAdd(s->mod, buf, s->n1, s->buf, s->b2 + 1);
+		beltBin2StrAdd(s->mod, s->k, s->modk,
+			buf, s->n1, s->buf, s->b2 + 1);
 		// вторая половинка
-		beltStr2Bin(s->buf, s->b1, s->mod, buf, s->n1);
+		beltStr2Bin(s->buf, s->b1, s->mod, s->k, s->modk,
+			buf, s->n1);
 		memCopy(s->buf + s->b1 * 8, beltH() + 8 * i + 4, 4);
 		memCopy(s->buf + s->b1 * 8 + 4, s->iv + 8 * i + 4, 4);
 		if (s->b1 == 1)
@@ -363,7 +405,8 @@ void beltFMTStepE(u16 buf[], const octet iv[16], void* state)
 			belt32BlockEncr(s->buf, s->wbl->key);
 		else
 			beltWBLStepE(s->buf, 8 * s->b1 + 8, s->wbl);
-		beltBin2StrAdd(s->mod, buf + s->n1, s->n2, s->buf, s->b1 + 1);
+		beltBin2StrAdd(s->mod, s->k, s->modk,
+			buf + s->n1, s->n2, s->buf, s->b1 + 1);
 	}
 }
 
@@ -384,7 +427,8 @@ void beltFMTStepD(u16 buf[], const octet iv[16], void* state)
 	for (i = 3; i--;)
 	{
 		// вторая половинка
-		beltStr2Bin(s->buf, s->b1, s->mod, buf, s->n1);
+		beltStr2Bin(s->buf, s->b1, s->mod, s->k, s->modk,
+			buf, s->n1);
 		memCopy(s->buf + s->b1 * 8, beltH() + 8 * i + 4, 4);
 		memCopy(s->buf + s->b1 * 8 + 4, s->iv + 8 * i + 4, 4);
 		if (s->b1 == 1)
@@ -393,9 +437,11 @@ void beltFMTStepD(u16 buf[], const octet iv[16], void* state)
 			belt32BlockEncr(s->buf, s->wbl->key);
 		else
 			beltWBLStepE(s->buf, 8 * s->b1 + 8, s->wbl);
-		beltBin2StrSub(s->mod, buf + s->n1, s->n2, s->buf, s->b1 + 1);
+		beltBin2StrSub(s->mod, s->k, s->modk,
+			buf + s->n1, s->n2, s->buf, s->b1 + 1);
 		// первая половинка
-		beltStr2Bin(s->buf, s->b2, s->mod, buf + s->n1, s->n2);
+		beltStr2Bin(s->buf, s->b2, s->mod, s->k, s->modk,
+			buf + s->n1, s->n2);
 		memCopy(s->buf + s->b2 * 8, beltH() + 8 * i, 4);
 		memCopy(s->buf + s->b2 * 8 + 4, s->iv + 8 * i, 4);
 		if (s->b2 == 1)
@@ -404,7 +450,8 @@ void beltFMTStepD(u16 buf[], const octet iv[16], void* state)
 			belt32BlockEncr(s->buf, s->wbl->key);
 		else
 			beltWBLStepE(s->buf, 8 * s->b2 + 8, s->wbl);
-		beltBin2StrSub(s->mod, buf, s->n1, s->buf, s->b2 + 1);
+		beltBin2StrSub(s->mod, s->k, s->modk,
+			buf, s->n1, s->buf, s->b2 + 1);
 	}	
 }
 
@@ -463,3 +510,100 @@ err_t beltFMTDecr(u16 dest[], u32 mod, const u16 src[], size_t count,
 	blobClose(state);
 	return ERR_OK;
 }
+
+/*
+*******************************************************************************
+Пакетное шифрование в режиме FMT
+
+Строки распределяются между потоками по принципу "поток i обрабатывает
+строки i, i + threads,...". Каждому потоку выделяется собственное
+состояние FMT.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	u16* buf;				/*< строки */
+	size_t count;			/*< длина строки */
+	size_t num;				/*< число строк */
+	const octet* iv;		/*< синхропосылки */
+	bool_t encr;			/*< зашифрование? */
+	size_t start;			/*< первая строка задания */
+	size_t step;			/*< шаг по строкам */
+	void* state;			/*< состояние FMT */
+} belt_fmt_job;
+
+static void beltFMTRun(void* arg)
+{
+	belt_fmt_job* job = (belt_fmt_job*)arg;
+	size_t i;
+	for (i = job->start; i < job->num; i += job->step)
+		if (job->encr)
+			beltFMTStepE(job->buf + i * job->count,
+				job->iv ? job->iv + 16 * i : 0, job->state);
+		else
+			beltFMTStepD(job->buf + i * job->count,
+				job->iv ? job->iv + 16 * i : 0, job->state);
+}
+
+static err_t beltFMTExec(u16 dest[], u32 mod, const u16 src[], size_t count,
+	size_t num, const octet key[], size_t len, const octet iv[], bool_t encr,
+	size_t threads)
+{
+	size_t keep, i;
+	void* stack;
+	belt_fmt_job* jobs;
+	// проверить входные данные
+	if (count < 2 ||
+		len != 16 && len != 24 && len != 32 ||
+		num > SIZE_MAX / 32 / count ||
+		!memIsValid(src, 2 * count * num) ||
+		!memIsNullOrValid(iv, 16 * num) ||
+		!memIsValid(key, len) ||
+		!memIsValid(dest, 2 * count * num) ||
+		iv && !memIsDisjoint2(dest, 2 * count * num, iv, 16 * num))
+		return ERR_BAD_INPUT;
+	if (count > 600)
+		return ERR_NOT_IMPLEMENTED;
+	if (num == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MIN2(MAX2(threads, 1), num);
+	// выделить память
+	keep = beltFMT_keep(mod, count);
+	stack = blobCreate(threads * (keep + sizeof(belt_fmt_job)));
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	jobs = (belt_fmt_job*)((octet*)stack + threads * keep);
+	// подготовить задания
+	memMove(dest, src, 2 * count * num);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].buf = dest, jobs[i].count = count, jobs[i].num = num;
+		jobs[i].iv = iv, jobs[i].encr = encr;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].state = (octet*)stack + i * keep;
+		beltFMTStart(jobs[i].state, mod, count, key, len);
+	}
+	// выполнить задания
+	mtRunJobs(beltFMTRun, jobs, sizeof(belt_fmt_job), threads);
+	// завершить
+	blobClose(stack);
+	return ERR_OK;
+}
+
+err_t beltFMTEncrBatch(u16 dest[], u32 mod, const u16 src[], size_t count,
+	size_t num, const octet key[], size_t len, const octet iv[],
+	size_t threads)
+{
+	return beltFMTExec(dest, mod, src, count, num, key, len, iv, TRUE,
+		threads);
+}
+
+err_t beltFMTDecrBatch(u16 dest[], u32 mod, const u16 src[], size_t count,
+	size_t num, const octet key[], size_t len, const octet iv[],
+	size_t threads)
+{
+	return beltFMTExec(dest, mod, src, count, num, key, len, iv, FALSE,
+		threads);
+}
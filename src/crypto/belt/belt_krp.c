@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.12.18
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,6 +14,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/u32.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/belt.h"
@@ -94,3 +95,161 @@ err_t beltKRP(octet dest[], size_t m, const octet src[], size_t n,
 	blobClose(state);
 	return ERR_OK;
 }
+
+/*
+*******************************************************************************
+Пакетное преобразование ключа
+
+Ключи распределяются между потоками парами: поток i обрабатывает пары
+i, i + threads,... Для ключей пары функция belt-compr2 вычисляется
+одновременно: три зашифрования belt-compr2 выполняются функцией
+beltBlockEncrPair() для первого и второго ключей. Непарный последний ключ
+строится с помощью beltCompr().
+
+В belt-compr2 первоначальный ключ (h0 || h1) играет роль состояния,
+а блок r || level || header -- роль данных X:
+	S <- beltBlock(h0 + h1, X) + h0 + h1,
+	Y0 <- beltBlock(X0, S || h1) + X0,
+	Y1 <- beltBlock(X1, ~S || h0) + X1.
+Все зашифрования выполняются на ключах, которые зависят от header.
+Поэтому общая для пакета часть вычислений сводится к форматированию
+первоначального ключа.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	u32 X[2][8];			/*< блоки r || level || header */
+	u32 S[2][4];			/*< блоки S */
+	u32 K1[2][8];			/*< ключи S || h1 */
+	u32 K2[2][8];			/*< ключи ~S || h0 */
+	u32 Y[2][8];			/*< преобразованные ключи */
+	octet stack[];			/*< стек beltCompr */
+} belt_krp_pair_st;
+
+static size_t beltKRPPair_keep()
+{
+	return sizeof(belt_krp_pair_st) + beltCompr_deep();
+}
+
+typedef struct
+{
+	octet* dest;			/*< преобразованные ключи */
+	size_t m;				/*< длина преобразованного ключа */
+	size_t n;				/*< длина первоначального ключа */
+	const u32* key;			/*< форматированный первоначальный ключ */
+	const octet* levels;	/*< уровни */
+	const octet* headers;	/*< заголовки */
+	size_t num;				/*< число ключей */
+	size_t start;			/*< первая пара задания */
+	size_t step;			/*< шаг по парам */
+	void* stack;			/*< вспомогательная память */
+} belt_krp_job;
+
+static void beltKRPComprPair(const u32 key[8], void* state)
+{
+	belt_krp_pair_st* s = (belt_krp_pair_st*)state;
+	size_t j, t;
+	// S_j <- beltBlock(h0 + h1, X_j) + h0 + h1
+	for (j = 0; j < 2; ++j)
+		for (t = 0; t < 4; ++t)
+			s->S[j][t] = key[t] ^ key[t + 4];
+	beltBlockEncrPair(s->S[0], s->X[0], s->S[1], s->X[1]);
+	for (j = 0; j < 2; ++j)
+		for (t = 0; t < 4; ++t)
+		{
+			s->S[j][t] ^= key[t] ^ key[t + 4];
+			// K1_j <- S_j || h1, K2_j <- ~S_j || h0
+			s->K1[j][t] = s->S[j][t], s->K1[j][t + 4] = key[t + 4];
+			s->K2[j][t] = ~s->S[j][t], s->K2[j][t + 4] = key[t];
+		}
+	// Y_j <- X_j
+	for (j = 0; j < 2; ++j)
+		for (t = 0; t < 8; ++t)
+			s->Y[j][t] = s->X[j][t];
+	// Y_j0 <- beltBlock(X_j0, K1_j) + X_j0
+	beltBlockEncrPair(s->Y[0], s->K1[0], s->Y[1], s->K1[1]);
+	// Y_j1 <- beltBlock(X_j1, K2_j) + X_j1
+	beltBlockEncrPair(s->Y[0] + 4, s->K2[0], s->Y[1] + 4, s->K2[1]);
+	for (j = 0; j < 2; ++j)
+		for (t = 0; t < 8; ++t)
+			s->Y[j][t] ^= s->X[j][t];
+}
+
+static void beltKRPRun(void* arg)
+{
+	belt_krp_job* job = (belt_krp_job*)arg;
+	belt_krp_pair_st* s = (belt_krp_pair_st*)job->stack;
+	const octet* r = beltH() + 4 * (job->n - 16) + 2 * (job->m - 16);
+	size_t i, j;
+	for (i = 2 * job->start; i < job->num; i += 2 * job->step)
+	{
+		// X_j <- r || level_j || header_j
+		for (j = 0; j < 2 && i + j < job->num; ++j)
+		{
+			u32From(s->X[j], r, 4);
+			u32From(s->X[j] + 1, job->levels + 12 * (i + j), 12);
+			u32From(s->X[j] + 4, job->headers + 16 * (i + j), 16);
+		}
+		// применить belt-compr2
+		if (j == 2)
+			beltKRPComprPair(job->key, s);
+		else
+		{
+			memCopy(s->Y[0], job->key, 32);
+			beltCompr(s->Y[0], s->X[0], s->stack);
+		}
+		// выгрузить ключи
+		while (j--)
+			u32To(job->dest + job->m * (i + j), job->m, s->Y[j]);
+	}
+}
+
+err_t beltKRPBatch(octet dest[], size_t m, const octet src[], size_t n,
+	const octet levels[], const octet headers[], size_t num, size_t threads)
+{
+	size_t i;
+	void* stack;
+	u32* key;
+	belt_krp_job* jobs;
+	// проверить входные данные
+	if (m > n ||
+		m != 16 && m != 24 && m != 32 ||
+		n != 16 && n != 24 && n != 32 ||
+		num > SIZE_MAX / 32 ||
+		!memIsValid(src, n) ||
+		!memIsValid(levels, 12 * num) ||
+		!memIsValid(headers, 16 * num) ||
+		!memIsValid(dest, m * num) ||
+		!memIsDisjoint2(dest, m * num, levels, 12 * num) ||
+		!memIsDisjoint2(dest, m * num, headers, 16 * num))
+		return ERR_BAD_INPUT;
+	if (num == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MIN2(MAX2(threads, 1), (num + 1) / 2);
+	// выделить память
+	stack = blobCreate(32 + threads * (beltKRPPair_keep() +
+		sizeof(belt_krp_job)));
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	key = (u32*)stack;
+	jobs = (belt_krp_job*)((octet*)stack + 32 +
+		threads * beltKRPPair_keep());
+	// форматировать ключ
+	beltKeyExpand2(key, src, n);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].dest = dest, jobs[i].m = m, jobs[i].n = n;
+		jobs[i].key = key, jobs[i].num = num;
+		jobs[i].levels = levels, jobs[i].headers = headers;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + 32 + i * beltKRPPair_keep();
+	}
+	// выполнить задания
+	mtRunJobs(beltKRPRun, jobs, sizeof(belt_krp_job), threads);
+	// завершить
+	blobClose(stack);
+	return ERR_OK;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.12.18
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,6 +14,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/belt.h"
 #include "belt_lcl.h"
@@ -88,3 +89,92 @@ err_t beltKWPUnwrap(octet dest[], const octet src[], size_t count,
 	blobClose(state);
 	return ERR_OK;
 }
+
+/*
+*******************************************************************************
+Пакетная установка защиты
+
+Ключи распределяются между потоками парами: поток i обрабатывает пары
+i, i + threads,... Ключи пары зашифровываются одновременно функцией
+beltWBLStepEPair(), непарный последний ключ -- функцией beltKWPStepE().
+Каждому потоку выделяется собственное состояние KWP. Расписание ключа
+защиты строится один раз и копируется в состояния потоков.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	octet* dest;			/*< защищенные ключи */
+	size_t count;			/*< длина ключа */
+	size_t num;				/*< число ключей */
+	size_t start;			/*< первая пара задания */
+	size_t step;			/*< шаг по парам */
+	void* state;			/*< состояние KWP */
+} belt_kwp_job;
+
+static void beltKWPRun(void* arg)
+{
+	belt_kwp_job* job = (belt_kwp_job*)arg;
+	const size_t len = job->count + 16;
+	size_t i;
+	for (i = 2 * job->start; i < job->num; i += 2 * job->step)
+		if (i + 1 < job->num)
+			beltWBLStepEPair(job->dest + i * len, job->dest + (i + 1) * len,
+				len, job->state);
+		else
+			beltKWPStepE(job->dest + i * len, len, job->state);
+}
+
+err_t beltKWPWrapBatch(octet dest[], const octet src[], size_t count,
+	size_t num, const octet headers[], const octet key[], size_t len,
+	size_t threads)
+{
+	size_t i;
+	void* stack;
+	belt_kwp_job* jobs;
+	// проверить входные данные
+	if (count < 16 ||
+		len != 16 && len != 24 && len != 32 ||
+		num > SIZE_MAX / 2 / (count + 16) ||
+		!memIsValid(src, count * num) ||
+		!memIsNullOrValid(headers, 16 * num) ||
+		!memIsValid(key, len) ||
+		!memIsValid(dest, (count + 16) * num) ||
+		!memIsDisjoint2(dest, (count + 16) * num, src, count * num) ||
+		headers && !memIsDisjoint2(dest, (count + 16) * num, headers,
+			16 * num))
+		return ERR_BAD_INPUT;
+	if (num == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MIN2(MAX2(threads, 1), (num + 1) / 2);
+	// выделить память
+	stack = blobCreate(threads * (beltKWP_keep() + sizeof(belt_kwp_job)));
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	jobs = (belt_kwp_job*)((octet*)stack + threads * beltKWP_keep());
+	// подготовить ключи: dest_i <- src_i || header_i
+	for (i = 0; i < num; ++i)
+	{
+		memCopy(dest + i * (count + 16), src + i * count, count);
+		if (headers)
+			memCopy(dest + i * (count + 16) + count, headers + 16 * i, 16);
+		else
+			memSetZero(dest + i * (count + 16) + count, 16);
+	}
+	// подготовить задания
+	beltKWPStart(stack, key, len);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].dest = dest, jobs[i].count = count, jobs[i].num = num;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].state = (octet*)stack + i * beltKWP_keep();
+		if (i)
+			memCopy(jobs[i].state, stack, beltKWP_keep());
+	}
+	// выполнить задания
+	mtRunJobs(beltKWPRun, jobs, sizeof(belt_kwp_job), threads);
+	// завершить
+	blobClose(stack);
+	return ERR_OK;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.12.18
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -230,6 +230,46 @@ typedef struct
 void beltBlockAddBitSizeU32(u32 block[4], size_t count);
 void beltHalfBlockAddBitSizeW(word block[W_OF_B(64)], size_t count);
 
+/*
+*******************************************************************************
+Зашифрование пары блоков
+
+Блоки block1 и block2 зашифровываются на ключах key1 и key2 соответственно.
+Такты зашифрования чередуются. Ключи могут совпадать.
+*******************************************************************************
+*/
+
+void beltBlockEncrPair(u32 block1[4], const u32 key1[8], u32 block2[4],
+	const u32 key2[8]);
+
+/*
+*******************************************************************************
+Зашифрование пары буферов в режиме WBL
+
+Буферы [count]buf1 и [count]buf2 зашифровываются на ключе, установленном
+в state функцией beltWBLStart(). Такты зашифрования буферов совмещаются
+с помощью beltBlockEncrPair(). Результат совпадает с результатом двух
+обращений к beltWBLStepE().
+*******************************************************************************
+*/
+
+void beltWBLStepEPair(void* buf1, void* buf2, size_t count, void* state);
+
+/*
+*******************************************************************************
+Зашифрование пары буферов в режиме CTR
+
+Буферы [count1]buf1 и [count2]buf2 зашифровываются на состояниях state1
+и state2 функций CTR (в том числе на состояниях DWP, которые начинаются
+с состояний CTR). Гамма для полных блоков вырабатывается парами
+с помощью beltBlockEncrPair(). Результат совпадает с результатом
+обращений к beltCTRStepE() для каждого буфера.
+*******************************************************************************
+*/
+
+void beltCTRStepEPair(void* buf1, size_t count1, void* state1,
+	void* buf2, size_t count2, void* state2);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2017.11.03
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -50,40 +50,81 @@ void beltWBLStart(void* state, const octet key[], size_t len)
 	s->round = 0;
 }
 
-void beltWBLStepEBase(void* buf, size_t count, void* state)
+static void beltWBLStepEBufs(void* buf1, void* buf2, size_t count, 
+	void* state)
 {
 	belt_wbl_st* s = (belt_wbl_st*)state;
 	word n = ((word)count + 15) / 16;
+	octet* bufs[2];
+	octet* blocks[2];
+	size_t m, j;
 	ASSERT(count >= 32);
-	ASSERT(memIsDisjoint2(buf, count, state, beltWBL_keep()));
-	ASSERT(s->round % (2 * n) == 0);
+	// второй буфер (если есть) обрабатывается с использованием s->sum
+	bufs[0] = (octet*)buf1, blocks[0] = s->block;
+	bufs[1] = (octet*)buf2, blocks[1] = s->sum;
+	m = buf2 ? 2 : 1;
 	do
 	{
 		size_t i;
-		// block <- r1 + ... + r_{n-1}
-		beltBlockCopy(s->block, buf);
-		for (i = 16; i + 16 < count; i += 16)
-			beltBlockXor2(s->block, (octet*)buf + i);
-		// r <- ShLo^128(r)
-		memMove(buf, (octet*)buf + 16, count - 16);
-		// r* <- block
-		beltBlockCopy((octet*)buf + count - 16, s->block);
-		// block <- beltBlockEncr(block) + <round>
-		beltBlockEncr(s->block, s->key);
+		for (j = 0; j < m; ++j)
+		{
+			// block <- r1 + ... + r_{n-1}
+			beltBlockCopy(blocks[j], bufs[j]);
+			for (i = 16; i + 16 < count; i += 16)
+				beltBlockXor2(blocks[j], bufs[j] + i);
+			// r <- ShLo^128(r)
+			memMove(bufs[j], bufs[j] + 16, count - 16);
+			// r* <- block
+			beltBlockCopy(bufs[j] + count - 16, blocks[j]);
+		}
+		// block <- beltBlockEncr(block)
+		if (buf2)
+		{
+#if (OCTET_ORDER == BIG_ENDIAN)
+			beltBlockRevU32(s->block);
+			beltBlockRevU32(s->sum);
+#endif
+			beltBlockEncrPair((u32*)s->block, s->key, (u32*)s->sum, s->key);
+#if (OCTET_ORDER == BIG_ENDIAN)
+			beltBlockRevU32(s->block);
+			beltBlockRevU32(s->sum);
+#endif
+		}
+		else
+			beltBlockEncr(s->block, s->key);
+		// block <- block + <round>
 		s->round++;
-#if (OCTET_ORDER == LITTLE_ENDIAN)
-		memXor2(s->block, &s->round, O_PER_W);
-#else // BIG_ENDIAN
+#if (OCTET_ORDER == BIG_ENDIAN)
 		s->round = wordRev(s->round);
-		memXor2(s->block, &s->round, O_PER_W);
+#endif
+		for (j = 0; j < m; ++j)
+			memXor2(blocks[j], &s->round, O_PER_W);
+#if (OCTET_ORDER == BIG_ENDIAN)
 		s->round = wordRev(s->round);
-#endif // OCTET_ORDER
+#endif
 		// r*_до_сдвига <- r*_до_сдвига + block
-		beltBlockXor2((octet*)buf + count - 32, s->block);
+		for (j = 0; j < m; ++j)
+			beltBlockXor2(bufs[j] + count - 32, blocks[j]);
 	}
 	while (s->round % (2 * n));
 }
 
+void beltWBLStepEBase(void* buf, size_t count, void* state)
+{
+	belt_wbl_st* s = (belt_wbl_st*)state;
+	ASSERT(memIsDisjoint2(buf, count, state, beltWBL_keep()));
+	ASSERT(s->round % (2 * ((count + 15) / 16)) == 0);
+	beltWBLStepEBufs(buf, 0, count, state);
+}
+
+void beltWBLStepEPair(void* buf1, void* buf2, size_t count, void* state)
+{
+	belt_wbl_st* s = (belt_wbl_st*)state;
+	ASSERT(memIsDisjoint3(buf1, count, buf2, count, state, beltWBL_keep()));
+	s->round = 0;
+	beltWBLStepEBufs(buf1, buf2, count, state);
+}
+
 void beltWBLStepEOpt(void* buf, size_t count, void* state)
 {
 	belt_wbl_st* s = (belt_wbl_st*)state;
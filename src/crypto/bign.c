@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2018.07.04
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -15,16 +15,22 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/err.h"
 #include "bee2/core/der.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/oid.h"
 #include "bee2/core/str.h"
+#include "bee2/core/tm.h"
+#include "bee2/core/u32.h"
 #include "bee2/core/util.h"
+#include "bee2/crypto/bash.h"
 #include "bee2/crypto/belt.h"
 #include "bee2/crypto/bign.h"
+#include "bee2/crypto/vcache.h"
 #include "crypto/bign_lcl.h"
 #include "bee2/math/gfp.h"
 #include "bee2/math/ecp.h"
 #include "bee2/math/pri.h"
 #include "bee2/math/ww.h"
+#include "bee2/math/zm.h"
 #include "bee2/math/zz.h"
 
 /*
@@ -300,6 +306,165 @@ size_t bignStart_keep(size_t l, bign_deep_i deep)
 			deep ? deep(n, f_deep, ec_d, ec_deep) : 0);
 }
 
+/*
+*******************************************************************************
+Кольцо вычетов по модулю порядка
+
+Скаляры (компоненты подписи, эфемерные ключи протоколов bake) 
+обрабатываются в кольце вычетов по модулю q (порядка группы точек) 
+с редукцией Барретта. По сравнению с zzMul() + zzMod() умножение в кольце 
+не требует деления, а для q длины 256 выполняется специализированной 
+функцией (см. zm.c).
+
+Кольцо создается в памяти высокоуровневой функции, а не присоединяется 
+к описанию кривой: в таблице указателей ec_o нет места для еще одного 
+вложенного объекта, и objCopy() не сдвинул бы указатели внутри кольца. 
+Создание кольца требует одного деления и несущественно по сравнению 
+с вычислением кратной точки.
+*******************************************************************************
+*/
+
+void bignCreateRing(qr_o* r, const ec_o* ec, void* stack)
+{
+	const size_t no = ec->f->no;
+	// переменные в stack
+	octet* q = (octet*)stack;
+	stack = q + no;
+	// pre
+	ASSERT(ecIsOperableGroup(ec));
+	// создать кольцо
+	wwTo(q, no, ec->order);
+	zmCreateBarr(r, q, no, stack);
+}
+
+size_t bignCreateRing_keep(size_t n)
+{
+	return zmCreateBarr_keep(O_OF_W(n));
+}
+
+size_t bignCreateRing_deep(size_t n)
+{
+	return O_OF_W(n) + zmCreateBarr_deep(O_OF_W(n));
+}
+
+/*
+*******************************************************************************
+Квадратные корни и восстановление точек
+
+При p \equiv 3 \mod 4 квадратный корень из квадратичного вычета a 
+вычисляется как a^e, e = (p + 1) / 4. У стандартных модулей bign 
+p = 2^{2l} - c, c < 2^{16}, и поэтому e = (2^m - 1) 2^{16} + e_0, 
+m = 2l - 18, e_0 < 2^{16}. Степень a^{2^m - 1} вычисляется по цепочке, 
+которая строится по двоичной записи m: 
+	a^{2^{2j} - 1} = (a^{2^j - 1})^{2^j} a^{2^j - 1},
+	a^{2^{j + 1} - 1} = (a^{2^j - 1})^2 a.
+Затем выполняются 16 возведений в квадрат с умножениями на a для единичных 
+разрядов e_0. Всего требуется 2l - 2 возведения в квадрат и не более 
+2 \log_2(m) + 16 умножений, тогда как qrPower() со скользящим окном 
+ширины w выполняет порядка 2l / (w + 1) + 2^{w - 1} умножений. Для модулей 
+другого вида используется qrPower(). По замерам ecpBench() (x86-64, лучшее 
+из трех измерений) цепочка быстрее qrPower() примерно на 12% при l = 128 
+и на 13 -- 20% при l = 192 и l = 256.
+
+Функция bignSqrt() не проверяет, что a -- квадратичный вычет. Проверка 
+выполняется в функции bignRecoverY(), которая по x-координате точки 
+кривой определяет одну из двух ее возможных y-координат: 
+	y = (x^3 + a x + b)^{(p + 1) / 4}.
+Функция bignRecoverY() возвращает FALSE, если на кривой нет точки 
+с заданной x-координатой.
+
+\pre В bignSqrt() и bignRecoverY() буферы входа и выхода не пересекаются.
+*******************************************************************************
+*/
+
+#define BIGN_SQRT_LO 16
+
+void bignSqrt(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	size_t m, i, j, k;
+	// переменные в stack
+	word* e = (word*)stack;
+	word* t = e + n;
+	stack = t + n;
+	// e <- (p + 1) / 4
+	wwCopy(e, ec->f->mod, n);
+	zzAddW2(e, n, 1);
+	wwShLo(e, n, 2);
+	// e = (2^m - 1) 2^{16} + e_0?
+	m = wwBitSize(e, n);
+	for (i = BIGN_SQRT_LO; i < m && wwTestBit(e, i); ++i);
+	if (m <= 2 * BIGN_SQRT_LO || i < m)
+	{
+		qrPower(b, a, e, n, ec->f, stack);
+		return;
+	}
+	m -= BIGN_SQRT_LO;
+	// b <- a^{2^j - 1}, j -- старшие разряды m
+	qrCopy(b, a, ec->f);
+	for (i = B_PER_S - 1; !((m >> i) & 1); --i);
+	for (j = 1; i--;)
+	{
+		// b <- a^{2^{2j} - 1}
+		qrCopy(t, b, ec->f);
+		for (k = j; k--;)
+			qrSqr(b, b, ec->f, stack);
+		qrMul(b, b, t, ec->f, stack);
+		j *= 2;
+		// b <- a^{2^{j + 1} - 1}
+		if ((m >> i) & 1)
+		{
+			qrSqr(b, b, ec->f, stack);
+			qrMul(b, b, a, ec->f, stack);
+			++j;
+		}
+	}
+	ASSERT(j == m);
+	// b <- b^{2^{16}} a^{e_0}
+	for (i = BIGN_SQRT_LO; i--;)
+	{
+		qrSqr(b, b, ec->f, stack);
+		if (wwTestBit(e, i))
+			qrMul(b, b, a, ec->f, stack);
+	}
+}
+
+size_t bignSqrt_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			f_deep,
+			qrPower_deep(n, n, f_deep));
+}
+
+static bool_t bignRecoverY(word y[], const word x[], const ec_o* ec, 
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	stack = t2 + n;
+	// t1 <- x^3 + a x + b
+	qrSqr(t1, x, ec->f, stack);
+	zmAdd(t1, t1, ec->A, ec->f);
+	qrMul(t1, t1, x, ec->f, stack);
+	zmAdd(t1, t1, ec->B, ec->f);
+	// y <- t1^{(p + 1) / 4}, t2 <- y^2
+	bignSqrt(y, t1, ec, stack);
+	qrSqr(t2, y, ec->f, stack);
+	// (x, y) на кривой? t1 == t2?
+	return wwEq(t1, t2, n);
+}
+
+static size_t bignRecoverY_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			f_deep,
+			bignSqrt_deep(n, f_deep));
+}
+
 /*
 *******************************************************************************
 Проверка параметров
@@ -318,100 +483,206 @@ size_t bignStart_keep(size_t l, bign_deep_i deep)
 -#	(b / p) = 1 (zzJacobi)
 -#	G = (0, b^{(p + 1) /4}) (bignValParams)
 -#	qG = O (ecpHasOrder)
+
+Условия, которые не проверяются в bignStart(), объединены в BIGN_VAL_CHECKS
+независимых проверок (см. bignValParamsCheck()). Проверки распределяются
+между потоками: поток i выполняет проверки i, i + threads,... и прекращает
+работу после первой неудачной проверки. Описание кривой строится один раз
+и используется всеми потоками только для чтения.
+
+Ключи успешно проверенных параметров сохраняются в кэше (см. vcache.h)
+с меткой "bign".
 *******************************************************************************
 */
 
-static size_t bignValParams_deep(size_t n, size_t f_deep, size_t ec_d,
+static bool_t bignValParamsCheck(size_t i, const ec_o* ec,
+	const bign_params* params, void* stack)
+{
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	// переменные в stack
+	octet* hash_state;		/* [beltHash_keep] состояние хэширования */
+	octet* hash_data;		/* [8] данные хэширования */
+	word* B;				/* [W_OF_B(512)] переменная B */
+	// раскладка stack
+	hash_state = (octet*)stack;
+	hash_data = hash_state + beltHash_keep();
+	B = (word*)hash_data;
+	stack = hash_data + O_OF_B(512);
+	// проверки
+	switch (i)
+	{
+	case 0:
+		// belt-hash(p..)
+		beltHashStart(hash_state);
+		beltHashStepH(params->p, no, hash_state);
+		// belt-hash(..a..)
+		beltHashStepH(params->a, no, hash_state);
+		memCopy(stack, hash_state, beltHash_keep());
+		// belt-hash(..seed)
+		memCopy(hash_data, params->seed, 8);
+		beltHashStepH(hash_data, 8, hash_state);
+		// belt-hash(..seed + 1)
+		wwFrom(B, hash_data, 8);
+		zzAddW2(B, W_OF_O(8), 1);
+		wwTo(hash_data, 8, B);
+		beltHashStepH(hash_data, 8, stack);
+		// B <- belt-hash(p || a || seed) || belt-hash(p || a || seed + 1)
+		beltHashStepG(hash_data, hash_state);
+		beltHashStepG(hash_data + 32, stack);
+		wwFrom(B, hash_data, 64);
+		// B <- B \mod p
+		zzMod(B, B, W_OF_O(64), ec->f->mod, n, stack);
+		wwTo(B, 64, B);
+		// b == B, b != 0?
+		return qrFrom(B, (octet*)B, ec->f, stack) &&
+			wwEq(B, ec->B, n) &&
+			!wwIsZero(ec->B, n);
+	case 1:
+		return ecpIsValid(ec, stack);
+	case 2:
+		return ecpIsSafeGroup(ec, 50, stack);
+	case 3:
+		if (zzJacobi(ec->B, n, ec->f->mod, n, stack) != 1)
+			return FALSE;
+		// B <- b^{(p + 1) / 4} = \sqrt{b} mod p
+		wwCopy(B, ec->f->mod, n);
+		zzAddW2(B, n, 1);
+		wwShLo(B, n, 2);
+		qrPower(B, ec->B, B, n, ec->f, stack);
+		// G == (0, B), qG == O?
+		return wwEq(B, ecY(ec->base, n), n) &&
+			ecHasOrderA(ec->base, ec, ec->order, n, stack);
+	}
+	return FALSE;
+}
+
+static size_t bignValParamsCheck_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return beltHash_keep() + O_OF_B(512) +
-		utilMax(6,
+		utilMax(8,
 			beltHash_keep(),
+			zzMod_deep(W_OF_O(64), n),
 			ecpIsValid_deep(n, f_deep),
 			ecpIsSafeGroup_deep(n),
-			ecpIsOnA_deep(n, f_deep),
+			zzJacobi_deep(n, n),
 			qrPower_deep(n, n, f_deep),
+			ecpIsOnA_deep(n, f_deep),
 			ecHasOrderA_deep(n, ec_d, ec_deep, n));
 }
 
-err_t bignValParams(const bign_params* params)
+typedef struct
+{
+	const ec_o* ec;				/*< описание кривой */
+	const bign_params* params;	/*< параметры */
+	bool_t* oks;				/*< результаты проверок */
+	tm_ticks_t* ticks;			/*< продолжительность проверок */
+	size_t start;				/*< первая проверка */
+	size_t step;				/*< шаг по проверкам */
+	void* stack;				/*< вспомогательная память */
+} bign_val_params_job;
+
+static void bignValParamsRun(void* arg)
+{
+	const bign_val_params_job* job = (const bign_val_params_job*)arg;
+	tm_ticks_t t;
+	size_t i;
+	for (i = job->start; i < BIGN_VAL_CHECKS; i += job->step)
+	{
+		t = tmTicks();
+		job->oks[i] = bignValParamsCheck(i, job->ec, job->params,
+			job->stack);
+		job->ticks[i] = tmTicks() - t;
+		if (!job->oks[i])
+			break;
+	}
+}
+
+static size_t bignValParamsRun_deep(size_t l)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return O_OF_W(W_OF_O(bignValParamsCheck_deep(n, f_deep, ec_d,
+		ec_deep)));
+}
+
+err_t bignValParams2(const bign_params* params, size_t threads,
+	tm_ticks_t ticks[BIGN_VAL_CHECKS])
 {
 	err_t code;
-	size_t no, n;
-	// состояние (буферы могут пересекаться)
+	size_t i;
+	size_t job_deep;
+	octet key[32];
+	bool_t oks[BIGN_VAL_CHECKS];
+	tm_ticks_t ticks1[BIGN_VAL_CHECKS];
+	// состояние
 	void* state;
 	ec_o* ec;				/* описание эллиптической кривой */
-	octet* hash_state;		/* [beltHash_keep] состояние хэширования */
-	octet* hash_data;		/* [8] данные хэширования */
-	word* B;				/* [W_OF_B(512)] переменная B */
-	octet* stack;
+	void* stack;
+	bign_val_params_job* jobs;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
 		return ERR_BAD_INPUT;
 	if (params->l != 128 && params->l != 192 && params->l != 256)
 		return ERR_BAD_PARAMS;
+	// проверить ticks
+	if (!memIsNullOrValid(ticks, sizeof(tm_ticks_t) * BIGN_VAL_CHECKS))
+		return ERR_BAD_INPUT;
+	if (ticks == 0)
+		ticks = ticks1;
+	for (i = 0; i < BIGN_VAL_CHECKS; ++i)
+		oks[i] = TRUE, ticks[i] = 0;
+	// параметры уже проверялись?
+	vcacheKey(key, "bign", params, sizeof(bign_params));
+	if (vcacheHas(key))
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, BIGN_VAL_CHECKS);
+	job_deep = bignValParamsRun_deep(params->l);
 	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignValParams_deep));
+	state = blobCreate(bignStart_keep(params->l, 0) +
+		threads * (job_deep + sizeof(bign_val_params_job)));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
 	ec = (ec_o*)state;
-	// размерности
-	no  = ec->f->no;
-	n = ec->f->n;
 	// раскладка состояния
-	hash_state = objEnd(ec, octet);
-	hash_data = hash_state + beltHash_keep();
-	B = (word*)hash_data;
-	stack = hash_data + O_OF_B(512);
-	// belt-hash(p..)
-	beltHashStart(hash_state);
-	beltHashStepH(params->p, no, hash_state);
-	// belt-hash(..a..)
-	beltHashStepH(params->a, no, hash_state);
-	memCopy(stack, hash_state, beltHash_keep());
-	// belt-hash(..seed)
-	memCopy(hash_data, params->seed, 8);
-	beltHashStepH(hash_data, 8, hash_state);
-	// belt-hash(..seed + 1)
-	wwFrom(B, hash_data, 8);
-	zzAddW2(B, W_OF_O(8), 1);
-	wwTo(hash_data, 8, B);
-	beltHashStepH(hash_data, 8, stack);
-	// B <- belt-hash(p || a || seed) || belt-hash(p || a || seed + 1)
-	beltHashStepG(hash_data, hash_state);
-	beltHashStepG(hash_data + 32, stack);
-	wwFrom(B, hash_data, 64);
-	// B <- B \mod p
-	zzMod(B, B, W_OF_O(64), ec->f->mod, n, stack);
-	wwTo(B, 64, B);
-	// проверить условия алгоритма 6.1.4
-	if (qrFrom(B, (octet*)B, ec->f, stack) &&
-		wwEq(B, ec->B, n) &&
-		!wwIsZero(ec->B, n) &&
-		ecpIsValid(ec, stack) &&
-		ecpIsSafeGroup(ec, 50, stack) &&
-		zzJacobi(ec->B, n, ec->f->mod, n, stack) == 1)
+	stack = objEnd(ec, void);
+	jobs = (bign_val_params_job*)((octet*)stack + threads * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
 	{
-		// B <- b^{(p + 1) / 4} = \sqrt{b} mod p
-		wwCopy(B, ec->f->mod, n);
-		zzAddW2(B, n, 1);
-		wwShLo(B, n, 2);
-		qrPower(B, ec->B, B, n, ec->f, stack);
-		// оставшиеся условия
-		if (!wwEq(B, ecY(ec->base, n), n) ||
-			!ecHasOrderA(ec->base, ec, ec->order, n, stack))
-			code = ERR_BAD_PARAMS;
+		jobs[i].ec = ec;
+		jobs[i].params = params;
+		jobs[i].oks = oks, jobs[i].ticks = ticks;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
 	}
-	else
-		code = ERR_BAD_PARAMS;
+	// выполнить задания
+	mtRunJobs(bignValParamsRun, jobs, sizeof(bign_val_params_job), threads);
+	// результат
+	for (i = 0; i < BIGN_VAL_CHECKS; ++i)
+		if (!oks[i])
+			code = ERR_BAD_PARAMS;
+	if (code == ERR_OK)
+		vcacheAdd(key);
 	// завершение
 	blobClose(state);
 	return code;
 }
 
+err_t bignValParams(const bign_params* params)
+{
+	return bignValParams2(params, 1, 0);
+}
+
 /*
 *******************************************************************************
 Идентификатор объекта
@@ -448,7 +719,7 @@ static size_t bignGenKeypair_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(n + 2 * n) +
-		ecMulA_deep(n, ec_d, ec_deep, n);
+		ecMulRegA_deep(n, ec_d, ec_deep, n);
 }
 
 err_t bignGenKeypair(octet privkey[], octet pubkey[],
@@ -493,13 +764,13 @@ err_t bignGenKeypair(octet privkey[], octet pubkey[],
 	Q = d + n;
 	stack = Q + 2 * n;
 	// d <-R {1,2,..., q - 1}
-	if (!zzRandNZMod(d, ec->f->mod, n, rng, rng_state))
+	if (!zzRandNZMod(d, ec->order, n, rng, rng_state))
 	{
 		blobClose(state);
 		return ERR_BAD_RNG;
 	}
 	// Q <- d G
-	if (ecMulA(Q, ec->base, ec, d, n, stack))
+	if (ecMulRegA(Q, ec->base, ec, d, n, stack))
 	{
 		// выгрузить ключи
 		wwTo(privkey, no, d);
@@ -513,207 +784,1061 @@ err_t bignGenKeypair(octet privkey[], octet pubkey[],
 	return code;
 }
 
-static size_t bignValPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
+/*
+*******************************************************************************
+Таблицы предвычислений
+
+Образ таблицы кратных базовой точки G (см. ecTblCreateA()) имеет следующий 
+формат (числовые поля заголовка записываются по правилам little-endian):
+-	[8] сигнатура "bee2tbl" (с завершающим нулем);
+-	[4] версия формата (BIGN_TBL_VERSION);
+-	[4] тип образа (BIGN_TBL_BASE -- таблица кратных G);
+-	[4] уровень стойкости l;
+-	[2] B_PER_W;
+-	[2] порядок октетов в слове (1 -- little-endian, 2 -- big-endian);
+-	[4] длина таблицы в октетах;
+-	[4] резерв (нули);
+-	[32] хэш-значение параметров: 
+	bash256(<l>_32 || p || a || b || q || yG || seed);
+-	[32] тег: bash256(первые 64 октета заголовка || таблица);
+-	таблица: слова в машинном представлении, координаты точек 
+	во внутреннем представлении поля (определяется p, B_PER_W и 
+	версией формата).
+
+Заголовок занимает BIGN_TBL_HDR = 96 октетов, поэтому таблица выровнена 
+на границу слова, если выровнен образ. Образ не содержит указателей 
+и может отображаться в память по любому выровненному адресу (например, 
+mmap(PROT_READ, MAP_SHARED)) и разделяться между процессами.
+
+Описания поля и кривой (объекты qr_o и ec_o) в образ не входят: в них 
+хранятся указатели на функции, которые действительны только в адресном 
+пространстве процесса. Описания строятся функцией bignStart() за время, 
+малое по сравнению со временем построения таблицы.
+
+Тег не защищает от подмены образа: его может пересчитать любой. Поэтому 
+кроме тега проверяется, что все точки таблицы лежат на кривой и их 
+координаты являются корректными элементами поля. Некорректные точки 
+могли бы привести к утечке одноразовых ключей (атаки с неверной кривой). 
+Образ целиком проверяется функцией bignTblCheck(), которую вызывают 
+bignTblVal() и все функции, принимающие образ. Проверка выполняется 
+много быстрее, чем построение таблицы.
+*******************************************************************************
+*/
+
+#define BIGN_TBL_HDR 96
+#define BIGN_TBL_VERSION 1
+#define BIGN_TBL_BASE 1
+
+static size_t bignTblLen(size_t l)
+{
+	const size_t n = W_OF_B(2 * l);
+	return ecTblCreateA_keep(n, n);
+}
+
+static void bignTblParamsHash(octet hash[32], const bign_params* params,
+	void* state)
+{
+	const size_t no = O_OF_B(2 * params->l);
+	octet l[4];
+	u32To(l, 4, &params->l);
+	bashHashStart(state, 128);
+	bashHashStepH(l, 4, state);
+	bashHashStepH(params->p, no, state);
+	bashHashStepH(params->a, no, state);
+	bashHashStepH(params->b, no, state);
+	bashHashStepH(params->q, no, state);
+	bashHashStepH(params->yG, no, state);
+	bashHashStepH(params->seed, 8, state);
+	bashHashStepG(hash, 32, state);
+}
+
+static void bignTblHdr(octet hdr[64], const bign_params* params, 
+	void* state)
+{
+	u32 t[4];
+	memSetZero(hdr, 64);
+	memCopy(hdr, "bee2tbl", 8);
+	t[0] = BIGN_TBL_VERSION;
+	t[1] = BIGN_TBL_BASE;
+	t[2] = params->l;
+	t[3] = B_PER_W | (OCTET_ORDER == LITTLE_ENDIAN ? 1 : 2) << 16;
+	u32To(hdr + 8, 16, t);
+	t[0] = (u32)bignTblLen(params->l);
+	u32To(hdr + 24, 4, t);
+	bignTblParamsHash(hdr + 32, params, state);
+}
+
+static size_t bignTblHdr_keep()
+{
+	return 64 + bashHash_keep();
+}
+
+static err_t bignTblCheckHdr(const octet tbl[], const bign_params* params,
+	void* stack)
+{
+	octet* hdr = (octet*)stack;
+	stack = hdr + 64;
+	bignTblHdr(hdr, params, stack);
+	if (!memEq(tbl, hdr, 32))
+		return ERR_BAD_FORMAT;
+	if (!memEq(tbl + 32, hdr + 32, 32))
+		return ERR_BAD_PARAMS;
+	return ERR_OK;
+}
+
+static err_t bignTblCheck(const octet tbl[], const bign_params* params,
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t len = bignTblLen(params->l);
+	const word* pt;
+	err_t code;
+	octet* tag;
+	// проверить заголовок
+	code = bignTblCheckHdr(tbl, params, stack);
+	ERR_CALL_CHECK(code);
+	// проверить тег
+	tag = (octet*)stack;
+	stack = tag + 32;
+	bashHashStart(stack, 128);
+	bashHashStepH(tbl, 64, stack);
+	bashHashStepH(tbl + BIGN_TBL_HDR, len, stack);
+	bashHashStepG(tag, 32, stack);
+	if (!memEq(tag, tbl + 64, 32))
+		return ERR_BAD_HASH;
+	// проверить точки
+	ASSERT((size_t)(tbl + BIGN_TBL_HDR) % O_PER_W == 0);
+	for (pt = (const word*)(tbl + BIGN_TBL_HDR); 
+		pt < (const word*)(tbl + BIGN_TBL_HDR + len); pt += 2 * n)
+		if (wwCmp(ecX(pt), ec->f->mod, n) >= 0 ||
+			wwCmp(ecY(pt, n), ec->f->mod, n) >= 0 ||
+			!ecpIsOnA(pt, ec, stack))
+			return ERR_BAD_POINT;
+	return ERR_OK;
+}
+
+static size_t bignTblCheck_deep(size_t n, size_t f_deep)
+{
+	return utilMax(3,
+		bignTblHdr_keep(),
+		32 + bashHash_keep(),
+		ecpIsOnA_deep(n, f_deep));
+}
+
+static size_t bignTblCreate_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(2 * n) +
-		ecpIsOnA_deep(n, f_deep);
+	return ecTblCreateA_keep(n, n) +
+		utilMax(2,
+			ecTblCreateA_deep(n, ec_d, ec_deep),
+			bignTblHdr_keep() + bashHash_keep());
 }
 
-err_t bignValPubkey(const bign_params* params, const octet pubkey[])
+err_t bignTblCreate(octet tbl[], size_t* count, const bign_params* params)
 {
 	err_t code;
-	size_t no, n;
+	size_t len;
 	// состояние
 	void* state;
-	ec_o* ec;			/* описание эллиптической кривой */
-	word* Q;			/* [2n] открытый ключ */
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* t;				/* таблица */
 	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
 		return ERR_BAD_INPUT;
 	if (params->l != 128 && params->l != 192 && params->l != 256)
 		return ERR_BAD_PARAMS;
+	// проверить count
+	if (!memIsValid(count, sizeof(size_t)))
+		return ERR_BAD_INPUT;
+	len = bignTblLen(params->l);
+	// только длина?
+	if (tbl == 0)
+	{
+		*count = BIGN_TBL_HDR + len;
+		return ERR_OK;
+	}
+	// проверить tbl
+	if (*count < BIGN_TBL_HDR + len || !memIsValid(tbl, *count))
+		return ERR_BAD_INPUT;
 	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignValPubkey_deep));
+	state = blobCreate(bignStart_keep(params->l, bignTblCreate_deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
 	ec = (ec_o*)state;
-	// размерности
-	no  = ec->f->no;
-	n = ec->f->n;
-	// проверить входные указатели
-	if (!memIsValid(pubkey, 2 * no))
-	{
-		blobClose(state);
-		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	Q = objEnd(ec, word);
-	stack = Q + 2 * n;
-	// загрузить pt
-	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
-		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack))
+	t = objEnd(ec, word);
+	stack = (octet*)t + len;
+	// построить таблицу
+	if (!ecTblCreateA(t, ec->base, ec, ec->f->n, stack))
 	{
 		blobClose(state);
-		return ERR_BAD_PUBKEY;
+		return ERR_BAD_PARAMS;
 	}
-	// Q \in ec?
-	code = ecpIsOnA(Q, ec, stack) ? ERR_OK : ERR_BAD_PUBKEY;
+	// сформировать образ
+	bignTblHdr(tbl, params, stack);
+	memCopy(tbl + BIGN_TBL_HDR, t, len);
+	bashHashStart(stack, 128);
+	bashHashStepH(tbl, 64, stack);
+	bashHashStepH(tbl + BIGN_TBL_HDR, len, stack);
+	bashHashStepG(tbl + 64, 32, stack);
+	*count = BIGN_TBL_HDR + len;
 	// завершение
 	blobClose(state);
-	return code;
+	return ERR_OK;
 }
 
-static size_t bignCalcPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
+static size_t bignTblVal_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(n + 2 * n) +
-		ecMulA_deep(n, ec_d, ec_deep, n);
+	return bignTblCheck_deep(n, f_deep);
 }
 
-err_t bignCalcPubkey(octet pubkey[], const bign_params* params,
-	const octet privkey[])
+err_t bignTblVal(const bign_params* params, const octet tbl[], size_t count)
 {
 	err_t code;
-	size_t no, n;
-	// состояние
 	void* state;
-	ec_o* ec;				/* описание эллиптической кривой */
-	word* d;				/* [n] личный ключ */
-	word* Q;				/* [2n] открытый ключ */
-	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
 		return ERR_BAD_INPUT;
 	if (params->l != 128 && params->l != 192 && params->l != 256)
 		return ERR_BAD_PARAMS;
+	// проверить tbl
+	if (!memIsValid(tbl, count) || (size_t)tbl % O_PER_W)
+		return ERR_BAD_INPUT;
+	if (count != BIGN_TBL_HDR + bignTblLen(params->l))
+		return ERR_BAD_FORMAT;
 	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignCalcPubkey_deep));
+	state = blobCreate(bignStart_keep(params->l, bignTblVal_deep));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
-	ec = (ec_o*)state;
-	// размерности
-	no  = ec->f->no;
-	n = ec->f->n;
-	// проверить входные указатели
-	if (!memIsValid(privkey, no) ||
-		!memIsValid(pubkey, 2 * no))
-	{
-		blobClose(state);
-		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	d = objEnd(ec, word);
-	Q = d + n;
-	stack = Q + 2 * n;
-	// загрузить d
-	wwFrom(d, privkey, no);
-	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
-	{
-		blobClose(state);
-		return ERR_BAD_PRIVKEY;
-	}
-	// Q <- d G
-	if (ecMulA(Q, ec->base, ec, d, n, stack))
-	{
-		// выгрузить открытый ключ
-		qrTo(pubkey, ecX(Q), ec->f, stack);
-		qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
-	}
-	else
-		code = ERR_BAD_PARAMS;
+	// проверить образ
+	code = bignTblCheck(tbl, params, (const ec_o*)state, 
+		objEnd((ec_o*)state, void));
 	// завершение
 	blobClose(state);
 	return code;
 }
 
-static size_t bignDH_deep(size_t n, size_t f_deep, size_t ec_d,
-	size_t ec_deep)
+/*
+*******************************************************************************
+Пакетная генерация ключей
+
+Личные ключи генерируются последовательно в вызывающем потоке: генератор 
+rng не обязан допускать обращения из нескольких потоков. Открытые ключи 
+вычисляются по таблице кратных базовой точки (см. ecTblCreateA()) без 
+перехода к аффинным координатам. Таблица строится при каждом вызове либо 
+берется из образа (см. bignTblCreate()), который предварительно 
+проверяется. Переход выполняется порциями по BIGN_GEN_BLOCK точек с одним 
+обращением в базовом поле на порцию (см. ecToABatch()). Порции 
+распределяются между потоками.
+
+Таблица строится примерно за то же время, что и одна кратная точка, 
+а вычисление кратной по таблице обходится без удвоений. Поэтому уже при 
+нескольких ключах пакетная генерация быстрее повторных вызовов 
+bignGenKeypair().
+*******************************************************************************
+*/
+
+#define BIGN_GEN_BLOCK 32
+
+typedef struct
 {
-	return O_OF_W(n + 2 * n) +
-		utilMax(2,
-			ecpIsOnA_deep(n, f_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n));
+	const ec_o* ec;			/*< описание кривой */
+	const word* tbl;		/*< таблица кратных базовой точки */
+	const octet* privkeys;	/*< личные ключи */
+	octet* pubkeys;			/*< открытые ключи */
+	err_t* codes;			/*< коды ошибок */
+	size_t count;			/*< число ключей */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_gen_job;
+
+static void bignGenRun(void* arg)
+{
+	const bign_gen_job* job = (const bign_gen_job*)arg;
+	const ec_o* ec = job->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	size_t i, j, count;
+	// переменные в stack
+	word* d;
+	word* Q;
+	void* stack;
+	// раскладка stack
+	d = (word*)job->stack;
+	Q = d + n;
+	stack = Q + BIGN_GEN_BLOCK * ec->d * n;
+	// цикл по порциям
+	for (i = job->start * BIGN_GEN_BLOCK; i < job->count; 
+		i += job->step * BIGN_GEN_BLOCK)
+	{
+		count = MIN2(BIGN_GEN_BLOCK, job->count - i);
+		// Q[j] <- d[j] G (при ошибках Q[j] <- G, чтобы Q[j] != O)
+		for (j = 0; j < count; ++j)
+		{
+			word* Qj = Q + j * ec->d * n;
+			if (job->codes[i + j] == ERR_OK)
+			{
+				wwFrom(d, job->privkeys + (i + j) * no, no);
+				if (!ecMulTbl(Qj, job->tbl, ec, d, n, stack))
+					job->codes[i + j] = ERR_BAD_PARAMS;
+			}
+			if (job->codes[i + j] != ERR_OK)
+				ecFromA(Qj, ec->base, ec, stack);
+		}
+		// к аффинным координатам
+		ecToABatch(Q, Q, count, ec, stack);
+		// выгрузить открытые ключи
+		for (j = 0; j < count; ++j)
+			if (job->codes[i + j] == ERR_OK)
+			{
+				octet* pubkey = job->pubkeys + 2 * (i + j) * no;
+				qrTo(pubkey, ecX(Q + 2 * j * n), ec->f, stack);
+				qrTo(pubkey + no, ecY(Q + 2 * j * n, n), ec->f, stack);
+			}
+	}
+	// очистка
+	wwSetZero(d, n);
 }
 
-err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
-	const octet pubkey[], size_t key_len)
+static size_t bignGenRun_deep(size_t l)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return O_OF_W(n + BIGN_GEN_BLOCK * ec_d * n) +
+		O_OF_W(W_OF_O(utilMax(4,
+			f_deep,
+			ec_deep,
+			ecMulTbl_deep(n, ec_d, ec_deep, n),
+			ecToABatch_deep(n, ec_d, ec_deep, BIGN_GEN_BLOCK))));
+}
+
+static size_t bignGenKeypairBatch_keep(size_t l, bool_t pre, 
+	size_t threads)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return bignStart_keep(l, 0) + 
+		O_OF_W(n) + (pre ? ecTblCreateA_keep(n, n) : 0) +
+		utilMax(3,
+			f_deep,
+			pre ? ecTblCreateA_deep(n, ec_d, ec_deep) : 
+				bignTblCheck_deep(n, f_deep),
+			threads * (bignGenRun_deep(l) + sizeof(bign_gen_job)));
+}
+
+err_t bignGenKeypairBatch2(octet privkeys[], octet pubkeys[], 
+	err_t codes[], size_t count, const bign_params* params, 
+	const octet tbl[], gen_i rng, void* rng_state, size_t threads)
 {
 	err_t code;
-	size_t no, n;
+	size_t no, n, i;
+	size_t job_deep;
 	// состояние
 	void* state;
 	ec_o* ec;				/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
-	word* Q;				/* [2n] открытый ключ */
+	word* pre;				/* таблица кратных базовой точки */
 	void* stack;
+	bign_gen_job* jobs;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
 		return ERR_BAD_INPUT;
 	if (params->l != 128 && params->l != 192 && params->l != 256)
 		return ERR_BAD_PARAMS;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (!memIsValid(privkeys, count * no) ||
+		!memIsValid(pubkeys, 2 * count * no) ||
+		!memIsValid(codes, count * sizeof(err_t)) ||
+		!memIsDisjoint2(privkeys, count * no, pubkeys, 2 * count * no) ||
+		!memIsNullOrValid(tbl, BIGN_TBL_HDR + bignTblLen(params->l)) ||
+		tbl && (size_t)tbl % O_PER_W)
+		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_GEN_BLOCK - 1) / BIGN_GEN_BLOCK);
+	// создать состояние
+	state = blobCreate(bignGenKeypairBatch_keep(params->l, tbl == 0, 
+		threads));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	n = ec->f->n;
+	job_deep = bignGenRun_deep(params->l);
+	// раскладка состояния
+	d = objEnd(ec, word);
+	pre = d + n;
+	stack = tbl ? (void*)pre : (octet*)pre + ecTblCreateA_keep(n, n);
+	// проверить образ или построить таблицу кратных G
+	if (tbl)
+		code = bignTblCheck(tbl, params, ec, stack);
+	else if (!ecTblCreateA(pre, ec->base, ec, n, stack))
+		code = ERR_BAD_PARAMS;
+	if (code != ERR_OK)
+	{
+		blobClose(state);
+		return code;
+	}
+	// d[i] <-R {1,2,..., q - 1}
+	for (i = 0; i < count; ++i)
+		if (zzRandNZMod(d, ec->order, n, rng, rng_state))
+		{
+			wwTo(privkeys + i * no, no, d);
+			codes[i] = ERR_OK;
+		}
+		else
+		{
+			memSetZero(privkeys + i * no, no);
+			memSetZero(pubkeys + 2 * i * no, 2 * no);
+			codes[i] = ERR_BAD_RNG;
+		}
+	wwSetZero(d, n);
+	// подготовить задания
+	jobs = (bign_gen_job*)((octet*)stack + threads * job_deep);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].tbl = tbl ? (const word*)(tbl + BIGN_TBL_HDR) : pre;
+		jobs[i].privkeys = privkeys, jobs[i].pubkeys = pubkeys;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(bignGenRun, jobs, sizeof(bign_gen_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+err_t bignGenKeypairBatch(octet privkeys[], octet pubkeys[], err_t codes[],
+	size_t count, const bign_params* params, gen_i rng, void* rng_state, 
+	size_t threads)
+{
+	return bignGenKeypairBatch2(privkeys, pubkeys, codes, count, params, 0,
+		rng, rng_state, threads);
+}
+
+static size_t bignValPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n) +
+		ecpIsOnA_deep(n, f_deep);
+}
+
+err_t bignValPubkey(const bign_params* params, const octet pubkey[])
+{
+	err_t code;
+	size_t no, n;
+	// состояние
+	void* state;
+	ec_o* ec;			/* описание эллиптической кривой */
+	word* Q;			/* [2n] открытый ключ */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignValPubkey_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// проверить входные указатели
+	if (!memIsValid(pubkey, 2 * no))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	Q = objEnd(ec, word);
+	stack = Q + 2 * n;
+	// загрузить pt
+	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
+		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_PUBKEY;
+	}
+	// Q \in ec?
+	code = ecpIsOnA(Q, ec, stack) ? ERR_OK : ERR_BAD_PUBKEY;
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+static size_t bignCompressPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n) +
+		ecpIsOnA_deep(n, f_deep);
+}
+
+err_t bignCompressPubkey(octet xpubkey[], const bign_params* params, 
+	const octet pubkey[])
+{
+	err_t code;
+	size_t no, n;
+	octet parity;
+	// состояние
+	void* state;
+	ec_o* ec;			/* описание эллиптической кривой */
+	word* Q;			/* [2n] открытый ключ */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignCompressPubkey_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// проверить входные указатели
+	if (!memIsValid(pubkey, 2 * no) ||
+		!memIsValid(xpubkey, no + 1))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	Q = objEnd(ec, word);
+	stack = Q + 2 * n;
+	// Q \in ec?
+	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
+		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack) ||
+		!ecpIsOnA(Q, ec, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_PUBKEY;
+	}
+	// xpubkey <- x || (y \bmod 2)
+	parity = pubkey[no] & 1;
+	memMove(xpubkey, pubkey, no);
+	xpubkey[no] = parity;
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+static err_t bignDecompressPubkeyEc(octet pubkey[], const ec_o* ec, 
+	const octet xpubkey[], void* stack)
+{
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	octet parity;
+	// раскладка стека
+	word* Q = (word*)stack;
+	stack = Q + 2 * n;
+	// Q <- (x, y), (x, y) на кривой?
+	parity = xpubkey[no];
+	if (parity > 1 ||
+		!qrFrom(ecX(Q), xpubkey, ec->f, stack) ||
+		!bignRecoverY(ecY(Q, n), ecX(Q), ec, stack))
+		return ERR_BAD_PUBKEY;
+	// выгрузить Q с выбором y по четности
+	qrTo(pubkey, ecX(Q), ec->f, stack);
+	qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
+	if ((pubkey[no] & 1) != parity)
+	{
+		if (qrIsZero(ecY(Q, n), ec->f))
+			return ERR_BAD_PUBKEY;
+		zmNeg(ecY(Q, n), ecY(Q, n), ec->f);
+		qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
+	}
+	return ERR_OK;
+}
+
+static size_t bignDecompressPubkeyEc_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			f_deep,
+			bignRecoverY_deep(n, f_deep));
+}
+
+static size_t bignDecompressPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return bignDecompressPubkeyEc_deep(n, f_deep);
+}
+
+err_t bignDecompressPubkey(octet pubkey[], const bign_params* params, 
+	const octet xpubkey[])
+{
+	err_t code;
+	size_t no;
+	// состояние
+	void* state;
+	ec_o* ec;			/* описание эллиптической кривой */
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignDecompressPubkey_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	no  = ec->f->no;
+	// проверить входные указатели
+	if (!memIsValid(xpubkey, no + 1) ||
+		!memIsValid(pubkey, 2 * no))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// восстановить ключ
+	code = bignDecompressPubkeyEc(pubkey, ec, xpubkey, objEnd(ec, void));
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+static size_t bignCalcPubkey_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(n + 2 * n) +
+		ecMulRegA_deep(n, ec_d, ec_deep, n);
+}
+
+err_t bignCalcPubkey(octet pubkey[], const bign_params* params,
+	const octet privkey[])
+{
+	err_t code;
+	size_t no, n;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* d;				/* [n] личный ключ */
+	word* Q;				/* [2n] открытый ключ */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignCalcPubkey_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// проверить входные указатели
+	if (!memIsValid(privkey, no) ||
+		!memIsValid(pubkey, 2 * no))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	d = objEnd(ec, word);
+	Q = d + n;
+	stack = Q + 2 * n;
+	// загрузить d
+	wwFrom(d, privkey, no);
+	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PRIVKEY;
+	}
+	// Q <- d G
+	if (ecMulRegA(Q, ec->base, ec, d, n, stack))
+	{
+		// выгрузить открытый ключ
+		qrTo(pubkey, ecX(Q), ec->f, stack);
+		qrTo(pubkey + no, ecY(Q, n), ec->f, stack);
+	}
+	else
+		code = ERR_BAD_PARAMS;
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+static size_t bignDH_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(n + 2 * n) +
+		utilMax(3,
+			ecpIsOnA_deep(n, f_deep),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			ecpMulLadderA_deep(n, f_deep));
+}
+
+static err_t _bignDH(octet key[], const bign_params* params, 
+	const octet privkey[], const octet pubkey[], size_t key_len, 
+	bool_t ladder)
+{
+	err_t code;
+	size_t no, n;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* d;				/* [n] личный ключ */
+	word* Q;				/* [2n] открытый ключ */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignDH_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// проверить длину key
+	if (key_len > 2 * no)
+	{
+		blobClose(state);
+		return ERR_BAD_SHAREKEY;
+	}
+	// проверить входные указатели
+	if (!memIsValid(privkey, no) ||
+		!memIsValid(pubkey, 2 * no) ||
+		!memIsValid(key, key_len))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	d = objEnd(ec, word);
+	Q = d + n;
+	stack = Q + 2 * n;
+	// загрузить d
+	wwFrom(d, privkey, no);
+	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PRIVKEY;
+	}
+	// загрузить Q
+	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
+		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack) ||
+		!ecpIsOnA(Q, ec, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_PUBKEY;
+	}
+	// Q <- d Q
+	if (ladder ? ecpMulLadderA(Q, Q, ec, d, n, stack) :
+		ecMulRegA(Q, Q, ec, d, n, stack))
+	{
+		// выгрузить общий ключ
+		qrTo((octet*)Q, ecX(Q), ec->f, stack);
+		if (key_len > no)
+			qrTo((octet*)Q + no, ecY(Q, n), ec->f, stack);
+		memCopy(key, Q, key_len);
+	}
+	else
+		code = ERR_BAD_PARAMS;
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
+	const octet pubkey[], size_t key_len)
+{
+	return _bignDH(key, params, privkey, pubkey, key_len, FALSE);
+}
+
+err_t bignDHLadder(octet key[], const bign_params* params, 
+	const octet privkey[], const octet pubkey[], size_t key_len)
+{
+	return _bignDH(key, params, privkey, pubkey, key_len, TRUE);
+}
+
+/*
+*******************************************************************************
+Пакетная проверка открытых ключей
+
+Описание кривой строится один раз. Ключи проверяются порциями 
+по BIGN_VAL_BLOCK, порции распределяются между потоками. Кофактор кривых 
+bign равняется 1, поэтому проверка принадлежности подгруппе не требуется: 
+достаточно проверить, что координаты лежат в базовом поле и точка лежит 
+на кривой.
+*******************************************************************************
+*/
+
+#define BIGN_VAL_BLOCK 64
+
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	const octet* pubkeys;	/*< открытые ключи */
+	err_t* codes;			/*< коды проверки */
+	size_t count;			/*< число ключей */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_val_job;
+
+static void bignValRun(void* arg)
+{
+	const bign_val_job* job = (const bign_val_job*)arg;
+	const ec_o* ec = job->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	size_t i, j;
+	// переменные в stack
+	word* Q;
+	void* stack;
+	// раскладка stack
+	Q = (word*)job->stack;
+	stack = Q + 2 * n;
+	// цикл по порциям
+	for (i = job->start * BIGN_VAL_BLOCK; i < job->count; 
+		i += job->step * BIGN_VAL_BLOCK)
+		for (j = i; j < MIN2(i + BIGN_VAL_BLOCK, job->count); ++j)
+		{
+			const octet* pubkey = job->pubkeys + 2 * j * no;
+			// Q \in ec?
+			if (qrFrom(ecX(Q), pubkey, ec->f, stack) &&
+				qrFrom(ecY(Q, n), pubkey + no, ec->f, stack) &&
+				ecpIsOnA(Q, ec, stack))
+				job->codes[j] = ERR_OK;
+			else
+				job->codes[j] = ERR_BAD_PUBKEY;
+		}
+}
+
+static size_t bignValRun_deep(size_t l)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	return O_OF_W(2 * n) + 
+		O_OF_W(W_OF_O(utilMax(2,
+			f_deep,
+			ecpIsOnA_deep(n, f_deep))));
+}
+
+err_t bignValPubkeyBatch(err_t codes[], const bign_params* params,
+	const octet pubkeys[], size_t count, size_t threads)
+{
+	err_t code;
+	size_t no, i;
+	size_t job_deep;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	void* stack;
+	bign_val_job* jobs;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (!memIsValid(pubkeys, 2 * count * no) ||
+		!memIsValid(codes, count * sizeof(err_t)))
+		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_VAL_BLOCK - 1) / BIGN_VAL_BLOCK);
+	job_deep = bignValRun_deep(params->l);
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, 0) + 
+		threads * (job_deep + sizeof(bign_val_job)));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// раскладка состояния
+	stack = objEnd(ec, void);
+	jobs = (bign_val_job*)((octet*)stack + threads * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].pubkeys = pubkeys;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(bignValRun, jobs, sizeof(bign_val_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+/*
+*******************************************************************************
+Пакетное восстановление открытых ключей
+
+Описание кривой строится один раз. Ключи восстанавливаются порциями 
+по BIGN_VAL_BLOCK, порции распределяются между потоками. Основная работа 
+-- извлечение квадратного корня (см. bignSqrt()), которое не удается 
+объединить для нескольких ключей, поэтому выигрыш по сравнению с повторными 
+вызовами bignDecompressPubkey() достигается за счет однократной подготовки 
+кривой и параллельных вычислений.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	octet* pubkeys;			/*< открытые ключи */
+	const octet* xpubkeys;	/*< сжатые открытые ключи */
+	err_t* codes;			/*< коды восстановления */
+	size_t count;			/*< число ключей */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_dec_job;
+
+static void bignDecRun(void* arg)
+{
+	const bign_dec_job* job = (const bign_dec_job*)arg;
+	const size_t no = job->ec->f->no;
+	size_t i, j;
+	// цикл по порциям
+	for (i = job->start * BIGN_VAL_BLOCK; i < job->count; 
+		i += job->step * BIGN_VAL_BLOCK)
+		for (j = i; j < MIN2(i + BIGN_VAL_BLOCK, job->count); ++j)
+		{
+			octet* pubkey = job->pubkeys + 2 * j * no;
+			job->codes[j] = bignDecompressPubkeyEc(pubkey, job->ec, 
+				job->xpubkeys + j * (no + 1), job->stack);
+			if (job->codes[j] != ERR_OK)
+				memSetZero(pubkey, 2 * no);
+		}
+}
+
+static size_t bignDecRun_deep(size_t l)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	return O_OF_W(W_OF_O(bignDecompressPubkeyEc_deep(n, f_deep)));
+}
+
+err_t bignDecompressPubkeyBatch(octet pubkeys[], err_t codes[], 
+	const bign_params* params, const octet xpubkeys[], size_t count, 
+	size_t threads)
+{
+	err_t code;
+	size_t no, i;
+	size_t job_deep;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	void* stack;
+	bign_dec_job* jobs;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (!memIsValid(xpubkeys, count * (no + 1)) ||
+		!memIsValid(pubkeys, 2 * count * no) ||
+		!memIsValid(codes, count * sizeof(err_t)) ||
+		!memIsDisjoint2(xpubkeys, count * (no + 1), pubkeys, 2 * count * no))
+		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_VAL_BLOCK - 1) / BIGN_VAL_BLOCK);
+	job_deep = bignDecRun_deep(params->l);
 	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignDH_deep));
+	state = blobCreate(bignStart_keep(params->l, 0) + 
+		threads * (job_deep + sizeof(bign_dec_job)));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
 	ec = (ec_o*)state;
-	// размерности
-	no  = ec->f->no;
-	n = ec->f->n;
-	// проверить длину key
-	if (key_len > 2 * no)
-	{
-		blobClose(state);
-		return ERR_BAD_SHAREKEY;
-	}
-	// проверить входные указатели
-	if (!memIsValid(privkey, no) ||
-		!memIsValid(pubkey, 2 * no) ||
-		!memIsValid(key, key_len))
-	{
-		blobClose(state);
-		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	d = objEnd(ec, word);
-	Q = d + n;
-	stack = Q + 2 * n;
-	// загрузить d
-	wwFrom(d, privkey, no);
-	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
-	{
-		blobClose(state);
-		return ERR_BAD_PRIVKEY;
-	}
-	// загрузить Q
-	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
-		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack) ||
-		!ecpIsOnA(Q, ec, stack))
+	stack = objEnd(ec, void);
+	jobs = (bign_dec_job*)((octet*)stack + threads * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
 	{
-		blobClose(state);
-		return ERR_BAD_PUBKEY;
-	}
-	// Q <- d Q
-	if (ecMulA(Q, Q, ec, d, n, stack))
-	{
-		// выгрузить общий ключ
-		qrTo((octet*)Q, ecX(Q), ec->f, stack);
-		if (key_len > no)
-			qrTo((octet*)Q + no, ecY(Q, n), ec->f, stack);
-		memCopy(key, Q, key_len);
+		jobs[i].ec = ec;
+		jobs[i].pubkeys = pubkeys;
+		jobs[i].xpubkeys = xpubkeys;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
 	}
-	else
-		code = ERR_BAD_PARAMS;
+	// выполнить задания
+	mtRunJobs(bignDecRun, jobs, sizeof(bign_dec_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
 	// завершение
 	blobClose(state);
 	return code;
@@ -728,12 +1853,11 @@ err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
 static size_t bignSign_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(4 * n) +
-		utilMax(4,
+	return O_OF_W(4 * n) + bignCreateRing_keep(n) +
+		utilMax(3,
 			beltHash_keep(),
-			ecMulA_deep(n, ec_d, ec_deep, n),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n));
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			bignCreateRing_deep(n));
 }
 
 err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
@@ -748,8 +1872,9 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 	word* d;				/* [n] личный ключ */
 	word* k;				/* [n] одноразовый личный ключ */
 	word* R;				/* [2n] точка R */
-	word* s0;				/* [n/2] первая часть подписи */
+	word* s0;				/* [n] первая часть подписи */
 	word* s1;				/* [n] вторая часть подписи */
+	qr_o* r;				/* кольцо вычетов по модулю q */
 	octet* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
@@ -785,8 +1910,9 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 	d = s1 = objEnd(ec, word);
 	k = d + n;
 	R = k + n;
-	s0 = R + n + n / 2;
-	stack = (octet*)(R + 2 * n);
+	s0 = R + n;
+	r = (qr_o*)(R + 2 * n);
+	stack = (octet*)r + bignCreateRing_keep(n);
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
@@ -801,7 +1927,7 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 		return ERR_BAD_RNG;
 	}
 	// R <- k G
-	if (!ecMulA(R, ec->base, ec, k, n, stack))
+	if (!ecMulRegA(R, ec->base, ec, k, n, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -814,15 +1940,16 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 	beltHashStepH(hash, no, stack);
 	beltHashStepG2(sig, no / 2, stack);
 	wwFrom(s0, sig, no / 2);
-	// R <- (s0 + 2^l) d
-	zzMul(R, s0, n / 2, d, n, stack);
-	R[n + n / 2] = zzAdd(R + n / 2, R + n / 2, d, n);
-	// s1 <- R mod q
-	zzMod(s1, R, n + n / 2 + 1, ec->order, n, stack);
+	// s0 <- s0 + 2^l
+	s0[n / 2] = 1;
+	wwSetZero(s0 + n / 2 + 1, n - n / 2 - 1);
+	// s1 <- s0 d mod q
+	bignCreateRing(r, ec, stack);
+	qrMul(s1, s0, d, r, stack);
 	// s1 <- (k - s1 - H) mod q
-	zzSubMod(s1, k, s1, ec->order, n);
+	zmSub(s1, k, s1, r);
 	wwFrom(k, hash, no);
-	zzSubMod(s1, s1, k, ec->order, n);
+	zmSub(s1, s1, k, r);
 	// выгрузить s1
 	wwTo(sig + no / 2, no, s1);
 	// все нормально
@@ -833,13 +1960,12 @@ err_t bignSign(octet sig[], const bign_params* params, const octet oid_der[],
 static size_t bignSign2_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(4 * n) + beltHash_keep() +
-		utilMax(5,
+	return O_OF_W(4 * n) + bignCreateRing_keep(n) + beltHash_keep() +
+		utilMax(4,
 			beltHash_keep(),
 			beltKWP_keep(),
-			ecMulA_deep(n, ec_d, ec_deep, n),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n));
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			bignCreateRing_deep(n));
 }
 
 err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
@@ -854,8 +1980,9 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 	word* d;				/* [n] личный ключ */
 	word* k;				/* [n] одноразовый личный ключ */
 	word* R;				/* [2n] точка R */
-	word* s0;				/* [n/2] первая часть подписи */
+	word* s0;				/* [n] первая часть подписи */
 	word* s1;				/* [n] вторая часть подписи */
+	qr_o* r;				/* кольцо вычетов по модулю q */
 	octet* hash_state;		/* [beltHash_keep] состояние хэширования */
 	octet* stack;
 	// проверить params
@@ -892,9 +2019,10 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 	d = s1 = objEnd(ec, word);
 	k = d + n;
 	R = k + n;
-	s0 = R + n + n / 2;
+	s0 = R + n;
 	hash_state = (octet*)(R + 2 * n);
-	stack = hash_state + beltHash_keep();
+	r = (qr_o*)(hash_state + beltHash_keep());
+	stack = (octet*)r + bignCreateRing_keep(n);
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
@@ -928,7 +2056,7 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 		}
 	}
 	// R <- k G
-	if (!ecMulA(R, ec->base, ec, k, n, stack))
+	if (!ecMulRegA(R, ec->base, ec, k, n, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -939,15 +2067,16 @@ err_t bignSign2(octet sig[], const bign_params* params, const octet oid_der[],
 	beltHashStepH(hash, no, hash_state);
 	beltHashStepG2(sig, no / 2, hash_state);
 	wwFrom(s0, sig, no / 2);
-	// R <- (s0 + 2^l) d
-	zzMul(R, s0, n / 2, d, n, stack);
-	R[n + n / 2] = zzAdd(R + n / 2, R + n / 2, d, n);
-	// s1 <- R mod q
-	zzMod(s1, R, n + n / 2 + 1, ec->order, n, stack);
+	// s0 <- s0 + 2^l
+	s0[n / 2] = 1;
+	wwSetZero(s0 + n / 2 + 1, n - n / 2 - 1);
+	// s1 <- s0 d mod q
+	bignCreateRing(r, ec, stack);
+	qrMul(s1, s0, d, r, stack);
 	// s1 <- (k - s1 - H) mod q
-	zzSubMod(s1, k, s1, ec->order, n);
+	zmSub(s1, k, s1, r);
 	wwFrom(k, hash, no);
-	zzSubMod(s1, s1, k, ec->order, n);
+	zmSub(s1, s1, k, r);
 	// выгрузить s1
 	wwTo(sig + no / 2, no, s1);
 	// все нормально
@@ -1071,7 +2200,7 @@ static size_t bignKeyWrap_deep(size_t n, size_t f_deep, size_t ec_d,
 {
 	return O_OF_W(3 * n) + 32 +
 		utilMax(2,
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
 			beltKWP_keep());
 }
 
@@ -1137,7 +2266,7 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 		blobClose(state);
 		return ERR_BAD_PUBKEY;
 	}
-	if (!ecMulA(R, R, ec, k, n, stack))
+	if (!ecMulRegA(R, R, ec, k, n, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -1145,7 +2274,7 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 	// theta <- <R>_{256}
 	qrTo(theta, ecX(R), ec->f, stack);
 	// R <- k G
-	if (!ecMulA(R, ec->base, ec, k, n, stack))
+	if (!ecMulRegA(R, ec->base, ec, k, n, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -1169,81 +2298,559 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 	return ERR_OK;
 }
 
-/*
-*******************************************************************************
-Разбор токена
-*******************************************************************************
-*/
+/*
+*******************************************************************************
+Разбор токена
+*******************************************************************************
+*/
+
+static size_t bignKeyUnwrap_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return MAX2(O_OF_W(5 * n), 32 + 16) +
+		utilMax(3,
+			beltKWP_keep(),
+			bignSqrt_deep(n, f_deep),
+			ecMulRegA_deep(n, ec_d, ec_deep, n));
+}
+
+err_t bignKeyUnwrap(octet key[], const bign_params* params, const octet token[], 
+	size_t len, const octet header[16], const octet privkey[])
+{
+	err_t code;
+	size_t no, n;
+	// состояние (буферы могут пересекаться)
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* d;				/* [n] личный ключ */
+	word* R;				/* [2n] точка R */
+	word* t1;				/* [n] вспомогательное число */
+	word* t2;				/* [n] вспомогательное число */
+	octet* theta;			/* [32] ключ защиты */
+	octet* header2;			/* [16] заголовок2 */
+	void* stack;			/* граница стека */
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить token и header
+	if (!memIsValid(token, len) ||
+		!memIsNullOrValid(header, 16))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignKeyUnwrap_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// проверить длину токена
+	if (len < 32 + no)
+	{
+		blobClose(state);
+		return ERR_BAD_KEYTOKEN;
+	}
+	// проверить входные указатели
+	if (!memIsValid(privkey, no) ||
+		!memIsValid(key, len - 16 - no))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	d = objEnd(ec, word);
+	R = d + n;
+	t1 = R + 2 * n;
+	t2 = t1 + n;
+	theta = (octet*)d;
+	header2 = theta + 32;
+	if (5 * no >= 48)
+		stack = t2 + n;
+	else
+		stack = header2 + 16;
+	// загрузить d
+	wwFrom(d, privkey, no);
+	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PRIVKEY;
+	}
+	// xR <- x
+	if (!qrFrom(R, token, ec->f, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_KEYTOKEN;
+	}
+	// t1 <- x^3 + a x + b
+	qrSqr(t1, R, ec->f, stack);
+	zmAdd(t1, t1, ec->A, ec->f);
+	qrMul(t1, t1, R, ec->f, stack);
+	zmAdd(t1, t1, ec->B, ec->f);
+	// yR <- t1^{(p + 1) / 4}
+	bignSqrt(R + n, t1, ec, stack);
+	// t2 <- yR^2
+	qrSqr(t2, R + n, ec->f, stack);
+	// (xR, yR) на кривой? t1 == t2?
+	if (!wwEq(t1, t2, n))
+	{
+		blobClose(state);
+		return ERR_BAD_KEYTOKEN;
+	}
+	// R <- d R
+	if (!ecMulRegA(R, R, ec, d, n, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_PARAMS;
+	}
+	// theta <- <R>_{256}
+	qrTo(theta, ecX(R), ec->f, stack);
+	// сформировать данные для расшифрования
+	memCopy(key, token + no, len - no - 16);
+	memCopy(header2, token + len - 16, 16);
+	// расшифровать
+	beltKWPStart(stack, theta, 32);
+	beltKWPStepD2(key, header2, len - no, stack);
+	// проверить целостность
+	if (header && !memEq(header, header2, 16) ||
+		header == 0 && !memIsZero(header2, 16))
+	{
+		memSetZero(key, len - no - 16);
+		code = ERR_BAD_KEYTOKEN;
+	}
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+/*
+*******************************************************************************
+Пакетный транспорт ключа
+
+При создании токенов для нескольких получателей описание кривой строится 
+один раз. Одноразовые личные ключи k генерируются последовательно 
+в вызывающем потоке и до момента использования хранятся в состоянии, 
+которое очищается при закрытии. Выходные буферы токенов до шифрования 
+секретных данных не содержат. Точки kG вычисляются 
+по таблице кратных базовой точки, точки kQ -- регулярным алгоритмом. 
+Переход к аффинным координатам выполняется порциями по BIGN_WRAP_BLOCK 
+получателей с одним обращением в базовом поле на порцию (2 точки на 
+получателя). Порции распределяются между потоками.
+
+При разборе токенов одним личным ключом d точки R восстанавливаются 
+по x-координатам, точки dR вычисляются регулярным алгоритмом и 
+переводятся в аффинные координаты порциями, как и при создании токенов.
+*******************************************************************************
+*/
+
+#define BIGN_WRAP_BLOCK 16
+
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	const word* tbl;		/*< таблица кратных базовой точки */
+	const word* ks;			/*< одноразовые личные ключи */
+	octet* tokens;			/*< токены */
+	const octet* keys;		/*< ключи */
+	size_t key_step;		/*< расстояние между ключами (0 или len) */
+	size_t len;				/*< длина ключа */
+	const octet* header;	/*< заголовок ключа */
+	const octet* pubkeys;	/*< открытые ключи получателей */
+	err_t* codes;			/*< коды ошибок */
+	size_t count;			/*< число получателей */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_wrap_job;
+
+static void bignWrapRun(void* arg)
+{
+	const bign_wrap_job* job = (const bign_wrap_job*)arg;
+	const ec_o* ec = job->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	const size_t token_len = no + job->len + 16;
+	size_t i, j, count;
+	// переменные в stack
+	word* Q;
+	octet* theta;
+	word* pts;
+	void* stack;
+	// раскладка stack
+	Q = (word*)job->stack;
+	theta = (octet*)(Q + 2 * n);
+	pts = (word*)theta + n;
+	stack = pts + 2 * BIGN_WRAP_BLOCK * ec->d * n;
+	// цикл по порциям
+	for (i = job->start * BIGN_WRAP_BLOCK; i < job->count; 
+		i += job->step * BIGN_WRAP_BLOCK)
+	{
+		count = MIN2(BIGN_WRAP_BLOCK, job->count - i);
+		// pts[2j] <- k Q, pts[2j + 1] <- k G
+		for (j = 0; j < count; ++j)
+		{
+			octet* token = job->tokens + (i + j) * token_len;
+			const octet* pubkey = job->pubkeys + 2 * (i + j) * no;
+			const word* k = job->ks + (i + j) * n;
+			word* R = pts + 2 * j * ec->d * n;
+			if (job->codes[i + j] == ERR_OK)
+			{
+				if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
+					!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack))
+					job->codes[i + j] = ERR_BAD_PUBKEY;
+				else if (!ecMulReg(R, Q, ec, k, n, stack) ||
+					!ecMulTbl(R + ec->d * n, job->tbl, ec, k, n, stack))
+					job->codes[i + j] = ERR_BAD_PARAMS;
+			}
+			if (job->codes[i + j] != ERR_OK)
+			{
+				memSetZero(token, token_len);
+				ecFromA(R, ec->base, ec, stack);
+				ecFromA(R + ec->d * n, ec->base, ec, stack);
+			}
+		}
+		// к аффинным координатам
+		ecToABatch(pts, pts, 2 * count, ec, stack);
+		// сформировать токены
+		for (j = 0; j < count; ++j)
+		{
+			octet* token = job->tokens + (i + j) * token_len;
+			const word* R = pts + 4 * j * n;
+			if (job->codes[i + j] != ERR_OK)
+				continue;
+			// theta <- <kQ>_{256}
+			qrTo(theta, ecX(R), ec->f, stack);
+			// зашифровать key || header
+			memCopy(token + no, job->keys + (i + j) * job->key_step, 
+				job->len);
+			if (job->header)
+				memCopy(token + no + job->len, job->header, 16);
+			else
+				memSetZero(token + no + job->len, 16);
+			beltKWPStart(stack, theta, 32);
+			beltKWPStepE(token + no, job->len + 16, stack);
+			// <kG>
+			qrTo(token, ecX(R + 2 * n), ec->f, stack);
+		}
+	}
+	// очистка
+	memSetZero(theta, no);
+	wwSetZero(pts, 2 * BIGN_WRAP_BLOCK * ec->d * n);
+}
+
+static size_t bignWrapRun_deep(size_t l)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return O_OF_W(3 * n + 2 * BIGN_WRAP_BLOCK * ec_d * n) +
+		O_OF_W(W_OF_O(utilMax(6,
+			f_deep,
+			ec_deep,
+			ecMulReg_deep(n, ec_d, ec_deep, n),
+			ecMulTbl_deep(n, ec_d, ec_deep, n),
+			ecToABatch_deep(n, ec_d, ec_deep, 2 * BIGN_WRAP_BLOCK),
+			beltKWP_keep())));
+}
+
+static size_t bignKeyWrapBatch_keep(size_t l, size_t count, bool_t pre, 
+	size_t threads)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return bignStart_keep(l, 0) + 
+		O_OF_W(count * n) + (pre ? ecTblCreateA_keep(n, n) : 0) +
+		utilMax(3,
+			f_deep,
+			pre ? ecTblCreateA_deep(n, ec_d, ec_deep) : 
+				bignTblCheck_deep(n, f_deep),
+			threads * (bignWrapRun_deep(l) + sizeof(bign_wrap_job)));
+}
+
+err_t bignKeyWrapBatch2(octet tokens[], err_t codes[], 
+	const bign_params* params, const octet tbl[], const octet keys[], 
+	size_t keys_count, size_t len, const octet header[16], 
+	const octet pubkeys[], size_t count, gen_i rng, void* rng_state, 
+	size_t threads)
+{
+	err_t code;
+	size_t no, n, i;
+	size_t job_deep;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* ks;				/* [count * n] одноразовые личные ключи */
+	word* pre;				/* таблица кратных базовой точки */
+	void* stack;
+	bign_wrap_job* jobs;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (len < 16 ||
+		keys_count != 1 && keys_count != count ||
+		!memIsValid(keys, keys_count * len) ||
+		!memIsNullOrValid(header, 16) ||
+		!memIsValid(pubkeys, 2 * count * no) ||
+		!memIsValid(codes, count * sizeof(err_t)) ||
+		!memIsValid(tokens, count * (no + len + 16)) ||
+		!memIsDisjoint2(tokens, count * (no + len + 16), 
+			keys, keys_count * len) ||
+		!memIsDisjoint2(tokens, count * (no + len + 16), 
+			pubkeys, 2 * count * no) ||
+		header && !memIsDisjoint2(tokens, count * (no + len + 16), 
+			header, 16) ||
+		!memIsNullOrValid(tbl, BIGN_TBL_HDR + bignTblLen(params->l)) ||
+		tbl && (size_t)tbl % O_PER_W)
+		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_WRAP_BLOCK - 1) / BIGN_WRAP_BLOCK);
+	// создать состояние
+	state = blobCreate(bignKeyWrapBatch_keep(params->l, count, tbl == 0, 
+		threads));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	n = ec->f->n;
+	job_deep = bignWrapRun_deep(params->l);
+	// раскладка состояния
+	ks = objEnd(ec, word);
+	pre = ks + count * n;
+	stack = tbl ? (void*)pre : (octet*)pre + ecTblCreateA_keep(n, n);
+	// проверить образ или построить таблицу кратных G
+	if (tbl)
+		code = bignTblCheck(tbl, params, ec, stack);
+	else if (!ecTblCreateA(pre, ec->base, ec, n, stack))
+		code = ERR_BAD_PARAMS;
+	if (code != ERR_OK)
+	{
+		blobClose(state);
+		return code;
+	}
+	// k[i] <-R {1,2,..., q - 1}
+	for (i = 0; i < count; ++i)
+		codes[i] = zzRandNZMod(ks + i * n, ec->order, n, rng, rng_state) ?
+			ERR_OK : ERR_BAD_RNG;
+	// подготовить задания
+	jobs = (bign_wrap_job*)((octet*)stack + threads * job_deep);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].tbl = tbl ? (const word*)(tbl + BIGN_TBL_HDR) : pre;
+		jobs[i].ks = ks;
+		jobs[i].tokens = tokens;
+		jobs[i].keys = keys;
+		jobs[i].key_step = keys_count == 1 ? 0 : len;
+		jobs[i].len = len;
+		jobs[i].header = header;
+		jobs[i].pubkeys = pubkeys;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(bignWrapRun, jobs, sizeof(bign_wrap_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+err_t bignKeyWrapBatch(octet tokens[], err_t codes[], 
+	const bign_params* params, const octet keys[], size_t keys_count, 
+	size_t len, const octet header[16], const octet pubkeys[], size_t count,
+	gen_i rng, void* rng_state, size_t threads)
+{
+	return bignKeyWrapBatch2(tokens, codes, params, 0, keys, keys_count, 
+		len, header, pubkeys, count, rng, rng_state, threads);
+}
+
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	const word* d;			/*< личный ключ */
+	octet* keys;			/*< ключи */
+	const octet* tokens;	/*< токены */
+	size_t len;				/*< длина токена */
+	const octet* header;	/*< заголовок ключа */
+	err_t* codes;			/*< коды ошибок */
+	size_t count;			/*< число токенов */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_unwrap_job;
+
+static void bignUnwrapRun(void* arg)
+{
+	const bign_unwrap_job* job = (const bign_unwrap_job*)arg;
+	const ec_o* ec = job->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	const size_t key_len = job->len - no - 16;
+	size_t i, j, count;
+	// переменные в stack
+	word* R;
+	octet* theta;
+	octet* header2;
+	word* pts;
+	void* stack;
+	// раскладка stack
+	R = (word*)job->stack;
+	theta = (octet*)(R + 2 * n);
+	header2 = theta + O_OF_W(n);
+	pts = (word*)(header2 + 16);
+	stack = pts + BIGN_WRAP_BLOCK * ec->d * n;
+	// цикл по порциям
+	for (i = job->start * BIGN_WRAP_BLOCK; i < job->count; 
+		i += job->step * BIGN_WRAP_BLOCK)
+	{
+		count = MIN2(BIGN_WRAP_BLOCK, job->count - i);
+		// pts[j] <- d R
+		for (j = 0; j < count; ++j)
+		{
+			const octet* token = job->tokens + (i + j) * job->len;
+			word* P = pts + j * ec->d * n;
+			// R <- (x, y), (x, y) на кривой?
+			if (!qrFrom(R, token, ec->f, stack) ||
+				!bignRecoverY(R + n, R, ec, stack))
+				job->codes[i + j] = ERR_BAD_KEYTOKEN;
+			else if (!ecMulReg(P, R, ec, job->d, n, stack))
+				job->codes[i + j] = ERR_BAD_PARAMS;
+			else
+				job->codes[i + j] = ERR_OK;
+			if (job->codes[i + j] != ERR_OK)
+				ecFromA(P, ec->base, ec, stack);
+		}
+		// к аффинным координатам
+		ecToABatch(pts, pts, count, ec, stack);
+		// расшифровать
+		for (j = 0; j < count; ++j)
+		{
+			const octet* token = job->tokens + (i + j) * job->len;
+			octet* key = job->keys + (i + j) * key_len;
+			if (job->codes[i + j] != ERR_OK)
+			{
+				memSetZero(key, key_len);
+				continue;
+			}
+			// theta <- <dR>_{256}
+			qrTo(theta, ecX(pts + 2 * j * n), ec->f, stack);
+			// расшифровать
+			memCopy(key, token + no, key_len);
+			memCopy(header2, token + job->len - 16, 16);
+			beltKWPStart(stack, theta, 32);
+			beltKWPStepD2(key, header2, job->len - no, stack);
+			// проверить целостность
+			if (job->header && !memEq(job->header, header2, 16) ||
+				job->header == 0 && !memIsZero(header2, 16))
+			{
+				memSetZero(key, key_len);
+				job->codes[i + j] = ERR_BAD_KEYTOKEN;
+			}
+		}
+	}
+	// очистка
+	memSetZero(theta, O_OF_W(n));
+	wwSetZero(pts, BIGN_WRAP_BLOCK * ec->d * n);
+}
+
+static size_t bignUnwrapRun_deep(size_t l)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return O_OF_W(3 * n + BIGN_WRAP_BLOCK * ec_d * n) + 16 +
+		O_OF_W(W_OF_O(utilMax(6,
+			f_deep,
+			ec_deep,
+			bignRecoverY_deep(n, f_deep),
+			ecMulReg_deep(n, ec_d, ec_deep, n),
+			ecToABatch_deep(n, ec_d, ec_deep, BIGN_WRAP_BLOCK),
+			beltKWP_keep())));
+}
 
-static size_t bignKeyUnwrap_deep(size_t n, size_t f_deep, size_t ec_d,
-	size_t ec_deep)
+static size_t bignKeyUnwrapBatch_keep(size_t l, size_t threads)
 {
-	return MAX2(O_OF_W(5 * n), 32 + 16) +
-		utilMax(3,
-			beltKWP_keep(),
-			qrPower_deep(n, n, f_deep),
-			ecMulA_deep(n, ec_d, ec_deep, n));
+	const size_t n = W_OF_B(2 * l);
+	return bignStart_keep(l, 0) + O_OF_W(n) +
+		threads * (bignUnwrapRun_deep(l) + sizeof(bign_unwrap_job));
 }
 
-err_t bignKeyUnwrap(octet key[], const bign_params* params, const octet token[], 
-	size_t len, const octet header[16], const octet privkey[])
+err_t bignKeyUnwrapBatch(octet keys[], err_t codes[], 
+	const bign_params* params, const octet tokens[], size_t len, 
+	size_t count, const octet header[16], const octet privkey[], 
+	size_t threads)
 {
 	err_t code;
-	size_t no, n;
-	// состояние (буферы могут пересекаться)
+	size_t no, n, i;
+	size_t job_deep;
+	// состояние
 	void* state;
 	ec_o* ec;				/* описание эллиптической кривой */
 	word* d;				/* [n] личный ключ */
-	word* R;				/* [2n] точка R */
-	word* t1;				/* [n] вспомогательное число */
-	word* t2;				/* [n] вспомогательное число */
-	octet* theta;			/* [32] ключ защиты */
-	octet* header2;			/* [16] заголовок2 */
-	void* stack;			/* граница стека */
+	void* stack;
+	bign_unwrap_job* jobs;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
 		return ERR_BAD_INPUT;
 	if (params->l != 128 && params->l != 192 && params->l != 256)
 		return ERR_BAD_PARAMS;
-	// проверить token и header
-	if (!memIsValid(token, len) ||
-		!memIsNullOrValid(header, 16))
+	// проверить длину токенов
+	no = O_OF_B(2 * params->l);
+	if (len < 32 + no)
+		return ERR_BAD_KEYTOKEN;
+	// проверить входные указатели
+	if (!memIsValid(tokens, count * len) ||
+		!memIsNullOrValid(header, 16) ||
+		!memIsValid(privkey, no) ||
+		!memIsValid(codes, count * sizeof(err_t)) ||
+		!memIsValid(keys, count * (len - no - 16)) ||
+		!memIsDisjoint2(keys, count * (len - no - 16), tokens, count * len))
 		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_WRAP_BLOCK - 1) / BIGN_WRAP_BLOCK);
 	// создать состояние
-	state = blobCreate(bignStart_keep(params->l, bignKeyUnwrap_deep));
+	state = blobCreate(bignKeyUnwrapBatch_keep(params->l, threads));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// старт
 	code = bignStart(state, params);
 	ERR_CALL_HANDLE(code, blobClose(state));
 	ec = (ec_o*)state;
-	// размерности
-	no  = ec->f->no;
 	n = ec->f->n;
-	// проверить длину токена
-	if (len < 32 + no)
-	{
-		blobClose(state);
-		return ERR_BAD_KEYTOKEN;
-	}
-	// проверить входные указатели
-	if (!memIsValid(privkey, no) ||
-		!memIsValid(key, len - 16 - no))
-	{
-		blobClose(state);
-		return ERR_BAD_INPUT;
-	}
+	job_deep = bignUnwrapRun_deep(params->l);
 	// раскладка состояния
 	d = objEnd(ec, word);
-	R = d + n;
-	t1 = R + 2 * n;
-	t2 = t1 + n;
-	theta = (octet*)d;
-	header2 = theta + 32;
-	if (5 * no >= 48)
-		stack = t2 + n;
-	else
-		stack = header2 + 16;
+	stack = d + n;
 	// загрузить d
 	wwFrom(d, privkey, no);
 	if (wwIsZero(d, n) || wwCmp(d, ec->order, n) >= 0)
@@ -1251,51 +2858,26 @@ err_t bignKeyUnwrap(octet key[], const bign_params* params, const octet token[],
 		blobClose(state);
 		return ERR_BAD_PRIVKEY;
 	}
-	// xR <- x
-	if (!qrFrom(R, token, ec->f, stack))
-	{
-		blobClose(state);
-		return ERR_BAD_KEYTOKEN;
-	}
-	// t1 <- x^3 + a x + b
-	qrSqr(t1, R, ec->f, stack);
-	zmAdd(t1, t1, ec->A, ec->f);
-	qrMul(t1, t1, R, ec->f, stack);
-	zmAdd(t1, t1, ec->B, ec->f);
-	// yR <- t1^{(p + 1) / 4}
-	wwCopy(R + n, ec->f->mod, n);
-	zzAddW2(R + n, n, 1);
-	wwShLo(R + n, n, 2);
-	qrPower(R + n, t1, R + n, n, ec->f, stack);
-	// t2 <- yR^2
-	qrSqr(t2, R + n, ec->f, stack);
-	// (xR, yR) на кривой? t1 == t2?
-	if (!wwEq(t1, t2, n))
-	{
-		blobClose(state);
-		return ERR_BAD_KEYTOKEN;
-	}
-	// R <- d R
-	if (!ecMulA(R, R, ec, d, n, stack))
-	{
-		blobClose(state);
-		return ERR_BAD_PARAMS;
-	}
-	// theta <- <R>_{256}
-	qrTo(theta, ecX(R), ec->f, stack);
-	// сформировать данные для расшифрования
-	memCopy(key, token + no, len - no - 16);
-	memCopy(header2, token + len - 16, 16);
-	// расшифровать
-	beltKWPStart(stack, theta, 32);
-	beltKWPStepD2(key, header2, len - no, stack);
-	// проверить целостность
-	if (header && !memEq(header, header2, 16) ||
-		header == 0 && !memIsZero(header2, 16))
+	// подготовить задания
+	jobs = (bign_unwrap_job*)((octet*)stack + threads * job_deep);
+	for (i = 0; i < threads; ++i)
 	{
-		memSetZero(key, len - no - 16);
-		code = ERR_BAD_KEYTOKEN;
+		jobs[i].ec = ec;
+		jobs[i].d = d;
+		jobs[i].keys = keys;
+		jobs[i].tokens = tokens;
+		jobs[i].len = len;
+		jobs[i].header = header;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
 	}
+	// выполнить задания
+	mtRunJobs(bignUnwrapRun, jobs, sizeof(bign_unwrap_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
 	// завершение
 	blobClose(state);
 	return code;
@@ -1416,6 +2998,317 @@ err_t bignIdExtract(octet id_privkey[], octet id_pubkey[],
 	return code;
 }
 
+/*
+*******************************************************************************
+Пакетное извлечение ключей идентификационной ЭЦП
+
+Описание кривой строится один раз. Для базовой точки G и открытого ключа
+центра Q строятся таблицы кратных (см. ecTblCreateA()). Поэтому точки
+R = s1 G + (s0 + 2^l) Q вычисляются без удвоений: две кратные точки
+находятся по таблицам и складываются в проективных координатах. Переход
+к аффинным координатам выполняется порциями по BIGN_ID_BLOCK точек
+с одним обращением в базовом поле на порцию (см. ecToABatch()). Порции
+распределяются между потоками. Состояние хэширования после обработки
+oid_der и кольцо вычетов по модулю q (см. bignCreateRing()) также
+готовятся один раз. Подготовка общая с bignIdVerifyBatch().
+
+Таблица кратных строится только для точки Q, которая лежит на кривой.
+Поэтому в отличие от bignIdExtract() принадлежность Q кривой проверяется.
+*******************************************************************************
+*/
+
+#define BIGN_ID_BLOCK 32
+
+/*
+Общая часть пакетных функций bignIdExtractBatch() и bignIdVerifyBatch():
+описание кривой, таблицы кратных точек G и Q (для Q -- кратных с m-словными
+множителями), кольцо вычетов по модулю q и состояние хэширования после
+обработки oid_der. Раскладка состояния после описания кривой:
+Q || tbl_G || tbl_Q || hash_state || r || stack.
+*/
+
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	const word* tbl_G;		/*< таблица кратных базовой точки */
+	const word* tbl_Q;		/*< таблица кратных открытого ключа */
+	const qr_o* r;			/*< кольцо вычетов по модулю q */
+	const octet* hash_state;/*< состояние хэширования после oid_der */
+	void* stack;			/*< вспомогательная память */
+} bign_id_batch;
+
+static size_t bignIdBatchRun_deep(size_t l, size_t vars_keep)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return vars_keep + O_OF_W(ec_d * n + BIGN_ID_BLOCK * ec_d * n) +
+		beltHash_keep() +
+		O_OF_W(W_OF_O(utilMax(7,
+			f_deep,
+			ec_deep,
+			ecpIsOnA_deep(n, f_deep),
+			bignCreateRing_deep(n),
+			ecAddMul_deep(n, ec_d, ec_deep, 1, n / 2 + 1),
+			ecMulTbl_deep(n, ec_d, ec_deep, n),
+			ecToABatch_deep(n, ec_d, ec_deep, BIGN_ID_BLOCK))));
+}
+
+static size_t bignIdBatch_keep(size_t l, size_t m, size_t jobs_keep)
+{
+	const size_t no = O_OF_B(2 * l);
+	const size_t n = W_OF_B(2 * l);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	return bignStart_keep(l, 0) + O_OF_W(2 * n) +
+		ecTblCreateA_keep(n, n) + ecTblCreateA_keep(n, m) +
+		beltHash_keep() + bignCreateRing_keep(n) +
+		utilMax(5,
+			f_deep,
+			ecpIsOnA_deep(n, f_deep),
+			ecTblCreateA_deep(n, ec_d, ec_deep),
+			bignCreateRing_deep(n),
+			jobs_keep);
+}
+
+static err_t bignIdBatchStart(bign_id_batch* batch, void* state,
+	const bign_params* params, const octet oid_der[], size_t oid_len,
+	const octet pubkey[], size_t m)
+{
+	err_t code;
+	size_t no, n;
+	ec_o* ec;
+	word* Q;
+	word* tbl_G;
+	word* tbl_Q;
+	octet* hash_state;
+	qr_o* r;
+	void* stack;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_CHECK(code);
+	ec = (ec_o*)state;
+	no = ec->f->no;
+	n = ec->f->n;
+	// раскладка состояния
+	Q = objEnd(ec, word);
+	tbl_G = Q + 2 * n;
+	tbl_Q = tbl_G + W_OF_O(ecTblCreateA_keep(n, n));
+	hash_state = (octet*)(tbl_Q + W_OF_O(ecTblCreateA_keep(n, m)));
+	r = (qr_o*)(hash_state + beltHash_keep());
+	stack = (octet*)r + bignCreateRing_keep(n);
+	// загрузить и проверить Q
+	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
+		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack) ||
+		!ecpIsOnA(Q, ec, stack))
+		return ERR_BAD_PUBKEY;
+	// построить таблицы кратных
+	if (!ecTblCreateA(tbl_G, ec->base, ec, n, stack) ||
+		!ecTblCreateA(tbl_Q, Q, ec, m, stack))
+		return ERR_BAD_PUBKEY;
+	// belt-hash(oid...)
+	beltHashStart(hash_state);
+	beltHashStepH(oid_der, oid_len, hash_state);
+	// создать кольцо вычетов по модулю q
+	bignCreateRing(r, ec, stack);
+	// описание
+	batch->ec = ec;
+	batch->tbl_G = tbl_G, batch->tbl_Q = tbl_Q;
+	batch->r = r;
+	batch->hash_state = hash_state;
+	batch->stack = stack;
+	return ERR_OK;
+}
+
+typedef struct
+{
+	const bign_id_batch* batch;	/*< общая часть */
+	octet* id_privkeys;		/*< личные ключи */
+	octet* id_pubkeys;		/*< открытые ключи */
+	const octet* id_hashes;	/*< хэш-значения идентификаторов */
+	const octet* sigs;		/*< подписи */
+	err_t* codes;			/*< коды ошибок */
+	size_t count;			/*< число ключей */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_id_extract_job;
+
+static void bignIdExtractRun(void* arg)
+{
+	const bign_id_extract_job* job = (const bign_id_extract_job*)arg;
+	const bign_id_batch* batch = job->batch;
+	const ec_o* ec = batch->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	size_t i, j, count;
+	// переменные в stack
+	word* s0;
+	word* s1;
+	word* H;
+	word* T;
+	word* pts;
+	octet* hash_state;
+	void* stack;
+	// раскладка stack
+	s0 = (word*)job->stack;
+	s1 = s0 + n / 2 + 1;
+	H = s1 + n;
+	T = H + n;
+	pts = T + ec->d * n;
+	hash_state = (octet*)(pts + BIGN_ID_BLOCK * ec->d * n);
+	stack = hash_state + beltHash_keep();
+	// цикл по порциям
+	for (i = job->start * BIGN_ID_BLOCK; i < job->count;
+		i += job->step * BIGN_ID_BLOCK)
+	{
+		count = MIN2(BIGN_ID_BLOCK, job->count - i);
+		// pts[j] <- s1 G + (s0 + 2^l) Q
+		for (j = 0; j < count; ++j)
+		{
+			const octet* sig = job->sigs + (i + j) * (no + no / 2);
+			word* R = pts + j * ec->d * n;
+			// загрузить и проверить s1
+			wwFrom(s1, sig + no / 2, no);
+			if (!zmIsIn(s1, batch->r))
+				job->codes[i + j] = ERR_BAD_SIG;
+			else
+			{
+				// s1 <- (s1 + H) mod q
+				wwFrom(H, job->id_hashes + (i + j) * no, no);
+				if (!zmIsIn(H, batch->r))
+					zzSub2(H, ec->order, n);
+				zmAdd(s1, s1, H, batch->r);
+				wwTo(job->id_privkeys + (i + j) * no, no, s1);
+				// загрузить s0
+				wwFrom(s0, sig, no / 2);
+				s0[n / 2] = 1;
+				// R <- s1 G + (s0 + 2^l) Q
+				ecMulTbl(R, batch->tbl_G, ec, s1, n, stack);
+				ecMulTbl(T, batch->tbl_Q, ec, s0, n / 2 + 1, stack);
+				ecAdd(R, R, T, ec, stack);
+				job->codes[i + j] = ecIsO(R, ec) ? ERR_BAD_SIG : ERR_OK;
+			}
+			if (job->codes[i + j] != ERR_OK)
+				ecFromA(R, ec->base, ec, stack);
+		}
+		// к аффинным координатам
+		ecToABatch(pts, pts, count, ec, stack);
+		// проверить s0 и выгрузить ключи
+		for (j = 0; j < count; ++j)
+		{
+			const octet* id_hash = job->id_hashes + (i + j) * no;
+			const octet* sig = job->sigs + (i + j) * (no + no / 2);
+			octet* id_privkey = job->id_privkeys + (i + j) * no;
+			octet* id_pubkey = job->id_pubkeys + 2 * (i + j) * no;
+			const word* R = pts + 2 * j * n;
+			if (job->codes[i + j] == ERR_OK)
+			{
+				// s0 == belt-hash(oid || R || H)?
+				qrTo(id_pubkey, ecX(R), ec->f, stack);
+				memCopy(hash_state, batch->hash_state, beltHash_keep());
+				beltHashStepH(id_pubkey, no, hash_state);
+				beltHashStepH(id_hash, no, hash_state);
+				if (beltHashStepV2(sig, no / 2, hash_state))
+					qrTo(id_pubkey + no, ecY(R, n), ec->f, stack);
+				else
+					job->codes[i + j] = ERR_BAD_SIG;
+			}
+			if (job->codes[i + j] != ERR_OK)
+			{
+				memSetZero(id_privkey, no);
+				memSetZero(id_pubkey, 2 * no);
+			}
+		}
+	}
+	// очистка
+	wwSetZero(s1, n);
+	wwSetZero(pts, BIGN_ID_BLOCK * ec->d * n);
+}
+
+static size_t bignIdExtractRun_deep(size_t l)
+{
+	const size_t n = W_OF_B(2 * l);
+	return bignIdBatchRun_deep(l, O_OF_W(n / 2 + 1 + 2 * n));
+}
+
+static size_t bignIdExtractBatch_keep(size_t l, size_t threads)
+{
+	const size_t n = W_OF_B(2 * l);
+	return bignIdBatch_keep(l, n / 2 + 1,
+		threads * (bignIdExtractRun_deep(l) + sizeof(bign_id_extract_job)));
+}
+
+err_t bignIdExtractBatch(octet id_privkeys[], octet id_pubkeys[],
+	err_t codes[], const bign_params* params, const octet oid_der[],
+	size_t oid_len, const octet id_hashes[], const octet sigs[],
+	const octet pubkey[], size_t count, size_t threads)
+{
+	err_t code;
+	size_t no, n, i;
+	size_t job_deep;
+	// состояние
+	void* state;
+	bign_id_batch batch[1];
+	bign_id_extract_job* jobs;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (!memIsValid(id_hashes, count * no) ||
+		!memIsValid(sigs, count * (no + no / 2)) ||
+		!memIsValid(pubkey, 2 * no) ||
+		!memIsValid(id_privkeys, count * no) ||
+		!memIsValid(id_pubkeys, 2 * count * no) ||
+		!memIsValid(codes, count * sizeof(err_t)) ||
+		!memIsDisjoint2(id_privkeys, count * no, id_pubkeys, 2 * count * no))
+		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_ID_BLOCK - 1) / BIGN_ID_BLOCK);
+	// создать состояние
+	state = blobCreate(bignIdExtractBatch_keep(params->l, threads));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// подготовить общую часть
+	n = W_OF_B(2 * params->l);
+	code = bignIdBatchStart(batch, state, params, oid_der, oid_len, pubkey,
+		n / 2 + 1);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	job_deep = bignIdExtractRun_deep(params->l);
+	// подготовить задания
+	jobs = (bign_id_extract_job*)((octet*)batch->stack + threads * job_deep);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].batch = batch;
+		jobs[i].id_privkeys = id_privkeys, jobs[i].id_pubkeys = id_pubkeys;
+		jobs[i].id_hashes = id_hashes, jobs[i].sigs = sigs;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)batch->stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(bignIdExtractRun, jobs, sizeof(bign_id_extract_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	blobClose(state);
+	return code;
+}
+
 /*
 *******************************************************************************
 Выработка идентификационной ЭЦП
@@ -1425,12 +3318,11 @@ err_t bignIdExtract(octet id_privkey[], octet id_pubkey[],
 static size_t bignIdSign_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(4 * n) +
-		utilMax(4,
+	return O_OF_W(4 * n) + bignCreateRing_keep(n) +
+		utilMax(3,
 			beltHash_keep(),
-			ecMulA_deep(n, ec_d, ec_deep, n),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n));
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			bignCreateRing_deep(n));
 }
 
 err_t bignIdSign(octet id_sig[], const bign_params* params, 
@@ -1445,8 +3337,9 @@ err_t bignIdSign(octet id_sig[], const bign_params* params,
 	word* e;				/* [n] личный ключ */
 	word* k;				/* [n] одноразовый личный ключ */
 	word* V;				/* [2n] точка V */
-	word* s0;				/* [n/2] первая часть подписи */
+	word* s0;				/* [n] первая часть подписи */
 	word* s1;				/* [n] вторая часть подписи */
+	qr_o* r;				/* кольцо вычетов по модулю q */
 	octet* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
@@ -1483,8 +3376,9 @@ err_t bignIdSign(octet id_sig[], const bign_params* params,
 	e = s1 = objEnd(ec, word);
 	k = e + n;
 	V = k + n;
-	s0 = V + n + n / 2;
-	stack = (octet*)(V + 2 * n);
+	s0 = V + n;
+	r = (qr_o*)(V + 2 * n);
+	stack = (octet*)r + bignCreateRing_keep(n);
 	// загрузить e
 	wwFrom(e, id_privkey, no);
 	if (wwCmp(e, ec->order, n) >= 0)
@@ -1499,7 +3393,7 @@ err_t bignIdSign(octet id_sig[], const bign_params* params,
 		return ERR_BAD_RNG;
 	}
 	// V <- k G
-	if (!ecMulA(V, ec->base, ec, k, n, stack))
+	if (!ecMulRegA(V, ec->base, ec, k, n, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -1513,15 +3407,16 @@ err_t bignIdSign(octet id_sig[], const bign_params* params,
 	beltHashStepH(hash, no, stack);
 	beltHashStepG2(id_sig, no / 2, stack);
 	wwFrom(s0, id_sig, no / 2);
-	// V <- (s0 + 2^l) e
-	zzMul(V, s0, n / 2, e, n, stack);
-	V[n + n / 2] = zzAdd(V + n / 2, V + n / 2, e, n);
-	// s1 <- V mod q
-	zzMod(s1, V, n + n / 2 + 1, ec->order, n, stack);
+	// s0 <- s0 + 2^l
+	s0[n / 2] = 1;
+	wwSetZero(s0 + n / 2 + 1, n - n / 2 - 1);
+	// s1 <- s0 e mod q
+	bignCreateRing(r, ec, stack);
+	qrMul(s1, s0, e, r, stack);
 	// s1 <- (k - s1 - H) mod q
-	zzSubMod(s1, k, s1, ec->order, n);
+	zmSub(s1, k, s1, r);
 	wwFrom(k, hash, no);
-	zzSubMod(s1, s1, k, ec->order, n);
+	zmSub(s1, s1, k, r);
 	// выгрузить s1
 	wwTo(id_sig + no / 2, no, s1);
 	// все нормально
@@ -1532,13 +3427,12 @@ err_t bignIdSign(octet id_sig[], const bign_params* params,
 static size_t bignIdSign2_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(4 * n) + beltHash_keep() +
-		utilMax(5,
+	return O_OF_W(4 * n) + bignCreateRing_keep(n) + beltHash_keep() +
+		utilMax(4,
 			beltHash_keep(),
 			beltKWP_keep(),
-			ecMulA_deep(n, ec_d, ec_deep, n),
-			zzMul_deep(n / 2, n),
-			zzMod_deep(n + n / 2 + 1, n));
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			bignCreateRing_deep(n));
 }
 
 err_t bignIdSign2(octet id_sig[], const bign_params* params, 
@@ -1553,8 +3447,9 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 	word* e;				/* [n] личный ключ */
 	word* k;				/* [n] одноразовый личный ключ */
 	word* V;				/* [2n] точка V */
-	word* s0;				/* [n/2] первая часть подписи */
+	word* s0;				/* [n] первая часть подписи */
 	word* s1;				/* [n] вторая часть подписи */
+	qr_o* r;				/* кольцо вычетов по модулю q */
 	octet* hash_state;		/* [beltHash_keep] состояние хэширования */
 	octet* stack;
 	// проверить params
@@ -1592,9 +3487,10 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 	e = s1 = objEnd(ec, word);
 	k = e + n;
 	V = k + n;
-	s0 = V + n + n / 2;
+	s0 = V + n;
 	hash_state = (octet*)(V + 2 * n);
-	stack = hash_state + beltHash_keep();
+	r = (qr_o*)(hash_state + beltHash_keep());
+	stack = (octet*)r + bignCreateRing_keep(n);
 	// загрузить e
 	wwFrom(e, id_privkey, no);
 	if (wwCmp(e, ec->order, n) >= 0)
@@ -1628,7 +3524,7 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 		}
 	}
 	// V <- k G
-	if (!ecMulA(V, ec->base, ec, k, n, stack))
+	if (!ecMulRegA(V, ec->base, ec, k, n, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -1640,15 +3536,16 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 	beltHashStepH(hash, no, hash_state);
 	beltHashStepG2(id_sig, no / 2, hash_state);
 	wwFrom(s0, id_sig, no / 2);
-	// V <- (s0 + 2^l) e
-	zzMul(V, s0, n / 2, e, n, stack);
-	V[n + n / 2] = zzAdd(V + n / 2, V + n / 2, e, n);
-	// s1 <- V mod q
-	zzMod(s1, V, n + n / 2 + 1, ec->order, n, stack);
+	// s0 <- s0 + 2^l
+	s0[n / 2] = 1;
+	wwSetZero(s0 + n / 2 + 1, n - n / 2 - 1);
+	// s1 <- s0 e mod q
+	bignCreateRing(r, ec, stack);
+	qrMul(s1, s0, e, r, stack);
 	// s1 <- (k - s1 - H) mod q
-	zzSubMod(s1, k, s1, ec->order, n);
+	zmSub(s1, k, s1, r);
 	wwFrom(k, hash, no);
-	zzSubMod(s1, s1, k, ec->order, n);
+	zmSub(s1, s1, k, r);
 	// выгрузить s1
 	wwTo(id_sig + no / 2, no, s1);
 	// все нормально
@@ -1665,12 +3562,11 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 static size_t bignIdVerify_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(7 * n + 2) + beltHash_keep() +
-		utilMax(5,
+	return O_OF_W(8 * n) + beltHash_keep() + bignCreateRing_keep(n) +
+		utilMax(4,
 			beltHash_keep(),
 			ecpIsOnA_deep(n, f_deep),
-			zzMul_deep(n / 2, n / 2),
-			zzMod_deep(n + 1, n),
+			bignCreateRing_deep(n),
 			ecAddMulA_deep(n, ec_d, ec_deep, 3, n, n / 2 + 1, n));
 }
 
@@ -1686,11 +3582,12 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 	word* R;			/* [2n] открытый ключ R */
 	word* Q;			/* [2n] открытый ключ Q */
 	word* V;			/* [2n] точка V (V == R) */
-	word* s0;			/* [n / 2 + 1] первая часть подписи */
+	word* s0;			/* [n] первая часть подписи */
 	word* s1;			/* [n] вторая часть подписи */
-	word* t;			/* [n / 2] переменная t */
-	word* t1;			/* [n + 1] произведение (s0 + 2^l)(t + 2^l) */
+	word* t;			/* [n] переменная t */
+	word* t1;			/* [n] произведение (s0 + 2^l)(t + 2^l) */
 	octet* hash_state;	/* [beltHash_keep] состояние хэширования */
+	qr_o* r;			/* кольцо вычетов по модулю q */
 	octet* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(bign_params)))
@@ -1725,11 +3622,12 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 	R = V = objEnd(ec, word);
 	Q = R + 2 * n;
 	s0 = Q + 2 * n;
-	s1 = s0 + n / 2 + 1;
+	s1 = s0 + n;
 	t = s1 + n;
-	t1 = t + n / 2;
-	hash_state = (octet*)(t1 + n + 1);
-	stack = hash_state + beltHash_keep();
+	t1 = t + n;
+	hash_state = (octet*)(t1 + n);
+	r = (qr_o*)(hash_state + beltHash_keep());
+	stack = (octet*)r + bignCreateRing_keep(n);
 	// загрузить R
 	if (!qrFrom(ecX(R), id_pubkey, ec->f, stack) ||
 		!qrFrom(ecY(R, n), id_pubkey + no, ec->f, stack) ||
@@ -1764,6 +3662,7 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 	// загрузить s0
 	wwFrom(s0, id_sig, no / 2);
 	s0[n / 2] = 1;
+	wwSetZero(s0 + n / 2 + 1, n - n / 2 - 1);
 	// belt-hash(oid...)
 	beltHashStart(hash_state);
 	beltHashStepH(oid_der, oid_len, hash_state);
@@ -1774,12 +3673,11 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 	beltHashStepG2((octet*)t, no / 2, stack);
 	wwFrom(t, t, no / 2);
 	// t1 <- -(t + 2^l)(s0 + 2^l) mod q
-	zzMul(t1, t, n / 2, s0, n / 2, stack);
-	t1[n] = zzAdd2(t1 + n / 2, t, n / 2);
-	t1[n] += zzAdd2(t1 + n / 2, s0, n / 2);
-	++t1[n];
-	zzMod(t1, t1, n + 1, ec->order, n, stack);
-	zzNegMod(t1, t1, ec->order, n);
+	t[n / 2] = 1;
+	wwSetZero(t + n / 2 + 1, n - n / 2 - 1);
+	bignCreateRing(r, ec, stack);
+	qrMul(t1, t, s0, r, stack);
+	zmNeg(t1, t1, r);
 	// V <- s1 G + (s0 + 2^l) R + t Q
 	if (!ecAddMulA(V, ec, stack,
 		3, ec->base, s1, n, R, s0, n / 2 + 1, Q, t1, n))
@@ -1797,3 +3695,217 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 	blobClose(state);
 	return code;
 }
+
+/*
+*******************************************************************************
+Пакетная проверка идентификационной ЭЦП
+
+Описание кривой, таблицы кратных точек G и Q (см. ecTblCreateA())
+и состояние хэширования после обработки oid_der готовятся один раз.
+В точке V = s1 G + (s0 + 2^l) R + t Q слагаемые s1 G и t Q находятся
+по таблицам, слагаемое (s0 + 2^l) R -- функцией ecAddMul(), точки
+складываются в проективных координатах. Переход к аффинным координатам
+выполняется порциями по BIGN_ID_BLOCK подписей с одним обращением
+в базовом поле на порцию. Порции распределяются между потоками.
+
+Как и в bignIdExtractBatch(), принадлежность Q кривой проверяется.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	const bign_id_batch* batch;	/*< общая часть */
+	const octet* id_hashes;	/*< хэш-значения идентификаторов */
+	const octet* hashes;	/*< хэш-значения сообщений */
+	const octet* id_sigs;	/*< подписи */
+	const octet* id_pubkeys;/*< открытые ключи подписантов */
+	err_t* codes;			/*< коды проверки */
+	size_t count;			/*< число подписей */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} bign_id_verify_job;
+
+static void bignIdVerifyRun(void* arg)
+{
+	const bign_id_verify_job* job = (const bign_id_verify_job*)arg;
+	const bign_id_batch* batch = job->batch;
+	const ec_o* ec = batch->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	size_t i, j, count;
+	// переменные в stack
+	word* R;
+	word* s0;
+	word* s1;
+	word* t;
+	word* t1;
+	word* T;
+	word* pts;
+	octet* hash_state;
+	void* stack;
+	// раскладка stack
+	R = (word*)job->stack;
+	s0 = R + 2 * n;
+	s1 = s0 + n;
+	t = s1 + n;
+	t1 = t + n;
+	T = t1 + n;
+	pts = T + ec->d * n;
+	hash_state = (octet*)(pts + BIGN_ID_BLOCK * ec->d * n);
+	stack = hash_state + beltHash_keep();
+	// цикл по порциям
+	for (i = job->start * BIGN_ID_BLOCK; i < job->count;
+		i += job->step * BIGN_ID_BLOCK)
+	{
+		count = MIN2(BIGN_ID_BLOCK, job->count - i);
+		// pts[j] <- s1 G + (s0 + 2^l) R + t Q
+		for (j = 0; j < count; ++j)
+		{
+			const octet* id_hash = job->id_hashes + (i + j) * no;
+			const octet* id_sig = job->id_sigs + (i + j) * (no + no / 2);
+			const octet* id_pubkey = job->id_pubkeys + 2 * (i + j) * no;
+			word* V = pts + j * ec->d * n;
+			// загрузить R
+			if (!qrFrom(ecX(R), id_pubkey, ec->f, stack) ||
+				!qrFrom(ecY(R, n), id_pubkey + no, ec->f, stack) ||
+				!ecpIsOnA(R, ec, stack))
+				job->codes[i + j] = ERR_BAD_PUBKEY;
+			else
+			{
+				// загрузить и проверить s1
+				wwFrom(s1, id_sig + no / 2, no);
+				job->codes[i + j] = wwCmp(s1, ec->order, n) < 0 ?
+					ERR_OK : ERR_BAD_SIG;
+			}
+			if (job->codes[i + j] == ERR_OK)
+			{
+				// s1 <- (s1 + H) mod q
+				wwFrom(t, job->hashes + (i + j) * no, no);
+				if (wwCmp(t, ec->order, n) >= 0)
+					zzSub2(t, ec->order, n);
+				zzAddMod(s1, s1, t, ec->order, n);
+				// загрузить s0
+				wwFrom(s0, id_sig, no / 2);
+				s0[n / 2] = 1;
+				wwSetZero(s0 + n / 2 + 1, n - n / 2 - 1);
+				// t <- belt-hash(oid || R || H0)
+				memCopy(hash_state, batch->hash_state, beltHash_keep());
+				beltHashStepH(id_pubkey, no, hash_state);
+				beltHashStepH(id_hash, no, hash_state);
+				beltHashStepG2((octet*)t, no / 2, hash_state);
+				wwFrom(t, t, no / 2);
+				// t1 <- -(t + 2^l)(s0 + 2^l) mod q
+				t[n / 2] = 1;
+				wwSetZero(t + n / 2 + 1, n - n / 2 - 1);
+				qrMul(t1, t, s0, batch->r, stack);
+				zmNeg(t1, t1, batch->r);
+				// V <- s1 G + (s0 + 2^l) R + t1 Q
+				ecAddMul(V, ec, stack, 1, R, s0, n / 2 + 1);
+				ecMulTbl(T, batch->tbl_G, ec, s1, n, stack);
+				ecAdd(V, V, T, ec, stack);
+				ecMulTbl(T, batch->tbl_Q, ec, t1, n, stack);
+				ecAdd(V, V, T, ec, stack);
+				if (ecIsO(V, ec))
+					job->codes[i + j] = ERR_BAD_SIG;
+			}
+			if (job->codes[i + j] != ERR_OK)
+				ecFromA(V, ec->base, ec, stack);
+		}
+		// к аффинным координатам
+		ecToABatch(pts, pts, count, ec, stack);
+		// s0 == belt-hash(oid || V || H0 || H)?
+		for (j = 0; j < count; ++j)
+		{
+			if (job->codes[i + j] != ERR_OK)
+				continue;
+			qrTo((octet*)R, ecX(pts + 2 * j * n), ec->f, stack);
+			memCopy(hash_state, batch->hash_state, beltHash_keep());
+			beltHashStepH(R, no, hash_state);
+			beltHashStepH(job->id_hashes + (i + j) * no, no, hash_state);
+			beltHashStepH(job->hashes + (i + j) * no, no, hash_state);
+			if (!beltHashStepV2(job->id_sigs + (i + j) * (no + no / 2),
+				no / 2, hash_state))
+				job->codes[i + j] = ERR_BAD_SIG;
+		}
+	}
+}
+
+static size_t bignIdVerifyRun_deep(size_t l)
+{
+	const size_t n = W_OF_B(2 * l);
+	return bignIdBatchRun_deep(l, O_OF_W(6 * n));
+}
+
+static size_t bignIdVerifyBatch_keep(size_t l, size_t threads)
+{
+	const size_t n = W_OF_B(2 * l);
+	return bignIdBatch_keep(l, n,
+		threads * (bignIdVerifyRun_deep(l) + sizeof(bign_id_verify_job)));
+}
+
+err_t bignIdVerifyBatch(err_t codes[], const bign_params* params,
+	const octet oid_der[], size_t oid_len, const octet id_hashes[],
+	const octet hashes[], const octet id_sigs[], const octet id_pubkeys[],
+	const octet pubkey[], size_t count, size_t threads)
+{
+	err_t code;
+	size_t no, n, i;
+	size_t job_deep;
+	// состояние
+	void* state;
+	bign_id_batch batch[1];
+	bign_id_verify_job* jobs;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// проверить входные указатели
+	no = O_OF_B(2 * params->l);
+	if (!memIsValid(id_hashes, count * no) ||
+		!memIsValid(hashes, count * no) ||
+		!memIsValid(id_sigs, count * (no + no / 2)) ||
+		!memIsValid(id_pubkeys, 2 * count * no) ||
+		!memIsValid(pubkey, 2 * no) ||
+		!memIsValid(codes, count * sizeof(err_t)))
+		return ERR_BAD_INPUT;
+	if (count == 0)
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + BIGN_ID_BLOCK - 1) / BIGN_ID_BLOCK);
+	// создать состояние
+	state = blobCreate(bignIdVerifyBatch_keep(params->l, threads));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// подготовить общую часть
+	n = W_OF_B(2 * params->l);
+	code = bignIdBatchStart(batch, state, params, oid_der, oid_len, pubkey,
+		n);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	job_deep = bignIdVerifyRun_deep(params->l);
+	// подготовить задания
+	jobs = (bign_id_verify_job*)((octet*)batch->stack + threads * job_deep);
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].batch = batch;
+		jobs[i].id_hashes = id_hashes, jobs[i].hashes = hashes;
+		jobs[i].id_sigs = id_sigs, jobs[i].id_pubkeys = id_pubkeys;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)batch->stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(bignIdVerifyRun, jobs, sizeof(bign_id_verify_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	blobClose(state);
+	return code;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.04.03
-\version 2016.07.05
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -78,6 +78,46 @@ err_t bignStart(
 	const bign_params* params	/*!< [in] долговременные параметры */
 );
 
+/*!	\brief Кольцо вычетов по модулю порядка
+
+	По описанию ec, созданному функцией bignStart(), в r создается описание 
+	кольца вычетов по модулю порядка q группы точек. Используется редукция 
+	Барретта. Кольцо предназначено для арифметики скаляров (компонент 
+	подписи, эфемерных ключей).
+	\keep{r} bignCreateRing_keep(ec->f->n).
+	\deep{stack} bignCreateRing_deep(ec->f->n).
+	\remark Глубина bignCreateRing_deep() достаточна и для операций 
+	в созданном кольце.
+*/
+void bignCreateRing(
+	qr_o* r,				/*!< [out] описание кольца */
+	const ec_o* ec,			/*!< [in] описание кривой */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t bignCreateRing_keep(size_t n);
+size_t bignCreateRing_deep(size_t n);
+
+/*!	\brief Квадратный корень в базовом поле
+
+	По описанию ec, созданному функцией bignStart(), определяется 
+	[ec->f->n]b = a^{(p + 1) / 4}. Если a -- квадратичный вычет, то b -- 
+	квадратный корень из a. Для стандартных модулей p = 2^{2l} - c 
+	(c < 2^{16}) используется специализированная цепочка возведений 
+	в квадрат и умножений, для остальных модулей -- qrPower().
+	\pre Буферы a и b не пересекаются.
+	\deep{stack} bignSqrt_deep(ec->f->n, ec->f->deep).
+	\remark Цепочка сравнивается с qrPower() в ecpBench().
+*/
+void bignSqrt(
+	word b[],				/*!< [out] квадратный корень */
+	const word a[],			/*!< [in] квадратичный вычет */
+	const ec_o* ec,			/*!< [in] описание кривой */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t bignSqrt_deep(size_t n, size_t f_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
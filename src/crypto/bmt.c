@@ -0,0 +1,539 @@
+/*
+*******************************************************************************
+\file bmt.c
+\brief Merkle tree hashing over belt-hash and bash
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include "bee2/core/blob.h"
+#include "bee2/core/err.h"
+#include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
+#include "bee2/core/util.h"
+#include "bee2/crypto/bash.h"
+#include "bee2/crypto/belt.h"
+#include "bee2/crypto/bmt.h"
+
+/*
+*******************************************************************************
+Базовое хэширование
+
+Функции bmtH*() вызывают belt-hash (l == 0) или bash уровня l.
+При инициализации в состояние загружается октет tag, который разделяет
+хэширование листьев (BMT_TAG_LEAF), узлов (BMT_TAG_NODE) и вершины
+(BMT_TAG_ROOT).
+*******************************************************************************
+*/
+
+#define BMT_TAG_LEAF 0
+#define BMT_TAG_NODE 1
+#define BMT_TAG_ROOT 2
+
+static size_t bmtH_keep()
+{
+	return MAX2(beltHash_keep(), bashHash_keep());
+}
+
+static size_t bmtHLen(size_t l)
+{
+	return l ? l / 4 : 32;
+}
+
+static void bmtHStart(void* state, size_t l, octet tag)
+{
+	if (l)
+	{
+		bashHashStart(state, l);
+		bashHashStepH(&tag, 1, state);
+	}
+	else
+	{
+		beltHashStart(state);
+		beltHashStepH(&tag, 1, state);
+	}
+}
+
+static void bmtHStepH(const void* buf, size_t count, void* state, size_t l)
+{
+	if (l)
+		bashHashStepH(buf, count, state);
+	else
+		beltHashStepH(buf, count, state);
+}
+
+static void bmtHStepG(octet hash[], void* state, size_t l)
+{
+	if (l)
+		bashHashStepG(hash, l / 4, state);
+	else
+		beltHashStepG(hash, state);
+}
+
+static void bmtHLeaf(octet hash[], const void* leaf, size_t leaf_len,
+	size_t l, void* state)
+{
+	bmtHStart(state, l, BMT_TAG_LEAF);
+	bmtHStepH(leaf, leaf_len, state, l);
+	bmtHStepG(hash, state, l);
+}
+
+static void bmtHRoot(octet hash[], const octet top[], size_t leaf_size,
+	size_t count, size_t l, void* state)
+{
+	octet len[16];
+	size_t i;
+	// len <- <leaf_size>_64 || <count>_64
+	memSetZero(len, sizeof(len));
+	for (i = 0; i < MIN2(sizeof(size_t), 8); ++i)
+	{
+		len[i] = (octet)(leaf_size >> 8 * i);
+		len[8 + i] = (octet)(count >> 8 * i);
+	}
+	// hash <- h(02 || len || top)
+	bmtHStart(state, l, BMT_TAG_ROOT);
+	bmtHStepH(len, sizeof(len), state, l);
+	bmtHStepH(top, bmtHLen(l), state, l);
+	bmtHStepG(hash, state, l);
+	memSetZero(len, sizeof(len));
+}
+
+/*
+*******************************************************************************
+Параллельное хэширование листьев
+
+Листья [count]src с номерами 0, 1,..., n - 1 распределяются между потоками
+по принципу "поток i обрабатывает листья i, i + threads, i + 2 threads,...".
+Длина листьев обычно велика (сотни килобайт и больше), поэтому более
+крупные порции не требуются.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	size_t l;				/*< уровень стойкости */
+	size_t leaf_size;		/*< длина листа */
+	const octet* src;		/*< данные */
+	size_t count;			/*< длина данных */
+	size_t n;				/*< число листьев */
+	octet* hashes;			/*< хэш-значения листьев */
+	size_t start;			/*< первый лист */
+	size_t step;			/*< шаг по листьям */
+	void* state;			/*< состояние хэширования */
+} bmt_leaf_job;
+
+static void bmtLeafRun(void* arg)
+{
+	const bmt_leaf_job* job = (const bmt_leaf_job*)arg;
+	const size_t hash_len = bmtHLen(job->l);
+	size_t i, offset;
+	for (i = job->start; i < job->n; i += job->step)
+	{
+		offset = i * job->leaf_size;
+		bmtHLeaf(job->hashes + i * hash_len, job->src + offset,
+			MIN2(job->leaf_size, job->count - offset), job->l, job->state);
+	}
+}
+
+static size_t bmtLeaves_deep(size_t threads)
+{
+	return threads * (bmtH_keep() + sizeof(bmt_leaf_job));
+}
+
+static void bmtLeaves(octet hashes[], size_t l, size_t leaf_size,
+	const octet src[], size_t count, size_t n, size_t threads, void* stack)
+{
+	size_t i;
+	// переменные в stack
+	bmt_leaf_job* jobs;
+	octet* states;
+	// pre
+	ASSERT(n > 0 && (n - 1) * leaf_size <= count);
+	ASSERT(count - (n - 1) * leaf_size <= leaf_size);
+	// раскладка stack
+	threads = MIN2(MAX2(threads, 1), n);
+	jobs = (bmt_leaf_job*)stack;
+	states = (octet*)(jobs + threads);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].l = l;
+		jobs[i].leaf_size = leaf_size;
+		jobs[i].src = src, jobs[i].count = count, jobs[i].n = n;
+		jobs[i].hashes = hashes;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].state = states + i * bmtH_keep();
+	}
+	// выполнить задания
+	mtRunJobs(bmtLeafRun, jobs, sizeof(bmt_leaf_job), threads);
+}
+
+/*
+*******************************************************************************
+Инкрементальное хэширование
+
+В состоянии хранится текущий лист и текущие узлы уровней 1, 2,...,
+BMT_MAX_LEVELS (уровень 0 -- листья). Для каждого узла поддерживается
+состояние базового хэширования, в которое уже загружены хэш-значения
+потомков, и число этих потомков deg. Узел уровня j начат (deg > 0) только
+если на уровне j - 1 уже есть хотя бы два элемента.
+
+Лист или узел завершается "лениво": только когда появляется следующий
+элемент того же уровня или в bmtHashStepG(). Поэтому в bmtHashStepG()
+элемент, у которого нет соседей и у которого не начат родитель,
+является вершиной дерева. Это соответствует построению дерева
+по уровням, которое выполняется в bmtProve(), bmtVerify().
+
+Число листьев не превосходит 2^64, поэтому при BMT_ARITY >= 2 уровней
+узлов не больше 64.
+
+При параллельной обработке полные листья хэшируются порциями
+по threads * BMT_BATCH листьев. Память для хэш-значений порции
+выделяется на время вызова bmtHashStepH().
+*******************************************************************************
+*/
+
+#define BMT_MAX_LEVELS 64
+#define BMT_BATCH 16
+
+typedef struct
+{
+	size_t l;					/*< уровень стойкости */
+	size_t hash_len;			/*< длина хэш-значений */
+	size_t leaf_size;			/*< длина листа */
+	size_t threads;				/*< число потоков */
+	size_t count;				/*< число обработанных октетов */
+	size_t filled;				/*< накоплено октетов в текущем листе */
+	size_t deg[BMT_MAX_LEVELS];	/*< число потомков текущих узлов */
+	octet carry[64];			/*< переносимое хэш-значение */
+	octet h[64];				/*< хэш-значение завершенного узла */
+	octet states[];				/*< [(BMT_MAX_LEVELS + 1) * bmtH_keep()] */
+} bmt_hash_st;
+
+size_t bmtHash_keep()
+{
+	return sizeof(bmt_hash_st) + (BMT_MAX_LEVELS + 1) * bmtH_keep();
+}
+
+static void* bmtHashState(bmt_hash_st* s, size_t level)
+{
+	ASSERT(level <= BMT_MAX_LEVELS);
+	return s->states + level * bmtH_keep();
+}
+
+/*
+	Хэш-значение h добавляется к текущему узлу уровня j. Если узел
+	полон, то он предварительно завершается и передается на уровень j + 1.
+*/
+static void bmtHashAdd(bmt_hash_st* s, size_t j, const octet h[])
+{
+	void* state;
+	ASSERT(j > 0);
+	memMove(s->carry, h, s->hash_len);
+	for (;; ++j)
+	{
+		ASSERT(j <= BMT_MAX_LEVELS);
+		state = bmtHashState(s, j);
+		// есть место?
+		if (s->deg[j - 1] < BMT_ARITY)
+		{
+			if (s->deg[j - 1]++ == 0)
+				bmtHStart(state, s->l, BMT_TAG_NODE);
+			bmtHStepH(s->carry, s->hash_len, state, s->l);
+			break;
+		}
+		// завершить узел и начать новый с потомком carry
+		bmtHStepG(s->h, state, s->l);
+		bmtHStart(state, s->l, BMT_TAG_NODE);
+		bmtHStepH(s->carry, s->hash_len, state, s->l);
+		s->deg[j - 1] = 1;
+		// передать завершенный узел на следующий уровень
+		memCopy(s->carry, s->h, s->hash_len);
+	}
+}
+
+/*
+	Хэширование n полных листьев [n * leaf_size]buf в потоках.
+	Возвращается число обработанных листьев: n или 0, если не удалось
+	выделить память.
+*/
+static size_t bmtHashStepHMT(const octet buf[], size_t n, bmt_hash_st* s)
+{
+	const size_t batch = s->threads * BMT_BATCH;
+	void* stack;
+	octet* hashes;
+	size_t i, j, k;
+	// выделить память
+	stack = blobCreate(bmtLeaves_deep(s->threads) + batch * s->hash_len);
+	if (stack == 0)
+		return 0;
+	hashes = (octet*)stack + bmtLeaves_deep(s->threads);
+	// цикл по порциям
+	for (i = 0; i < n; i += k)
+	{
+		k = MIN2(batch, n - i);
+		bmtLeaves(hashes, s->l, s->leaf_size, buf + i * s->leaf_size,
+			k * s->leaf_size, k, s->threads, stack);
+		for (j = 0; j < k; ++j)
+			bmtHashAdd(s, 1, hashes + j * s->hash_len);
+	}
+	// завершить
+	blobClose(stack);
+	return n;
+}
+
+void bmtHashStart(void* state, size_t l, size_t leaf_size, size_t threads)
+{
+	bmt_hash_st* s = (bmt_hash_st*)state;
+	ASSERT(l % 16 == 0 && l <= 256);
+	ASSERT(leaf_size > 0);
+	ASSERT(memIsValid(s, bmtHash_keep()));
+	s->l = l, s->hash_len = bmtHLen(l);
+	s->leaf_size = leaf_size;
+	s->threads = MAX2(threads, 1);
+	s->count = s->filled = 0;
+	memSetZero(s->deg, sizeof(s->deg));
+	bmtHStart(bmtHashState(s, 0), l, BMT_TAG_LEAF);
+}
+
+void bmtHashStepH(const void* buf, size_t count, void* state)
+{
+	bmt_hash_st* s = (bmt_hash_st*)state;
+	size_t t;
+	ASSERT(memIsDisjoint2(buf, count, s, bmtHash_keep()));
+	while (count)
+	{
+		// текущий лист заполнен: завершить его
+		if (s->filled == s->leaf_size)
+		{
+			bmtHStepG(s->h, bmtHashState(s, 0), s->l);
+			bmtHashAdd(s, 1, s->h);
+			bmtHStart(bmtHashState(s, 0), s->l, BMT_TAG_LEAF);
+			s->filled = 0;
+		}
+		// несколько полных листьев (последний лист остается текущим)?
+		if (s->filled == 0 && s->threads > 1 && (count - 1) / s->leaf_size >= 2)
+		{
+			t = bmtHashStepHMT(buf, (count - 1) / s->leaf_size, s);
+			t *= s->leaf_size;
+			buf = (const octet*)buf + t;
+			count -= t, s->count += t;
+		}
+		// дополнить текущий лист
+		t = MIN2(count, s->leaf_size - s->filled);
+		bmtHStepH(buf, t, bmtHashState(s, 0), s->l);
+		buf = (const octet*)buf + t;
+		count -= t, s->count += t;
+		s->filled += t;
+	}
+}
+
+static void bmtHashStepG_internal(void* state)
+{
+	bmt_hash_st* s = (bmt_hash_st*)state;
+	void* node;
+	size_t j;
+	ASSERT(memIsValid(s, bmtHash_keep()));
+	// завершить текущий лист
+	bmtHStepG(s->h, bmtHashState(s, 0), s->l);
+	// завершать узлы, пока у элемента есть соседи или начат родитель
+	for (j = 1; j <= BMT_MAX_LEVELS && s->deg[j - 1]; ++j)
+	{
+		bmtHashAdd(s, j, s->h);
+		node = bmtHashState(s, j);
+		bmtHStepG(s->h, node, s->l);
+		s->deg[j - 1] = 0;
+	}
+	// h <- h(02 || <leaf_size>_64 || <count>_64 || h)
+	memCopy(s->carry, s->h, s->hash_len);
+	bmtHRoot(s->h, s->carry, s->leaf_size, s->count, s->l,
+		bmtHashState(s, 0));
+}
+
+void bmtHashStepG(octet hash[], void* state)
+{
+	bmt_hash_st* s = (bmt_hash_st*)state;
+	bmtHashStepG_internal(state);
+	memMove(hash, s->h, s->hash_len);
+}
+
+bool_t bmtHashStepV(const octet hash[], void* state)
+{
+	bmt_hash_st* s = (bmt_hash_st*)state;
+	bmtHashStepG_internal(state);
+	return memEq(hash, s->h, s->hash_len);
+}
+
+err_t bmtHash(octet hash[], size_t l, size_t leaf_size, const void* src,
+	size_t count, size_t threads)
+{
+	void* state;
+	// проверить входные данные
+	if (l % 16 != 0 || l > 256 || leaf_size == 0)
+		return ERR_BAD_PARAMS;
+	if (!memIsValid(src, count) || !memIsValid(hash, bmtHLen(l)))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(bmtHash_keep());
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// вычислить хэш-значение
+	bmtHashStart(state, l, leaf_size, threads);
+	bmtHashStepH(src, count, state);
+	bmtHashStepG(hash, state);
+	// завершить
+	blobClose(state);
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Доказательства принадлежности
+
+Дерево строится по уровням. На уровне из c элементов элемент с номером i
+входит в группу g = i / BMT_ARITY, которая начинается с элемента
+g * BMT_ARITY и содержит MIN2(BMT_ARITY, c - g * BMT_ARITY) элементов.
+На следующем уровне c' = ceil(c / BMT_ARITY) элементов, а номер предка
+равняется g.
+
+В bmtProve() хэш-значения всех листьев вычисляются (параллельно)
+и размещаются в одном буфере. Следующие уровни строятся в том же буфере:
+хэш-значение группы g записывается на место элемента g, которое
+не предшествует первому элементу группы.
+*******************************************************************************
+*/
+
+static size_t bmtLeafCount(size_t leaf_size, size_t count)
+{
+	return count ? (count - 1) / leaf_size + 1 : 1;
+}
+
+static size_t bmtProofLen(size_t n, size_t index, size_t hash_len)
+{
+	size_t len = 0;
+	size_t first;
+	for (; n > 1; n = (n + BMT_ARITY - 1) / BMT_ARITY, index /= BMT_ARITY)
+	{
+		first = index - index % BMT_ARITY;
+		len += MIN2(BMT_ARITY, n - first) - 1;
+	}
+	return len * hash_len;
+}
+
+err_t bmtProve(octet proof[], size_t* proof_len, size_t l, size_t leaf_size,
+	const void* src, size_t count, size_t index, size_t threads)
+{
+	size_t hash_len, n, c, g, first, k, i;
+	void* stack;
+	octet* hashes;
+	void* state;
+	// проверить входные данные
+	if (l % 16 != 0 || l > 256 || leaf_size == 0)
+		return ERR_BAD_PARAMS;
+	if (!memIsValid(proof_len, sizeof(size_t)) || !memIsValid(src, count))
+		return ERR_BAD_INPUT;
+	hash_len = bmtHLen(l);
+	n = bmtLeafCount(leaf_size, count);
+	if (index >= n)
+		return ERR_BAD_INPUT;
+	// определить длину доказательства
+	*proof_len = bmtProofLen(n, index, hash_len);
+	if (proof == 0)
+		return ERR_OK;
+	if (!memIsValid(proof, *proof_len))
+		return ERR_BAD_INPUT;
+	threads = MIN2(MAX2(threads, 1), n);
+	// выделить память
+	if (n > (SIZE_MAX - bmtLeaves_deep(threads)) / hash_len)
+		return ERR_OUTOFMEMORY;
+	stack = blobCreate(bmtLeaves_deep(threads) + n * hash_len);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	hashes = (octet*)stack + bmtLeaves_deep(threads);
+	state = (octet*)stack + threads * sizeof(bmt_leaf_job);
+	// хэшировать листья
+	bmtLeaves(hashes, l, leaf_size, src, count, n, threads, stack);
+	// строить уровни
+	for (c = n; c > 1; c = (c + BMT_ARITY - 1) / BMT_ARITY, index /= BMT_ARITY)
+		for (g = 0, first = 0; first < c; ++g, first += BMT_ARITY)
+		{
+			k = MIN2(BMT_ARITY, c - first);
+			// группа листа / предка листа?
+			if (first <= index && index < first + k)
+				for (i = first; i < first + k; ++i)
+					if (i != index)
+					{
+						memCopy(proof, hashes + i * hash_len, hash_len);
+						proof += hash_len;
+					}
+			// хэшировать группу
+			bmtHStart(state, l, BMT_TAG_NODE);
+			bmtHStepH(hashes + first * hash_len, k * hash_len, state, l);
+			bmtHStepG(hashes + g * hash_len, state, l);
+		}
+	// завершить
+	blobClose(stack);
+	return ERR_OK;
+}
+
+err_t bmtVerify(const octet hash[], size_t l, size_t leaf_size, size_t count,
+	size_t index, const void* leaf, size_t leaf_len, const octet proof[],
+	size_t proof_len)
+{
+	size_t hash_len, n, c, first, k, i;
+	void* state;
+	octet* h;
+	octet* top;
+	bool_t eq;
+	// проверить входные данные
+	if (l % 16 != 0 || l > 256 || leaf_size == 0)
+		return ERR_BAD_PARAMS;
+	hash_len = bmtHLen(l);
+	n = bmtLeafCount(leaf_size, count);
+	if (index >= n)
+		return ERR_BAD_INPUT;
+	if (!memIsValid(hash, hash_len) || !memIsValid(leaf, leaf_len) ||
+		!memIsValid(proof, proof_len))
+		return ERR_BAD_INPUT;
+	// проверить длины
+	if (leaf_len != (index + 1 < n ? leaf_size : count - index * leaf_size) ||
+		proof_len != bmtProofLen(n, index, hash_len))
+		return ERR_BAD_HASH;
+	// создать состояние
+	state = blobCreate(bmtH_keep() + 2 * hash_len);
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	h = (octet*)state + bmtH_keep();
+	top = h + hash_len;
+	// хэшировать лист
+	bmtHLeaf(h, leaf, leaf_len, l, state);
+	// подниматься по уровням
+	for (c = n; c > 1; c = (c + BMT_ARITY - 1) / BMT_ARITY, index /= BMT_ARITY)
+	{
+		first = index - index % BMT_ARITY;
+		k = MIN2(BMT_ARITY, c - first);
+		memCopy(top, h, hash_len);
+		bmtHStart(state, l, BMT_TAG_NODE);
+		for (i = first; i < first + k; ++i)
+			if (i == index)
+				bmtHStepH(top, hash_len, state, l);
+			else
+			{
+				bmtHStepH(proof, hash_len, state, l);
+				proof += hash_len;
+			}
+		bmtHStepG(h, state, l);
+	}
+	// проверить результат
+	memCopy(top, h, hash_len);
+	bmtHRoot(h, top, leaf_size, count, l, state);
+	eq = memEq(h, hash, hash_len);
+	// завершить
+	blobClose(state);
+	return eq ? ERR_OK : ERR_BAD_HASH;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.27
-\version 2016.04.22
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,9 +14,12 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/str.h"
+#include "bee2/core/tm.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/dstu.h"
+#include "bee2/crypto/vcache.h"
 #include "bee2/math/ec2.h"
 #include "bee2/math/gf2.h"
 #include "bee2/math/ww.h"
@@ -415,7 +418,8 @@ err_t dstuStdParams(dstu_params* params, const char* name)
 По долговременным параметрам params формируется описание pec эллиптической
 кривой. Указатель *pec является одновременно началом фрагмента памяти, 
 в котором размещается состояние и стек. Длина фрагмента определяется с учетом 
-потребностей deep и размерностей dims.
+потребностей deep и размерностей dims. При qt == TRUE к описанию поля 
+присоединяется таблица решений квадратных уравнений (см. gf2CreateQT()).
 \pre Указатель pec корректен.
 \return ERR_OK, если описание успешно создано, и код ошибки в противном 
 случае.
@@ -425,9 +429,10 @@ err_t dstuStdParams(dstu_params* params, const char* name)
 *******************************************************************************
 */
 
-static err_t _dstuCreateEc(
+static err_t _dstuCreateEcQT(
 	ec_o** pec,						/* [out] описание эллиптической кривой */
 	const dstu_params* params,		/* [in] долговременные параметры */
+	bool_t qt,						/* [in] строить таблицу решений? */
 	_dstu_deep_i deep				/* [in] потребности в стековой памяти */
 )
 {
@@ -455,7 +460,8 @@ static err_t _dstuCreateEc(
 		return ERR_BAD_PARAMS;
 	// определить размерности
 	n = W_OF_B(m);
-	f_keep = gf2Create_keep(m);
+	qt = qt && m % 2;
+	f_keep = qt ? gf2CreateQT_keep(m) : gf2Create_keep(m);
 	f_deep = gf2Create_deep(m);
 	ec_d = 3;
 	ec_keep = ec2CreateLD_keep(n);
@@ -464,7 +470,7 @@ static err_t _dstuCreateEc(
 	state = blobCreate(
 		f_keep + ec_keep +
 		utilMax(4,
-			4 * sizeof(size_t) + f_deep,
+			4 * sizeof(size_t) + (qt ? gf2CreateQT_deep(m) : f_deep),
 			O_OF_B(m) + ec_deep,
 			ecCreateGroup_deep(f_deep),
 			deep(n, f_deep, ec_d, ec_deep)));
@@ -478,7 +484,7 @@ static err_t _dstuCreateEc(
 	p[2] = params->p[2];
 	p[3] = params->p[3];
 	stack = p + 4;
-	if (!gf2Create(f, p, stack))
+	if (qt ? !gf2CreateQT(f, p, stack) : !gf2Create(f, p, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PARAMS;
@@ -503,6 +509,12 @@ static err_t _dstuCreateEc(
 	return ERR_OK;
 }
 
+static err_t _dstuCreateEc(ec_o** pec, const dstu_params* params, 
+	_dstu_deep_i deep)
+{
+	return _dstuCreateEcQT(pec, params, FALSE, deep);
+}
+
 /*
 *******************************************************************************
 Закрытие описания эллиптической кривой
@@ -535,10 +547,32 @@ void _dstuCloseEc(ec_o* ec)
 
 Дополнительно проверяется, что базовая точка лежит на кривой и имеет
 порядок order.
+
+Условия объединены в DSTU_VAL_CHECKS независимых проверок
+(см. _dstuValParamsCheck()), которые распределяются между потоками так же,
+как в bignValParams2(). Ключи успешно проверенных параметров сохраняются
+в кэше (см. vcache.h) с меткой "dstu".
 *******************************************************************************
 */
 
-static size_t _dstuValParams_deep(size_t n, size_t f_deep, size_t ec_d, 
+static bool_t _dstuValParamsCheck(size_t i, const ec_o* ec, void* stack)
+{
+	switch (i)
+	{
+	case 0:
+		return wwBitSize(ec->order, ec->f->n) > 160 &&
+			ec2IsValid(ec, stack);
+	case 1:
+		return ec2SeemsValidGroup(ec, stack);
+	case 2:
+		return ec2IsSafeGroup(ec, 32, stack);
+	case 3:
+		return ecHasOrderA(ec->base, ec, ec->order, ec->f->n, stack);
+	}
+	return FALSE;
+}
+
+static size_t _dstuValParamsCheck_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return utilMax(4,
@@ -548,28 +582,166 @@ static size_t _dstuValParams_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecHasOrderA_deep(n, ec_d, ec_deep, n));
 }
 
-err_t dstuValParams(const dstu_params* params)
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	bool_t* oks;			/*< результаты проверок */
+	tm_ticks_t* ticks;		/*< продолжительность проверок */
+	size_t start;			/*< первая проверка */
+	size_t step;			/*< шаг по проверкам */
+	void* stack;			/*< вспомогательная память */
+} dstu_val_params_job;
+
+static void _dstuValParamsRun(void* arg)
+{
+	const dstu_val_params_job* job = (const dstu_val_params_job*)arg;
+	tm_ticks_t t;
+	size_t i;
+	for (i = job->start; i < DSTU_VAL_CHECKS; i += job->step)
+	{
+		t = tmTicks();
+		job->oks[i] = _dstuValParamsCheck(i, job->ec, job->stack);
+		job->ticks[i] = tmTicks() - t;
+		if (!job->oks[i])
+			break;
+	}
+}
+
+err_t dstuValParams2(const dstu_params* params, size_t threads,
+	tm_ticks_t ticks[DSTU_VAL_CHECKS])
 {
 	err_t code;
+	size_t i;
+	size_t job_deep;
+	octet key[32];
+	bool_t oks[DSTU_VAL_CHECKS];
+	tm_ticks_t ticks1[DSTU_VAL_CHECKS];
 	// состояние
 	ec_o* ec;
+	void* state;
 	void* stack;
+	dstu_val_params_job* jobs;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(dstu_params)) ||
+		!memIsNullOrValid(ticks, sizeof(tm_ticks_t) * DSTU_VAL_CHECKS))
+		return ERR_BAD_INPUT;
+	if (ticks == 0)
+		ticks = ticks1;
+	for (i = 0; i < DSTU_VAL_CHECKS; ++i)
+		oks[i] = TRUE, ticks[i] = 0;
+	// параметры уже проверялись?
+	vcacheKey(key, "dstu", params, sizeof(dstu_params));
+	if (vcacheHas(key))
+		return ERR_OK;
 	// старт
-	code = _dstuCreateEc(&ec, params, _dstuValParams_deep);
+	code = _dstuCreateEc(&ec, params, _dstuValParamsCheck_deep);
 	ERR_CALL_CHECK(code);
-	stack = objEnd(ec, void);
-	// проверить кривую и базовую точку
-	if (wwBitSize(ec->order, ec->f->n) <= 160 ||
-		!ec2IsValid(ec, stack) ||
-		!ec2SeemsValidGroup(ec, stack) ||
-		!ec2IsSafeGroup(ec, 32, stack) ||
-		!ecHasOrderA(ec->base, ec, ec->order, ec->f->n, stack))
-		code = ERR_BAD_PARAMS;
+	job_deep = _dstuValParamsCheck_deep(ec->f->n, ec->f->deep, ec->d,
+		ec->deep);
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, DSTU_VAL_CHECKS);
+	// создать состояние (стек задания 0 -- в ec)
+	state = blobCreate((threads - 1) * job_deep +
+		threads * sizeof(dstu_val_params_job));
+	if (state == 0)
+	{
+		_dstuCloseEc(ec);
+		return ERR_OUTOFMEMORY;
+	}
+	// раскладка состояния
+	stack = state;
+	jobs = (dstu_val_params_job*)((octet*)stack + (threads - 1) * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].oks = oks, jobs[i].ticks = ticks;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = i ? (octet*)stack + (i - 1) * job_deep :
+			objEnd(ec, void);
+	}
+	// выполнить задания
+	mtRunJobs(_dstuValParamsRun, jobs, sizeof(dstu_val_params_job), threads);
+	// результат
+	for (i = 0; i < DSTU_VAL_CHECKS; ++i)
+		if (!oks[i])
+			code = ERR_BAD_PARAMS;
+	if (code == ERR_OK)
+		vcacheAdd(key);
 	// завершение
+	blobClose(state);
 	_dstuCloseEc(ec);
 	return code;
 }
 
+err_t dstuValParams(const dstu_params* params)
+{
+	return dstuValParams2(params, 1, 0);
+}
+
+/*
+*******************************************************************************
+Принадлежность подгруппе
+
+Точка a кривой E: y^2 + xy = x^3 + A x^2 + B над GF(2^m) лежит в подгруппе 
+2E тогда и только тогда, когда tr(x(a)) == tr(A). Если a \in 2E, то 
+половинами a являются точки b и b + T, где T = (0, \sqrt{B}) -- точка 
+порядка 2. Квадраты x-координат половин являются корнями уравнения
+	w^2 + x(a) w + B == 0.
+2-часть группы E циклическая, поэтому при cofactor == 4 точка T лежит в 2E 
+и половины одновременно лежат либо не лежат в 2E. Следовательно, 
+a \in 4E тогда и только тогда, когда a \in 2E и tr(w) == tr(A), где w -- 
+любой корень уравнения (след не меняется при извлечении квадратного корня).
+
+Если кофактор равняется 2 или 4 и порядок order -- простое число, то 
+подгруппа порядка order совпадает с 2E или 4E соответственно. Поэтому 
+вместо умножения на order (см. ecHasOrderA()) достаточно вычислить один 
+или два следа и, возможно, решить одно квадратное уравнение. Уравнение 
+решается с помощью gf2QSolve() (по таблице, если описание поля создано 
+функцией gf2CreateQT()). При других значениях кофактора проверяется 
+условие order * a == O.
+
+\pre Точка a лежит на кривой.
+\expect Параметры кривой корректны (см. dstuValParams()).
+*******************************************************************************
+*/
+
+static bool_t _dstuIsInGroupA(const word a[], const ec_o* ec, void* stack)
+{
+	bool_t trA;
+	// раскладка стека
+	word* w = (word*)stack;
+	stack = w + ec->f->n;
+	// другой кофактор?
+	if (ec->cofactor != 2 && ec->cofactor != 4)
+		return ecHasOrderA(a, ec, ec->order, ec->f->n, stack);
+	// a == T?
+	if (qrIsZero(ecX(a), ec->f))
+		return FALSE;
+	// a \in 2E?
+	trA = gf2Tr(ec->A, ec->f, stack);
+	if (gf2Tr(ecX(a), ec->f, stack) != trA)
+		return FALSE;
+	if (ec->cofactor == 2)
+		return TRUE;
+	// w <- Solve[w^2 + x(a) w + B == 0]
+	if (!gf2QSolve(w, ecX(a), ec->B, ec->f, stack))
+		return FALSE;
+	// a \in 4E?
+	return gf2Tr(w, ec->f, stack) == trA;
+}
+
+static size_t _dstuIsInGroupA_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	return O_OF_W(n) + 
+		utilMax(3,
+			gf2Tr_deep(n, f_deep),
+			gf2QSolve_deep(n, f_deep),
+			ecHasOrderA_deep(n, ec_d, ec_deep, n));
+}
+
 /*
 *******************************************************************************
 Управление точками
@@ -647,7 +819,7 @@ static size_t _dstuValPoint_deep(size_t n, size_t f_deep, size_t ec_d,
 	return O_OF_W(2 * n) + 
 		utilMax(2,
 			ec2IsOnA_deep(n, f_deep),
-			ecHasOrderA_deep(n, ec_d, ec_deep, n));
+			_dstuIsInGroupA_deep(n, f_deep, ec_d, ec_deep));
 }
 
 err_t dstuValPoint(const dstu_params* params, const octet point[])
@@ -675,7 +847,7 @@ err_t dstuValPoint(const dstu_params* params, const octet point[])
 	if (!qrFrom(x, point, ec->f, stack) ||
 		!qrFrom(y, point + ec->f->no, ec->f, stack) ||
 		!ec2IsOnA(x, ec, stack) ||
-		!ecHasOrderA(x, ec, ec->order, ec->f->n, stack))
+		!_dstuIsInGroupA(x, ec, stack))
 		code = ERR_BAD_POINT;
 	// завершение
 	_dstuCloseEc(ec);
@@ -735,74 +907,53 @@ err_t dstuCompressPoint(octet xpoint[], const dstu_params* params,
 	return ERR_OK;
 }
 
-static size_t _dstuRecoverPoint_deep(size_t n, size_t f_deep, size_t ec_d, 
-	size_t ec_deep)
-{
-	return O_OF_W(2 * n) + 
-		utilMax(2,
-			gf2QSolve_deep(n, f_deep),
-			gf2Tr_deep(n, f_deep));
-}
+/*
+	Восстановление точки: вспомогательная функция
 
-err_t dstuRecoverPoint(octet point[], const dstu_params* params, 
-	const octet xpoint[])
+	Точка point восстанавливается по сжатому представлению xpoint. 
+	Квадратное уравнение решается с помощью gf2QSolve() (по таблице, 
+	если описание поля создано функцией gf2CreateQT()).
+*/
+
+static err_t _dstuRecoverPointEc(octet point[], const ec_o* ec, bool_t A,
+	const octet xpoint[], void* stack)
 {
-	err_t code;
 	register bool_t trace;
-	// состояние
-	ec_o* ec;
-	word* x;
-	word* y;
-	void* stack;
-	// старт
-	code = _dstuCreateEc(&ec, params, _dstuRecoverPoint_deep);
-	ERR_CALL_CHECK(code);
-	// проверить входные указатели
-	if (!memIsValid(xpoint, ec->f->no) || 
-		!memIsValid(point, 2 * ec->f->no))
-	{
-		_dstuCloseEc(ec);
-		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	x = objEnd(ec, word);
-	y = x + ec->f->n;
+	// раскладка стека
+	word* x = (word*)stack;
+	word* y = x + ec->f->n;
 	stack = y + ec->f->n;
 	// загрузить сжатое представление точки
 	if (!qrFrom(x, xpoint, ec->f, stack))
-	{
-		_dstuCloseEc(ec);
 		return ERR_BAD_POINT;
-	}
 	// x == 0?
 	if (qrIsZero(x, ec->f))
 	{
 		size_t m = gf2Deg(ec->f);
-		// b <- b^{2^{m - 1}}
+		// y <- b^{2^{m - 1}}
+		qrCopy(y, ec->B, ec->f);
 		while (--m)
-			qrSqr(ec->B, ec->B, ec->f, stack);
-		// выгрузить y-координату
-		qrTo(point + ec->f->n, ec->B, ec->f, stack);
-		// все нормально
-		_dstuCloseEc(ec);
+			qrSqr(y, y, ec->f, stack);
+		// выгрузить точку
+		qrTo(point, x, ec->f, stack);
+		qrTo(point + ec->f->no, y, ec->f, stack);
 		return ERR_OK;
 	}
 	// восстановить первый разряд x
 	trace = wwTestBit(x, 0);
 	wwSetBit(x, 0, 0);
-	if (gf2Tr(x, ec->f, stack) != (bool_t)params->A)
+	if (gf2Tr(x, ec->f, stack) != A)
 		wwSetBit(x, 0, 1);
 	// y <- x + a + b / x^2
 	qrSqr(y, x, ec->f, stack);
 	qrDiv(y, ec->B, y, ec->f, stack);
 	gf2Add2(y, x, ec->f);
-	if (params->A)
+	if (A)
 		wwFlipBit(y, 0);
 	// Solve[z^2 + z == y]
 	if (!gf2QSolve(y, ec->f->unity, y, ec->f, stack))
 	{
 		trace = 0;
-		_dstuCloseEc(ec);
 		return ERR_BAD_PARAMS;
 	}
 	// tr(y) == trace?
@@ -818,6 +969,195 @@ err_t dstuRecoverPoint(octet point[], const dstu_params* params,
 	qrTo(point + ec->f->no, y, ec->f, stack);
 	// все нормально
 	trace = 0;
+	return ERR_OK;
+}
+
+static size_t _dstuRecoverPointEc_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			gf2QSolve_deep(n, f_deep),
+			gf2Tr_deep(n, f_deep));
+}
+
+static size_t _dstuRecoverPoint_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	return _dstuRecoverPointEc_deep(n, f_deep);
+}
+
+err_t dstuRecoverPoint(octet point[], const dstu_params* params, 
+	const octet xpoint[])
+{
+	err_t code;
+	// состояние
+	ec_o* ec;
+	// старт
+	code = _dstuCreateEc(&ec, params, _dstuRecoverPoint_deep);
+	ERR_CALL_CHECK(code);
+	// проверить входные указатели
+	if (!memIsValid(xpoint, ec->f->no) || 
+		!memIsValid(point, 2 * ec->f->no))
+	{
+		_dstuCloseEc(ec);
+		return ERR_BAD_INPUT;
+	}
+	// восстановить точку
+	code = _dstuRecoverPointEc(point, ec, (bool_t)params->A, xpoint, 
+		objEnd(ec, void));
+	// завершение
+	_dstuCloseEc(ec);
+	return code;
+}
+
+err_t dstuRecoverPointBatch(octet points[], err_t codes[], 
+	const dstu_params* params, const octet xpoints[], size_t count)
+{
+	err_t code;
+	size_t i;
+	// состояние
+	ec_o* ec;
+	// старт
+	code = _dstuCreateEcQT(&ec, params, TRUE, _dstuRecoverPoint_deep);
+	ERR_CALL_CHECK(code);
+	// проверить входные указатели
+	if (!memIsValid(xpoints, count * ec->f->no) || 
+		!memIsValid(points, 2 * count * ec->f->no) ||
+		!memIsValid(codes, count * sizeof(err_t)))
+	{
+		_dstuCloseEc(ec);
+		return ERR_BAD_INPUT;
+	}
+	// восстановить точки (в обратном порядке, чтобы допустить 
+	// points == xpoints)
+	for (i = count; i--;)
+	{
+		octet* point = points + 2 * i * ec->f->no;
+		codes[i] = _dstuRecoverPointEc(point, ec, (bool_t)params->A, 
+			xpoints + i * ec->f->no, objEnd(ec, void));
+		if (codes[i] != ERR_OK)
+			memSetZero(point, 2 * ec->f->no);
+	}
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	_dstuCloseEc(ec);
+	return code;
+}
+
+/*
+*******************************************************************************
+Пакетная проверка точек
+
+Описание кривой строится один раз. При cofactor == 4 и достаточно большом 
+числе точек к описанию поля присоединяется таблица решений квадратных 
+уравнений (см. gf2CreateQT()), которая затем используется 
+в _dstuIsInGroupA(). Точки проверяются порциями по DSTU_VAL_BLOCK, порции 
+распределяются между потоками.
+*******************************************************************************
+*/
+
+#define DSTU_VAL_BLOCK 64
+
+typedef struct
+{
+	const ec_o* ec;			/*< описание кривой */
+	const octet* points;	/*< точки */
+	err_t* codes;			/*< коды проверки */
+	size_t count;			/*< число точек */
+	size_t start;			/*< первая порция */
+	size_t step;			/*< шаг по порциям */
+	void* stack;			/*< вспомогательная память */
+} dstu_val_job;
+
+static void _dstuValPointRun(void* arg)
+{
+	const dstu_val_job* job = (const dstu_val_job*)arg;
+	const ec_o* ec = job->ec;
+	const size_t no = ec->f->no;
+	size_t i, j;
+	// раскладка стека
+	word* x = (word*)job->stack;
+	word* y = x + ec->f->n;
+	void* stack = y + ec->f->n;
+	// цикл по порциям
+	for (i = job->start * DSTU_VAL_BLOCK; i < job->count; 
+		i += job->step * DSTU_VAL_BLOCK)
+		for (j = i; j < MIN2(i + DSTU_VAL_BLOCK, job->count); ++j)
+		{
+			const octet* point = job->points + 2 * j * no;
+			// (x, y) лежит на ЭК? (x, y) имеет порядок order?
+			if (qrFrom(x, point, ec->f, stack) &&
+				qrFrom(y, point + no, ec->f, stack) &&
+				ec2IsOnA(x, ec, stack) &&
+				_dstuIsInGroupA(x, ec, stack))
+				job->codes[j] = ERR_OK;
+			else
+				job->codes[j] = ERR_BAD_POINT;
+		}
+}
+
+err_t dstuValPointBatch(err_t codes[], const dstu_params* params, 
+	const octet points[], size_t count, size_t threads)
+{
+	err_t code;
+	size_t i, job_deep;
+	// состояние
+	ec_o* ec;
+	void* state;
+	void* stack;
+	dstu_val_job* jobs;
+	// старт
+	code = _dstuCreateEcQT(&ec, params, 
+		memIsValid(params, sizeof(dstu_params)) && params->c == 4 && 
+		count >= 16, _dstuValPoint_deep);
+	ERR_CALL_CHECK(code);
+	// проверить входные указатели
+	if (!memIsValid(points, 2 * count * ec->f->no) ||
+		!memIsValid(codes, count * sizeof(err_t)))
+	{
+		_dstuCloseEc(ec);
+		return ERR_BAD_INPUT;
+	}
+	if (count == 0)
+	{
+		_dstuCloseEc(ec);
+		return ERR_OK;
+	}
+	// размерности
+	job_deep = _dstuValPoint_deep(ec->f->n, ec->f->deep, ec->d, ec->deep);
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (count + DSTU_VAL_BLOCK - 1) / DSTU_VAL_BLOCK);
+	// создать состояние
+	state = blobCreate(
+		threads * (job_deep + sizeof(dstu_val_job)));
+	if (state == 0)
+	{
+		_dstuCloseEc(ec);
+		return ERR_OUTOFMEMORY;
+	}
+	// раскладка состояния
+	stack = state;
+	jobs = (dstu_val_job*)((octet*)stack + threads * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].points = points;
+		jobs[i].codes = codes;
+		jobs[i].count = count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(_dstuValPointRun, jobs, sizeof(dstu_val_job), threads);
+	// код первой ошибки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = codes[i];
+	// завершение
+	blobClose(state);
 	_dstuCloseEc(ec);
 	return code;
 }
@@ -832,7 +1172,7 @@ static size_t _dstuGenKeypair_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(3 * n) + 
-		ecMulA_deep(n, ec_d, ec_deep, n);
+		ecMulRegA_deep(n, ec_d, ec_deep, n);
 }
 
 err_t dstuGenKeypair(octet privkey[], octet pubkey[], 
@@ -882,7 +1222,7 @@ err_t dstuGenKeypair(octet privkey[], octet pubkey[],
 			break;
 	}
 	// Q <- d G
-	if (!ecMulA(x, ec->base, ec, d, order_n, stack))
+	if (!ecMulRegA(x, ec->base, ec, d, order_n, stack))
 	{
 		// если params корректны, то этого быть не должно
 		_dstuCloseEc(ec);
@@ -909,14 +1249,15 @@ static size_t _dstuSign_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(6 * n) + 
-		utilMax(2,
-			ecMulA_deep(n, ec_d, ec_deep, n),
+		utilMax(3,
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			ec2MulLadderA_deep(n, f_deep),
 			zzMulMod_deep(n));
 }
 
-err_t dstuSign(octet sig[], const dstu_params* params, size_t ld, 
+static err_t _dstuSign(octet sig[], const dstu_params* params, size_t ld, 
 	const octet hash[], size_t hash_len, const octet privkey[], 
-	gen_i rng, void* rng_state)
+	gen_i rng, void* rng_state, bool_t ladder)
 {
 	err_t code;
 	size_t order_n, order_no, order_nb;
@@ -989,7 +1330,8 @@ step8:
 			break;
 	}
 	// шаг 8: (x, y) <- e G
-	if (!ecMulA(x, ec->base, ec, e, order_n, stack))
+	if (ladder ? !ec2MulLadderA(x, ec->base, ec, e, order_n, stack) :
+		!ecMulRegA(x, ec->base, ec, e, order_n, stack))
 	{
 		// если params корректны, то этого быть не должно
 		_dstuCloseEc(ec);
@@ -1025,6 +1367,22 @@ step8:
 	return code;
 }
 
+err_t dstuSign(octet sig[], const dstu_params* params, size_t ld, 
+	const octet hash[], size_t hash_len, const octet privkey[], 
+	gen_i rng, void* rng_state)
+{
+	return _dstuSign(sig, params, ld, hash, hash_len, privkey, 
+		rng, rng_state, FALSE);
+}
+
+err_t dstuSignLadder(octet sig[], const dstu_params* params, size_t ld, 
+	const octet hash[], size_t hash_len, const octet privkey[], 
+	gen_i rng, void* rng_state)
+{
+	return _dstuSign(sig, params, ld, hash, hash_len, privkey, 
+		rng, rng_state, TRUE);
+}
+
 static size_t _dstuVerify_deep(size_t n, size_t f_deep, size_t ec_d, 
 	size_t ec_deep)
 {
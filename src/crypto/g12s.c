@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.07.09
-\version 2016.04.22
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,9 +14,12 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/str.h"
+#include "bee2/core/tm.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/g12s.h"
+#include "bee2/crypto/vcache.h"
 #include "bee2/math/ecp.h"
 #include "bee2/math/gfp.h"
 #include "bee2/math/ww.h"
@@ -572,6 +575,11 @@ err_t g12sStdParams(g12s_params* params, const char* name)
 кривой. Указатель *pec является одновременно началом фрагмента памяти, 
 в котором размещается состояние и стек. Длина фрагмента определяется с учетом 
 потребностей deep и размерностей dims.
+
+Описание строится функцией g12sStart() в памяти, подготовленной вызывающей 
+программой. Длина памяти (с учетом стека) определяется функцией 
+g12sStart_keep(). Функция g12sStart() используется также при создании 
+долговременного контекста (см. g12sCtxStart()).
 \pre Указатель pec корректен.
 \return ERR_OK, если описание успешно создано, и код ошибки в противном 
 случае.
@@ -592,26 +600,33 @@ err_t g12sStdParams(g12s_params* params, const char* name)
 *******************************************************************************
 */
 
-static err_t g12sCreateEc(
-	ec_o** pec,						/* [out] описание эллиптической кривой */
-	const g12s_params* params,		/* [in] долговременные параметры */
-	g12s_deep_i deep				/* [in] потребности в стековой памяти */
-)
+static size_t g12sStart_keep(size_t l, g12s_deep_i deep)
+{
+	// размерности
+	size_t no = G12S_FIELD_SIZE * l / 512;
+	size_t n = W_OF_O(no);
+	size_t f_keep = gfpCreate_keep(no);
+	size_t f_deep = gfpCreate_deep(no);
+	size_t ec_d = 3;
+	size_t ec_keep = ecpCreateJ_keep(n);
+	size_t ec_deep = ecpCreateJ_deep(n, f_deep);
+	// расчет
+	return f_keep + ec_keep +
+		utilMax(3,
+			ec_deep,
+			ecCreateGroup_deep(f_deep),
+			deep ? deep(n, f_deep, ec_d, ec_deep) : 0);
+}
+
+static err_t g12sStart(void* state, const g12s_params* params)
 {
 	// размерности
 	size_t n, no, nb;
-	size_t f_keep;
-	size_t f_deep;
-	size_t ec_d;
 	size_t ec_keep;
-	size_t ec_deep;
 	// состояние
-	void* state;	
 	qr_o* f;			/* базовое поле */
 	ec_o* ec;			/* кривая */
 	void* stack;
-	// pre
-	ASSERT(memIsValid(pec, sizeof(*pec)));
 	// минимальная проверка входных данных
 	if (!memIsValid(params, sizeof(g12s_params)) ||
 		params->l != 256 && params->l != 512)
@@ -619,59 +634,63 @@ static err_t g12sCreateEc(
 	// определить размерности
 	no = memNonZeroSize(params->p, sizeof(params->p) * params->l / 512);
 	n = W_OF_O(no);
-	f_keep = gfpCreate_keep(no);
-	f_deep = gfpCreate_deep(no);
-	ec_d = 3;
-	ec_keep = ecpCreateJ_keep(no);
-	ec_deep = ecpCreateJ_deep(no, f_deep);
-	// создать состояние
-	state = blobCreate(
-		f_keep + ec_keep +
-		utilMax(3,
-			ec_deep,
-			ecCreateGroup_deep(f_deep),
-			deep(n, f_deep, ec_d, ec_deep)));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
+	ec_keep = ecpCreateJ_keep(n);
 	// создать поле
 	f = (qr_o*)((octet*)state + ec_keep);
-	stack = (octet*)f + f_keep;
+	stack = (octet*)f + gfpCreate_keep(no);
 	if (!gfpCreate(f, params->p, no, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// проверить длину p
 	nb = wwBitSize(f->mod, n);
 	if (params->l == 256 && nb <= 253 ||
 		params->l == 512 && nb <= 507)
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// создать кривую и группу
 	ec = (ec_o*)state;
 	if (!ecpCreateJ(ec, f, params->a, params->b, stack) ||
 		!ecCreateGroup(ec, params->xP, params->yP, params->q, 
 			params->l / 8, params->n, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// проверить q
 	n = W_OF_B(params->l);
 	nb = wwBitSize(ec->order, n);
 	if (params->l == 256 && nb <= 254 ||
 		params->l == 512 && nb <= 508 ||
 		zzIsEven(ec->order, n))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// присоединить f к ec
 	objAppend(ec, f, 0);
 	// все нормально
-	*pec = ec;
+	return ERR_OK;
+}
+
+static err_t g12sCreateEc(
+	ec_o** pec,						/* [out] описание эллиптической кривой */
+	const g12s_params* params,		/* [in] долговременные параметры */
+	g12s_deep_i deep				/* [in] потребности в стековой памяти */
+)
+{
+	err_t code;
+	void* state;	
+	// pre
+	ASSERT(memIsValid(pec, sizeof(*pec)));
+	// минимальная проверка входных данных
+	if (!memIsValid(params, sizeof(g12s_params)) ||
+		params->l != 256 && params->l != 512)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(g12sStart_keep(params->l, deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// загрузить параметры
+	code = g12sStart(state, params);
+	if (code != ERR_OK)
+	{
+		blobClose(state);
+		return code;
+	}
+	// все нормально
+	*pec = (ec_o*)state;
 	return ERR_OK;
 }
 
@@ -703,10 +722,33 @@ void g12sCloseEc(ec_o* ec)
 -#	|n * q - (p + 1)| \leq 2\sqrt{p} (ecpSeemsValidGroup)
 -#	qP = O (ecpHasOrder)
 
+Условия объединены в G12S_VAL_CHECKS независимых проверок
+(см. g12sValParamsCheck()), которые распределяются между потоками так же,
+как в bignValParams2(). Ключи успешно проверенных параметров сохраняются
+в кэше (см. vcache.h) с меткой "g12s".
 *******************************************************************************
 */
 
-static size_t g12sValParams_deep(size_t n, size_t f_deep, size_t ec_d, 
+static bool_t g12sValParamsCheck(size_t i, const ec_o* ec,
+	const g12s_params* params, void* stack)
+{
+	switch (i)
+	{
+	case 0:
+		return !qrIsZero(ec->A, ec->f) &&
+			!qrIsZero(ec->B, ec->f) &&
+			ecpIsValid(ec, stack);
+	case 1:
+		return ecpSeemsValidGroup(ec, stack);
+	case 2:
+		return ecpIsSafeGroup(ec, params->l == 256 ? 31 : 131, stack);
+	case 3:
+		return ecHasOrderA(ec->base, ec, ec->order, ec->f->n, stack);
+	}
+	return FALSE;
+}
+
+static size_t g12sValParamsCheck_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return utilMax(4,
@@ -716,29 +758,107 @@ static size_t g12sValParams_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecHasOrderA_deep(n, ec_d, ec_deep, n));
 }
 
-err_t g12sValParams(const g12s_params* params)
+typedef struct
+{
+	const ec_o* ec;				/*< описание кривой */
+	const g12s_params* params;	/*< параметры */
+	bool_t* oks;				/*< результаты проверок */
+	tm_ticks_t* ticks;			/*< продолжительность проверок */
+	size_t start;				/*< первая проверка */
+	size_t step;				/*< шаг по проверкам */
+	void* stack;				/*< вспомогательная память */
+} g12s_val_params_job;
+
+static void g12sValParamsRun(void* arg)
+{
+	const g12s_val_params_job* job = (const g12s_val_params_job*)arg;
+	tm_ticks_t t;
+	size_t i;
+	for (i = job->start; i < G12S_VAL_CHECKS; i += job->step)
+	{
+		t = tmTicks();
+		job->oks[i] = g12sValParamsCheck(i, job->ec, job->params,
+			job->stack);
+		job->ticks[i] = tmTicks() - t;
+		if (!job->oks[i])
+			break;
+	}
+}
+
+err_t g12sValParams2(const g12s_params* params, size_t threads,
+	tm_ticks_t ticks[G12S_VAL_CHECKS])
 {
 	err_t code;
+	size_t i;
+	size_t job_deep;
+	octet key[32];
+	bool_t oks[G12S_VAL_CHECKS];
+	tm_ticks_t ticks1[G12S_VAL_CHECKS];
 	// состояние
 	ec_o* ec;
+	void* state;
 	void* stack;
+	g12s_val_params_job* jobs;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(g12s_params)) ||
+		!memIsNullOrValid(ticks, sizeof(tm_ticks_t) * G12S_VAL_CHECKS))
+		return ERR_BAD_INPUT;
+	if (ticks == 0)
+		ticks = ticks1;
+	for (i = 0; i < G12S_VAL_CHECKS; ++i)
+		oks[i] = TRUE, ticks[i] = 0;
+	// параметры уже проверялись?
+	vcacheKey(key, "g12s", params, sizeof(g12s_params));
+	if (vcacheHas(key))
+		return ERR_OK;
 	// старт
-	code = g12sCreateEc(&ec, params, g12sValParams_deep);
+	code = g12sCreateEc(&ec, params, g12sValParamsCheck_deep);
 	ERR_CALL_CHECK(code);
-	stack = objEnd(ec, void);
-	// проверить кривую, проверить J(E)
-	if (!ecpIsValid(ec, stack) ||
-		!ecpSeemsValidGroup(ec, stack) ||
-		!ecpIsSafeGroup(ec, params->l == 256 ? 31 : 131, stack) ||
-		!ecHasOrderA(ec->base, ec, ec->order, ec->f->n, stack) ||
-		qrIsZero(ec->A, ec->f) || 
-		qrIsZero(ec->B, ec->f))
-		code = ERR_BAD_PARAMS;
+	job_deep = g12sValParamsCheck_deep(ec->f->n, ec->f->deep, ec->d,
+		ec->deep);
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, G12S_VAL_CHECKS);
+	// создать состояние (стек задания 0 -- в ec)
+	state = blobCreate((threads - 1) * job_deep +
+		threads * sizeof(g12s_val_params_job));
+	if (state == 0)
+	{
+		g12sCloseEc(ec);
+		return ERR_OUTOFMEMORY;
+	}
+	// раскладка состояния
+	stack = state;
+	jobs = (g12s_val_params_job*)((octet*)stack + (threads - 1) * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].params = params;
+		jobs[i].oks = oks, jobs[i].ticks = ticks;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = i ? (octet*)stack + (i - 1) * job_deep :
+			objEnd(ec, void);
+	}
+	// выполнить задания
+	mtRunJobs(g12sValParamsRun, jobs, sizeof(g12s_val_params_job), threads);
+	// результат
+	for (i = 0; i < G12S_VAL_CHECKS; ++i)
+		if (!oks[i])
+			code = ERR_BAD_PARAMS;
+	if (code == ERR_OK)
+		vcacheAdd(key);
 	// завершение
+	blobClose(state);
 	g12sCloseEc(ec);
 	return code;
 }
 
+err_t g12sValParams(const g12s_params* params)
+{
+	return g12sValParams2(params, 1, 0);
+}
+
 /*
 *******************************************************************************
 Управление ключами
@@ -750,7 +870,7 @@ static size_t g12sGenKeypair_deep(size_t n, size_t f_deep, size_t ec_d,
 {
 	const size_t m = n;
 	return O_OF_W(m + 2 * n) + 
-		ecMulA_deep(n, ec_d, ec_deep, n);
+		ecMulRegA_deep(n, ec_d, ec_deep, n);
 }
 
 err_t g12sGenKeypair(octet privkey[], octet pubkey[],
@@ -790,7 +910,7 @@ err_t g12sGenKeypair(octet privkey[], octet pubkey[],
 		return ERR_BAD_RNG;
 	}
 	// Q <- d P
-	if (!ecMulA(Q, ec->base, ec, d, m, stack))
+	if (!ecMulRegA(Q, ec->base, ec, d, m, stack))
 	{
 		g12sCloseEc(ec);
 		return ERR_BAD_PARAMS;
@@ -807,53 +927,40 @@ err_t g12sGenKeypair(octet privkey[], octet pubkey[],
 /*
 *******************************************************************************
 Выработка ЭЦП
+
+Подпись вырабатывается в функции g12sSignEc(). Если задана таблица кратных 
+tbl базовой точки (см. ecTblCreateA()), то кратная точка kP рассчитывается 
+по таблице, иначе -- с помощью ecMulRegA().
 *******************************************************************************
 */
 
-static size_t g12sSign_deep(size_t n, size_t f_deep, size_t ec_d, 
+static size_t g12sSignEc_deep(size_t n, size_t f_deep, size_t ec_d, 
 	size_t ec_deep)
 {
 	const size_t m = n;
 	return 	O_OF_W(3 * m + 2 * n) +
-		utilMax(3,
+		utilMax(4,
 			zzMod_deep(m, m),
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			ecMulTblA_deep(n, ec_d, ec_deep, n),
 			zzMulMod_deep(m));
 }
 
-err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
-	const octet privkey[], gen_i rng, void* rng_stack)
+static err_t g12sSignEc(octet sig[], const ec_o* ec, const word tbl[],
+	size_t l, const octet hash[], const octet privkey[], gen_i rng, 
+	void* rng_stack, void* stack)
 {
-	err_t code;
-	size_t m, mo;
-	// состояние
-	ec_o* ec;
+	const size_t m = W_OF_B(l);
+	const size_t mo = O_OF_B(l);
+	// переменные в stack
 	word* d;		/* [m] личный ключ */
 	word* e;		/* [m] обработанное хэш-значение */
 	word* k;		/* [m] одноразовый ключ */
 	word* C;		/* [2n] вспомогательная точка */
 	word* r;		/* [m] первая (старшая) часть подписи */
 	word* s;		/* [m] вторая часть подписи */
-	void* stack;
-	// проверить rng
-	if (rng == 0)
-		return ERR_BAD_RNG;
-	// старт
-	code = g12sCreateEc(&ec, params, g12sSign_deep);
-	ERR_CALL_CHECK(code);
-	// размерности order
-	m = W_OF_B(params->l);
-	mo = O_OF_B(params->l);
-	// проверить входные указатели
-	if (!memIsValid(hash, mo) ||
-		!memIsValid(privkey, mo) ||
-		!memIsValid(sig, 2 * mo))
-	{
-		g12sCloseEc(ec);
-		return ERR_BAD_INPUT;
-	}
-	// раскладка состояния
-	d = objEnd(ec, word);
+	// раскладка stack
+	d = (word*)stack;
 	e = d + m;
 	k = e + m;
 	C = k + m;
@@ -864,10 +971,7 @@ err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
 	wwFrom(d, privkey, mo);
 	if (wwIsZero(d, m) || 
 		wwCmp(d, ec->order, m) >= 0)
-	{
-		g12sCloseEc(ec);
 		return ERR_BAD_PRIVKEY;
-	}
 	// e <- hash \mod q
 	memCopy(e, hash, mo);
 	memRev(e, mo);
@@ -879,17 +983,12 @@ err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
 	// k <-R {1,2,..., q - 1}
 gen_k:
 	if (!zzRandNZMod(k, ec->order, m, rng, rng_stack))
-	{
-		g12sCloseEc(ec);
 		return ERR_BAD_RNG;
-	}
 	// C <- k P
-	if (!ecMulA(C, ec->base, ec, k, m, stack))
-	{
+	if (tbl ? !ecMulTblA(C, tbl, ec, k, m, stack) :
+		!ecMulRegA(C, ec->base, ec, k, m, stack))
 		// если params корректны, то этого быть не должно
-		g12sCloseEc(ec);
 		return ERR_BAD_INPUT;
-	}
 	// r <- x_C \mod q
 	qrTo((octet*)C, ecX(C), ec->f, stack);
 	wwFrom(r, C, ec->f->no);
@@ -905,111 +1004,374 @@ gen_k:
 	wwTo(sig, mo, s);
 	wwTo(sig + mo, mo, r);
 	memRev(sig, 2 * mo);
-	// все нормально
-	g12sCloseEc(ec);
+	// очистка
+	wwSetZero(d, 3 * m);
 	return ERR_OK;
 }
 
-/*
-*******************************************************************************
-Проверка ЭЦП
-*******************************************************************************
-*/
-
-static size_t g12sVerify_deep(size_t n, size_t f_deep, size_t ec_d, 
-	size_t ec_deep)
-{
-	const size_t m = n;
-	return O_OF_W(5 * m + 2 * n) +
-		utilMax(4,
-			zzMod_deep(m, m),
-			zzMulMod_deep(m),
-			zzInvMod_deep(m),
-			ecAddMulA_deep(n, ec_d, ec_deep, 2, m, m));
-}
-
-err_t g12sVerify(const g12s_params* params, const octet hash[], 
-	const octet sig[], const octet pubkey[])
+err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
+	const octet privkey[], gen_i rng, void* rng_stack)
 {
 	err_t code;
-	size_t m, mo;
+	size_t mo;
 	// состояние
 	ec_o* ec;
-	word* Q;		/* [2n] открытый ключ / точка R */
-	word* r;		/* [m] первая (старшая) часть подписи */
-	word* s;		/* [m] вторая часть подписи */
-	word* e;		/* [m] обработанное хэш-значение, v */
-	void* stack;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
 	// старт
-	code = g12sCreateEc(&ec, params, g12sVerify_deep);
+	code = g12sCreateEc(&ec, params, g12sSignEc_deep);
 	ERR_CALL_CHECK(code);
-	// размерности order
-	m = W_OF_B(params->l);
-	mo = O_OF_B(params->l);
 	// проверить входные указатели
+	mo = O_OF_B(params->l);
 	if (!memIsValid(hash, mo) ||
-		!memIsValid(sig, 2 * mo) ||
-		!memIsValid(pubkey, 2 * ec->f->no))
+		!memIsValid(privkey, mo) ||
+		!memIsValid(sig, 2 * mo))
 	{
 		g12sCloseEc(ec);
 		return ERR_BAD_INPUT;
 	}
-	// раскладка состояния
-	Q = objEnd(ec, word);
-	r = Q + 2 * ec->f->n;
-	s = r + m;
-	e = s + m;
-	stack = e + m;
+	// выработать подпись
+	code = g12sSignEc(sig, ec, 0, params->l, hash, privkey, rng, rng_stack, 
+		objEnd(ec, void));
+	// завершение
+	g12sCloseEc(ec);
+	return code;
+}
+
+/*
+*******************************************************************************
+Проверка ЭЦП
+
+В функции g12sVerifyPre() загружаются открытый ключ Q и подпись (r, s), 
+проверяются ограничения на подпись и рассчитываются множители 
+z1 = s v \mod q и z2 = -r v \mod q, v = e^{-1} \mod q. Остается проверить, 
+что x-координата точки R = z1 P + z2 Q по модулю q совпадает с r. 
+Проверка выполняется в функции g12sVerifyEc() или, в пакетном режиме, 
+в функции g12sCtxVerifyBatch().
+*******************************************************************************
+*/
+
+static size_t g12sVerifyPre_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	const size_t m = n;
+	return utilMax(3,
+		zzMod_deep(m, m),
+		zzMulMod_deep(m),
+		zzInvMod_deep(m));
+}
+
+static err_t g12sVerifyPre(word Q[], word r[], word z1[], word z2[], 
+	const ec_o* ec, size_t l, const octet hash[], const octet sig[], 
+	const octet pubkey[], void* stack)
+{
+	const size_t m = W_OF_B(l);
+	const size_t mo = O_OF_B(l);
 	// загрузить Q
 	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
 		!qrFrom(ecY(Q, ec->f->n), pubkey + ec->f->no, ec->f, stack))
-	{
-		g12sCloseEc(ec);
 		return ERR_BAD_PUBKEY;
-	}
-	// загрузить r и s
-	memCopy(s, sig + mo, mo);
-	memRev(s, mo);
-	wwFrom(s, s, mo);
+	// загрузить r и s [s -> z1]
+	memCopy(z1, sig + mo, mo);
+	memRev(z1, mo);
+	wwFrom(z1, z1, mo);
 	memCopy(r, sig, mo);
 	memRev(r, mo);
 	wwFrom(r, r, mo);
-	if (wwIsZero(s, m) || 
+	if (wwIsZero(z1, m) || 
 		wwIsZero(r, m) || 
-		wwCmp(s, ec->order, m) >= 0 ||
+		wwCmp(z1, ec->order, m) >= 0 ||
 		wwCmp(r, ec->order, m) >= 0)
-	{
-		g12sCloseEc(ec);
 		return ERR_BAD_SIG;
-	}
-	// e <- hash \mod q
-	memCopy(e, hash, mo);
-	memRev(e, mo);
-	wwFrom(e, e, mo);
-	zzMod(e, e, m, ec->order, m, stack);
+	// z2 <- hash \mod q [e]
+	memCopy(z2, hash, mo);
+	memRev(z2, mo);
+	wwFrom(z2, z2, mo);
+	zzMod(z2, z2, m, ec->order, m, stack);
 	// e == 0 => e <- 1
-	if (wwIsZero(e, m))
-		e[0] = 1;
-	// e <- e^{-1} \mod q [v]
-	zzInvMod(e, e, ec->order, m, stack);
-	// s <- s e \mod q [z1]
-	zzMulMod(s, s, e, ec->order, m, stack);
-	// e <- - e r \mod q [z2]
-	zzMulMod(e, e, r, ec->order, m, stack);
-	zzNegMod(e, e, ec->order, m);
+	if (wwIsZero(z2, m))
+		z2[0] = 1;
+	// z2 <- e^{-1} \mod q [v]
+	zzInvMod(z2, z2, ec->order, m, stack);
+	// z1 <- s v \mod q
+	zzMulMod(z1, z1, z2, ec->order, m, stack);
+	// z2 <- - v r \mod q
+	zzMulMod(z2, z2, r, ec->order, m, stack);
+	zzNegMod(z2, z2, ec->order, m);
+	return ERR_OK;
+}
+
+static size_t g12sVerifyEc_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	const size_t m = n;
+	return O_OF_W(5 * m + 2 * n) +
+		utilMax(3,
+			g12sVerifyPre_deep(n, f_deep, ec_d, ec_deep),
+			zzMod_deep(m, m),
+			ecAddMulA_deep(n, ec_d, ec_deep, 2, m, m));
+}
+
+static err_t g12sVerifyEc(const ec_o* ec, size_t l, const octet hash[], 
+	const octet sig[], const octet pubkey[], void* stack)
+{
+	const size_t m = W_OF_B(l);
+	err_t code;
+	// переменные в stack
+	word* Q;		/* [2n] открытый ключ / точка R */
+	word* r;		/* [m] первая (старшая) часть подписи */
+	word* s;		/* [m] вторая часть подписи, z1 */
+	word* e;		/* [m] обработанное хэш-значение, v, z2 */
+	// раскладка stack
+	Q = (word*)stack;
+	r = Q + 2 * ec->f->n;
+	s = r + m;
+	e = s + m;
+	stack = e + m;
+	// загрузить и подготовить данные
+	code = g12sVerifyPre(Q, r, s, e, ec, l, hash, sig, pubkey, stack);
+	ERR_CALL_CHECK(code);
 	// Q <- s P + e Q [z1 P + z2 Q = R]
 	if (!ecAddMulA(Q, ec, stack, 2, ec->base, s, m, Q, e, m))
-	{
-		g12sCloseEc(ec);
 		return ERR_BAD_PARAMS;
-	}
 	// s <- x_Q \mod q [x_R \mod q]
 	qrTo((octet*)Q, ecX(Q), ec->f, stack);
 	wwFrom(Q, Q, ec->f->no);
 	zzMod(s, Q, ec->f->n, ec->order, m, stack);
 	// s == r?
-	code = wwEq(r, s, m) ? ERR_OK : ERR_BAD_SIG;
+	return wwEq(r, s, m) ? ERR_OK : ERR_BAD_SIG;
+}
+
+err_t g12sVerify(const g12s_params* params, const octet hash[], 
+	const octet sig[], const octet pubkey[])
+{
+	err_t code;
+	size_t mo;
+	// состояние
+	ec_o* ec;
+	// старт
+	code = g12sCreateEc(&ec, params, g12sVerifyEc_deep);
+	ERR_CALL_CHECK(code);
+	// проверить входные указатели
+	mo = O_OF_B(params->l);
+	if (!memIsValid(hash, mo) ||
+		!memIsValid(sig, 2 * mo) ||
+		!memIsValid(pubkey, 2 * ec->f->no))
+	{
+		g12sCloseEc(ec);
+		return ERR_BAD_INPUT;
+	}
+	// проверить подпись
+	code = g12sVerifyEc(ec, params->l, hash, sig, pubkey, objEnd(ec, void));
 	// завершение
 	g12sCloseEc(ec);
 	return code;
 }
+
+/*
+*******************************************************************************
+Долговременный контекст
+
+Контекст содержит описание кривой (вместе с описанием базового поля), 
+таблицу кратных базовой точки и стек для вызова g12sCtxSign(), 
+g12sCtxVerify(), g12sCtxVerifyBatch().
+
+При пакетной проверке подписи обрабатываются порциями по G12S_BATCH штук. 
+Для каждой подписи порции рассчитывается проективная точка R = z1 P + z2 Q 
+(функция ecAddMul()), затем все точки порции переводятся в аффинные 
+координаты с одним обращением в базовом поле (функция ecToABatch()).
+*******************************************************************************
+*/
+
+#define G12S_BATCH 16
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	ec_o* ec;					/*< описание эллиптической кривой */
+	word* tbl;					/*< таблица кратных базовой точки */
+// }
+	size_t l;					/*< уровень стойкости */
+	octet data[];				/*< данные */
+} g12s_ctx_o;
+
+static size_t g12sCtxVerifyBatch_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	const size_t m = n;
+	return O_OF_W(G12S_BATCH * (ec_d * n + 2 * n + m)) +
+		sizeof(err_t) * G12S_BATCH +
+		O_OF_W(2 * n + 2 * m) +
+		utilMax(4,
+			g12sVerifyPre_deep(n, f_deep, ec_d, ec_deep),
+			ecAddMul_deep(n, ec_d, ec_deep, 2, m, m),
+			ecToABatch_deep(n, ec_d, ec_deep, G12S_BATCH),
+			zzMod_deep(m, m));
+}
+
+static size_t g12sCtx_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	return utilMax(4,
+		ecTblCreateA_deep(n, ec_d, ec_deep),
+		g12sSignEc_deep(n, f_deep, ec_d, ec_deep),
+		g12sVerifyEc_deep(n, f_deep, ec_d, ec_deep),
+		g12sCtxVerifyBatch_deep(n, f_deep, ec_d, ec_deep));
+}
+
+size_t g12sCtx_keep(size_t l)
+{
+	const size_t n = W_OF_O(G12S_FIELD_SIZE * l / 512);
+	if (l != 256 && l != 512)
+		return SIZE_MAX;
+	return sizeof(g12s_ctx_o) + 
+		g12sStart_keep(l, g12sCtx_deep) +
+		ecTblCreateA_keep(n, W_OF_B(l));
+}
+
+err_t g12sCtxStart(void* state, const g12s_params* params)
+{
+	err_t code;
+	g12s_ctx_o* s = (g12s_ctx_o*)state;
+	size_t m;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(g12s_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 256 && params->l != 512)
+		return ERR_BAD_PARAMS;
+	ASSERT(memIsValid(state, g12sCtx_keep(params->l)));
+	// загрузить параметры
+	code = g12sStart(s->data, params);
+	ERR_CALL_CHECK(code);
+	s->ec = (ec_o*)s->data;
+	s->l = params->l;
+	m = W_OF_B(params->l);
+	// настроить указатели
+	s->tbl = objEnd(s->ec, word);
+	// настроить заголовок
+	s->hdr.keep = sizeof(g12s_ctx_o) + objKeep(s->ec) + 
+		ecTblCreateA_keep(s->ec->f->n, m);
+	s->hdr.p_count = 2;
+	s->hdr.o_count = 1;
+	// построить таблицу кратных базовой точки
+	if (!ecTblCreateA(s->tbl, s->ec->base, s->ec, m, objEnd(s, void)))
+		return ERR_BAD_PARAMS;
+	// все нормально
+	return ERR_OK;
+}
+
+err_t g12sCtxSign(octet sig[], const octet hash[], const octet privkey[], 
+	gen_i rng, void* rng_state, void* state)
+{
+	g12s_ctx_o* s = (g12s_ctx_o*)state;
+	size_t mo;
+	// проверить входные данные
+	if (!objIsOperable(s))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	mo = O_OF_B(s->l);
+	if (!memIsValid(hash, mo) ||
+		!memIsValid(privkey, mo) ||
+		!memIsValid(sig, 2 * mo))
+		return ERR_BAD_INPUT;
+	// выработать подпись
+	return g12sSignEc(sig, s->ec, s->tbl, s->l, hash, privkey, rng, 
+		rng_state, objEnd(s, void));
+}
+
+err_t g12sCtxVerify(const octet hash[], const octet sig[], 
+	const octet pubkey[], void* state)
+{
+	g12s_ctx_o* s = (g12s_ctx_o*)state;
+	size_t mo;
+	// проверить входные данные
+	if (!objIsOperable(s))
+		return ERR_BAD_INPUT;
+	mo = O_OF_B(s->l);
+	if (!memIsValid(hash, mo) ||
+		!memIsValid(sig, 2 * mo) ||
+		!memIsValid(pubkey, 2 * s->ec->f->no))
+		return ERR_BAD_INPUT;
+	// проверить подпись
+	return g12sVerifyEc(s->ec, s->l, hash, sig, pubkey, objEnd(s, void));
+}
+
+err_t g12sCtxVerifyBatch(err_t codes[], const octet hashes[], 
+	const octet sigs[], const octet pubkeys[], size_t count, void* state)
+{
+	g12s_ctx_o* s = (g12s_ctx_o*)state;
+	err_t code = ERR_OK;
+	size_t n, m, mo, no;
+	size_t i, j, c;
+	// стек
+	word* R;		/* [G12S_BATCH * ec_d * n] точки R (проективные) */
+	word* Ra;		/* [G12S_BATCH * 2n] точки R (аффинные) */
+	word* r;		/* [G12S_BATCH * m] первые части подписей */
+	err_t* cs;		/* [G12S_BATCH] коды проверки */
+	word* Q;		/* [2n] открытый ключ */
+	word* z1;		/* [m] множитель P */
+	word* z2;		/* [m] множитель Q */
+	void* stack;
+	// проверить входные данные
+	if (!objIsOperable(s))
+		return ERR_BAD_INPUT;
+	n = s->ec->f->n, no = s->ec->f->no;
+	m = W_OF_B(s->l), mo = O_OF_B(s->l);
+	if (!memIsNullOrValid(codes, sizeof(err_t) * count) ||
+		!memIsValid(hashes, mo * count) ||
+		!memIsValid(sigs, 2 * mo * count) ||
+		!memIsValid(pubkeys, 2 * no * count))
+		return ERR_BAD_INPUT;
+	// раскладка стека
+	R = objEnd(s, word);
+	Ra = R + G12S_BATCH * s->ec->d * n;
+	r = Ra + G12S_BATCH * 2 * n;
+	Q = r + G12S_BATCH * m;
+	z1 = Q + 2 * n;
+	z2 = z1 + m;
+	cs = (err_t*)(z2 + m);
+	stack = cs + G12S_BATCH;
+	// цикл по порциям
+	for (i = 0; i < count; i += c)
+	{
+		c = MIN2(count - i, G12S_BATCH);
+		// рассчитать точки R
+		for (j = 0; j < c; ++j)
+		{
+			word* Rj = R + j * s->ec->d * n;
+			cs[j] = g12sVerifyPre(Q, r + j * m, z1, z2, s->ec, s->l,
+				hashes + (i + j) * mo, sigs + (i + j) * 2 * mo,
+				pubkeys + (i + j) * 2 * no, stack);
+			if (cs[j] == ERR_OK &&
+				!ecAddMul(Rj, s->ec, stack, 2, s->ec->base, z1, m, Q, z2, m))
+				cs[j] = ERR_BAD_PARAMS;
+			// R == O или ошибка => R <- P (для пакетного экспорта)
+			if (cs[j] != ERR_OK)
+				ecFromA(Rj, s->ec->base, s->ec, stack);
+		}
+		// к аффинным координатам (точки R отличны от O)
+		VERIFY(ecToABatch(Ra, R, c, s->ec, stack));
+		// проверить подписи
+		for (j = 0; j < c; ++j)
+		{
+			if (cs[j] == ERR_OK)
+			{
+				word* x = Ra + j * 2 * n;
+				// z1 <- x_R \mod q
+				qrTo((octet*)x, ecX(x), s->ec->f, stack);
+				wwFrom(x, x, no);
+				zzMod(z1, x, n, s->ec->order, m, stack);
+				if (!wwEq(r + j * m, z1, m))
+					cs[j] = ERR_BAD_SIG;
+			}
+			if (codes)
+				codes[i + j] = cs[j];
+			if (code == ERR_OK)
+				code = cs[j];
+		}
+	}
+	return code;
+}
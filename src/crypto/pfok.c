@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.01
-\version 2016.09.07
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,10 +14,13 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/prng.h"
 #include "bee2/core/str.h"
+#include "bee2/core/tm.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/pfok.h"
+#include "bee2/crypto/vcache.h"
 #include "bee2/math/pri.h"
 #include "bee2/math/zm.h"
 #include "bee2/math/ww.h"
@@ -601,64 +604,157 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 	return ERR_OK;
 }
 
-err_t pfokValParams(const pfok_params* params)
+/*
+*******************************************************************************
+Проверка параметров
+
+Условия на p и g объединены в PFOK_VAL_CHECKS независимых проверок
+(см. pfokValParamsCheck()), которые распределяются между потоками так же,
+как в bignValParams2(). Проверка g не использует результаты проверок
+простоты: g^q вычисляется для q = (p - 1) / 2 в любом случае. Ключи
+успешно проверенных параметров сохраняются в кэше (см. vcache.h) с меткой
+"pfok".
+*******************************************************************************
+*/
+
+static bool_t pfokValParamsCheck(size_t i, const pfok_params* params,
+	void* stack)
 {
-	size_t no, n;
-	// состояние 
-	void* state;
+	const size_t no = O_OF_B(params->l);
+	const size_t n = W_OF_B(params->l);
+	// переменные в stack
 	word* p;
 	word* g;
 	qr_o* qr;
+	// раскладка stack
+	p = (word*)stack;
+	g = p + n;
+	qr = (qr_o*)(g + n);
+	stack = (octet*)qr + zmMontCreate_keep(no);
+	// p <- params->p
+	wwFrom(p, params->p, no);
+	// проверки
+	switch (i)
+	{
+	case 0:
+		// p -- простое?
+		return priIsPrime(p, n, stack);
+	case 1:
+		// q -- простое?
+		wwShLo(p, n, 1);
+		return priIsPrime(p, n, stack);
+	case 2:
+		// построить кольцо Монтгомери
+		zmMontCreate(qr, params->p, no, params->l + 2, stack);
+		// проверить g
+		wwShLo(p, n, 1);
+		qrFrom(g, params->g, qr, stack);
+		qrPower(p, g, p, W_OF_B(params->l - 1), qr, stack);
+		return !qrIsUnity(p, qr) && !qrIsUnity(g, qr) &&
+			qrCmp(p, g, qr) != 0;
+	}
+	return FALSE;
+}
+
+static size_t pfokValParamsCheck_deep(size_t l)
+{
+	const size_t no = O_OF_B(l);
+	const size_t n = W_OF_B(l);
+	return 2 * O_OF_W(n) + zmMontCreate_keep(no) +
+		utilMax(3,
+			priIsPrime_deep(n),
+			zmMontCreate_deep(no),
+			qrPower_deep(n, n, zmMontCreate_deep(no)));
+}
+
+typedef struct
+{
+	const pfok_params* params;	/*< параметры */
+	bool_t* oks;				/*< результаты проверок */
+	tm_ticks_t* ticks;			/*< продолжительность проверок */
+	size_t start;				/*< первая проверка */
+	size_t step;				/*< шаг по проверкам */
+	void* stack;				/*< вспомогательная память */
+} pfok_val_params_job;
+
+static void pfokValParamsRun(void* arg)
+{
+	const pfok_val_params_job* job = (const pfok_val_params_job*)arg;
+	tm_ticks_t t;
+	size_t i;
+	for (i = job->start; i < PFOK_VAL_CHECKS; i += job->step)
+	{
+		t = tmTicks();
+		job->oks[i] = pfokValParamsCheck(i, job->params, job->stack);
+		job->ticks[i] = tmTicks() - t;
+		if (!job->oks[i])
+			break;
+	}
+}
+
+err_t pfokValParams2(const pfok_params* params, size_t threads,
+	tm_ticks_t ticks[PFOK_VAL_CHECKS])
+{
+	err_t code = ERR_OK;
+	size_t i;
+	size_t job_deep;
+	octet key[32];
+	bool_t oks[PFOK_VAL_CHECKS];
+	tm_ticks_t ticks1[PFOK_VAL_CHECKS];
+	// состояние
+	void* state;
 	void* stack;
+	pfok_val_params_job* jobs;
 	// проверить указатели
-	if (!memIsValid(params, sizeof(pfok_params)))
+	if (!memIsValid(params, sizeof(pfok_params)) ||
+		!memIsNullOrValid(ticks, sizeof(tm_ticks_t) * PFOK_VAL_CHECKS))
 		return ERR_BAD_INPUT;
+	if (ticks == 0)
+		ticks = ticks1;
+	for (i = 0; i < PFOK_VAL_CHECKS; ++i)
+		oks[i] = TRUE, ticks[i] = 0;
 	// работоспособные параметры?
 	if (!pfokIsOperableParams(params))
 		return ERR_BAD_PARAMS;
-	// размерности
-	no = O_OF_B(params->l), n = W_OF_B(params->l);
+	// параметры уже проверялись?
+	vcacheKey(key, "pfok", params, sizeof(pfok_params));
+	if (vcacheHas(key))
+		return ERR_OK;
+	// число потоков
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, PFOK_VAL_CHECKS);
+	job_deep = pfokValParamsCheck_deep(params->l);
 	// создать состояние
-	state = blobCreate(
-		2 * O_OF_W(n) + zmMontCreate_keep(no) +  
-		utilMax(3,
-			priIsPrime_deep(n),
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+	state = blobCreate(threads * (job_deep + sizeof(pfok_val_params_job)));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
-	p = (word*)state;
-	g = p + n;
-	qr = (qr_o*)(g + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// p -- простое?
-	wwFrom(p, params->p, no);
-	if (!priIsPrime(p, n, stack))
+	stack = state;
+	jobs = (pfok_val_params_job*)((octet*)stack + threads * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
 	{
-		blobClose(state);
-		return ERR_BAD_PARAMS;
+		jobs[i].params = params;
+		jobs[i].oks = oks, jobs[i].ticks = ticks;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].stack = (octet*)stack + i * job_deep;
 	}
-	// q -- простое?
-	wwShLo(p, n, 1);
-	if (!priIsPrime(p, n, stack))
-	{
-		blobClose(state);
-		return ERR_BAD_PARAMS;
-	}
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
-	// проверить g
-	qrFrom(g, params->g, qr, stack);
-	qrPower(p, g, p, W_OF_B(params->l - 1), qr, stack);
-	if (qrIsUnity(p, qr) || qrIsUnity(g, qr) || qrCmp(p, g, qr) == 0)
-	{
-		blobClose(state);
-		return ERR_BAD_PARAMS;
-	}
-	// все нормально
+	// выполнить задания
+	mtRunJobs(pfokValParamsRun, jobs, sizeof(pfok_val_params_job), threads);
+	// результат
+	for (i = 0; i < PFOK_VAL_CHECKS; ++i)
+		if (!oks[i])
+			code = ERR_BAD_PARAMS;
+	if (code == ERR_OK)
+		vcacheAdd(key);
+	// завершение
 	blobClose(state);
-	return ERR_OK;
+	return code;
+}
+
+err_t pfokValParams(const pfok_params* params)
+{
+	return pfokValParams2(params, 1, 0);
 }
 
 /*
@@ -0,0 +1,184 @@
+/*
+*******************************************************************************
+\file vcache.c
+\brief Cache of validated domain parameters
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include "bee2/core/blob.h"
+#include "bee2/core/err.h"
+#include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
+#include "bee2/core/str.h"
+#include "bee2/core/u32.h"
+#include "bee2/core/util.h"
+#include "bee2/crypto/belt.h"
+#include "bee2/crypto/vcache.h"
+
+/*
+*******************************************************************************
+Состояние
+
+Ключ key может находиться в ячейках с номерами (i + j) % size,
+0 <= j < ways, где i = <key[0..3]> % size, ways = MIN2(VCACHE_WAYS, size).
+Пустая ячейка содержит нулевой ключ (ключ belt-hash окажется нулевым
+с пренебрежимо малой вероятностью). Если все ячейки ключа заняты, то
+вытесняется ячейка (i + j) % size, где j -- очередное значение счетчика
+next по модулю ways.
+
+Как и в rng.c, создание и закрытие кэша не защищены от одновременного
+вызова из разных потоков. В vcacheHas() и vcacheAdd() признак _lock
+читается до блокировки мьютекса: это корректно, поскольку vcacheClose()
+не выполняется одновременно с ними (см. vcache.h).
+*******************************************************************************
+*/
+
+typedef struct
+{
+	size_t size;				/*< число ячеек */
+	size_t next;				/*< счетчик вытеснений */
+	octet keys[];				/*< [size][32] ячейки */
+} vcache_st;
+
+static size_t _lock;			/*< счетчик созданий */
+static mt_mtx_t _mtx[1];		/*< мьютекс */
+static vcache_st* _cache;		/*< кэш */
+
+/*
+*******************************************************************************
+Создание / закрытие
+*******************************************************************************
+*/
+
+err_t vcacheCreate(size_t size)
+{
+	// уже создан?
+	if (_lock)
+	{
+		++_lock;
+		return ERR_OK;
+	}
+	// проверить входные данные
+	if (size == 0 || size > VCACHE_MAX_SIZE)
+		return ERR_BAD_INPUT;
+	// создать мьютекс
+	if (!mtMtxCreate(_mtx))
+		return ERR_FILE_CREATE;
+	// создать кэш
+	_cache = (vcache_st*)blobCreate(sizeof(vcache_st) + 32 * size);
+	if (!_cache)
+	{
+		mtMtxClose(_mtx);
+		return ERR_OUTOFMEMORY;
+	}
+	_cache->size = size;
+	_lock = 1;
+	return ERR_OK;
+}
+
+bool_t vcacheIsValid()
+{
+	return _lock > 0 && mtMtxIsValid(_mtx) && blobIsValid(_cache);
+}
+
+void vcacheWipe()
+{
+	ASSERT(vcacheIsValid());
+	mtMtxLock(_mtx);
+	memSetZero(_cache->keys, 32 * _cache->size);
+	_cache->next = 0;
+	mtMtxUnlock(_mtx);
+}
+
+void vcacheClose()
+{
+	ASSERT(vcacheIsValid());
+	mtMtxLock(_mtx);
+	if (--_lock == 0)
+	{
+		blobClose(_cache);
+		_cache = 0;
+		mtMtxUnlock(_mtx);
+		mtMtxClose(_mtx);
+	}
+	else
+		mtMtxUnlock(_mtx);
+}
+
+/*
+*******************************************************************************
+Ключи
+*******************************************************************************
+*/
+
+void vcacheKey(octet key[32], const char* tag, const void* params,
+	size_t count)
+{
+	octet state[256];
+	u32 len;
+	ASSERT(sizeof(state) >= beltHash_keep());
+	ASSERT(strIsValid(tag));
+	ASSERT(memIsValid(params, count));
+	len = (u32)strLen(tag);
+	u32To(key, 4, &len);
+	beltHashStart(state);
+	beltHashStepH(key, 4, state);
+	beltHashStepH(tag, len, state);
+	beltHashStepH(params, count, state);
+	beltHashStepG(key, state);
+	memSetZero(state, beltHash_keep());
+}
+
+static size_t vcacheIndex(const octet key[32])
+{
+	u32 i;
+	u32From(&i, key, 4);
+	return (size_t)i % _cache->size;
+}
+
+bool_t vcacheHas(const octet key[32])
+{
+	size_t i, j, ways;
+	bool_t ret = FALSE;
+	ASSERT(memIsValid(key, 32));
+	if (!_lock)
+		return FALSE;
+	mtMtxLock(_mtx);
+	ways = MIN2(VCACHE_WAYS, _cache->size);
+	i = vcacheIndex(key);
+	for (j = 0; j < ways && !ret; ++j)
+		ret = memEq(_cache->keys + 32 * ((i + j) % _cache->size), key, 32);
+	mtMtxUnlock(_mtx);
+	return ret;
+}
+
+void vcacheAdd(const octet key[32])
+{
+	size_t i, j, ways;
+	octet* slot;
+	ASSERT(memIsValid(key, 32));
+	if (!_lock)
+		return;
+	mtMtxLock(_mtx);
+	ways = MIN2(VCACHE_WAYS, _cache->size);
+	i = vcacheIndex(key);
+	// уже есть? есть пустая ячейка?
+	for (j = 0; j < ways; ++j)
+	{
+		slot = _cache->keys + 32 * ((i + j) % _cache->size);
+		if (memEq(slot, key, 32) || memIsZero(slot, 32))
+			break;
+	}
+	// вытеснить
+	if (j == ways)
+		j = _cache->next++ % ways;
+	slot = _cache->keys + 32 * ((i + j) % _cache->size);
+	memCopy(slot, key, 32);
+	mtMtxUnlock(_mtx);
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.03.04
-\version 2015.11.09
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -13,6 +13,7 @@ version 3. See Copyright Notices in bee2/info.h.
 
 #include <stdarg.h>
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
 #include "bee2/core/word.h"
@@ -135,44 +136,120 @@ Springer, 2004].
 
 В практических диапазонах размерностей при использовании наиболее эффективных
 координат (якобиановых для кривых над GF(p) и Лопеса -- Дахаба для кривых 
-над GF(2^m)) первые две стратегии являются проигрышными. Реализована только 
-третья стратегия. 
-
-Оптимальная длина окна выбирается как решение следующей оптимизационной 
-задачи:
-	(2^{w - 2} - 2) + l / (w + 1) -> min.
-
-\todo Усилить вторую стратегию. Рассчитать малые кратные в проективных 
-координатах, а затем быстро перейти к аффинным координатам с помощью 
-трюка Монтгомери [Algorithm 11.15 Simultaneous inversion, CohenFrey, p. 209]:
-	U_1 <- Z_1
-	for t = 2,..., T: U_t <- U_{t-1} Z_t
-	V <- U_T^{-1}
-	for t = T,..., 2: 
-		Z_t^{-1} <- V U_{t-1}
-		V <- V Z_t
-	Z_1^{-1} <- V
+над GF(2^m)) первые две стратегии являются проигрышными. 
+
+Если кривая поддерживает пакетный экспорт (ec->toab != 0), то становится 
+доступной стратегия
+4)	w > 2, малые кратные рассчитываются в проективных координатах, а затем 
+	переводятся в аффинные с одним общим обращением (трюк Монтгомери 
+	[Algorithm 11.15 Simultaneous inversion, CohenFrey, p. 209], 
+	см. qrInvBatch()). 
+Сложность стратегии:
+	c4(l, w) = c3(l, w) + 1I + 2^{w-2}(A <- P)* - l/(w + 1)[(P <- P + P) - 
+		(P <- P + A)],
+где (A <- P)* -- затраты ec->toab на одну точку без учета общего 
+обращения I.
+
+Стратегии 3 и 4 сравниваются с помощью оценок, выраженных в умножениях 
+в базовом поле. Для якобиановых координат (см. ecp.c):
+	(P <- P + P) ~ 16M, (P <- P + A) ~ 11M, (A <- P)* ~ 7M.
+Измерения на кривых bign (x86-64) дают 14--19.5M, 9--13M и 7--8.5M 
+соответственно. Эти же оценки используются для координат Лопеса -- Дахаба. 
+Стоимость I обращения в поле берется из поля ec->inv_ratio. Если 
+ec->inv_ratio == 0 или ec->toab == 0, то выбирается стратегия 3.
+
+Длина окна в стратегии 3 минимизирует c3(l, w), в стратегии 4 -- c4(l, w). 
+Функция c3(l, w) выпукла по w, поэтому оптимальное окно растет вместе с l 
+(w = 3 при l <= 40, w = 4 при l <= 120, w = 5 при l <= 337, w = 6 при 
+l <= 899). Поскольку в стратегии 4 дороже предвычисления и дешевле сложения 
+основного цикла, оптимальное окно стратегии 4 не длиннее окна стратегии 3. 
+Поэтому глубина стека определяется окном стратегии 3 и не зависит 
+от ec->inv_ratio.
+
+Измерения стратегий 3 и 4 (x86-64, лучшее из 7 серий по 200 умножений, 
+стратегия 4 включалась через ec->inv_ratio = 1, см. также ecpBench() 
+и ec2Bench()):
+-	кривые bign, I / M = 230--305: стратегия 4 проигрывает 5--7.5% на уровне
+	стойкости 128, 0--4% на уровне 192, от -3% до +2.5% на уровне 256;
+-	кривые ДСТУ, поля из gf2Create(), I / M = 60--215: разница от -5% 
+	до +4% без устойчивого знака (отдельные выбросы до 20% в обе стороны);
+-	кривые ДСТУ, поля из gf2CreateIT(), I / M = 25--55: стратегия 4 
+	выигрывает 2--9% при m >= 233.
+По модели c4 < c3 при I / M = 300 и l = 512, но выигрыш (около 1% общего 
+времени) меньше погрешности измерений. Поэтому ecpCreateJ() и ec2CreateLD() 
+устанавливают ec->inv_ratio = 0, т.е. выбирают стратегию 3. Если поле 
+допускает быстрое обращение (например, создано функцией gf2CreateIT()), 
+то ec->inv_ratio следует установить равным измеренному отношению I / M.
 *******************************************************************************
 */
 
+#define EC_COST_ADD		16
+#define EC_COST_ADDA	11
+#define EC_COST_TOAB	7
+
+static size_t ecMulCost3(size_t l, size_t w)
+{
+	const size_t naf_count = SIZE_1 << (w - 2);
+	return (naf_count - 1) * EC_COST_ADD + l * EC_COST_ADD / (w + 1);
+}
+
 static size_t ecNAFWidth(size_t l)
 {
-	if (l >= 336)
-		return 6;
-	else if (l >= 120)
-		return 5;
-	else if (l >= 40)
-		return 4;
-	return 3;
+	size_t w = 3;
+	while (ecMulCost3(l, w + 1) < ecMulCost3(l, w))
+		++w;
+	return w;
+}
+
+static size_t ecMulCost4(size_t l, size_t w, size_t inv_ratio)
+{
+	const size_t naf_count = SIZE_1 << (w - 2);
+	return (naf_count - 1) * EC_COST_ADD + inv_ratio + 
+		naf_count * EC_COST_TOAB + l * EC_COST_ADDA / (w + 1);
+}
+
+static size_t ecMulWidthA(size_t l, const ec_o* ec)
+{
+	const size_t naf_width = ecNAFWidth(l);
+	size_t w, ret;
+	// стратегия 4 недоступна?
+	if (ec->toab == 0 || ec->inv_ratio == 0)
+		return 0;
+	// оптимальное окно стратегии 4
+	for (ret = w = 3; w <= naf_width; ++w)
+		if (ecMulCost4(l, w, ec->inv_ratio) < 
+			ecMulCost4(l, ret, ec->inv_ratio))
+			ret = w;
+	// стратегия 4 проигрывает?
+	if (ecMulCost4(l, ret, ec->inv_ratio) >= ecMulCost3(l, naf_width))
+		return 0;
+	return ret;
+}
+
+static void ecMulPre(word pre[], word t[], const word a[], size_t naf_count,
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	size_t i;
+	// pre[0] <- a
+	ecFromA(pre, a, ec, stack);
+	// расчет pre[i]: t <- 2a, pre[i] <- t + pre[i - 1]
+	ASSERT(naf_count > 1);
+	ecDblA(t, pre, ec, stack);
+	ecAddA(pre + ec->d * n, t, pre, ec, stack);
+	for (i = 2; i < naf_count; ++i)
+		ecAdd(pre + i * ec->d * n, t, pre + (i - 1) * ec->d * n, ec, stack);
 }
 
 bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
 	size_t m, void* stack)
 {
 	const size_t n = ec->f->n;
-	const size_t naf_width = ecNAFWidth(B_OF_W(m));
-	const size_t naf_count = SIZE_1 << (naf_width - 2);
-	const word naf_hi = WORD_1 << (naf_width - 1);
+	size_t naf_width = ecMulWidthA(B_OF_W(m), ec);
+	const bool_t affine = naf_width != 0;
+	size_t naf_count;
+	word naf_hi;
+	size_t pre_d;
 	register size_t naf_size;
 	register size_t i;
 	register word w;
@@ -182,6 +259,11 @@ bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
 	word* pre;			/* pre[i] = (2i + 1)a (naf_count элементов) */
 	// pre
 	ASSERT(ecIsOperable(ec));
+	// стратегия 3?
+	if (!affine)
+		naf_width = ecNAFWidth(B_OF_W(m));
+	naf_count = SIZE_1 << (naf_width - 2);
+	naf_hi = WORD_1 << (naf_width - 1);
 	// раскладка stack
 	naf = (word*)stack;
 	t = naf + 2 * m + 1;
@@ -193,18 +275,25 @@ bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
 	// d == O => b <- O
 	if (naf_size == 0)
 		return FALSE;
-	// pre[0] <- a
-	ecFromA(pre, a, ec, stack);
-	// расчет pre[i]: t <- 2a, pre[i] <- t + pre[i - 1]
-	ASSERT(naf_count > 1);
-	ecDblA(t, pre, ec, stack);
-	ecAddA(pre + ec->d * n, t, pre, ec, stack);
-	for (i = 2; i < naf_count; ++i)
-		ecAdd(pre + i * ec->d * n, t, pre + (i - 1) * ec->d * n, ec, stack);
+	// расчет pre[i]
+	ecMulPre(pre, t, a, naf_count, ec, stack);
+	// стратегия 4: переход к аффинным pre[i]
+	pre_d = ec->d;
+	if (affine)
+	{
+		if (ec->toab(pre, pre, naf_count, ec, stack))
+			pre_d = 2;
+		// одна из pre[i] равна O: вернуться к проективным pre[i]
+		else
+			ecMulPre(pre, t, a, naf_count, ec, stack);
+	}
 	// t <- a[naf[l - 1]]
 	w = wwGetBits(naf, 0, naf_width);
 	ASSERT((w & 1) == 1 && (w & naf_hi) == 0);
-	wwCopy(t, pre + (w >> 1) * ec->d * n, ec->d * n);
+	if (pre_d == 2)
+		ecFromA(t, pre + (w >> 1) * 2 * n, ec, stack);
+	else
+		wwCopy(t, pre + (w >> 1) * ec->d * n, ec->d * n);
 	// цикл по символам NAF
 	i = naf_width;
 	while (--naf_size)
@@ -214,8 +303,17 @@ bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
 		{
 			// t <- 2 t
 			ecDbl(t, t, ec, stack);
-			// t <- t \pm pre[naf[w]]
-			if (w == 1)
+			// t <- t \pm pre[naf[w]] (аффинные pre[i])
+			if (pre_d == 2)
+			{
+				if (w & naf_hi)
+					ecSubA(t, t, pre + ((w ^ naf_hi) >> 1) * 2 * n, ec, 
+						stack);
+				else
+					ecAddA(t, t, pre + (w >> 1) * 2 * n, ec, stack);
+			}
+			// t <- t \pm pre[naf[w]] (проективные pre[i])
+			else if (w == 1)
 				ecAddA(t, t, pre, ec, stack);
 			else if (w == (naf_hi ^ 1))
 				ecSubA(t, t, pre, ec, stack);
@@ -243,9 +341,170 @@ size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
 	return O_OF_W(2 * m + 1) + 
 		O_OF_W(ec_d * n) + 
 		O_OF_W(ec_d * n * naf_count) + 
+		utilMax(2,
+			ec_deep,
+			ecToABatch_deep(n, ec_d, ec_deep, naf_count));
+}
+
+/*
+*******************************************************************************
+Регулярная кратная точка
+
+Реализован алгоритм Джойе -- Тунстолла [M. Joye, M. Tunstall. Exponent 
+recoding and regular exponentiation algorithms. AFRICACRYPT 2009] 
+с нечетными знаковыми цифрами. Нечетная кратность k = d | 1 записывается 
+в виде
+	k = 2^{w(count - 1)} + \sum_{i < count - 1} k_i 2^{wi},
+где k_i = ((k >> wi) \bmod 2^{w + 1} | 1) - 2^w -- нечетные цифры из 
+интервала [-(2^w - 1), 2^w - 1], count = \lceil (l - 1) / w \rceil + 1, 
+l = B_OF_W(m). Старшая цифра равняется (k >> w(count - 1)) | 1 = 1, 
+поскольку w(count - 1) >= l - 1 и k < 2^l. Запись строится без переносов 
+(см. также ecMulTblA()). При определении цифр читаются разряды k с номерами 
+до w(count - 1) < l + w - 1, поэтому k размещается в m + 1 слове.
+
+При обработке каждой цифры выполняется ровно w удвоений и одно сложение 
+с точкой \pm pre[|k_i| / 2], pre[j] = (2j + 1)a. Точка таблицы выбирается 
+маскированным просмотром всех 2^{w - 1} элементов, знак учитывается 
+маскированной заменой на противоположную точку. Четность d учитывается 
+в конце маскированным выбором между k a и k a - a. Таким образом, 
+последовательность операций и обращений к памяти не зависит от d.
+
+Если a имеет простой порядок q > 2^{w + 1} и d < q, то слагаемые 
+в основном цикле всегда различны и ненулевы (исключение -- d = q - 1, 
+когда на последнем шаге получается O). Поэтому формулы сложения 
+(см. ecp.c, ec2.c) работают без исключительных ветвлений и сохраняют 
+регулярность без перехода к полным формулам. Крайние записи (d = 1, 
+d = q - 1, d с нулевыми старшими цифрами) проверяются в ecpTest().
+
+Длина окна минимизирует 2^{w - 1} + l / w: затраты на предвычисления 
+и сложения основного цикла. Для l = 256 выбирается w = 5 и выполняется 
+около 66 сложений против 50 в ecMulA(). С учетом l удвоений, общих для 
+обоих алгоритмов, модель дает замедление около 8% плюс маскированные 
+просмотры. Измеренное замедление относительно ecMulA() на кривых bign 
+(x86-64, ecpBench(), лучшее из 25 чередующихся серий) составляет около 
+13% (8--17% в повторных запусках) на всех трех уровнях стойкости. 
+Однократные замеры без чередования дают разброс до 50%.
+*******************************************************************************
+*/
+
+static size_t ecRegWidth(size_t l)
+{
+	size_t w, ret;
+	for (ret = w = 3; w <= 6; ++w)
+		if ((SIZE_1 << (w - 1)) + l / w < (SIZE_1 << (ret - 1)) + l / ret)
+			ret = w;
+	return ret;
+}
+
+bool_t ecMulReg(word b[], const word a[], const ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t w = ecRegWidth(B_OF_W(m));
+	const size_t pre_count = SIZE_1 << (w - 1);
+	const size_t count = (B_OF_W(m) - 1 + w - 1) / w + 1;
+	register word even;
+	register word sign;
+	register word mask;
+	register word digit;
+	size_t i, j, pos;
+	// переменные в stack
+	word* k;			/* d | 1 */
+	word* t;			/* накопленная кратная точка */
+	word* u;			/* выбранная точка таблицы */
+	word* v;			/* обратная к u */
+	word* pre;			/* pre[j] = (2j + 1)a (pre_count элементов) */
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(wwIsValid(d, m));
+	// раскладка stack
+	k = (word*)stack;
+	t = k + m + 1;
+	u = t + ec->d * n;
+	v = u + ec->d * n;
+	pre = v + ec->d * n;
+	stack = pre + pre_count * ec->d * n;
+	// k <- d | 1
+	wwCopy(k, d, m);
+	k[m] = 0;
+	even = (k[0] & 1) ^ 1;
+	k[0] |= 1;
+	// расчет pre[j]
+	ecMulPre(pre, t, a, pre_count, ec, stack);
+	// t <- a (старшая цифра)
+	ecFromA(t, a, ec, stack);
+	// цикл по цифрам
+	for (i = count - 1; i--;)
+	{
+		// t <- 2^w t
+		for (j = 0; j < w; ++j)
+			ecDbl(t, t, ec, stack);
+		// digit <- (k >> wi) \bmod 2^{w + 1} | 1
+		digit = wwGetBits(k, i * w, w + 1) | 1;
+		// sign <- [k_i < 0], digit <- (|k_i| - 1) / 2
+		sign = (digit >> w) ^ 1;
+		digit = ((digit ^ (WORD_0 - sign)) & (WORD_BIT_POS(w) - 1)) >> 1;
+		// u <- pre[digit] (маскированный выбор)
+		wwSetZero(u, ec->d * n);
+		for (j = 0; j < pre_count; ++j)
+		{
+			mask = WORD_0 - wordEq01((word)j, digit);
+			for (pos = 0; pos < ec->d * n; ++pos)
+				u[pos] |= pre[j * ec->d * n + pos] & mask;
+		}
+		// u <- sign ? -u : u
+		ecNeg(v, u, ec, stack);
+		mask = WORD_0 - sign;
+		for (pos = 0; pos < ec->d * n; ++pos)
+			u[pos] ^= (u[pos] ^ v[pos]) & mask;
+		// t <- t + u
+		ecAdd(t, t, u, ec, stack);
+	}
+	// d -- четное? t <- t - a
+	ecSubA(u, t, a, ec, stack);
+	mask = WORD_0 - even;
+	for (pos = 0; pos < ec->d * n; ++pos)
+		t[pos] ^= (t[pos] ^ u[pos]) & mask;
+	// выгрузить
+	wwCopy(b, t, ec->d * n);
+	// очистка
+	even = sign = mask = digit = 0;
+	wwSetZero(k, m + 1);
+	wwSetZero(t, ec->d * n);
+	return !ecIsO(b, ec);
+}
+
+size_t ecMulReg_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	const size_t w = ecRegWidth(B_OF_W(m));
+	const size_t pre_count = SIZE_1 << (w - 1);
+	return O_OF_W(m + 1) + 
+		O_OF_W(3 * ec_d * n) + 
+		O_OF_W(ec_d * n * pre_count) + 
 		ec_deep;
 }
 
+bool_t ecMulRegA(word b[], const word a[], const ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * n;
+	// t <- d a
+	ecMulReg(t, a, ec, d, m, stack);
+	// к аффинным координатам
+	return ecToA(b, t, ec, stack);
+}
+
+size_t ecMulRegA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	return O_OF_W(ec_d * n) + 
+		utilMax(2,
+			ecMulReg_deep(n, ec_d, ec_deep, m),
+			ec_deep);
+}
+
 /*
 *******************************************************************************
 Имеет порядок?
@@ -280,17 +539,28 @@ Elliptic Curve Cryptography, Springer, 2004] (interleaving with NAF).
 Сложность алгоритма:
 	max l[i](P <- 2P) + \sum {i=1}^k
 		[1(P <- 2A) + (2^{w[i]-2}-2)(P <- P + P) + l[i]/(w[i]+1)(P <- P + P)].
+
+Алгоритм реализован в функции ecAddMulS(), которая принимает массивы 
+указателей на точки и кратности и возвращает проективную точку. Функция 
+ecAddMulV() формирует массивы по списку дополнительных параметров. 
+Функция ecAddMulA() дополнительно переходит к аффинным координатам.
 *******************************************************************************
 */
 
-bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
+static size_t ecAddMulTerm_deep(size_t n, size_t ec_d, size_t m)
+{
+	const size_t naf_width = ecNAFWidth(B_OF_W(m));
+	const size_t naf_count = SIZE_1 << (naf_width - 2);
+	return O_OF_W(2 * m + 1) + O_OF_W(ec_d * n * naf_count);
+}
+
+static bool_t ecAddMulS(word b[], const ec_o* ec, const word* const as[],
+	const word* const ds[], const size_t ms[], size_t k, void* stack)
 {
 	const size_t n = ec->f->n;
 	register word w;
 	size_t i, naf_max_size = 0;
-	va_list marker;
 	// переменные в stack
-	word* t;			/* проективная точка */
 	size_t* m;			/* длины d[i] */
 	size_t* naf_width;	/* размеры NAF-окон */
 	size_t* naf_size;	/* длины NAF */
@@ -301,35 +571,25 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 	ASSERT(ecIsOperable(ec));
 	ASSERT(k > 0);
 	// раскладка stack
-	t = (word*)stack;
-	m = (size_t*)(t + ec->d * n);
+	m = (size_t*)stack;
 	naf_width = m + k;
 	naf_size = naf_width + k;
 	naf_pos = naf_size + k;
 	naf = (word**)(naf_pos + k);
 	pre = naf + k;
 	stack = pre + k;
-	// обработать параметры (a[i], d[i], m[i])
-	va_start(marker, k);
+	// обработать тройки (a[i], d[i], m[i])
 	for (i = 0; i < k; ++i)
 	{
-		const word* a;
-		const word* d;
 		size_t naf_count, j;
-		// a <- a[i]
-		a = va_arg(marker, const word*);
-		// d <- d[i]
-		d = va_arg(marker, const word*);
-		// прочитать m[i]
-		m[i] = va_arg(marker, size_t);
 		// подправить m[i]
-		m[i] = wwWordSize(d, m[i]);
+		m[i] = wwWordSize(ds[i], ms[i]);
 		// расчет naf[i]
 		naf_width[i] = ecNAFWidth(B_OF_W(m[i]));
 		naf_count = SIZE_1 << (naf_width[i] - 2);
 		naf[i] = (word*)stack;
 		stack = naf[i] + 2 * m[i] + 1;
-		naf_size[i] = wwNAF(naf[i], d, m[i], naf_width[i]);
+		naf_size[i] = wwNAF(naf[i], ds[i], m[i], naf_width[i]);
 		if (naf_size[i] > naf_max_size)
 			naf_max_size = naf_size[i];
 		naf_pos[i] = 0;
@@ -337,23 +597,22 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 		pre[i] = (word*)stack;
 		stack = pre[i] + ec->d * n * naf_count;
 		// pre[i][0] <- a[i]
-		ecFromA(pre[i], a, ec, stack);
-		// расчет pre[i][j]: t <- 2a[i], pre[i][j] <- t + pre[i][j - 1]
+		ecFromA(pre[i], as[i], ec, stack);
+		// расчет pre[i][j]: b <- 2a[i], pre[i][j] <- b + pre[i][j - 1]
 		ASSERT(naf_count > 1);
-		ecDblA(t, pre[i], ec, stack);
-		ecAddA(pre[i] + ec->d * n, t, pre[i], ec, stack);
+		ecDblA(b, pre[i], ec, stack);
+		ecAddA(pre[i] + ec->d * n, b, pre[i], ec, stack);
 		for (j = 2; j < naf_count; ++j)
-			ecAdd(pre[i] + j * ec->d * n, t, pre[i] + (j - 1) * ec->d * n, ec,
+			ecAdd(pre[i] + j * ec->d * n, b, pre[i] + (j - 1) * ec->d * n, ec,
 				stack);
 	}
-	va_end(marker);
-	// t <- O
-	ecSetO(t, ec);
+	// b <- O
+	ecSetO(b, ec);
 	// основной цикл
 	for (; naf_max_size; --naf_max_size)
 	{
-		// t <- 2 t
-		ecDbl(t, t, ec, stack);
+		// b <- 2 b
+		ecDbl(b, b, ec, stack);
 		// цикл по (a[i], naf[i])
 		for (i = 0; i < k; ++i)
 		{
@@ -367,16 +626,16 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 			naf_hi = WORD_1 << (naf_width[i] - 1);
 			if (w & 1)
 			{
-				// t <- t \pm pre[i][naf[i][w]]
+				// b <- b \pm pre[i][naf[i][w]]
 				if (w == 1)
-					ecAddA(t, t, pre[i], ec, stack);
+					ecAddA(b, b, pre[i], ec, stack);
 				else if (w == (naf_hi ^ 1))
-					ecSubA(t, t, pre[i], ec, stack);
+					ecSubA(b, b, pre[i], ec, stack);
 				else if (w & naf_hi)
 					w ^= naf_hi,
-					ecSub(t, t, pre[i] + (w >> 1) * ec->d * n, ec, stack);
+					ecSub(b, b, pre[i] + (w >> 1) * ec->d * n, ec, stack);
 				else
-					ecAdd(t, t, pre[i] + (w >> 1) * ec->d * n, ec, stack);
+					ecAdd(b, b, pre[i] + (w >> 1) * ec->d * n, ec, stack);
 				// к следующему символу naf[i]
 				naf_pos[i] += naf_width[i];
 			}
@@ -386,27 +645,612 @@ bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
 	}
 	// очистка
 	w = 0;
+	return !ecIsO(b, ec);
+}
+
+static size_t ecAddMulS_deep(size_t k, size_t ec_deep)
+{
+	return 4 * sizeof(size_t) * k + 2 * sizeof(word**) * k + ec_deep;
+}
+
+static bool_t ecAddMulV(word b[], const ec_o* ec, void* stack, size_t k,
+	va_list marker)
+{
+	size_t i;
+	// переменные в stack
+	const word** as;
+	const word** ds;
+	size_t* ms;
+	// раскладка stack
+	as = (const word**)stack;
+	ds = as + k;
+	ms = (size_t*)(ds + k);
+	stack = ms + k;
+	// прочитать тройки (a[i], d[i], m[i])
+	for (i = 0; i < k; ++i)
+	{
+		as[i] = va_arg(marker, const word*);
+		ds[i] = va_arg(marker, const word*);
+		ms[i] = va_arg(marker, size_t);
+	}
+	// b <- \sum d[i] a[i]
+	return ecAddMulS(b, ec, as, ds, ms, k, stack);
+}
+
+static size_t ecAddMulV_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k,
+	va_list marker)
+{
+	size_t i, ret;
+	ret = 2 * sizeof(const word*) * k + sizeof(size_t) * k;
+	ret += ecAddMulS_deep(k, ec_deep);
+	for (i = 0; i < k; ++i)
+		ret += ecAddMulTerm_deep(n, ec_d, va_arg(marker, size_t));
+	return ret;
+}
+
+bool_t ecAddMulA(word b[], const ec_o* ec, void* stack, size_t k, ...)
+{
+	bool_t ret;
+	va_list marker;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * ec->f->n;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	// t <- \sum d[i] a[i]
+	va_start(marker, k);
+	ret = ecAddMulV(t, ec, stack, k, marker);
+	va_end(marker);
 	// к аффинным координатам
-	return ecToA(b, t, ec, stack);
+	return ret && ecToA(b, t, ec, stack);
 }
 
 size_t ecAddMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, ...)
 {
-	size_t i, ret;
+	size_t ret;
+	va_list marker;
+	va_start(marker, k);
+	ret = O_OF_W(ec_d * n) + ecAddMulV_deep(n, ec_d, ec_deep, k, marker);
+	va_end(marker);
+	return ret;
+}
+
+bool_t ecAddMul(word b[], const ec_o* ec, void* stack, size_t k, ...)
+{
+	bool_t ret;
+	va_list marker;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	// b <- \sum d[i] a[i]
+	va_start(marker, k);
+	ret = ecAddMulV(b, ec, stack, k, marker);
+	va_end(marker);
+	return ret;
+}
+
+size_t ecAddMul_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, ...)
+{
+	size_t ret;
 	va_list marker;
-	ret = O_OF_W(ec_d * n);
-	ret += 4 * sizeof(size_t) * k;
-	ret += 2 * sizeof(word**) * k;
 	va_start(marker, k);
+	ret = ecAddMulV_deep(n, ec_d, ec_deep, k, marker);
+	va_end(marker);
+	return ret;
+}
+
+/*
+*******************************************************************************
+Сумма кратных точек: массивы
+
+Точки a[i] и кратности d[i] задаются массивами. При небольшом числе 
+слагаемых k применяется алгоритм ecAddMulS(). При большом k применяется 
+метод корзин Пиппенджера [Pippenger N. On the evaluation of powers and 
+related problems. FOCS 1976, p. 258--263] со знаковыми цифрами.
+
+Кратности разбиваются на окна из c битов. В окне j кратность d[i] 
+представляется знаковой цифрой
+	e[i][j] = d[i]{jc..jc + c - 1} + d[i]{jc - 1} - 2^c d[i]{jc + c - 1},
+где d[i]{t} -- t-й бит d[i] (d[i]{-1} = 0), d[i]{t..u} -- число, 
+составленное из битов с номерами t..u. Цифры лежат в интервале 
+[-2^{c - 1}, 2^{c - 1}] и d[i] = \sum_j e[i][j] 2^{jc}. Число окон 
+W = \lceil (l + 1) / c \rceil, где l -- битовая длина кратностей.
+
+Для каждого окна j точки \pm a[i] накапливаются (смешанным сложением) 
+в 2^{c - 1} корзинах B[u] по модулям цифр e[i][j]. Сумма окна 
+T[j] = \sum_u u B[u] определяется бегущими суммами за 2^c сложений. 
+Окончательно b = \sum_j 2^{jc} T[j] определяется по схеме Горнера.
+
+Цифра e[i][j] зависит только от битов d[i] и не требует переносов из 
+младших окон. Поэтому окна обрабатываются независимо и могут быть 
+распределены по потокам. Каждый поток получает свою часть стека: 
+корзины и вспомогательную память ec. Если поток создать не удается, 
+то его окна обрабатываются в вызывающем потоке.
+
+Сложность (в сложениях точек, без учета общих l удвоений):
+	Штраус: k((2^{w - 2} - 1) + l / (w + 1)), w = ecNAFWidth(l);
+	Пиппенджер: W(k + 2^c).
+Выбирается метод и ширина окна c, при которых оценка сложности минимальна.
+Оценки зависят только от l = B_OF_W(m) и k, что позволяет заранее 
+рассчитать глубину стека. При l = 256 метод Пиппенджера выбирается 
+начиная с k ~ 400.
+*******************************************************************************
+*/
+
+#define EC_PIP_WMAX 16
+
+static size_t ecPipCost(size_t l, size_t k, size_t c)
+{
+	return (l + c) / c * (k + (SIZE_1 << c));
+}
+
+static size_t ecPipWidth(size_t l, size_t k)
+{
+	size_t c, ret = 2;
+	for (c = 3; c <= EC_PIP_WMAX; ++c)
+		if (ecPipCost(l, k, c) < ecPipCost(l, k, ret))
+			ret = c;
+	return ret;
+}
+
+static bool_t ecPipIsBetter(size_t l, size_t k)
+{
+	const size_t w = ecNAFWidth(l);
+	return ecPipCost(l, k, ecPipWidth(l, k)) < 
+		k * ((SIZE_1 << (w - 2)) - 1 + l / (w + 1));
+}
+
+static word ecPipDigit(bool_t* neg, const word d[], size_t m, size_t pos,
+	size_t c)
+{
+	const size_t l = B_OF_W(m);
+	word w, carry;
+	ASSERT(2 <= c && c <= EC_PIP_WMAX);
+	ASSERT(pos <= l);
+	// биты окна и перенос
+	w = pos < l ? wwGetBits(d, pos, MIN2(c, l - pos)) : 0;
+	carry = pos ? (word)wwTestBit(d, pos - 1) : 0;
+	// знаковая цифра
+	*neg = (bool_t)(w >> (c - 1));
+	if (*neg)
+		return (WORD_1 << c) - w - carry;
+	return w + carry;
+}
+
+typedef struct
+{
+	const ec_o* ec;		/*< описание кривой */
+	const word* a;		/*< точки */
+	const word* d;		/*< кратности */
+	size_t k;			/*< число слагаемых */
+	size_t m;			/*< длина кратностей в словах */
+	size_t c;			/*< ширина окна */
+	size_t w_count;		/*< число окон */
+	size_t start;		/*< первое окно */
+	size_t step;		/*< шаг по окнам */
+	word* sums;			/*< суммы окон */
+	void* stack;		/*< вспомогательная память */
+} ec_pip_job;
+
+static void ecPipRun(void* arg)
+{
+	const ec_pip_job* job = (const ec_pip_job*)arg;
+	const ec_o* ec = job->ec;
+	const size_t n = ec->f->n;
+	const size_t bucket_count = SIZE_1 << (job->c - 1);
+	size_t i, j, u;
+	// переменные в stack
+	word* buckets;
+	word* s;
+	void* stack;
+	// раскладка stack
+	buckets = (word*)job->stack;
+	s = buckets + bucket_count * ec->d * n;
+	stack = s + ec->d * n;
+	// цикл по окнам
+	for (j = job->start; j < job->w_count; j += job->step)
+	{
+		word* t = job->sums + j * ec->d * n;
+		// B[u] <- O
+		for (u = 0; u < bucket_count; ++u)
+			ecSetO(buckets + u * ec->d * n, ec);
+		// B[|e[i][j]|] <- B[|e[i][j]|] \pm a[i]
+		for (i = 0; i < job->k; ++i)
+		{
+			bool_t neg;
+			word e = ecPipDigit(&neg, job->d + i * job->m, job->m, 
+				j * job->c, job->c);
+			if (e == 0)
+				continue;
+			u = (size_t)(e - 1);
+			if (neg)
+				ecSubA(buckets + u * ec->d * n, buckets + u * ec->d * n,
+					job->a + i * 2 * n, ec, stack);
+			else
+				ecAddA(buckets + u * ec->d * n, buckets + u * ec->d * n,
+					job->a + i * 2 * n, ec, stack);
+		}
+		// t <- \sum_u (u + 1) B[u]
+		ecSetO(s, ec);
+		ecSetO(t, ec);
+		for (u = bucket_count; u--;)
+		{
+			ecAdd(s, s, buckets + u * ec->d * n, ec, stack);
+			ecAdd(t, t, s, ec, stack);
+		}
+	}
+}
+
+static size_t ecPipRun_deep(size_t n, size_t ec_d, size_t ec_deep, size_t c)
+{
+	return O_OF_W(((SIZE_1 << (c - 1)) + 1) * ec_d * n) + 
+		O_OF_W(W_OF_O(ec_deep));
+}
+
+static bool_t ecAddMulP(word b[], const ec_o* ec, const word a[], 
+	const word d[], size_t k, size_t m, size_t c, size_t threads, 
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t job_deep = ecPipRun_deep(n, ec->d, ec->deep, c);
+	size_t l, w_count, i, j;
+	// переменные в stack
+	word* sums;
+	void* jobs_stack;
+	ec_pip_job* jobs;
+	// битовая длина кратностей
+	for (l = i = 0; i < k; ++i)
+	{
+		size_t t = wwBitSize(d + i * m, m);
+		if (t > l)
+			l = t;
+	}
+	// все кратности нулевые => b <- O
+	if (l == 0)
+	{
+		ecSetO(b, ec);
+		return FALSE;
+	}
+	// число окон и число потоков
+	w_count = (l + c) / c;
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, (B_OF_W(m) + c) / c);
+	threads = MIN2(threads, w_count);
+	// раскладка stack
+	sums = (word*)stack;
+	jobs_stack = sums + w_count * ec->d * n;
+	jobs = (ec_pip_job*)((octet*)jobs_stack + threads * job_deep);
+	// подготовить задания
+	for (i = 0; i < threads; ++i)
+	{
+		jobs[i].ec = ec;
+		jobs[i].a = a, jobs[i].d = d;
+		jobs[i].k = k, jobs[i].m = m, jobs[i].c = c;
+		jobs[i].w_count = w_count;
+		jobs[i].start = i, jobs[i].step = threads;
+		jobs[i].sums = sums;
+		jobs[i].stack = (octet*)jobs_stack + i * job_deep;
+	}
+	// выполнить задания
+	mtRunJobs(ecPipRun, jobs, sizeof(ec_pip_job), threads);
+	// b <- \sum_j 2^{jc} T[j]
+	stack = jobs_stack;
+	wwCopy(b, sums + (w_count - 1) * ec->d * n, ec->d * n);
+	for (j = w_count - 1; j--;)
+	{
+		for (i = 0; i < c; ++i)
+			ecDbl(b, b, ec, stack);
+		ecAdd(b, b, sums + j * ec->d * n, ec, stack);
+	}
+	return !ecIsO(b, ec);
+}
+
+static size_t ecAddMulP_deep(size_t n, size_t ec_d, size_t ec_deep, 
+	size_t m, size_t c, size_t threads)
+{
+	const size_t w_count = (B_OF_W(m) + c) / c;
+	threads = MAX2(threads, 1);
+	threads = MIN2(threads, w_count);
+	return O_OF_W(w_count * ec_d * n) + 
+		threads * ecPipRun_deep(n, ec_d, ec_deep, c) +
+		threads * sizeof(ec_pip_job);
+}
+
+bool_t ecAddMulArr(word b[], const word a[], const word d[], size_t k, 
+	size_t m, const ec_o* ec, size_t threads, void* stack)
+{
+	const size_t l = B_OF_W(m);
+	size_t i;
+	// переменные в stack
+	const word** as;
+	const word** ds;
+	size_t* ms;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(k > 0 && m > 0);
+	ASSERT(wwIsValid(a, 2 * ec->f->n * k));
+	ASSERT(wwIsValid(d, m * k));
+	// метод Пиппенджера?
+	if (ecPipIsBetter(l, k))
+		return ecAddMulP(b, ec, a, d, k, m, ecPipWidth(l, k), threads, 
+			stack);
+	// раскладка stack
+	as = (const word**)stack;
+	ds = as + k;
+	ms = (size_t*)(ds + k);
+	stack = ms + k;
+	// метод Штрауса
 	for (i = 0; i < k; ++i)
 	{
-		size_t m = va_arg(marker, size_t);
-		size_t naf_width = ecNAFWidth(B_OF_W(m));
-		size_t naf_count = SIZE_1 << (naf_width - 2);
-		ret += O_OF_W(2 * m + 1);
-		ret += O_OF_W(ec_d * n * naf_count);
+		as[i] = a + i * 2 * ec->f->n;
+		ds[i] = d + i * m;
+		ms[i] = m;
+	}
+	return ecAddMulS(b, ec, as, ds, ms, k, stack);
+}
+
+size_t ecAddMulArr_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, 
+	size_t m, size_t threads)
+{
+	const size_t l = B_OF_W(m);
+	if (ecPipIsBetter(l, k))
+		return ecAddMulP_deep(n, ec_d, ec_deep, m, ecPipWidth(l, k), 
+			threads);
+	return 2 * sizeof(const word*) * k + sizeof(size_t) * k +
+		ecAddMulS_deep(k, ec_deep) + k * ecAddMulTerm_deep(n, ec_d, m);
+}
+
+bool_t ecAddMulArrA(word b[], const word a[], const word d[], size_t k, 
+	size_t m, const ec_o* ec, size_t threads, void* stack)
+{
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * ec->f->n;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	// t <- \sum d[i] a[i]
+	return ecAddMulArr(t, a, d, k, m, ec, threads, stack) && 
+		ecToA(b, t, ec, stack);
+}
+
+size_t ecAddMulArrA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t k, 
+	size_t m, size_t threads)
+{
+	return O_OF_W(ec_d * n) + 
+		ecAddMulArr_deep(n, ec_d, ec_deep, k, m, threads);
+}
+
+/*
+*******************************************************************************
+Пакетный переход к аффинным координатам
+
+Если кривая не поддерживает пакетный экспорт, то точки переводятся
+по одной. При совпадении буферов a и b очередная точка предварительно 
+копируется в стек: буфер b[i] может частично перекрываться с a[i].
+*******************************************************************************
+*/
+
+bool_t ecToABatch(word b[], const word a[], size_t count, const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	bool_t ret = TRUE;
+	size_t i;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * n;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(a == b || 
+		wwIsDisjoint2(a, count * ec->d * n, b, count * 2 * n));
+	// пакетный экспорт?
+	if (ec->toab != 0)
+		return count == 0 || ec->toab(b, a, count, ec, stack);
+	// экспорт по одной точке
+	for (i = 0; i < count; ++i)
+	{
+		wwCopy(t, a + i * ec->d * n, ec->d * n);
+		ret &= ecToA(b + 2 * i * n, t, ec, stack);
 	}
-	va_end(marker);
-	ret += ec_deep;
 	return ret;
 }
+
+size_t ecToABatch_deep(size_t n, size_t ec_d, size_t ec_deep, size_t count)
+{
+	return O_OF_W(ec_d * n) + O_OF_W((2 * count + 4) * n) + ec_deep;
+}
+
+/*
+*******************************************************************************
+Кратные точки с предвычислениями
+
+Для вычисления d a по заранее построенной таблице используется регулярное 
+знаковое представление кратности с нечетными цифрами [Joye M., Tunstall M. 
+Exponent Recoding and Regular Exponentiation Algorithms. AFRICACRYPT 2009].
+Ширина окна w = 4, число окон t = l / w + 1, где l = B_OF_W(m).
+
+Пусть k -- нечетное число, k < 2^l. Положим k_0 = k,
+	d_i = (k_i \bmod 2^{w + 1}) - 2^w, k_{i + 1} = (k_i - d_i) / 2^w.
+Тогда d_i -- нечетные числа из интервала [-(2^w - 1), 2^w - 1], 
+k_{i + 1} = (k_i >> w) | 1 и поэтому 
+	d_i = ((k >> wi) \bmod 2^{w + 1} | 1) - 2^w, 0 <= i < t - 1.
+Последняя цифра d_{t - 1} = k_{t - 1} = (k >> l) | 1 = 1. Получаем 
+	k = \sum_i d_i 2^{wi}.
+
+Таблица кратных содержит аффинные точки (2j + 1) 2^{wi} a, 0 <= j < 2^{w - 1}.
+Тогда d a является суммой t точек таблицы (с учетом знаков d_i). Очередная 
+точка выбирается маскированием: просматриваются все точки строки таблицы.
+Знак учитывается с помощью функции ec->neg, которая вызывается 
+всегда, и маскированного выбора между точкой и обратной к ней.
+
+Для четного d рассчитывается (d + 1) a, от которой затем (маскированным 
+выбором) отнимается a. Вычитание выполняется всегда.
+
+Сложность вычисления d a: (l / 4)(P <- P + A) + 1(P <- P - A). Для сравнения, 
+в ecMulA() выполняется около l(P <- 2P) + l / (w + 1)(P <- P + P). 
+Построение таблицы требует t обращений в базовом поле (используется 
+пакетный экспорт ecToABatch()).
+*******************************************************************************
+*/
+
+#define EC_TBL_W 4
+#define EC_TBL_ROW (SIZE_1 << (EC_TBL_W - 1))
+
+static size_t ecTblCount(size_t m)
+{
+	return B_OF_W(m) / EC_TBL_W + 1;
+}
+
+bool_t ecTblCreateA(word tbl[], const word a[], const ec_o* ec, size_t m, 
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t count = ecTblCount(m);
+	size_t i, j;
+	// переменные в stack
+	word* p;			/* p = 2^{wi} a */
+	word* t;			/* t = 2p */
+	word* row;			/* row[j] = (2j + 1)p */
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(wwIsDisjoint2(a, 2 * n, tbl, count * EC_TBL_ROW * 2 * n));
+	// раскладка stack
+	p = (word*)stack;
+	t = p + ec->d * n;
+	row = t + ec->d * n;
+	stack = row + EC_TBL_ROW * ec->d * n;
+	// p <- a
+	ecFromA(p, a, ec, stack);
+	// цикл по строкам таблицы
+	for (i = 0; i < count; ++i)
+	{
+		// row[j] <- (2j + 1)p
+		wwCopy(row, p, ec->d * n);
+		ecDbl(t, p, ec, stack);
+		for (j = 1; j < EC_TBL_ROW; ++j)
+			ecAdd(row + j * ec->d * n, row + (j - 1) * ec->d * n, t, ec, 
+				stack);
+		// к аффинным координатам
+		if (!ecToABatch(tbl + i * EC_TBL_ROW * 2 * n, row, EC_TBL_ROW, ec,
+			stack))
+			return FALSE;
+		// p <- 2^w p
+		ecDbl(p, t, ec, stack);
+		for (j = 2; j < EC_TBL_W; ++j)
+			ecDbl(p, p, ec, stack);
+	}
+	return TRUE;
+}
+
+size_t ecTblCreateA_keep(size_t n, size_t m)
+{
+	return O_OF_W(ecTblCount(m) * EC_TBL_ROW * 2 * n);
+}
+
+size_t ecTblCreateA_deep(size_t n, size_t ec_d, size_t ec_deep)
+{
+	return O_OF_W((EC_TBL_ROW + 2) * ec_d * n) + 
+		utilMax(2,
+			ec_deep,
+			ecToABatch_deep(n, ec_d, ec_deep, EC_TBL_ROW));
+}
+
+bool_t ecMulTbl(word b[], const word tbl[], const ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t count = ecTblCount(m);
+	register word even;
+	register word sign;
+	register word mask;
+	register word w;
+	size_t i, j, pos;
+	// переменные в stack
+	word* k;			/* d | 1 */
+	word* t;			/* сумма точек таблицы */
+	word* u;			/* очередная точка таблицы */
+	word* v;			/* обратная к u */
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(wwIsValid(d, m));
+	ASSERT(count >= 2);
+	// раскладка stack
+	k = (word*)stack;
+	t = k + m + 1;
+	u = t + ec->d * n;
+	v = u + ec->d * n;
+	stack = v + ec->d * n;
+	// k <- d | 1
+	wwCopy(k, d, m);
+	k[m] = 0;
+	even = (k[0] & 1) ^ 1;
+	k[0] |= 1;
+	// цикл по цифрам (кроме последней)
+	for (i = 0; i + 1 < count; ++i)
+	{
+		const word* row = tbl + i * EC_TBL_ROW * 2 * n;
+		// w <- (k >> wi) \bmod 2^{w + 1} | 1
+		w = wwGetBits(k, i * EC_TBL_W, EC_TBL_W + 1) | 1;
+		// sign <- [d_i < 0], w <- (|d_i| - 1) / 2
+		sign = (w >> EC_TBL_W) ^ 1;
+		w = ((w ^ (WORD_0 - sign)) & (WORD_BIT_POS(EC_TBL_W) - 1)) >> 1;
+		// u <- row[w] (маскированный выбор)
+		wwSetZero(u, 2 * n);
+		for (j = 0; j < EC_TBL_ROW; ++j)
+		{
+			mask = WORD_0 - wordEq01((word)j, w);
+			for (pos = 0; pos < 2 * n; ++pos)
+				u[pos] |= row[j * 2 * n + pos] & mask;
+		}
+		// u <- sign ? -u : u
+		ecFromA(u, u, ec, stack);
+		ecNeg(v, u, ec, stack);
+		mask = WORD_0 - sign;
+		for (pos = 0; pos < 2 * n; ++pos)
+			u[pos] ^= (u[pos] ^ v[pos]) & mask;
+		// t <- t + u
+		if (i == 0)
+			wwCopy(t, u, ec->d * n);
+		else
+			ecAddA(t, t, u, ec, stack);
+	}
+	// t <- t + 2^{w(count - 1)} a
+	ecAddA(t, t, tbl + (count - 1) * EC_TBL_ROW * 2 * n, ec, stack);
+	// d -- четное? t <- t - a
+	ecSubA(u, t, tbl, ec, stack);
+	mask = WORD_0 - even;
+	for (pos = 0; pos < ec->d * n; ++pos)
+		t[pos] ^= (t[pos] ^ u[pos]) & mask;
+	// выгрузить
+	wwCopy(b, t, ec->d * n);
+	// очистка
+	even = sign = mask = w = 0;
+	wwSetZero(k, m + 1);
+	wwSetZero(t, ec->d * n);
+	return !ecIsO(b, ec);
+}
+
+size_t ecMulTbl_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	return O_OF_W(m + 1) + O_OF_W(3 * ec_d * n) + ec_deep;
+}
+
+bool_t ecMulTblA(word b[], const word tbl[], const ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * n;
+	// t <- d a
+	ecMulTbl(t, tbl, ec, d, m, stack);
+	// к аффинным координатам
+	return ecToA(b, t, ec, stack);
+}
+
+size_t ecMulTblA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	return O_OF_W(ec_d * n) + 
+		utilMax(2,
+			ecMulTbl_deep(n, ec_d, ec_deep, m),
+			ec_deep);
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.06.26
-\version 2014.07.15
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -98,11 +98,22 @@ mdbl-2005-dl [Doche-Lange, 2005]. Сложность алгоритма:
 		8M + 5S + 1*A + 9add \approx 9M,
 причем умножение на A не выполняется, если A \in {0, 1}.
 
+В функции ec2ToABLD() выполняется пакетный переход A <- P. Z-координаты всех 
+точек обращаются одновременно (см. qrInvBatch()), после чего на каждую точку
+тратится 2M + 1S.
+
 Целевые функции ci(l), определенные в описании реализации ecMul() в ec.c,
 принимают следующий вид (считаем, что коэффициент A \in {0, 1}):
 	c1(l) = l/3 8;
 	c2(l, w) = 26 + (2^{w-2} - 2)26 + l/(w + 1) 8;
-	c3(l, w) = 2 + (2^{w-2} - 2)13 + l/(w + 1) 13.
+	c3(l, w) = 2 + (2^{w-2} - 2)13 + l/(w + 1) 13;
+	c4(l, w) = 2 + (2^{w-2} - 2)13 + I + 2^{w-2} 3 + l/(w + 1) 8.
+Стратегия 4 доступна благодаря ec2ToABLD(). Для полей, созданных функцией 
+gf2Create(), измеренное отношение I / M составляет 60--215, и стратегия 4 
+не дает устойчивого выигрыша. Поэтому ec->inv_ratio = 0. Для полей, 
+созданных функцией gf2CreateIT(), I / M = 25--55, стратегия 4 выигрывает 
+2--9% при m >= 233 (см. ec.c), и ec->inv_ratio следует установить 
+равным 40.
 
 Расчеты показывают, что
 	с1(l) <= min_w c2(l), l <= 39,
@@ -113,12 +124,27 @@ mdbl-2005-dl [Doche-Lange, 2005]. Сложность алгоритма:
 \todo Реализовать быстрые формулы для особенных B:
 B = 1 (кривые Коблица),	известен \sqrt{B}.
 
-\todo Реализовать редакции функций с A \in {0, 1}.
+При создании кривой коэффициент A классифицируется: A == 0, A == 1 или
+A \notin {0, 1}. Класс сохраняется в слове по адресу ec->params
+(макрос ec2LDA()) и используется в функциях удвоения и добавления
+аффинной точки вместо сравнений A с 0 и 1.
 
-\todo Исследовать расширенные LD-координаты (дополнительно поддерживается Z^2).
+Расширенные LD-координаты (X : Y : Z : Z^2) исследованы и отклонены.
+Кэширование Z^2 экономит 1S в ec2AddALD() и 1S в ec2AddLD(), но требует
+дополнительного 1S в ec2DblLD() (алгоритм dbl-2005-l не использует Z^2,
+а формула [Hankerson et al., 2004], использующая Z^2, не дешевле).
+В ecMulA() на одно сложение приходится w + 1 удвоений, поэтому
+расширенные координаты проигрывают: потери в удвоениях в w + 1 раз
+превышают экономию в сложениях. По данным ec2Bench() на стандартных
+кривых ДСТУ (x86-64) 1S составляет 6 -- 8% стоимости ec2DblLD() и около
+4% стоимости ec2AddALD(), т.е. ecMulA() замедлится примерно на 5%.
 *******************************************************************************
 */
 
+// класс A: 0 -- A == 0, 1 -- A == 1, 2 -- A \notin {0, 1}
+#define ec2LDA(ec)\
+	(*(const word*)(ec)->params)
+
 // [3n]b <- [2n]a (P <- A)
 static bool_t ec2FromALD(word b[], const word a[], const ec_o* ec,
 	void* stack)
@@ -168,6 +194,47 @@ static size_t ec2ToALD_deep(size_t n, size_t f_deep)
 	return O_OF_W(n) + f_deep;
 }
 
+// [count * 2n]b <- [count * 3n]a (A <- P, пакетный режим)
+static bool_t ec2ToABLD(word b[], const word a[], size_t count, const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	bool_t ret = TRUE;
+	size_t i;
+	// переменные в stack
+	word* z = (word*)stack;
+	word* t = z + count * n;
+	stack = t + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(count > 0);
+	ASSERT(a == b || wwIsDisjoint2(a, 3 * count * n, b, 2 * count * n));
+	// z[i] <- za[i] (za[i] == 0 => z[i] <- 1)
+	for (i = 0; i < count; ++i)
+	{
+		ASSERT(ec2SeemsOn3(a + 3 * i * n, ec));
+		if (qrIsZero(ecZ(a + 3 * i * n, n), ec->f))
+			qrSetUnity(z + i * n, ec->f), ret = FALSE;
+		else
+			qrCopy(z + i * n, ecZ(a + 3 * i * n, n), ec->f);
+	}
+	// z[i] <- z[i]^{-1}
+	qrInvBatch(z, z, count, ec->f, stack);
+	// b[i] <- a[i] (буфер b[i] не перекрывается с a[j], j > i)
+	for (i = 0; i < count; ++i)
+	{
+		// xb <- xa z
+		qrMul(ecX(b + 2 * i * n), ecX(a + 3 * i * n), z + i * n, ec->f, 
+			stack);
+		// t <- z^2
+		qrSqr(t, z + i * n, ec->f, stack);
+		// yb <- ya t
+		qrMul(ecY(b + 2 * i * n, n), ecY(a + 3 * i * n, n), t, ec->f, 
+			stack);
+	}
+	return ret;
+}
+
 // [3n]b <- -[3n]a (P <- -P)
 static void ec2NegLD(word b[], const word a[], const ec_o* ec, void* stack)
 {
@@ -228,9 +295,9 @@ static void ec2DblLD(word b[], const word a[], const ec_o* ec, void* stack)
 	qrSqr(ecY(b, n), t2, ec->f, stack);
 	qrMul(ecY(b, n), ecY(b, n), ecZ(b, n), ec->f, stack);
 	// xb <- xb + A * zb [C^2 + D + a2 * Z3]
-	if (qrIsUnity(ec->A, ec->f))
+	if (ec2LDA(ec) == 1)
 		gf2Add2(ecX(b), ecZ(b, n), ec->f);
-	else if (!qrIsZero(ec->A, ec->f))
+	else if (ec2LDA(ec) == 2)
 	{
 		qrMul(t2, ec->A, ecZ(b, n), ec->f, stack);
 		gf2Add2(ecX(b), t2, ec->f);
@@ -272,9 +339,9 @@ static void ec2DblALD(word b[], const word a[], const ec_o* ec, void* stack)
 	qrSqr(ecY(b, n), ecY(a, n), ec->f, stack);
 	gf2Add2(ecY(b, n), ec->B, ec->f);
 	// yb <- yb + A zb [Y1^2 + a2*Z3 + a6]
-	if (qrIsUnity(ec->A, ec->f))
+	if (ec2LDA(ec) == 1)
 		gf2Add2(ecY(b, n), ecZ(b, n), ec->f);
-	else if (!qrIsZero(ec->A, ec->f))
+	else if (ec2LDA(ec) == 2)
 	{
 		qrMul(t1, ec->A, ecZ(b, n), ec->f, stack);
 		gf2Add2(ecY(b, n), t1, ec->f);
@@ -338,7 +405,7 @@ static void ec2AddLD(word c[], const word a[], const word b[],
 	{
 		// t3 == t4 => a == b => c <- 2a
 		if (qrCmp(t3, t4, ec->f) == 0)
-			ec2DblLD(c, a, ec, stack);
+			ecDbl(c, a, ec, stack);
 		// t3 != t4 => a == -b => c <- O
 		else
 			qrSetZero(ecZ(c, n), ec->f);
@@ -442,9 +509,9 @@ static void ec2AddALD(word c[], const word a[], const word b[],
 	// xc <- t2^2 + t1 + A t3 [B^2 + A + a2 * C]
 	qrSqr(ecX(c), t2, ec->f, stack);
 	gf2Add2(ecX(c), t1, ec->f);
-	if (qrIsUnity(ec->A, ec->f))
+	if (ec2LDA(ec) == 1)
 		gf2Add2(ecX(c), t3, ec->f);
-	else if (!qrIsZero(ec->A, ec->f))
+	else if (ec2LDA(ec) == 2)
 	{
 		qrMul(t2, ec->A, t3, ec->f, stack);
 		gf2Add2(ecX(c), t2, ec->f);
@@ -524,7 +591,7 @@ static void ec2SubALD(word c[], const word a[], const word b[],
 	wwCopy(t, b, 2 * n);
 	gf2Add2(ecY(t, n), ecX(t), ec->f);
 	// c <- a + t
-	ec2AddALD(c, a, t, ec, stack);
+	ecAddA(c, a, t, ec, stack);
 }
 
 static size_t ec2SubALD_deep(size_t n, size_t f_deep)
@@ -553,9 +620,14 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	// подготовить буферы для описания группы точек
 	ec->base = ec->B + f->n;
 	ec->order = ec->base + 2 * f->n;
+	// классифицировать A
+	ec->params = ec->order + f->n + 1;
+	*(word*)ec->params = qrIsZero(ec->A, ec->f) ? 0 :
+		qrIsUnity(ec->A, ec->f) ? 1 : 2;
 	// настроить интерфейсы
 	ec->froma = ec2FromALD;
 	ec->toa = ec2ToALD;
+	ec->toab = ec2ToABLD;
 	ec->neg = ec2NegLD;
 	ec->add = ec2AddLD;
 	ec->adda = ec2AddALD;
@@ -563,6 +635,7 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	ec->suba = ec2SubALD;
 	ec->dbl = ec2DblLD;
 	ec->dbla = ec2DblALD;
+	ec->inv_ratio = 0;
 	ec->deep = utilMax(8,
 		ec2ToALD_deep(f->n, f->deep),
 		ec2NegLD_deep(f->n, f->deep),
@@ -573,7 +646,7 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 		ec2DblLD_deep(f->n, f->deep),
 		ec2DblALD_deep(f->n, f->deep));
 	// настроить заголовок
-	ec->hdr.keep = sizeof(ec_o) + O_OF_W(5 * f->n + 1);
+	ec->hdr.keep = sizeof(ec_o) + O_OF_W(5 * f->n + 2);
 	ec->hdr.p_count = 6;
 	ec->hdr.o_count = 1;
 	// все нормально
@@ -582,7 +655,7 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 
 size_t ec2CreateLD_keep(size_t n)
 {
-	return sizeof(ec_o) + O_OF_W(5 * n + 1);
+	return sizeof(ec_o) + O_OF_W(5 * n + 2);
 }
 
 size_t ec2CreateLD_deep(size_t n, size_t f_deep)
@@ -859,3 +932,146 @@ size_t ec2SubAA_deep(size_t n, size_t f_deep)
 {
 	return O_OF_W(2 * n) + ec2AddAA_deep(n, f_deep);
 }
+
+/*
+*******************************************************************************
+Лесенка Монтгомери
+
+Реализован алгоритм [López J., Dahab R. Fast multiplication on elliptic 
+curves over GF(2^m) without precomputation. CHES 1999] в редакции 
+[Hankerson et al., 2004, алгоритм 3.40]. Используются x-координаты точек
+в проективном представлении (X : Z), x = X / Z, O = (1 : 0).
+
+На каждом шаге лесенки поддерживается пара (R1, R2) такая, что 
+R2 - R1 = a. Сложение R2 <- R1 + R2 (madd):
+	Z2 <- (X1 Z2 + X2 Z1)^2, X2 <- x Z2 + (X1 Z2)(X2 Z1),
+	4M + 1S.
+Удвоение R1 <- 2R1 (mdouble):
+	X1 <- X1^4 + B Z1^4, Z1 <- X1^2 Z1^2,
+	2M + 4S.
+Формулы корректно обрабатывают R1 = O, поэтому лесенка стартует с пары 
+(O, a) и выполняет фиксированное число шагов, равное битовой длине 
+ec->order. Ветвления по разрядам d заменены условными перестановками 
+wwCondSwap(). Таблицы кратных точек не используются.
+
+После завершения лесенки y-координата dA восстанавливается по формуле 
+(алгоритм Mxy):
+	y = (x + X1/Z1)[(X1 + x Z1)(X2 + x Z2) + (x^2 + y_a)(Z1 Z2)] 
+		(x Z1 Z2)^{-1} + y_a.
+Сложность восстановления: 1D + 10M + 1S.
+
+Общая сложность: l(6M + 5S) + 1D, l -- битовая длина ec->order.
+*******************************************************************************
+*/
+
+bool_t ec2MulLadderA(word b[], const word a[], const ec_o* ec, 
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	size_t l;
+	bool_t swap = FALSE;
+	// переменные в stack
+	word* x1 = (word*)stack;
+	word* z1 = x1 + n;
+	word* x2 = z1 + n;
+	word* z2 = x2 + n;
+	word* t1 = z2 + n;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* e = t3 + n;
+	stack = e + n + 1;
+	// pre
+	ASSERT(ecIsOperableGroup(ec));
+	ASSERT(ec2SeemsOnA(a, ec));
+	ASSERT(wwIsValid(d, m));
+	ASSERT(wwCmp2(d, m, ec->order, n + 1) < 0);
+	// e <- d (дополнение нулями до n + 1 слов)
+	m = MIN2(m, n + 1);
+	wwCopy(e, d, m);
+	wwSetZero(e + m, n + 1 - m);
+	// xa == 0 => a -- точка порядка 2 (нерегулярно)
+	if (qrIsZero(ecX(a), ec->f))
+	{
+		bool_t odd = wwTestBit(e, 0);
+		wwSetZero(e, n + 1);
+		if (!odd)
+			return FALSE;
+		wwCopy(b, a, 2 * n);
+		return TRUE;
+	}
+	// (x1 : z1) <- O, (x2 : z2) <- a
+	qrSetUnity(x1, ec->f);
+	qrSetZero(z1, ec->f);
+	qrCopy(x2, ecX(a), ec->f);
+	qrSetUnity(z2, ec->f);
+	// лесенка
+	l = wwBitSize(ec->order, n + 1);
+	while (l--)
+	{
+		bool_t bit = wwTestBit(e, l);
+		// (R1, R2) <- (R2, R1), если bit != swap
+		wwCondSwap(x1, x2, 2 * n, bit ^ swap);
+		swap = bit;
+		// (x2 : z2) <- (x1 : z1) + (x2 : z2)
+		qrMul(t1, x1, z2, ec->f, stack);
+		qrMul(t2, x2, z1, ec->f, stack);
+		gf2Add(z2, t1, t2, ec->f);
+		qrSqr(z2, z2, ec->f, stack);
+		qrMul(t1, t1, t2, ec->f, stack);
+		qrMul(x2, ecX(a), z2, ec->f, stack);
+		gf2Add2(x2, t1, ec->f);
+		// (x1 : z1) <- 2(x1 : z1)
+		qrSqr(t1, z1, ec->f, stack);
+		qrSqr(x1, x1, ec->f, stack);
+		qrMul(z1, x1, t1, ec->f, stack);
+		qrSqr(x1, x1, ec->f, stack);
+		qrSqr(t1, t1, ec->f, stack);
+		qrMul(t1, ec->B, t1, ec->f, stack);
+		gf2Add2(x1, t1, ec->f);
+	}
+	wwCondSwap(x1, x2, 2 * n, swap);
+	swap = FALSE;
+	wwSetZero(e, n + 1);
+	// da == O?
+	if (qrIsZero(z1, ec->f))
+		return FALSE;
+	// (d + 1)a == O => da == -a
+	if (qrIsZero(z2, ec->f))
+	{
+		ec2NegA(b, a, ec);
+		return TRUE;
+	}
+	// t1 <- z1 z2, t2 <- (xa t1)^{-1}
+	qrMul(t1, z1, z2, ec->f, stack);
+	qrMul(t2, ecX(a), t1, ec->f, stack);
+	qrInv(t2, t2, ec->f, stack);
+	// t3 <- xa z2, x2 <- x2 + t3
+	qrMul(t3, ecX(a), z2, ec->f, stack);
+	gf2Add2(x2, t3, ec->f);
+	// t3 <- x1 t3 t2 [x-координата da]
+	qrMul(t3, t3, x1, ec->f, stack);
+	qrMul(t3, t3, t2, ec->f, stack);
+	// z1 <- (x1 + xa z1)(x2 + xa z2)
+	qrMul(z1, z1, ecX(a), ec->f, stack);
+	gf2Add2(z1, x1, ec->f);
+	qrMul(z1, z1, x2, ec->f, stack);
+	// z1 <- z1 + (xa^2 + ya) t1
+	qrSqr(x2, ecX(a), ec->f, stack);
+	gf2Add2(x2, ecY(a, n), ec->f);
+	qrMul(x2, x2, t1, ec->f, stack);
+	gf2Add2(z1, x2, ec->f);
+	// z1 <- z1 t2 (xa + t3) + ya [y-координата da]
+	qrMul(z1, z1, t2, ec->f, stack);
+	gf2Add(x2, ecX(a), t3, ec->f);
+	qrMul(z1, z1, x2, ec->f, stack);
+	gf2Add2(z1, ecY(a, n), ec->f);
+	// b <- (t3, z1)
+	qrCopy(ecX(b), t3, ec->f);
+	qrCopy(ecY(b, n), z1, ec->f);
+	return TRUE;
+}
+
+size_t ec2MulLadderA_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(8 * n + 1) + f_deep;
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.06.26
-\version 2016.07.05
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -14,11 +14,13 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/mem.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/ecp.h"
 #include "bee2/math/gfp.h"
 #include "bee2/math/pri.h"
 #include "bee2/math/ww.h"
 #include "bee2/math/zz.h"
+#include "zm_lcl.h"
 
 /*
 *******************************************************************************
@@ -107,17 +109,27 @@ tpl-2007-bl [Bernstein-Lange, 2007]. Сложность алгоритма
 Сложность алгоритма
 	7M + 7S + 13add + 2*4 + 1*8 + 1*12 + 1*16 + 1*3 \approx 14M.
 
+В функции ecpToABJ() выполняется пакетный переход A <- P. Z-координаты всех 
+точек обращаются одновременно (см. qrInvBatch()), после чего на каждую точку
+тратится 3M + 1S. Общая сложность для count точек:
+	1D + count(6M + 1S) \approx 100M + 7count M.
+
 Целевые функции ci(l), определенные в описании реализации ecMul() в ec.c, 
 принимают следующий вид:
 	c1(l) = l/3 11;
 	c2(l, w) = 103 + (2^{w-2} - 2)102 + l/(w + 1) 11;
-	c3(l, w) = 6 + (2^{w-2} - 2)16 + l/(w + 1) 16.
+	c3(l, w) = 6 + (2^{w-2} - 2)16 + l/(w + 1) 16;
+	c4(l, w) = 6 + (2^{w-2} - 2)16 + I + 2^{w-2} 7 + l/(w + 1) 11.
+Стратегия 4 доступна благодаря ecpToABJ(). Для полей кривых bign 
+измеренное отношение I / M составляет 230--305, и стратегия 4 не дает 
+устойчивого выигрыша (см. ec.c). Поэтому ec->inv_ratio = 0.
 
 Расчеты показывают, что
 	с1(l) <= min_w c3(l), l <= 81,
 	min_w c3(l, w) <= m	in_w c2(l, w), l <= 899.
 Поэтому для практически используемых размерностей l (192 <= l <= 571)
-первые две стратегии являются проигрышными. Реализована только стратегия 3.
+первые две стратегии являются проигрышными. Реализованы стратегии 3 и 4, 
+выбор между ними выполняется в ecMulA() с учетом ec->inv_ratio.
 
 \todo Сравнить madd-2004-hmv с madd-2007-bl, сложность которого
 	7M + 4S + 9add + 1*4 + 3*2.
@@ -181,6 +193,48 @@ static size_t ecpToAJ_deep(size_t n, size_t f_deep)
 	return O_OF_W(2 * n) + f_deep;
 }
 
+// [count * 2n]b <- [count * 3n]a (A <- P, пакетный режим)
+static bool_t ecpToABJ(word b[], const word a[], size_t count, const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	bool_t ret = TRUE;
+	size_t i;
+	// переменные в stack
+	word* z = (word*)stack;
+	word* t = z + count * n;
+	stack = t + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(count > 0);
+	ASSERT(a == b || wwIsDisjoint2(a, 3 * count * n, b, 2 * count * n));
+	// z[i] <- za[i] (za[i] == 0 => z[i] <- 1)
+	for (i = 0; i < count; ++i)
+	{
+		ASSERT(ecpSeemsOn3(a + 3 * i * n, ec));
+		if (qrIsZero(ecZ(a + 3 * i * n, n), ec->f))
+			qrSetUnity(z + i * n, ec->f), ret = FALSE;
+		else
+			qrCopy(z + i * n, ecZ(a + 3 * i * n, n), ec->f);
+	}
+	// z[i] <- z[i]^{-1}
+	qrInvBatch(z, z, count, ec->f, stack);
+	// b[i] <- a[i] (буфер b[i] не перекрывается с a[j], j > i)
+	for (i = 0; i < count; ++i)
+	{
+		// t <- z^2
+		qrSqr(t, z + i * n, ec->f, stack);
+		// xb <- xa t
+		qrMul(ecX(b + 2 * i * n), ecX(a + 3 * i * n), t, ec->f, stack);
+		// t <- t z
+		qrMul(t, t, z + i * n, ec->f, stack);
+		// yb <- ya t
+		qrMul(ecY(b + 2 * i * n, n), ecY(a + 3 * i * n, n), t, ec->f, 
+			stack);
+	}
+	return ret;
+}
+
 // [3n]b <- -[3n]a (P <- -P)
 static void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack)
 {
@@ -802,6 +856,528 @@ size_t ecpTplJA3_deep(size_t n, size_t f_deep)
 	return O_OF_W(7 * n) + f_deep;
 }
 
+/*
+*******************************************************************************
+Специализированные формулы
+
+Если элементы поля занимают n = 4, 6 или 8 машинных слов (поля кривых bign 
+всех уровней стойкости при B_PER_W == 64, поле уровня 128 при 
+B_PER_W == 32), то функция ecpCreateJ() устанавливает в ec специализированные 
+варианты ecpDblJ(), ecpDblJA3(), ecpAddJ(), ecpAddAJ(), ecpSubJ() 
+и ecpSubAJ().
+
+Специализированные варианты выполняют те же алгоритмы, что и общие. Отличия:
+-	n является константой, циклы аддитивных операций разворачиваются 
+	компилятором;
+-	сложение, вычитание, удвоение, деление на 2, аддитивное обращение 
+	\mod p, проверки на ноль и копирование встраиваются в код формул 
+	вместо обращений к функциям zzAddMod(), zzSubMod(), zzDoubleMod(), 
+	zzHalfMod(), zzNegMod(), wwIsZero(), wwCopy();
+-	встроенные аддитивные операции регулярны (маскирование вместо ветвлений),
+	как и функции SAFE(zz...Mod)();
+-	вспомогательные переменные размещаются в локальных массивах, а не 
+	нарезаются из stack.
+
+Если поле использует специализированные функции умножения для модулей 
+длины 256 (см. zm_lcl.h: редукция Крэндалла, Монтгомери или Барретта), 
+то устанавливаются варианты формул, в которые эти функции встраиваются 
+напрямую (признак red). В остальных случаях умножение и возведение 
+в квадрат вызываются через интерфейсы ec->f->mul и ec->f->sqr. Стек 
+передается этим интерфейсам без изменений, встроенные функции стек 
+не используют. Поэтому ec->deep не меняется.
+
+Специализированные формулы можно отключить вызовом ecpUseFixed(FALSE) 
+(для тестирования и сравнения скорости).
+
+Утроение ec->tpl не специализируется: оно не используется алгоритмами 
+модуля ec.
+*******************************************************************************
+*/
+
+#if defined(__GNUC__)
+	#define _ECP_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+	#define _ECP_INLINE static __forceinline
+#else
+	#define _ECP_INLINE static
+#endif
+
+#define ECP_FIXED_MAX_N 8
+
+#define ECP_RED_QR		0
+#define ECP_RED_CRAND	1
+#define ECP_RED_MONT	2
+#define ECP_RED_BARR	3
+
+// c <- a + b \mod mod
+_ECP_INLINE void ecpAddFixed(word c[], const word a[], const word b[],
+	const word mod[], const size_t n)
+{
+	word t[ECP_FIXED_MAX_N];
+	register dword s;
+	register word carry;
+	register word borrow;
+	register word mask;
+	size_t i;
+	// c <- a + b
+	for (carry = 0, i = 0; i < n; ++i)
+	{
+		s = (dword)a[i] + b[i] + carry;
+		c[i] = (word)s, carry = (word)(s >> B_PER_W);
+	}
+	// t <- c - mod
+	for (borrow = 0, i = 0; i < n; ++i)
+	{
+		s = (dword)c[i] - mod[i] - borrow;
+		t[i] = (word)s, borrow = (word)(s >> B_PER_W) & 1;
+	}
+	// c <- carry || c >= mod ? t : c
+	mask = WORD_0 - (carry | (borrow ^ 1));
+	for (i = 0; i < n; ++i)
+		c[i] ^= (c[i] ^ t[i]) & mask;
+	s = 0, carry = borrow = mask = 0;
+}
+
+// c <- a - b \mod mod
+_ECP_INLINE void ecpSubFixed(word c[], const word a[], const word b[],
+	const word mod[], const size_t n)
+{
+	register dword s;
+	register word borrow;
+	register word carry;
+	register word mask;
+	size_t i;
+	// c <- a - b
+	for (borrow = 0, i = 0; i < n; ++i)
+	{
+		s = (dword)a[i] - b[i] - borrow;
+		c[i] = (word)s, borrow = (word)(s >> B_PER_W) & 1;
+	}
+	// c <- borrow ? c + mod : c
+	mask = WORD_0 - borrow;
+	for (carry = 0, i = 0; i < n; ++i)
+	{
+		s = (dword)c[i] + (mod[i] & mask) + carry;
+		c[i] = (word)s, carry = (word)(s >> B_PER_W);
+	}
+	s = 0, borrow = carry = mask = 0;
+}
+
+// b <- a / 2 \mod mod
+_ECP_INLINE void ecpHalfFixed(word b[], const word a[], const word mod[],
+	const size_t n)
+{
+	register dword s;
+	register word carry;
+	register word mask;
+	size_t i;
+	// b <- a + (a нечетное ? mod : 0)
+	mask = WORD_0 - (a[0] & 1);
+	for (carry = 0, i = 0; i < n; ++i)
+	{
+		s = (dword)a[i] + (mod[i] & mask) + carry;
+		b[i] = (word)s, carry = (word)(s >> B_PER_W);
+	}
+	// b <- (carry || b) >> 1
+	for (i = 0; i + 1 < n; ++i)
+		b[i] = b[i] >> 1 | b[i + 1] << (B_PER_W - 1);
+	b[n - 1] = b[n - 1] >> 1 | carry << (B_PER_W - 1);
+	s = 0, carry = mask = 0;
+}
+
+// b <- -a \mod mod
+_ECP_INLINE void ecpNegFixed(word b[], const word a[], const word mod[],
+	const size_t n)
+{
+	register dword s;
+	register word borrow;
+	register word mask;
+	size_t i;
+	// mask <- a != 0
+	for (mask = 0, i = 0; i < n; ++i)
+		mask |= a[i];
+	mask = WORD_0 - wordNeq01(mask, 0);
+	// b <- (mod - a) & mask
+	for (borrow = 0, i = 0; i < n; ++i)
+	{
+		s = (dword)mod[i] - a[i] - borrow;
+		b[i] = (word)s & mask, borrow = (word)(s >> B_PER_W) & 1;
+	}
+	s = 0, borrow = mask = 0;
+}
+
+_ECP_INLINE bool_t ecpIsZeroFixed(const word a[], const size_t n)
+{
+	register word w = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+		w |= a[i];
+	return wordEq(w, 0);
+}
+
+_ECP_INLINE void ecpCopyFixed(word b[], const word a[], const size_t n)
+{
+	size_t i;
+	for (i = 0; i < n; ++i)
+		b[i] = a[i];
+}
+
+// c <- a * b \mod mod (red -- способ редукции)
+_ECP_INLINE void ecpMulFixed(word c[], const word a[], const word b[],
+	const qr_o* f, void* stack, const int red, const size_t n)
+{
+	switch (red)
+	{
+	case ECP_RED_CRAND:
+		zmMulCrandFixed(c, a, b, f->mod, n);
+		break;
+	case ECP_RED_MONT:
+		zmMulMontFixed(c, a, b, f->mod, *(const word*)f->params, n);
+		break;
+	case ECP_RED_BARR:
+		zmMulBarrFixed(c, a, b, f->mod, (const word*)f->params, n);
+		break;
+	default:
+		qrMul(c, a, b, f, stack);
+	}
+}
+
+// b <- a^2 \mod mod (red -- способ редукции)
+_ECP_INLINE void ecpSqrFixed(word b[], const word a[], const qr_o* f,
+	void* stack, const int red, const size_t n)
+{
+	if (red == ECP_RED_QR)
+		qrSqr(b, a, f, stack);
+	else
+		ecpMulFixed(b, a, a, f, stack, red, n);
+}
+
+#define _ADD(c, a, b) ecpAddFixed(c, a, b, ec->f->mod, n)
+#define _SUB(c, a, b) ecpSubFixed(c, a, b, ec->f->mod, n)
+#define _DBL(b, a) ecpAddFixed(b, a, a, ec->f->mod, n)
+#define _HALF(b, a) ecpHalfFixed(b, a, ec->f->mod, n)
+#define _MUL(c, a, b) ecpMulFixed(c, a, b, ec->f, stack, red, n)
+#define _SQR(b, a) ecpSqrFixed(b, a, ec->f, stack, red, n)
+
+// [3n]b <- 2[3n]a (P <- 2P, см. ecpDblJ(), ecpDblJA3())
+_ECP_INLINE void ecpDblJFixed(word b[], const word a[], const ec_o* ec,
+	void* stack, const bool_t bA3, const int red, const size_t n)
+{
+	word t1[ECP_FIXED_MAX_N];
+	word t2[ECP_FIXED_MAX_N];
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3 && ec->f->n == n);
+	ASSERT(ecpSeemsOn3(a, ec));
+	ASSERT(wwIsSameOrDisjoint(a, b, 3 * n));
+	// za == 0 или ya == 0? => b <- O
+	if (ecpIsZeroFixed(ecZ(a, n), n) || ecpIsZeroFixed(ecY(a, n), n))
+	{
+		wwSetZero(ecZ(b, n), n);
+		return;
+	}
+	// t1 <- za^2
+	_SQR(t1, ecZ(a, n));
+	// zb <- 2 ya za
+	_MUL(ecZ(b, n), ecY(a, n), ecZ(a, n));
+	_DBL(ecZ(b, n), ecZ(b, n));
+	// t1 <- 3(xa - t1)(xa + t1) [A = -3]
+	if (bA3)
+	{
+		_SUB(t2, ecX(a), t1);
+		_ADD(t1, ecX(a), t1);
+		_MUL(t2, t1, t2);
+		_DBL(t1, t2);
+		_ADD(t1, t1, t2);
+	}
+	// t1 <- A t1^2 + 3 xa^2
+	else
+	{
+		_SQR(t1, t1);
+		_MUL(t1, ec->A, t1);
+		_SQR(t2, ecX(a));
+		_ADD(t1, t1, t2);
+		_DBL(t2, t2);
+		_ADD(t1, t1, t2);
+	}
+	// yb <- (2 ya)^2, t2 <- yb^2 / 2
+	_DBL(ecY(b, n), ecY(a, n));
+	_SQR(ecY(b, n), ecY(b, n));
+	_SQR(t2, ecY(b, n));
+	_HALF(t2, t2);
+	// yb <- yb xa
+	_MUL(ecY(b, n), ecY(b, n), ecX(a));
+	// xb <- t1^2 - 2 yb
+	_SQR(ecX(b), t1);
+	_SUB(ecX(b), ecX(b), ecY(b, n));
+	_SUB(ecX(b), ecX(b), ecY(b, n));
+	// yb <- (yb - xb) t1 - t2
+	_SUB(ecY(b, n), ecY(b, n), ecX(b));
+	_MUL(ecY(b, n), ecY(b, n), t1);
+	_SUB(ecY(b, n), ecY(b, n), t2);
+}
+
+// [3n]c <- [3n]a + [3n]b (P <- P + P, см. ecpAddJ())
+_ECP_INLINE void ecpAddJFixed(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack, const int red, const size_t n)
+{
+	word t1[ECP_FIXED_MAX_N];
+	word t2[ECP_FIXED_MAX_N];
+	word t3[ECP_FIXED_MAX_N];
+	word t4[ECP_FIXED_MAX_N];
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3 && ec->f->n == n);
+	ASSERT(ecpSeemsOn3(a, ec));
+	ASSERT(ecpSeemsOn3(b, ec));
+	ASSERT(wwIsSameOrDisjoint(a, c, 3 * n));
+	ASSERT(wwIsSameOrDisjoint(b, c, 3 * n));
+	// a == O => c <- b
+	if (ecpIsZeroFixed(ecZ(a, n), n))
+	{
+		ecpCopyFixed(c, b, 3 * n);
+		return;
+	}
+	// b == O => c <- a
+	if (ecpIsZeroFixed(ecZ(b, n), n))
+	{
+		ecpCopyFixed(c, a, 3 * n);
+		return;
+	}
+	// t1 <- Z1Z1, t2 <- Z2Z2
+	_SQR(t1, ecZ(a, n));
+	_SQR(t2, ecZ(b, n));
+	// t3 <- Y1 Z2 Z2Z2 [S1]
+	_MUL(t3, ecZ(b, n), t2);
+	_MUL(t3, ecY(a, n), t3);
+	// t4 <- Y2 Z1 Z1Z1 [S2]
+	_MUL(t4, ecZ(a, n), t1);
+	_MUL(t4, ecY(b, n), t4);
+	// zc <- (Z1 + Z2)^2 - Z1Z1 - Z2Z2
+	_ADD(ecZ(c, n), ecZ(a, n), ecZ(b, n));
+	_SQR(ecZ(c, n), ecZ(c, n));
+	_SUB(ecZ(c, n), ecZ(c, n), t1);
+	_SUB(ecZ(c, n), ecZ(c, n), t2);
+	// t1 <- U2 - U1 [H], t2 <- U1
+	_MUL(t1, ecX(b), t1);
+	_MUL(t2, ecX(a), t2);
+	_SUB(t1, t1, t2);
+	// H == 0 => a == \pm b
+	if (ecpIsZeroFixed(t1, n))
+	{
+		if (qrCmp(t3, t4, ec->f) == 0)
+			ecpDblJ(c, c == a ? b : a, ec, stack);
+		else
+			wwSetZero(ecZ(c, n), n);
+		return;
+	}
+	// zc <- zc H [Z3]
+	_MUL(ecZ(c, n), ecZ(c, n), t1);
+	// t4 <- 2(S2 - S1) [r]
+	_SUB(t4, t4, t3);
+	_DBL(t4, t4);
+	// yc <- (2H)^2 [I], t1 <- H I [J], yc <- U1 I [V], t2 <- 2V
+	_DBL(ecY(c, n), t1);
+	_SQR(ecY(c, n), ecY(c, n));
+	_MUL(t1, t1, ecY(c, n));
+	_MUL(ecY(c, n), t2, ecY(c, n));
+	_DBL(t2, ecY(c, n));
+	// xc <- r^2 - J - 2V [X3]
+	_SQR(ecX(c), t4);
+	_SUB(ecX(c), ecX(c), t1);
+	_SUB(ecX(c), ecX(c), t2);
+	// yc <- r(V - X3) - 2 S1 J
+	_SUB(ecY(c, n), ecY(c, n), ecX(c));
+	_MUL(ecY(c, n), t4, ecY(c, n));
+	_DBL(t3, t3);
+	_MUL(t3, t3, t1);
+	_SUB(ecY(c, n), ecY(c, n), t3);
+}
+
+// [3n]c <- [3n]a + [2n]b (P <- P + A, см. ecpAddAJ())
+_ECP_INLINE void ecpAddAJFixed(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack, const int red, const size_t n)
+{
+	word t1[ECP_FIXED_MAX_N];
+	word t2[ECP_FIXED_MAX_N];
+	word t3[ECP_FIXED_MAX_N];
+	word t4[ECP_FIXED_MAX_N];
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3 && ec->f->n == n);
+	ASSERT(ecpSeemsOn3(a, ec));
+	ASSERT(ecpSeemsOnA(b, ec));
+	ASSERT(wwIsSameOrDisjoint(a,  c, 3 * n));
+	ASSERT(b == c || wwIsDisjoint2(b, 2 * n, c, 3 * n));
+	// a == O => c <- (xb : yb : 1)
+	if (ecpIsZeroFixed(ecZ(a, n), n))
+	{
+		ecpCopyFixed(ecX(c), ecX(b), n);
+		ecpCopyFixed(ecY(c, n), ecY(b, n), n);
+		ecpCopyFixed(ecZ(c, n), ec->f->unity, n);
+		return;
+	}
+	// t1 <- za^2 xb - xa, t2 <- za^3 yb - ya
+	_SQR(t1, ecZ(a, n));
+	_MUL(t2, t1, ecZ(a, n));
+	_MUL(t1, t1, ecX(b));
+	_MUL(t2, t2, ecY(b, n));
+	_SUB(t1, t1, ecX(a));
+	_SUB(t2, t2, ecY(a, n));
+	// t1 == 0 => a == \pm b
+	if (ecpIsZeroFixed(t1, n))
+	{
+		if (ecpIsZeroFixed(t2, n))
+			ecpDblAJ(c, b, ec, stack);
+		else
+			wwSetZero(ecZ(c, n), n);
+		return;
+	}
+	// zc <- t1 za
+	_MUL(ecZ(c, n), t1, ecZ(a, n));
+	// t3 <- t1^2, t4 <- t1^3, t3 <- t3 xa, t1 <- 2 t3
+	_SQR(t3, t1);
+	_MUL(t4, t1, t3);
+	_MUL(t3, t3, ecX(a));
+	_DBL(t1, t3);
+	// xc <- t2^2 - t1 - t4
+	_SQR(ecX(c), t2);
+	_SUB(ecX(c), ecX(c), t1);
+	_SUB(ecX(c), ecX(c), t4);
+	// yc <- (t3 - xc) t2 - t4 ya
+	_SUB(t3, t3, ecX(c));
+	_MUL(t3, t3, t2);
+	_MUL(t4, t4, ecY(a, n));
+	_SUB(ecY(c, n), t3, t4);
+}
+
+// [3n]c <- [3n]a - [3n]b (P <- P - P, см. ecpSubJ())
+_ECP_INLINE void ecpSubJFixed(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack, const int red, const size_t n)
+{
+	word t[3 * ECP_FIXED_MAX_N];
+	// t <- -b
+	ecpCopyFixed(ecX(t), ecX(b), n);
+	ecpNegFixed(ecY(t, n), ecY(b, n), ec->f->mod, n);
+	ecpCopyFixed(ecZ(t, n), ecZ(b, n), n);
+	// c <- a + t
+	ecpAddJFixed(c, a, t, ec, stack, red, n);
+}
+
+// [3n]c <- [3n]a - [2n]b (P <- P - A, см. ecpSubAJ())
+_ECP_INLINE void ecpSubAJFixed(word c[], const word a[], const word b[],
+	const ec_o* ec, void* stack, const int red, const size_t n)
+{
+	word t[2 * ECP_FIXED_MAX_N];
+	// t <- -b
+	ecpCopyFixed(ecX(t), ecX(b), n);
+	ecpNegFixed(ecY(t, n), ecY(b, n), ec->f->mod, n);
+	// c <- a + t
+	ecpAddAJFixed(c, a, t, ec, stack, red, n);
+}
+
+#undef _ADD
+#undef _SUB
+#undef _DBL
+#undef _HALF
+#undef _MUL
+#undef _SQR
+
+#define ECP_FIXED(n, suffix, red)\
+static void ecpDblJ##n##suffix(word b[], const word a[], const ec_o* ec,\
+	void* stack)\
+{\
+	ecpDblJFixed(b, a, ec, stack, FALSE, red, n);\
+}\
+static void ecpDblJA3##n##suffix(word b[], const word a[], const ec_o* ec,\
+	void* stack)\
+{\
+	ecpDblJFixed(b, a, ec, stack, TRUE, red, n);\
+}\
+static void ecpAddJ##n##suffix(word c[], const word a[], const word b[],\
+	const ec_o* ec, void* stack)\
+{\
+	ecpAddJFixed(c, a, b, ec, stack, red, n);\
+}\
+static void ecpAddAJ##n##suffix(word c[], const word a[], const word b[],\
+	const ec_o* ec, void* stack)\
+{\
+	ecpAddAJFixed(c, a, b, ec, stack, red, n);\
+}\
+static void ecpSubJ##n##suffix(word c[], const word a[], const word b[],\
+	const ec_o* ec, void* stack)\
+{\
+	ecpSubJFixed(c, a, b, ec, stack, red, n);\
+}\
+static void ecpSubAJ##n##suffix(word c[], const word a[], const word b[],\
+	const ec_o* ec, void* stack)\
+{\
+	ecpSubAJFixed(c, a, b, ec, stack, red, n);\
+}
+
+ECP_FIXED(4, Qr, ECP_RED_QR)
+ECP_FIXED(6, Qr, ECP_RED_QR)
+ECP_FIXED(8, Qr, ECP_RED_QR)
+
+#if (B_PER_W == 64)
+	#define ECP_FIXED_256 4
+#elif (B_PER_W == 32)
+	#define ECP_FIXED_256 8
+#endif
+
+#ifdef ECP_FIXED_256
+	#define ECP_FIXED_RED(n)\
+		ECP_FIXED(n, Crand, ECP_RED_CRAND)\
+		ECP_FIXED(n, Mont, ECP_RED_MONT)\
+		ECP_FIXED(n, Barr, ECP_RED_BARR)
+	#define ECP_FIXED_RED2(n) ECP_FIXED_RED(n)
+	ECP_FIXED_RED2(ECP_FIXED_256)
+#endif
+
+#define ECP_FIXED_SET(ec, n, suffix, bA3)\
+	(ec)->add = ecpAddJ##n##suffix,\
+	(ec)->adda = ecpAddAJ##n##suffix,\
+	(ec)->sub = ecpSubJ##n##suffix,\
+	(ec)->suba = ecpSubAJ##n##suffix,\
+	(ec)->dbl = (bA3) ? ecpDblJA3##n##suffix : ecpDblJ##n##suffix
+
+#define ECP_FIXED_SET2(ec, n, suffix, bA3) ECP_FIXED_SET(ec, n, suffix, bA3)
+
+static bool_t _use_fixed = TRUE;
+
+void ecpUseFixed(bool_t use)
+{
+	_use_fixed = use;
+}
+
+static void ecpSetFixed(ec_o* ec, bool_t bA3)
+{
+	switch (ec->f->n)
+	{
+	case 4:
+		ECP_FIXED_SET(ec, 4, Qr, bA3);
+		break;
+	case 6:
+		ECP_FIXED_SET(ec, 6, Qr, bA3);
+		break;
+	case 8:
+		ECP_FIXED_SET(ec, 8, Qr, bA3);
+		break;
+	}
+#ifdef ECP_FIXED_256
+	if (zmIsCrand256(ec->f))
+		ECP_FIXED_SET2(ec, ECP_FIXED_256, Crand, bA3);
+	else if (zmIsMont256(ec->f))
+		ECP_FIXED_SET2(ec, ECP_FIXED_256, Mont, bA3);
+	else if (zmIsBarr256(ec->f))
+		ECP_FIXED_SET2(ec, ECP_FIXED_256, Barr, bA3);
+#endif
+}
+
+#undef ECP_FIXED
+#undef ECP_FIXED_RED
+#undef ECP_FIXED_RED2
+#undef ECP_FIXED_SET
+#undef ECP_FIXED_SET2
+#undef ECP_FIXED_256
+
 bool_t ecpCreateJ(ec_o* ec, const qr_o* f, const octet A[], const octet B[], 
 	void* stack)
 {
@@ -836,6 +1412,7 @@ bool_t ecpCreateJ(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	// настроить интерфейсы
 	ec->froma = ecpFromAJ;
 	ec->toa = ecpToAJ;
+	ec->toab = ecpToABJ;
 	ec->neg = ecpNegJ;
 	ec->add = ecpAddJ;
 	ec->adda = ecpAddAJ;
@@ -844,7 +1421,10 @@ bool_t ecpCreateJ(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	ec->dbl = bA3 ? ecpDblJA3 : ecpDblJ;
 	ec->dbla = ecpDblAJ;
 	ec->tpl = bA3 ? ecpTplJA3 : ecpTplJ;
-	ec->deep = utilMax(9,
+	if (_use_fixed)
+		ecpSetFixed(ec, bA3);
+	ec->inv_ratio = 0;
+	ec->deep = utilMax(8,
 		ecpToAJ_deep(f->n, f->deep),
 		ecpAddJ_deep(f->n, f->deep),
 		ecpAddAJ_deep(f->n, f->deep),
@@ -1266,4 +1846,177 @@ size_t ecpSWU_deep(size_t n, size_t f_deep)
 		utilMax(2,
 			f_deep,
 			qrPower_deep(n, n, f_deep));
-}
\ No newline at end of file
+}
+
+/*
+*******************************************************************************
+Лесенка Монтгомери
+
+Реализованы формулы [Brier E., Joye M. Weierstrass elliptic curves and 
+side-channel attacks. PKC 2002] в аддитивной редакции [Izu T., Takagi T.
+A fast parallel elliptic curve multiplication resistant against side channel
+attacks. PKC 2002]. Используются x-координаты точек в проективном 
+представлении (X : Z), x = X / Z, O = (1 : 0).
+
+На каждом шаге лесенки поддерживается пара (R1, R2) такая, что 
+R2 - R1 = a. Сложение R2 <- R1 + R2 с известной разностью x = x(a):
+	Z2 <- (X1 Z2 - X2 Z1)^2,
+	X2 <- 2(X1 Z2 + X2 Z1)(X1 X2 + A Z1 Z2) + 4B (Z1 Z2)^2 - x Z2,
+	6M + 2S + 1*A + 1*B.
+Удвоение R1 <- 2R1:
+	X1 <- (X1^2 - A Z1^2)^2 - 8B X1 Z1^3,
+	Z1 <- 4 Z1 (X1 (X1^2 + A Z1^2) + B Z1^3),
+	4M + 3S + 1*A + 1*B.
+Аддитивная редакция сложения (в отличие от мультипликативной) корректна 
+при x = 0. Формулы корректно обрабатывают R1 = O, поэтому лесенка стартует 
+с пары (O, a) и выполняет фиксированное число шагов, равное битовой длине
+ec->order. Ветвления по разрядам d заменены условными перестановками 
+wwCondSwap(). Таблицы кратных точек не используются.
+
+После завершения лесенки y-координата dA восстанавливается по формуле
+[Okeya K., Sakurai K. Efficient elliptic curve cryptosystems from a scalar 
+multiplication algorithm with recovery of the y-coordinate on 
+a Montgomery-form elliptic curve. CHES 2001]:
+	y = (2B + (A + x x1)(x + x1) - x2 (x - x1)^2) / (2 y_a),
+где x1 = X1 / Z1, x2 = X2 / Z2. Сложность восстановления: 1D + 15M + 2S.
+
+Общая сложность: l(10M + 5S + 2*A + 2*B) + 1D \approx l 19M + 1D, 
+l -- битовая длина ec->order.
+*******************************************************************************
+*/
+
+bool_t ecpMulLadderA(word b[], const word a[], const ec_o* ec, 
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	size_t l;
+	bool_t swap = FALSE;
+	// переменные в stack
+	word* x1 = (word*)stack;
+	word* z1 = x1 + n;
+	word* x2 = z1 + n;
+	word* z2 = x2 + n;
+	word* t1 = z2 + n;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	word* e = t4 + n;
+	stack = e + n + 1;
+	// pre
+	ASSERT(ecIsOperableGroup(ec));
+	ASSERT(ecpSeemsOnA(a, ec));
+	ASSERT(wwIsValid(d, m));
+	ASSERT(wwCmp2(d, m, ec->order, n + 1) < 0);
+	// e <- d (дополнение нулями до n + 1 слов)
+	m = MIN2(m, n + 1);
+	wwCopy(e, d, m);
+	wwSetZero(e + m, n + 1 - m);
+	// (x1 : z1) <- O, (x2 : z2) <- a
+	qrSetUnity(x1, ec->f);
+	qrSetZero(z1, ec->f);
+	qrCopy(x2, ecX(a), ec->f);
+	qrSetUnity(z2, ec->f);
+	// лесенка
+	l = wwBitSize(ec->order, n + 1);
+	while (l--)
+	{
+		bool_t bit = wwTestBit(e, l);
+		// (R1, R2) <- (R2, R1), если bit != swap
+		wwCondSwap(x1, x2, 2 * n, bit ^ swap);
+		swap = bit;
+		// t1 <- x1 z2, t2 <- x2 z1, t3 <- x1 x2, t4 <- z1 z2
+		qrMul(t1, x1, z2, ec->f, stack);
+		qrMul(t2, x2, z1, ec->f, stack);
+		qrMul(t3, x1, x2, ec->f, stack);
+		qrMul(t4, z1, z2, ec->f, stack);
+		// z2 <- (t1 - t2)^2, t1 <- t1 + t2
+		zmSub(z2, t1, t2, ec->f);
+		qrSqr(z2, z2, ec->f, stack);
+		zmAdd(t1, t1, t2, ec->f);
+		// x2 <- 2 t1 (t3 + A t4)
+		qrMul(x2, ec->A, t4, ec->f, stack);
+		zmAdd(x2, x2, t3, ec->f);
+		qrMul(x2, x2, t1, ec->f, stack);
+		gfpDouble(x2, x2, ec->f);
+		// x2 <- x2 + 4 B t4^2
+		qrSqr(t4, t4, ec->f, stack);
+		qrMul(t4, ec->B, t4, ec->f, stack);
+		gfpDouble(t4, t4, ec->f);
+		gfpDouble(t4, t4, ec->f);
+		zmAdd(x2, x2, t4, ec->f);
+		// x2 <- x2 - xa z2
+		qrMul(t1, ecX(a), z2, ec->f, stack);
+		zmSub(x2, x2, t1, ec->f);
+		// t1 <- x1^2, t2 <- A z1^2, t3 <- B z1^3
+		qrSqr(t1, x1, ec->f, stack);
+		qrSqr(t3, z1, ec->f, stack);
+		qrMul(t2, ec->A, t3, ec->f, stack);
+		qrMul(t3, t3, z1, ec->f, stack);
+		qrMul(t3, ec->B, t3, ec->f, stack);
+		// t4 <- (t1 - t2)^2, t1 <- x1 (t1 + t2) + t3
+		zmSub(t4, t1, t2, ec->f);
+		qrSqr(t4, t4, ec->f, stack);
+		zmAdd(t1, t1, t2, ec->f);
+		qrMul(t1, t1, x1, ec->f, stack);
+		zmAdd(t1, t1, t3, ec->f);
+		// x1 <- t4 - 8 x1 t3
+		qrMul(t3, t3, x1, ec->f, stack);
+		gfpDouble(t3, t3, ec->f);
+		gfpDouble(t3, t3, ec->f);
+		gfpDouble(t3, t3, ec->f);
+		zmSub(x1, t4, t3, ec->f);
+		// z1 <- 4 z1 t1
+		qrMul(z1, z1, t1, ec->f, stack);
+		gfpDouble(z1, z1, ec->f);
+		gfpDouble(z1, z1, ec->f);
+	}
+	wwCondSwap(x1, x2, 2 * n, swap);
+	swap = FALSE;
+	wwSetZero(e, n + 1);
+	// da == O?
+	if (qrIsZero(z1, ec->f))
+		return FALSE;
+	// (d + 1)a == O => da == -a
+	if (qrIsZero(z2, ec->f))
+	{
+		ecpNegA(b, a, ec);
+		return TRUE;
+	}
+	// t1 <- z1^2 z2
+	qrSqr(t1, z1, ec->f, stack);
+	qrMul(t1, t1, z2, ec->f, stack);
+	// t2 <- 2 B t1
+	qrMul(t2, ec->B, t1, ec->f, stack);
+	gfpDouble(t2, t2, ec->f);
+	// t4 <- xa z1 + x1, t3 <- xa z1 - x1
+	qrMul(t3, ecX(a), z1, ec->f, stack);
+	zmAdd(t4, t3, x1, ec->f);
+	zmSub(t3, t3, x1, ec->f);
+	// t2 <- t2 - x2 t3^2
+	qrSqr(t3, t3, ec->f, stack);
+	qrMul(t3, t3, x2, ec->f, stack);
+	zmSub(t2, t2, t3, ec->f);
+	// t2 <- t2 + (A z1 + xa x1) t4 z2 [числитель y-координаты]
+	qrMul(t3, ecX(a), x1, ec->f, stack);
+	qrMul(x2, ec->A, z1, ec->f, stack);
+	zmAdd(t3, t3, x2, ec->f);
+	qrMul(t3, t3, t4, ec->f, stack);
+	qrMul(t3, t3, z2, ec->f, stack);
+	zmAdd(t2, t2, t3, ec->f);
+	// t4 <- 2 ya z1 z2, t1 <- (t4 z1)^{-1}
+	qrMul(t4, z1, z2, ec->f, stack);
+	qrMul(t4, t4, ecY(a, n), ec->f, stack);
+	gfpDouble(t4, t4, ec->f);
+	qrMul(t1, t4, z1, ec->f, stack);
+	qrInv(t1, t1, ec->f, stack);
+	// b <- (x1 t4 t1, t2 t1)
+	qrMul(ecX(b), x1, t4, ec->f, stack);
+	qrMul(ecX(b), ecX(b), t1, ec->f, stack);
+	qrMul(ecY(b, n), t2, t1, ec->f, stack);
+	return TRUE;
+}
+
+size_t ecpMulLadderA_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(9 * n + 1) + f_deep;
+}
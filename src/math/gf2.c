@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.17
-\version 2015.11.03
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -15,6 +15,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/mem.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/gf2.h"
 #include "bee2/math/pp.h"
 #include "bee2/math/ww.h"
@@ -36,6 +37,7 @@ typedef struct
 	size_t k;		/*< степень среднего монома */
 	size_t l;		/*< здесь должен быть 0 */
 	size_t l1;		/*< здесь должен быть 0 */
+	size_t qt;		/*< смещение таблицы решений (0 -- нет таблицы) */
 	size_t bm;		/*< m % B_PER_W */
 	size_t wm;		/*< m / B_PER_W */
 	size_t bk;		/*< (m - k) % B_PER_W */
@@ -122,7 +124,8 @@ static void gf2RedTrinomial1(word a[], size_t n, const gf2_trinom_st* p)
 Набор (bm, bk, bl, bl1) не может быть нулевым -- соответствующий многочлен
 не является неприводимым.
 
-\todo 15 функций gf2RedPentanomial[bm|bk|bl|bl1].
+Для стандартных многочленов ДСТУ 4145-2002 реализованы специальные 
+функции редукции (см. ниже).
 *******************************************************************************
 */
 
@@ -132,6 +135,7 @@ typedef struct
 	size_t k;		/*< степень старшего из средних мономов */
 	size_t l;		/*< степень среднего из средних мономов */
 	size_t l1;		/*< степень младшего из средних мономов */
+	size_t qt;		/*< смещение таблицы решений (0 -- нет таблицы) */
 	size_t bm;		/*< m % B_PER_W */
 	size_t wm;		/*< m / B_PER_W */
 	size_t bk;		/*< (m - k) % B_PER_W */
@@ -379,14 +383,433 @@ static size_t gf2Div_deep(size_t n)
 	return O_OF_W(n + 1) + ppDivMod_deep(n + 1);
 }
 
+/*
+*******************************************************************************
+Редукция по модулю стандартных многочленов
+
+Для многочленов p(x) из ДСТУ 4145-2002 реализованы функции 
+редукции с зафиксированными параметрами p(x). Функции строятся 
+с помощью макросов _RED_PENTANOMIAL и _RED_TRINOMIAL: числа m, k, l, l1 
+являются константами, поэтому смещения слов и сдвиги вычисляются 
+на этапе компиляции, проверки bm, bk, bl, bl1 на равенство нулю 
+исключаются, а циклы по словам с известным числом итераций раскрываются 
+компилятором.
+
+Макрос _RED_STEP обрабатывает моном x^{m - d} редукционного многочлена 
+при сбросе слова a[i]. Макрос _RED_LAST обрабатывает тот же моном при сбросе
+старших разрядов слова a[wm], на которое попадает моном x^m.
+
+Для каждого многочлена генерируются функции умножения и возведения 
+в квадрат (макрос _GF2_MUL_SQR), которые устанавливаются в gf2Create()
+при распознавании многочлена.
+*******************************************************************************
+*/
+
+#define _RED_STEP(a, i, hi, d)\
+	(a)[(i) - (d) / B_PER_W] ^= (hi) >> (d) % B_PER_W;\
+	if ((d) % B_PER_W)\
+		(a)[(i) - (d) / B_PER_W - 1] ^=\
+			(hi) << (B_PER_W - (d) % B_PER_W) % B_PER_W;\
+
+#define _RED_LAST(a, hi, wm, d)\
+	(a)[(wm) - (d) / B_PER_W] ^= (hi) >> (d) % B_PER_W;\
+	if ((d) / B_PER_W < (wm) && (d) % B_PER_W)\
+		(a)[(wm) - (d) / B_PER_W - 1] ^=\
+			(hi) << (B_PER_W - (d) % B_PER_W) % B_PER_W;\
+
+#define _RED_PENTANOMIAL(a, m, k, l, l1)\
+{\
+	register word hi;\
+	size_t i;\
+	for (i = 2 * W_OF_B(m) - 1; i > (m) / B_PER_W; --i)\
+	{\
+		hi = (a)[i];\
+		_RED_STEP(a, i, hi, m);\
+		_RED_STEP(a, i, hi, (m) - (l1));\
+		_RED_STEP(a, i, hi, (m) - (l));\
+		_RED_STEP(a, i, hi, (m) - (k));\
+	}\
+	hi = (a)[(m) / B_PER_W] >> (m) % B_PER_W;\
+	(a)[0] ^= hi;\
+	hi <<= (m) % B_PER_W;\
+	_RED_LAST(a, hi, (m) / B_PER_W, (m) - (l1));\
+	_RED_LAST(a, hi, (m) / B_PER_W, (m) - (l));\
+	_RED_LAST(a, hi, (m) / B_PER_W, (m) - (k));\
+	(a)[(m) / B_PER_W] ^= hi;\
+	hi = 0;\
+}\
+
+#define _RED_TRINOMIAL(a, m, k)\
+{\
+	register word hi;\
+	size_t i;\
+	for (i = 2 * W_OF_B(m) - 1; i > (m) / B_PER_W; --i)\
+	{\
+		hi = (a)[i];\
+		_RED_STEP(a, i, hi, m);\
+		_RED_STEP(a, i, hi, (m) - (k));\
+	}\
+	hi = (a)[(m) / B_PER_W] >> (m) % B_PER_W;\
+	(a)[0] ^= hi;\
+	hi <<= (m) % B_PER_W;\
+	_RED_LAST(a, hi, (m) / B_PER_W, (m) - (k));\
+	(a)[(m) / B_PER_W] ^= hi;\
+	hi = 0;\
+}\
+
+static void gf2Red163(word a[])
+	_RED_PENTANOMIAL(a, 163, 7, 6, 3)
+
+static void gf2Red167(word a[])
+	_RED_TRINOMIAL(a, 167, 6)
+
+static void gf2Red173(word a[])
+	_RED_PENTANOMIAL(a, 173, 10, 2, 1)
+
+static void gf2Red179(word a[])
+	_RED_PENTANOMIAL(a, 179, 4, 2, 1)
+
+static void gf2Red191(word a[])
+	_RED_TRINOMIAL(a, 191, 9)
+
+static void gf2Red233(word a[])
+	_RED_PENTANOMIAL(a, 233, 9, 4, 1)
+
+static void gf2Red257(word a[])
+	_RED_TRINOMIAL(a, 257, 12)
+
+static void gf2Red307(word a[])
+	_RED_PENTANOMIAL(a, 307, 8, 4, 2)
+
+static void gf2Red367(word a[])
+	_RED_TRINOMIAL(a, 367, 21)
+
+static void gf2Red431(word a[])
+	_RED_PENTANOMIAL(a, 431, 5, 3, 1)
+
+#define _GF2_MUL_SQR(m)\
+static void gf2Mul##m(word c[], const word a[], const word b[],\
+	const qr_o* f, void* stack)\
+{\
+	word* prod = (word*)stack;\
+	stack = prod + 2 * W_OF_B(m);\
+	ASSERT(gf2IsOperable(f) && f->n == W_OF_B(m));\
+	ASSERT(gf2IsIn(a, f));\
+	ASSERT(gf2IsIn(b, f));\
+	ppMul(prod, a, W_OF_B(m), b, W_OF_B(m), stack);\
+	gf2Red##m(prod);\
+	wwCopy(c, prod, W_OF_B(m));\
+}\
+\
+static void gf2Sqr##m(word b[], const word a[], const qr_o* f, void* stack)\
+{\
+	word* prod = (word*)stack;\
+	stack = prod + 2 * W_OF_B(m);\
+	ASSERT(gf2IsOperable(f) && f->n == W_OF_B(m));\
+	ASSERT(gf2IsIn(a, f));\
+	ppSqr(prod, a, W_OF_B(m), stack);\
+	gf2Red##m(prod);\
+	wwCopy(b, prod, W_OF_B(m));\
+}\
+
+_GF2_MUL_SQR(163)
+_GF2_MUL_SQR(167)
+_GF2_MUL_SQR(173)
+_GF2_MUL_SQR(179)
+_GF2_MUL_SQR(191)
+_GF2_MUL_SQR(233)
+_GF2_MUL_SQR(257)
+_GF2_MUL_SQR(307)
+_GF2_MUL_SQR(367)
+_GF2_MUL_SQR(431)
+
+static size_t gf2MulStd_deep(size_t n)
+{
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			ppMul_deep(n, n),
+			ppSqr_deep(n));
+}
+
+typedef struct
+{
+	size_t p[4];		/*< описание многочлена */
+	qr_mul_i mul;		/*< функция умножения */
+	qr_sqr_i sqr;		/*< функция возведения в квадрат */
+} gf2_std_st;
+
+static const gf2_std_st _gf2_std[] =
+{
+	{{163, 7, 6, 3}, gf2Mul163, gf2Sqr163},
+	{{167, 6, 0, 0}, gf2Mul167, gf2Sqr167},
+	{{173, 10, 2, 1}, gf2Mul173, gf2Sqr173},
+	{{179, 4, 2, 1}, gf2Mul179, gf2Sqr179},
+	{{191, 9, 0, 0}, gf2Mul191, gf2Sqr191},
+	{{233, 9, 4, 1}, gf2Mul233, gf2Sqr233},
+	{{257, 12, 0, 0}, gf2Mul257, gf2Sqr257},
+	{{307, 8, 4, 2}, gf2Mul307, gf2Sqr307},
+	{{367, 21, 0, 0}, gf2Mul367, gf2Sqr367},
+	{{431, 5, 3, 1}, gf2Mul431, gf2Sqr431},
+};
+
+static const gf2_std_st* gf2FindStd(const size_t p[4])
+{
+	size_t i;
+	for (i = 0; i < COUNT_OF(_gf2_std); ++i)
+		if (memEq(_gf2_std[i].p, p, sizeof(_gf2_std[i].p)))
+			return _gf2_std + i;
+	return 0;
+}
+
+/*
+*******************************************************************************
+Обращение Итоха -- Цудзии
+
+Обратный элемент a^{-1} = a^{2^m - 2} = (a^{2^{m - 1} - 1})^2 вычисляется 
+по цепочке сложений для e = m - 1. Пусть b_k = a^{2^k - 1}. Тогда
+	b_{2k} = b_k^{2^k} b_k,	b_{k + 1} = b_k^2 a,
+и b_e определяется по двоичной записи e (от старших разрядов к младшим)
+за (m - 2) возведений в квадрат и (l - 1) + (wt(e) - 1) умножений, 
+l -- битовая длина e. Вычисления регулярны: последовательность 
+операций определяется только m.
+
+Самые трудоемкие шаги цепочки -- многократные возведения в квадрат 
+x -> x^{2^k} при больших k. Это отображение линейно над GF(2), и его 
+можно задать таблицей: для каждой тетрады x (разряды 4w,..., 4w + 3) 
+хранятся образы всех 16 ее значений. Тогда x^{2^k} -- это сумма 
+ceil(m / 4) элементов таблицы. Таблицы строятся для шагов с 
+k >= GF2_IT_MIN (в порядке следования шагов) и размещаются 
+в описании поля сразу за params. Таблица одного шага занимает 
+GF2_IT_TBL_SIZE(m) слов.
+
+Таблицы строятся в функции gf2CreateIT(). Обращения к таблицам 
+зависят от обращаемого элемента, поэтому при использовании таблиц 
+обращение перестает быть регулярным (см. \safe в gf2.h).
+
+Трудоемкость обращения (в тактах, x86-64, PCLMULQDQ):
+	m	|	ppInvMod	|	ИЦ		|	ИЦ + таблицы
+	163	|	54000		|	31000	|	9000
+	257	|	87000		|	50000	|	14000
+	431	|	166000		|	85000	|	25000
+*******************************************************************************
+*/
+
+#define GF2_IT_MIN 8
+#define GF2_IT_TBL_SIZE(m) (((m) + 3) / 4 * 16 * W_OF_B(m))
+
+static size_t gf2ITCount(size_t m)
+{
+	const size_t e = m - 1;
+	size_t pos, k, count;
+	ASSERT(m >= 2);
+	for (pos = 0; (e >> pos) > 1; ++pos);
+	for (k = 1, count = 0; pos--; )
+	{
+		if (k >= GF2_IT_MIN)
+			++count;
+		k *= 2;
+		if ((e >> pos) & 1)
+			++k;
+	}
+	return count;
+}
+
+static const word* gf2ITTbl(const qr_o* f)
+{
+	const size_t* p = (const size_t*)f->params;
+	return (const word*)((const octet*)f->params + 
+		(p[2] ? sizeof(gf2_pentanom_st) : sizeof(gf2_trinom_st)));
+}
+
+static void gf2ITTblCreate(word tbl[], size_t k, const qr_o* f, void* stack)
+{
+	const size_t m = gf2Deg(f);
+	const size_t n = f->n;
+	size_t w, i, j;
+	// переменные в stack
+	word* s = (word*)stack;
+	word* c = s + n;
+	word* img = c + n;
+	stack = img + 4 * n;
+	// pre
+	ASSERT(gf2IsOperable(f));
+	ASSERT(m >= 2);
+	ASSERT(wwIsValid(tbl, GF2_IT_TBL_SIZE(m)));
+	// s <- t^{2^k}
+	qrSetZero(s, f);
+	wwSetBit(s, 1, 1);
+	for (i = 0; i < k; ++i)
+		qrSqr(s, s, f, stack);
+	// c <- t^{0 * 2^k}
+	qrCopy(c, f->unity, f);
+	// тетрады
+	for (w = 0; 4 * w < m; ++w, tbl += 16 * n)
+	{
+		// img_j <- (t^{4w + j})^{2^k}
+		for (j = 0; j < 4; ++j)
+			if (4 * w + j < m)
+			{
+				wwCopy(img + j * n, c, n);
+				qrMul(c, c, s, f, stack);
+			}
+			else
+				wwSetZero(img + j * n, n);
+		// tbl[i] <- \sum_{j: i_j = 1} img_j
+		wwSetZero(tbl, n);
+		for (i = 1; i < 16; ++i)
+		{
+			for (j = 0; (i >> j & 1) == 0; ++j);
+			wwXor(tbl + i * n, tbl + (i ^ SIZE_1 << j) * n, img + j * n, n);
+		}
+	}
+}
+
+static size_t gf2ITTblCreate_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(6 * n) + f_deep;
+}
+
+static void gf2SqrKTbl(word b[], const word a[], const word tbl[], 
+	const qr_o* f)
+{
+	const size_t m = gf2Deg(f);
+	size_t w;
+	ASSERT(wwIsDisjoint(a, b, f->n));
+	qrSetZero(b, f);
+	for (w = 0; 4 * w < m; ++w, tbl += 16 * f->n)
+		gf2Add2(b, 
+			tbl + f->n * (size_t)(a[w / (B_PER_W / 4)] >> 
+				w % (B_PER_W / 4) * 4 & 15), 
+			f);
+}
+
+static void gf2InvITCore(word b[], const word a[], const qr_o* f, 
+	const word* tbl, void* stack)
+{
+	const size_t e = gf2Deg(f) - 1;
+	size_t pos, k, i;
+	// переменные в stack
+	word* u = (word*)stack;
+	word* v = u + f->n;
+	stack = v + f->n;
+	// pre
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	ASSERT(e >= 1);
+	// u <- b_1
+	qrCopy(u, a, f);
+	// цепочка сложений
+	for (pos = 0; (e >> pos) > 1; ++pos);
+	for (k = 1; pos--; )
+	{
+		// v <- u^{2^k}
+		if (tbl && k >= GF2_IT_MIN)
+		{
+			gf2SqrKTbl(v, u, tbl, f);
+			tbl += GF2_IT_TBL_SIZE(e + 1);
+		}
+		else
+			for (qrSqr(v, u, f, stack), i = 1; i < k; ++i)
+				qrSqr(v, v, f, stack);
+		// u <- b_{2k}
+		qrMul(u, v, u, f, stack);
+		k *= 2;
+		// u <- b_{2k + 1}?
+		if ((e >> pos) & 1)
+		{
+			qrSqr(u, u, f, stack);
+			qrMul(u, u, a, f, stack);
+			++k;
+		}
+	}
+	ASSERT(k == e);
+	// b <- b_e^2
+	qrSqr(b, u, f, stack);
+}
+
+static void gf2InvIT(word b[], const word a[], const qr_o* f, void* stack)
+{
+	gf2InvITCore(b, a, f, 0, stack);
+}
+
+static void gf2InvITTbl(word b[], const word a[], const qr_o* f, 
+	void* stack)
+{
+	gf2InvITCore(b, a, f, gf2ITTbl(f), stack);
+}
+
+static size_t gf2InvIT_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) + f_deep;
+}
+
+static void gf2DivIT(word b[], const word divident[], const word a[], 
+	const qr_o* f, void* stack)
+{
+	word* c = (word*)stack;
+	stack = c + f->n;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(divident, f));
+	qrInv(c, a, f, stack);
+	qrMul(b, divident, c, f, stack);
+}
+
+static size_t gf2DivIT_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(n) + gf2InvIT_deep(n, f_deep);
+}
+
 /*
 *******************************************************************************
 Управление описанием поля
 *******************************************************************************
 */
 
+/*
+*******************************************************************************
+Маска следа
+
+След tr(a) -- линейная функция от a. Поэтому tr(a) = \sum_i a_i tr(t^i), 
+где a_i -- i-й разряд a в полиномиальном базисе, и след можно определить 
+как четность веса a & T, где T -- маска следа (i-й разряд T равняется 
+tr(t^i)).
+
+Маска рассчитывается по тождествам Ньютона. Пусть 
+	f(t) = t^m + e_1 t^{m - 1} + ... + e_m
+-- модуль поля, p_i = tr(t^i) -- сумма i-х степеней корней f. Тогда
+	p_0 = m \mod 2, 
+	p_i = e_1 p_{i - 1} + e_2 p_{i - 2} + ... + e_{i - 1} p_1 + i e_i.
+Для трехчленов и пятичленов ненулевыми являются не более 4 коэффициентов e_j,
+и расчет маски требует O(m) операций.
+*******************************************************************************
+*/
+
+static void gf2CalcTrMask(word tr[], const size_t p[4])
+{
+	const size_t m = p[0];
+	size_t i, j;
+	// pre
+	ASSERT(memIsValid(p, 4 * sizeof(size_t)));
+	ASSERT(wwIsValid(tr, W_OF_B(m)));
+	// p_0 <- m \mod 2
+	wwSetZero(tr, W_OF_B(m));
+	wwSetBit(tr, 0, m & 1);
+	// p_i <- \sum_{j} e_j p_{i - j} + i e_i, e_j = 1 <=> m - j \in p
+	for (i = 1; i < m; ++i)
+	{
+		bool_t bit = FALSE;
+		for (j = 1; j < 4 && p[j]; ++j)
+			if (m - p[j] < i)
+				bit ^= wwTestBit(tr, i - (m - p[j]));
+			else if (m - p[j] == i)
+				bit ^= (bool_t)(i & 1);
+		wwSetBit(tr, i, bit);
+	}
+}
+
 bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 {
+	const gf2_std_st* std;
 	ASSERT(memIsValid(f, sizeof(qr_o)));
 	ASSERT(memIsValid(p, 4 * sizeof(size_t)));
 	// нормальный базис?
@@ -419,12 +842,13 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		// сформировать unity
 		f->unity = f->mod + n1;
 		wwSetW(f->unity, f->n, 1);
-		// сформировать params
-		f->params = (size_t*)(f->unity + f->n);
+		// сформировать params (перед params -- маска следа)
+		f->params = (size_t*)(f->unity + 2 * f->n);
 		t = (gf2_trinom_st*)f->params;
 		t->m = p[0];
 		t->k = p[1];
 		t->l = t->l1 = 0;
+		t->qt = 0;
 		t->bm = p[0] % B_PER_W;
 		t->wm = p[0] / B_PER_W;
 		t->bk = (p[0] - p[1]) % B_PER_W;
@@ -440,7 +864,8 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->inv = gf2Inv;
 		f->div = gf2Div;
 		// заголовок
-		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + f->n) + sizeof(gf2_trinom_st);
+		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + 2 * f->n) + 
+			sizeof(gf2_trinom_st);
 		f->hdr.p_count = 3;
 		f->hdr.o_count = 0;
 		// глубина стека
@@ -484,13 +909,14 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		// сформировать unity
 		f->unity = f->mod + n1;
 		wwSetW(f->unity, f->n, 1);
-		// сформировать params
-		f->params = (size_t*)(f->unity + f->n);
+		// сформировать params (перед params -- маска следа)
+		f->params = (size_t*)(f->unity + 2 * f->n);
 		t = (gf2_pentanom_st*)f->params;
 		t->m = p[0];
 		t->k = p[1];
 		t->l = p[2];
 		t->l1 = p[3];
+		t->qt = 0;
 		t->bm = p[0] % B_PER_W;
 		t->wm = p[0] / B_PER_W;
 		t->bk = (p[0] - p[1]) % B_PER_W;
@@ -510,7 +936,7 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->inv = gf2Inv;
 		f->div = gf2Div;
 		// заголовок
-		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + f->n) + 
+		f->hdr.keep = sizeof(qr_o) + O_OF_W(n1 + 2 * f->n) + 
 			sizeof(gf2_pentanom_st);
 		f->hdr.p_count = 3;
 		f->hdr.o_count = 0;
@@ -521,6 +947,18 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 			gf2Inv_deep(f->n),
 			gf2Div_deep(f->n));
 	}
+	// маска следа
+	gf2CalcTrMask((word*)f->params - f->n, (const size_t*)f->params);
+	// стандартный многочлен?
+	if ((std = gf2FindStd(p)) != 0)
+	{
+		f->mul = std->mul;
+		f->sqr = std->sqr;
+		f->inv = gf2InvIT;
+		f->div = gf2DivIT;
+		f->deep = utilMax(2, f->deep, 
+			gf2DivIT_deep(f->n, gf2MulStd_deep(f->n)));
+	}
 	return TRUE;
 }
 
@@ -528,7 +966,7 @@ size_t gf2Create_keep(size_t m)
 {
 	const size_t n = W_OF_B(m);
 	const size_t n1 = n + (m % B_PER_W == 0);
-	return sizeof(qr_o) + O_OF_W(n1 + n) + 
+	return sizeof(qr_o) + O_OF_W(n1 + 2 * n) + 
 		utilMax(2, 
 			sizeof(gf2_trinom_st),
 			sizeof(gf2_pentanom_st));
@@ -537,15 +975,63 @@ size_t gf2Create_keep(size_t m)
 size_t gf2Create_deep(size_t m)
 {
 	const size_t n = W_OF_B(m);
-	return utilMax(8, 
+	return utilMax(10, 
 		gf2MulTrinomial0_deep(n),
 		gf2SqrTrinomial0_deep(n),
 		gf2MulTrinomial1_deep(n),
 		gf2SqrTrinomial1_deep(n),
 		gf2MulPentanomial_deep(n),
 		gf2SqrPentanomial_deep(n),
+		gf2MulStd_deep(n),
 		gf2Inv_deep(n),
-		gf2Div_deep(n));
+		gf2Div_deep(n),
+		gf2DivIT_deep(n, gf2MulStd_deep(n)));
+}
+
+bool_t gf2CreateIT(qr_o* f, const size_t p[4], void* stack)
+{
+	const word* tbl;
+	size_t m, k, e, pos;
+	// создать поле
+	if (!gf2Create(f, p, stack))
+		return FALSE;
+	m = gf2Deg(f);
+	ASSERT(m >= 2);
+	ASSERT(gf2ITTbl(f) == (const word*)((const octet*)f + f->hdr.keep));
+	// построить таблицы (по шагам цепочки сложений)
+	tbl = gf2ITTbl(f);
+	e = m - 1;
+	for (pos = 0; (e >> pos) > 1; ++pos);
+	for (k = 1; pos--; )
+	{
+		if (k >= GF2_IT_MIN)
+		{
+			gf2ITTblCreate((word*)tbl, k, f, stack);
+			tbl += GF2_IT_TBL_SIZE(m);
+		}
+		k *= 2;
+		if ((e >> pos) & 1)
+			++k;
+	}
+	// настроить интерфейсы
+	f->inv = gf2InvITTbl;
+	f->div = gf2DivIT;
+	f->hdr.keep += O_OF_W(gf2ITCount(m) * GF2_IT_TBL_SIZE(m));
+	f->deep = utilMax(2, f->deep, gf2DivIT_deep(f->n, f->deep));
+	return TRUE;
+}
+
+size_t gf2CreateIT_keep(size_t m)
+{
+	return gf2Create_keep(m) + O_OF_W(gf2ITCount(m) * GF2_IT_TBL_SIZE(m));
+}
+
+size_t gf2CreateIT_deep(size_t m)
+{
+	const size_t n = W_OF_B(m);
+	return utilMax(2,
+		gf2DivIT_deep(n, gf2Create_deep(m)),
+		gf2ITTblCreate_deep(n, gf2Create_deep(m)));
 }
 
 bool_t gf2IsOperable(const qr_o* f)
@@ -615,33 +1101,27 @@ size_t gf2Deg(const qr_o* f)
 
 bool_t gf2Tr(const word a[], const qr_o* f, void* stack)
 {
-	size_t m = gf2Deg(f);
-	word* t = (word*)stack;
-	stack = t + f->n;
+	const word* tr = (const word*)f->params - f->n;
+	register word w = 0;
+	size_t i;
+	bool_t ret;
 	// pre
 	ASSERT(gf2IsOperable(f));
 	ASSERT(gf2IsIn(a, f));
-	// t <- sum_{i = 0}^{m - 1} a^{2^i}
-	qrCopy(t, a, f);
-	while (--m)
-	{
-		qrSqr(t, t, f, stack);
-		gf2Add2(t, a, f);
-	}
-	// t == 0?
-	if (qrIsZero(t, f))
-		return FALSE;
-	// t == 1?
-	ASSERT(qrIsUnity(t, f));
-	return TRUE;
+	// tr(a) <- wt(a & tr) \mod 2
+	for (i = 0; i < f->n; ++i)
+		w ^= a[i] & tr[i];
+	ret = wordParity(w);
+	w = 0;
+	return ret;
 }
 
 size_t gf2Tr_deep(size_t n, size_t f_deep)
 {
-	return O_OF_W(n) + f_deep;
+	return 0;
 }
 
-bool_t gf2QSolve(word x[], const word a[], const word b[],
+static bool_t gf2QSolveHT(word x[], const word a[], const word b[],
 	const qr_o* f, void* stack)
 {
 	size_t m = gf2Deg(f);
@@ -669,8 +1149,13 @@ bool_t gf2QSolve(word x[], const word a[], const word b[],
 		return TRUE;
 	}
 	// t <- ba^{-2}
-	qrSqr(t, a, f, stack);
-	qrDiv(t, b, t, f, stack);
+	if (qrIsUnity(a, f))
+		qrCopy(t, b, f);
+	else
+	{
+		qrSqr(t, a, f, stack);
+		qrDiv(t, b, t, f, stack);
+	}
 	// tr(t) == 1?
 	if (gf2Tr(t, f, stack))
 		return FALSE;
@@ -684,12 +1169,205 @@ bool_t gf2QSolve(word x[], const word a[], const word b[],
 		gf2Add2(x, t, f);
 	}
 	// x <- x * a
-	qrMul(x, x, a, f, stack);
+	if (!qrIsUnity(a, f))
+		qrMul(x, x, a, f, stack);
 	// решение есть
 	return TRUE;
 }
 
-size_t gf2QSolve_deep(size_t n, size_t f_deep)
+static size_t gf2QSolveHT_deep(size_t n, size_t f_deep)
 {
 	return O_OF_W(n) + f_deep;
 }
+
+/*
+*******************************************************************************
+Таблица решений
+
+Отображение L(z) = z^2 + z является линейным над GF(2), его ядро -- {0, 1},
+образ -- элементы с нулевым следом. Таблица tbl состоит из элементов 
+z_0, z_1,..., z_{m - 1}, таких, что для любого c с нулевым следом 
+решением уравнения L(z) = c является z = \sum_i c_i z_i, где c_i -- i-й 
+разряд c в полиномиальном базисе.
+
+Элементы z_i находятся методом Гаусса -- Жордана по столбцам 
+L_j = L(t^j), j = 0, 1,..., m - 1, за O(m^2 n) операций со словами. 
+Одновременно со столбцами L_j преобразуются столбцы U_j = t^j, так что 
+всегда L(U_j) = L_j. Ранг L равняется m - 1, единственная линейная 
+зависимость между строками матрицы (L_j) задается маской следа T. 
+Поэтому при обработке строк по порядку без ведущего элемента остается 
+строка r с номером старшего ненулевого разряда T. Для этой строки 
+z_r = 0, для остальных строк z_i = U_j, где j -- ведущий столбец строки i.
+Тогда L(z) и c совпадают во всех разрядах, кроме, возможно, r-го. 
+Поскольку tr(L(z)) = tr(c) = 0 и r-й разряд T ненулевой, совпадают 
+и r-е разряды.
+
+При решении по таблице выполняется m маскированных сложений строк tbl.
+Обращения к памяти и время не зависят от c. Окна (по 4 или 8 разрядов)
+не используются: регулярный выбор из окна требует просмотра всех его 
+элементов и проигрывает поразрядной обработке.
+
+Таблица строится в функции gf2CreateQT() и размещается сразу за описанием 
+поля. Смещение таблицы относительно f сохраняется в поле qt структуры 
+params (на одной и той же позиции для трехчленов и пятичленов), что 
+сохраняет корректность таблицы при копировании описания. Функция 
+gf2QSolve() использует таблицу, если она построена.
+*******************************************************************************
+*/
+
+static void gf2QTblCreate(word tbl[], const qr_o* f, void* stack)
+{
+	const size_t m = gf2Deg(f);
+	const size_t n = f->n;
+	size_t r, c, j;
+	// переменные в stack
+	word* L = (word*)stack;
+	word* U = L + m * n;
+	size_t* pivot = (size_t*)(U + m * n);
+	stack = pivot + m;
+	// pre
+	ASSERT(gf2IsOperable(f));
+	ASSERT(m % 2);
+	ASSERT(wwIsValid(tbl, m * n));
+	// L_j <- t^{2j} + t^j, U_j <- t^j
+	for (j = 0; j < m; ++j)
+	{
+		wwSetZero(U + j * n, n);
+		wwSetBit(U + j * n, j, 1);
+		qrSqr(L + j * n, U + j * n, f, stack);
+		wwFlipBit(L + j * n, j);
+	}
+	// исключение Гаусса -- Жордана
+	for (r = c = 0; r < m; ++r)
+	{
+		// найти столбец с ведущим элементом в строке r
+		for (j = c; j < m && !wwTestBit(L + j * n, r); ++j);
+		if (j == m)
+		{
+			pivot[r] = SIZE_MAX;
+			continue;
+		}
+		if (j != c)
+		{
+			wwSwap(L + j * n, L + c * n, n);
+			wwSwap(U + j * n, U + c * n, n);
+		}
+		// исключить разряд r из остальных столбцов
+		for (j = 0; j < m; ++j)
+			if (j != c && wwTestBit(L + j * n, r))
+			{
+				wwXor2(L + j * n, L + c * n, n);
+				wwXor2(U + j * n, U + c * n, n);
+			}
+		pivot[r] = c++;
+	}
+	ASSERT(c == m - 1);
+	// z_i <- U_{pivot[i]}
+	for (j = 0; j < m; ++j)
+		if (pivot[j] == SIZE_MAX)
+			wwSetZero(tbl + j * n, n);
+		else
+			wwCopy(tbl + j * n, U + pivot[j] * n, n);
+}
+
+static size_t gf2QTblCreate_keep(size_t m)
+{
+	return O_OF_W(m * W_OF_B(m));
+}
+
+static size_t gf2QTblCreate_deep(size_t m, size_t f_deep)
+{
+	return O_OF_W(2 * m * W_OF_B(m)) + m * sizeof(size_t) + f_deep;
+}
+
+static bool_t gf2QSolveTbl(word x[], const word a[], const word b[],
+	const qr_o* f, const word tbl[], void* stack)
+{
+	const size_t m = gf2Deg(f);
+	const size_t n = f->n;
+	size_t i, j;
+	word* t = (word*)stack;
+	stack = t + n;
+	// pre
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	ASSERT(gf2IsIn(b, f));
+	ASSERT(m % 2);
+	ASSERT(wwIsValid(tbl, m * n));
+	// a == 0 или b == 0?
+	if (qrIsZero(a, f) || qrIsZero(b, f))
+		return gf2QSolveHT(x, a, b, f, stack);
+	// t <- ba^{-2}
+	if (qrIsUnity(a, f))
+		qrCopy(t, b, f);
+	else
+	{
+		qrSqr(t, a, f, stack);
+		qrDiv(t, b, t, f, stack);
+	}
+	// tr(t) == 1?
+	if (gf2Tr(t, f, stack))
+		return FALSE;
+	// x <- \sum_i t_i z_i
+	qrSetZero(x, f);
+	for (i = 0; i < m; ++i)
+	{
+		register word mask = WORD_0 - (word)wwTestBit(t, i);
+		for (j = 0; j < n; ++j)
+			x[j] ^= tbl[i * n + j] & mask;
+		mask = 0;
+	}
+	// x <- x * a
+	if (!qrIsUnity(a, f))
+		qrMul(x, x, a, f, stack);
+	// решение есть
+	return TRUE;
+}
+
+static size_t gf2QSolveTbl_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(n) + utilMax(2, f_deep, gf2QSolveHT_deep(n, f_deep));
+}
+
+bool_t gf2QSolve(word x[], const word a[], const word b[],
+	const qr_o* f, void* stack)
+{
+	const size_t qt = ((const size_t*)f->params)[4];
+	if (qt)
+		return gf2QSolveTbl(x, a, b, f, 
+			(const word*)((const octet*)f + qt), stack);
+	return gf2QSolveHT(x, a, b, f, stack);
+}
+
+size_t gf2QSolve_deep(size_t n, size_t f_deep)
+{
+	return gf2QSolveTbl_deep(n, f_deep);
+}
+
+bool_t gf2CreateQT(qr_o* f, const size_t p[4], void* stack)
+{
+	size_t m;
+	// создать поле
+	if (!gf2Create(f, p, stack))
+		return FALSE;
+	m = gf2Deg(f);
+	if (m % 2 == 0)
+		return FALSE;
+	// построить таблицу (сразу за описанием)
+	gf2QTblCreate((word*)((octet*)f + f->hdr.keep), f, stack);
+	((size_t*)f->params)[4] = f->hdr.keep;
+	f->hdr.keep += gf2QTblCreate_keep(m);
+	return TRUE;
+}
+
+size_t gf2CreateQT_keep(size_t m)
+{
+	return gf2Create_keep(m) + gf2QTblCreate_keep(m);
+}
+
+size_t gf2CreateQT_deep(size_t m)
+{
+	return utilMax(2,
+		gf2Create_deep(m),
+		gf2QTblCreate_deep(m, gf2Create_deep(m)));
+}
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.03.01
-\version 2016.05.18
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -15,6 +15,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/util.h"
 #include "bee2/math/pp.h"
 #include "bee2/math/ww.h"
+#include "pp_lcl.h"
 
 /*	подавить предупреждение C4146
 	[unary minus operator applied to unsigned type, result still unsigned]
@@ -785,6 +786,204 @@ static size_t ppMul9_deep()
 	return O_OF_W(18) + ppMul3_deep();
 }
 
+/*
+*******************************************************************************
+Умножение с помощью команды PCLMULQDQ
+
+Команда PCLMULQDQ (расширение CLMUL процессоров x86-64) вычисляет
+произведение двух 64-битовых двоичных многочленов. Если команда
+поддерживается процессором, то вместо функций ppMul1,..., ppMul9
+используются функции ppMul1C,..., ppMul9C, а вместо макроса _MUL1 
+в ppMulW(), ppAddMulW() -- команда PCLMULQDQ. Программная реализация
+остается резервной.
+
+Поддержка команды проверяется во время выполнения (признак 
+CPUID.01H:ECX[бит 1]). Результат проверки запоминается. В тестах 
+использование команды можно запретить вызовом ppUseCLMUL(FALSE) 
+(см. pp_lcl.h).
+
+В функциях ppMulnC используется аддитивный вариант алгоритма Карацубы
+(одноуровневое разбиение на слова):
+	a_i b_j + a_j b_i = (a_i + a_j)(b_i + b_j) + a_i b_i + a_j b_j.
+Для умножения многочленов из n слов требуется n(n + 1)/2 команд PCLMULQDQ.
+Промежуточные произведения накапливаются в 128-битовых регистрах:
+в массиве e -- произведения со смещениями 2k (в словах), в массиве o --
+со смещениями 2k + 1. На последнем шаге массивы объединяются.
+
+Функции ppMulnC не используют стек. Оценки глубины стека ppMuln_deep()
+остаются верхними границами.
+
+\remark Функции ppMulnC не ветвятся по данным и не обращаются к таблицам,
+поэтому регулярнее программных.
+*******************************************************************************
+*/
+
+#if (B_PER_W == 64) && defined(__GNUC__) &&\
+	(defined(__x86_64__) || defined(__amd64__))
+	#define PP_CLMUL
+	#include <cpuid.h>
+	#include <wmmintrin.h>
+	#define _CLMUL_FUNC __attribute__((target("pclmul,sse2")))
+	#define _CLMUL_INLINE __attribute__((target("pclmul,sse2"), always_inline))\
+		static inline
+#elif (B_PER_W == 64) && defined(_MSC_VER) && defined(_M_X64)
+	#define PP_CLMUL
+	#include <intrin.h>
+	#include <wmmintrin.h>
+	#define _CLMUL_FUNC
+	#define _CLMUL_INLINE static __forceinline
+#endif
+
+static bool_t _clmul_off;
+
+#ifdef PP_CLMUL
+
+bool_t ppHasCLMUL()
+{
+	static int has_clmul = -1;
+	if (has_clmul < 0)
+	{
+		u32 info[4];
+#if defined(_MSC_VER)
+		__cpuid((int*)info, 1);
+#else
+		__cpuid(1, info[0], info[1], info[2], info[3]);
+#endif
+		has_clmul = (info[2] & 0x00000002) == 0x00000002;
+	}
+	return has_clmul != 0 && !_clmul_off;
+}
+
+#define _CLMUL(a, b)\
+	_mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)(a)),\
+		_mm_cvtsi64_si128((long long)(b)), 0x00)
+
+_CLMUL_INLINE void ppMulC(word c[], const word a[], const word b[], 
+	const size_t n)
+{
+	__m128i d[9];
+	__m128i e[9];
+	__m128i o[8];
+	size_t i, j;
+	ASSERT(1 <= n && n <= 9);
+	// d[i] <- a_i b_i
+	for (i = 0; i < n; ++i)
+		d[i] = _CLMUL(a[i], b[i]);
+	// e[k] <- d[k], o[k] <- 0
+	for (i = 0; i < n; ++i)
+		e[i] = d[i];
+	for (i = 0; i + 1 < n; ++i)
+		o[i] = _mm_setzero_si128();
+	// слагаемые a_i b_j + a_j b_i со смещениями i + j
+	for (i = 0; i < n; ++i)
+		for (j = i + 1; j < n; ++j)
+		{
+			__m128i t = _CLMUL(a[i] ^ a[j], b[i] ^ b[j]);
+			t = _mm_xor_si128(t, _mm_xor_si128(d[i], d[j]));
+			if ((i + j) & 1)
+				o[(i + j) / 2] = _mm_xor_si128(o[(i + j) / 2], t);
+			else
+				e[(i + j) / 2] = _mm_xor_si128(e[(i + j) / 2], t);
+		}
+	// c <- e + o X
+	for (i = 0; i < n; ++i)
+	{
+		__m128i t = e[i];
+		if (i > 0)
+			t = _mm_xor_si128(t, _mm_srli_si128(o[i - 1], 8));
+		if (i + 1 < n)
+			t = _mm_xor_si128(t, _mm_slli_si128(o[i], 8));
+		_mm_storeu_si128((__m128i*)(c + 2 * i), t);
+	}
+}
+
+static void _CLMUL_FUNC ppMul1C(word c[2], const word a[1], const word b[1], 
+	void* stack)
+{
+	ppMulC(c, a, b, 1);
+}
+
+static void _CLMUL_FUNC ppMul2C(word c[4], const word a[2], const word b[2], 
+	void* stack)
+{
+	ppMulC(c, a, b, 2);
+}
+
+static void _CLMUL_FUNC ppMul3C(word c[6], const word a[3], const word b[3], 
+	void* stack)
+{
+	ppMulC(c, a, b, 3);
+}
+
+static void _CLMUL_FUNC ppMul4C(word c[8], const word a[4], const word b[4], 
+	void* stack)
+{
+	ppMulC(c, a, b, 4);
+}
+
+static void _CLMUL_FUNC ppMul5C(word c[10], const word a[5], const word b[5], 
+	void* stack)
+{
+	ppMulC(c, a, b, 5);
+}
+
+static void _CLMUL_FUNC ppMul6C(word c[12], const word a[6], const word b[6], 
+	void* stack)
+{
+	ppMulC(c, a, b, 6);
+}
+
+static void _CLMUL_FUNC ppMul7C(word c[14], const word a[7], const word b[7], 
+	void* stack)
+{
+	ppMulC(c, a, b, 7);
+}
+
+static void _CLMUL_FUNC ppMul8C(word c[16], const word a[8], const word b[8], 
+	void* stack)
+{
+	ppMulC(c, a, b, 8);
+}
+
+static void _CLMUL_FUNC ppMul9C(word c[18], const word a[9], const word b[9], 
+	void* stack)
+{
+	ppMulC(c, a, b, 9);
+}
+
+static word _CLMUL_FUNC ppMulWC(word b[], const word a[], size_t n, 
+	register word w, bool_t add)
+{
+	register word carry = 0;
+	size_t i;
+	__m128i t;
+	const __m128i ww = _mm_cvtsi64_si128((long long)w);
+	for (i = 0; i < n; ++i)
+	{
+		t = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a[i]), ww, 0);
+		if (add)
+			b[i] ^= carry ^ (word)_mm_cvtsi128_si64(t);
+		else
+			b[i] = carry ^ (word)_mm_cvtsi128_si64(t);
+		carry = (word)_mm_cvtsi128_si64(_mm_srli_si128(t, 8));
+	}
+	return carry;
+}
+
+#else
+
+bool_t ppHasCLMUL()
+{
+	return FALSE;
+}
+
+#endif // PP_CLMUL
+
+void ppUseCLMUL(bool_t use)
+{
+	_clmul_off = !use;
+}
+
 /*
 *******************************************************************************
 Умножение на слово
@@ -798,6 +997,10 @@ word ppMulW(word b[], const word a[], size_t n, register word w,
 	size_t i;
 	word* t = (word*)stack;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef PP_CLMUL
+	if (ppHasCLMUL())
+		return ppMulWC(b, a, n, w, FALSE);
+#endif
 	_MUL_PRE_S4(t, w);
 	for (i = 0; i < n; ++i)
 	{
@@ -822,6 +1025,10 @@ word ppAddMulW(word b[], const word a[], size_t n, register word w,
 	size_t i;
 	word* t = (word*)stack;
 	ASSERT(wwIsSameOrDisjoint(a, b, n));
+#ifdef PP_CLMUL
+	if (ppHasCLMUL())
+		return ppMulWC(b, a, n, w, TRUE);
+#endif
 	_MUL_PRE_S4(t, w);
 	for (i = 0; i < n; ++i)
 	{
@@ -844,7 +1051,8 @@ size_t ppAddMulW_deep(size_t n)
 Умножение в общем случае
 
 В массиве _mul_funcs задаются базовые функции умножения многочленов малой
-одинаковой длины.
+одинаковой длины. Если поддерживается команда PCLMULQDQ, то вместо 
+них используются функции из массива _mul_procs_clmul.
 
 Функция _ppMulEq() реализует умножение многочленов одинаковой длины.
 Используются функции из таблицы _mul_funcs либо алгоритм Карацубы
@@ -865,6 +1073,17 @@ static const _pp_mul_proc _mul_procs[] =
 	ppMul8, ppMul9,
 };
 
+#ifdef PP_CLMUL
+
+static const _pp_mul_proc _mul_procs_clmul[] =
+{
+	0,
+	ppMul1C, ppMul2C, ppMul3C, ppMul4C, ppMul5C, ppMul6C, ppMul7C,
+	ppMul8C, ppMul9C,
+};
+
+#endif
+
 static void ppMulEq(word c[], const word a[], const word b[], size_t n,
 	void* stack)
 {
@@ -872,7 +1091,14 @@ static void ppMulEq(word c[], const word a[], const word b[], size_t n,
 	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
 	// умножение многочленов малой длины
 	if (n < COUNT_OF(_mul_procs))
+	{
+#ifdef PP_CLMUL
+		if (ppHasCLMUL())
+			_mul_procs_clmul[n](c, a, b, stack);
+		else
+#endif
 		_mul_procs[n](c, a, b, stack);
+	}
 	// усеченный алгоритм Карацубы, n --- четное
 	else if ((n & 1) == 0)
 	{
@@ -1039,6 +1265,9 @@ size_t ppMul_deep(size_t n, size_t m)
 
 Возведение в квадрат двоичной строки, представляющей многочлен, состоит
 в прореживании строки нулями.
+Прореживание выполняется либо по таблице _squares (байт -> 16 битов), 
+либо, если поддерживается команда PCLMULQDQ, умножением каждого слова 
+на себя.
 *******************************************************************************
 */
 
@@ -1100,10 +1329,28 @@ static const word _squares[256] =
 	#error "Unsupported word size"
 #endif
 
+#ifdef PP_CLMUL
+
+static void _CLMUL_FUNC ppSqrC(word b[], const word a[], size_t n)
+{
+	size_t i;
+	for (i = 0; i < n; ++i)
+		_mm_storeu_si128((__m128i*)(b + i + i), _CLMUL(a[i], a[i]));
+}
+
+#endif
+
 void ppSqr(word b[], const word a[], size_t n, void* stack)
 {
 	size_t i;
 	ASSERT(wwIsDisjoint2(a, n, b, 2 * n));
+#ifdef PP_CLMUL
+	if (ppHasCLMUL())
+	{
+		ppSqrC(b, a, n);
+		return;
+	}
+#endif
 	for (i = 0; i < n; ++i)
 		b[i + i] = _SQR_LO(a[i]),
 		b[i + i + 1] = _SQR_HI(a[i]);
@@ -0,0 +1,45 @@
+/*
+*******************************************************************************
+\file pp_lcl.h
+\brief Binary polynomials: local definitions
+\project bee2 [cryptographic library]
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License 
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#ifndef __PP_LCL_H
+#define __PP_LCL_H
+
+#include "bee2/defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+*******************************************************************************
+Управление использованием команды PCLMULQDQ
+
+Функция ppUseCLMUL() разрешает (use == TRUE, по умолчанию) или запрещает 
+(use == FALSE) использование команды PCLMULQDQ при умножении многочленов. 
+При запрете используется программная реализация умножения.
+
+Функция предназначена только для тестов: для проверки программной 
+реализации и сравнения скорости. Признак запрета читается при каждом 
+умножении без синхронизации. Поэтому функцию нельзя вызывать одновременно 
+с умножением многочленов в других потоках (в том числе в заданиях 
+mtRunJobs()). Функция не входит в интерфейс библиотеки.
+*******************************************************************************
+*/
+
+void ppUseCLMUL(bool_t use);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __PP_LCL_H */
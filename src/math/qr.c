@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.09.14
-\version 2014.04.17
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -183,3 +183,54 @@ size_t qrPower_deep(size_t n, size_t m, size_t r_deep)
 	const size_t powers_count = SIZE_1 << (qrCalcSlideWidth(m) - 1);
 	return O_OF_W(n + n * powers_count) + r_deep;
 }
+
+/*
+*******************************************************************************
+Пакетное обращение
+
+В функции qrInvBatch() реализован прием Монтгомери. Рассчитываются 
+произведения p_i = a_0 a_1... a_i, обращается p_{count - 1}, и затем 
+для i = count - 1,..., 1:
+	a_i^{-1} = p_{count - 1}^{-1} a_{count - 1}... a_{i + 1} p_{i - 1}.
+Вместо count обращений выполняется одно обращение и 3(count - 1) 
+умножений.
+*******************************************************************************
+*/
+
+void qrInvBatch(word b[], const word a[], size_t count, const qr_o* r, 
+	void* stack)
+{
+	size_t i;
+	// переменные в stack
+	word* p = (word*)stack;
+	word* t = p + count * r->n;
+	word* u = t + r->n;
+	stack = u + r->n;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(a, count * r->n));
+	ASSERT(wwIsValid(b, count * r->n));
+	ASSERT(a == b || wwIsDisjoint2(a, count * r->n, b, count * r->n));
+	// пустой пакет?
+	if (count == 0)
+		return;
+	// p_i <- a_0 a_1... a_i
+	wwCopy(p, a, r->n);
+	for (i = 1; i < count; ++i)
+		qrMul(p + i * r->n, p + (i - 1) * r->n, a + i * r->n, r, stack);
+	// t <- p_{count - 1}^{-1}
+	qrInv(t, p + (count - 1) * r->n, r, stack);
+	// b_i <- t p_{i - 1}, t <- t a_i
+	for (i = count - 1; i; --i)
+	{
+		qrMul(u, t, a + i * r->n, r, stack);
+		qrMul(b + i * r->n, t, p + (i - 1) * r->n, r, stack);
+		wwCopy(t, u, r->n);
+	}
+	wwCopy(b, t, r->n);
+}
+
+size_t qrInvBatch_deep(size_t n, size_t count, size_t r_deep)
+{
+	return O_OF_W((count + 2) * n) + r_deep;
+}
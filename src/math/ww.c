@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.04.18
-\version 2016.05.27
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -36,6 +36,17 @@ void wwSwap(word a[], word b[], size_t n)
 		SWAP(a[n], b[n]);
 }
 
+void wwCondSwap(word a[], word b[], size_t n, bool_t cond)
+{
+	register word mask = WORD_0 - (word)cond;
+	register word t;
+	ASSERT(wwIsDisjoint(a, b, n));
+	ASSERT(cond == FALSE || cond == TRUE);
+	while (n--)
+		t = (a[n] ^ b[n]) & mask, a[n] ^= t, b[n] ^= t;
+	mask = t = 0;
+}
+
 bool_t SAFE(wwEq)(const word a[], const word b[], size_t n)
 {
 	register word diff = 0;
@@ -5,7 +5,7 @@
 \project bee2 [cryptographic library]
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.09.14
-\version 2016.07.04
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -17,6 +17,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/math/ww.h"
 #include "bee2/math/zm.h"
 #include "bee2/math/zz.h"
+#include "zm_lcl.h"
 
 /*
 *******************************************************************************
@@ -223,6 +224,23 @@ static size_t zmSqrCrand_deep(size_t n)
 		zzRedCrand_deep(n));
 }
 
+static void zmMulCrand256(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	ASSERT(zmIsOperable(r) && r->n == W_OF_B(256));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	zmMulCrandFixed(c, a, b, r->mod, W_OF_B(256));
+}
+
+static void zmSqrCrand256(word b[], const word a[], const qr_o* r, 
+	void* stack)
+{
+	ASSERT(zmIsOperable(r) && r->n == W_OF_B(256));
+	ASSERT(zmIsIn(a, r));
+	zmMulCrandFixed(b, a, a, r->mod, W_OF_B(256));
+}
+
 void zmCreateCrand(qr_o* r, const octet mod[], size_t no, void* stack)
 {
 	ASSERT(memIsValid(r, sizeof(qr_o)));
@@ -251,6 +269,8 @@ void zmCreateCrand(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->neg = zmNeg2;
 	r->mul = zmMulCrand;
 	r->sqr = zmSqrCrand;
+	if (no == 32)
+		r->mul = zmMulCrand256, r->sqr = zmSqrCrand256;
 	r->inv = zmInv;
 	r->div = zmDiv;
 	r->deep = utilMax(4,
@@ -301,9 +321,10 @@ static void zmMulBarr(word c[], const word a[], const word b[],
 
 static size_t zmMulBarr_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRedBarr_deep(n));
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRedBarr_deep(n));
 }
 
 static void zmSqrBarr(word b[], const word a[], const qr_o* r, void* stack)
@@ -319,9 +340,27 @@ static void zmSqrBarr(word b[], const word a[], const qr_o* r, void* stack)
 
 static size_t zmSqrBarr_deep(size_t n)
 {
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRedBarr_deep(n));
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedBarr_deep(n));
+}
+
+static void zmMulBarr256(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	ASSERT(zmIsOperable(r) && r->n == W_OF_B(256));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	zmMulBarrFixed(c, a, b, r->mod, r->params, W_OF_B(256));
+}
+
+static void zmSqrBarr256(word b[], const word a[], const qr_o* r, 
+	void* stack)
+{
+	ASSERT(zmIsOperable(r) && r->n == W_OF_B(256));
+	ASSERT(zmIsIn(a, r));
+	zmMulBarrFixed(b, a, a, r->mod, r->params, W_OF_B(256));
 }
 
 void zmCreateBarr(qr_o* r, const octet mod[], size_t no, void* stack)
@@ -350,6 +389,8 @@ void zmCreateBarr(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->neg = zmNeg2;
 	r->mul = zmMulBarr;
 	r->sqr = zmSqrBarr;
+	if (no == 32)
+		r->mul = zmMulBarr256, r->sqr = zmSqrBarr256;
 	r->inv = zmInv;
 	r->div = zmDiv;
 	r->deep = utilMax(4,
@@ -450,9 +491,10 @@ static void zmMulMont(word c[], const word a[], const word b[],
 
 static size_t zmMulMont_deep(size_t n)
 {
-	return utilMax(2,
-		zzMul_deep(n, n),
-		zzRedMont_deep(n));
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			zzMul_deep(n, n),
+			zzRedMont_deep(n));
 }
 
 static void zmSqrMont(word b[], const word a[], const qr_o* r, void* stack)
@@ -468,9 +510,27 @@ static void zmSqrMont(word b[], const word a[], const qr_o* r, void* stack)
 
 static size_t zmSqrMont_deep(size_t n)
 {
-	return utilMax(2,
-		zzSqr_deep(n),
-		zzRedMont_deep(n));
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedMont_deep(n));
+}
+
+static void zmMulMont256(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	ASSERT(zmIsOperable(r) && r->n == W_OF_B(256));
+	ASSERT(zmIsIn(a, r));
+	ASSERT(zmIsIn(b, r));
+	zmMulMontFixed(c, a, b, r->mod, *(word*)r->params, W_OF_B(256));
+}
+
+static void zmSqrMont256(word b[], const word a[], const qr_o* r, 
+	void* stack)
+{
+	ASSERT(zmIsOperable(r) && r->n == W_OF_B(256));
+	ASSERT(zmIsIn(a, r));
+	zmMulMontFixed(b, a, a, r->mod, *(word*)r->params, W_OF_B(256));
 }
 
 static void zmInvMont(word b[], const word a[], const qr_o* r, void* stack)
@@ -503,7 +563,7 @@ static void zmDivMont(word b[], const word divident[], const word a[],
 	// c <- a^{(-1)} (в кольце Монтгомери)
 	zmInvMont(c, a, r, stack);
 	// b <- divident * c
-	zmMulMont(b, divident, c, r, stack);
+	qrMul(b, divident, c, r, stack);
 }
 
 static size_t zmDivMont_deep(size_t n)
@@ -541,6 +601,8 @@ void zmCreateMont(qr_o* r, const octet mod[], size_t no, void* stack)
 	r->neg = zmNeg2;
 	r->mul = zmMulMont;
 	r->sqr = zmSqrMont;
+	if (no == 32)
+		r->mul = zmMulMont256, r->sqr = zmSqrMont256;
 	r->inv = zmInvMont;
 	r->div = zmDivMont;
 	r->deep = utilMax(6,
@@ -575,6 +637,27 @@ size_t zmCreateMont_deep(size_t no)
 		zmDivMont_deep(n));
 }
 
+/*
+*******************************************************************************
+Распознавание специализированных функций (см. zm_lcl.h)
+*******************************************************************************
+*/
+
+bool_t zmIsCrand256(const qr_o* r)
+{
+	return r->mul == zmMulCrand256;
+}
+
+bool_t zmIsMont256(const qr_o* r)
+{
+	return r->mul == zmMulMont256;
+}
+
+bool_t zmIsBarr256(const qr_o* r)
+{
+	return r->mul == zmMulBarr256;
+}
+
 /*
 *******************************************************************************
 Создание оптимального кольца
@@ -6,7 +6,7 @@
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \author (C) Stanislav Poruchnik [poruchnikstanislav@gmail.com]
 \created 2012.04.22
-\version 2019.06.26
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -368,7 +368,7 @@ bool_t zzRandMod(word a[], const word mod[], size_t n, gen_i rng,
 	// pre
 	ASSERT(wwIsDisjoint(a, mod, n));
 	ASSERT(n > 0 && mod[n - 1] != 0);
-	// генерировать
+	// генерировать (проверка принятого a -- регулярная)
 	l = wwBitSize(mod, n);
 	i =  B_PER_IMPOSSIBLE;
 	do
@@ -377,7 +377,7 @@ bool_t zzRandMod(word a[], const word mod[], size_t n, gen_i rng,
 		wwFrom(a, a, O_OF_B(l));
 		wwTrimHi(a, n, l);
 	}
-	while (wwCmp(a, mod, n) >= 0 && i--);
+	while ((SAFE(wwCmp)(a, mod, n) >= 0) && i--);
 	// выход
 	l = 0;
 	return i != SIZE_MAX;
@@ -391,7 +391,7 @@ bool_t zzRandNZMod(word a[], const word mod[], size_t n, gen_i rng,
 	// pre
 	ASSERT(wwIsDisjoint(a, mod, n));
 	ASSERT(n > 0 && mod[n - 1] != 0 && wwCmpW(mod, n, 1) > 0);
-	// генерировать
+	// генерировать (проверка принятого a -- регулярная)
 	l = wwBitSize(mod, n);
 	i = (l <= 16) ? 2 * B_PER_IMPOSSIBLE : B_PER_IMPOSSIBLE;
 	do
@@ -400,7 +400,7 @@ bool_t zzRandNZMod(word a[], const word mod[], size_t n, gen_i rng,
 		wwFrom(a, a, O_OF_B(l));
 		wwTrimHi(a, n, l);
 	}
-	while ((wwIsZero(a, n) || wwCmp(a, mod, n) >= 0) && i--);
+	while ((SAFE(wwIsZero)(a, n) | (SAFE(wwCmp)(a, mod, n) >= 0)) && i--);
 	// выход
 	l = 0;
 	return i != SIZE_MAX;
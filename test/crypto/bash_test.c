@@ -5,12 +5,13 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2015.09.22
-\version 2019.07.09
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/str.h>
@@ -168,6 +169,48 @@ bool_t bashTest()
 	if (!memEq(buf + 8 + 12, beltH() + 8 + 12, 15) ||
 		!memEq(buf + 8 + 12 + 15, hash, 8))
 		return FALSE;
+	// AE.2: пакетная обработка
+	{
+		octet st[2][512];
+		octet data[2][200];
+		octet macs[2 * 16];
+		void* states[2];
+		void* bufs[2];
+		const void* hdrs[2];
+		const size_t counts[2] = { 200, 15 };
+		const size_t hdr_counts[2] = { 12, 3 };
+		bool_t oks[2];
+		size_t i;
+		ASSERT(sizeof(st[0]) >= bashAE_keep());
+		for (i = 0; i < 2; ++i)
+		{
+			memCopy(data[i], beltH() + 8 * i, counts[i]);
+			bashAEStart(st[i], beltH() + 128 + 16 * i, 32, beltH(), 8);
+			states[i] = st[i], bufs[i] = data[i];
+			hdrs[i] = beltH() + 200 + 8 * i;
+		}
+		if (bashAEWrapBurst(bufs, counts, hdrs, hdr_counts, macs, 16,
+				states, 2) != ERR_OK)
+			return FALSE;
+		// сравнить с AE.1
+		bashAEStart(state, beltH() + 128 + 16, 32, beltH(), 8);
+		bashAEAbsorb(BASH_AE_DATA, beltH() + 208, 3, state);
+		memCopy(buf, beltH() + 8, 15);
+		bashAEEncr(buf, 15, state);
+		bashAESqueeze(BASH_AE_MAC, hash, 16, state);
+		if (!memEq(buf, data[1], 15) || !memEq(hash, macs + 16, 16))
+			return FALSE;
+		// снять защиту
+		for (i = 0; i < 2; ++i)
+			bashAEStart(st[i], beltH() + 128 + 16 * i, 32, beltH(), 8);
+		macs[0] ^= 1;
+		if (bashAEUnwrapBurst(bufs, counts, hdrs, hdr_counts, macs, 16,
+				states, 2, oks) != ERR_BAD_MAC ||
+			oks[0] || !oks[1] ||
+			!memIsZero(data[0], counts[0]) ||
+			!memEq(data[1], beltH() + 8, counts[1]))
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
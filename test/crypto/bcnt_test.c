@@ -0,0 +1,116 @@
+/*
+*******************************************************************************
+\file bcnt_test.c
+\brief Tests for chunked authenticated encryption containers
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bcnt.h>
+#include <bee2/crypto/belt.h>
+
+/*
+*******************************************************************************
+Самотестирование
+
+Проверяется, что результат зашифрования не зависит от числа потоков
+и от разбиения данных на порции, отдельные фрагменты расшифровываются
+независимо, а перестановка, искажение фрагментов и обрезка контейнера
+обнаруживаются.
+*******************************************************************************
+*/
+
+bool_t bcntTest()
+{
+	const size_t counts[] = { 0, 50, 100, 250, 300 };
+	const size_t algs[] = { BCNT_BELT_DWP, BCNT_BASH_AE };
+	const size_t cs = 100;
+	octet combo_state[128];
+	octet state[256];
+	octet state1[256];
+	octet header[BCNT_HDR_LEN];
+	octet buf[300];
+	octet ct[300 + 3 * 32];
+	octet ct1[300 + 3 * 32];
+	octet pt[300];
+	size_t i, j, tl, len;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(state) < bcnt_keep())
+		return FALSE;
+	prngCOMBOStart(combo_state, 29);
+	memCopy(buf, beltH(), 255);
+	memCopy(buf + 255, beltH(), sizeof(buf) - 255);
+	// цикл по алгоритмам и длинам
+	for (i = 0; i < COUNT_OF(algs); ++i)
+	for (j = 0; j < COUNT_OF(counts); ++j)
+	{
+		const size_t count = counts[j];
+		const size_t n = count ? (count - 1) / cs + 1 : 1;
+		// зашифровать в 1 и 3 потоках
+		if (bcntEncrStart(state, header, algs[i], cs, beltH(),
+				prngCOMBOStepR, combo_state) != ERR_OK ||
+			bcntChunkSize(state) != cs ||
+			bcntEncr(ct, buf, count, 0, TRUE, state, 1) != ERR_OK ||
+			bcntEncr(ct1, buf, count, 0, TRUE, state, 3) != ERR_OK)
+			return FALSE;
+		tl = bcntTagLen(state);
+		len = count + n * tl;
+		if (!memEq(ct, ct1, len))
+			return FALSE;
+		// зашифровать порциями
+		if (count > 2 * cs)
+		{
+			if (bcntEncr(ct1, buf, 2 * cs, 0, FALSE, state, 2) != ERR_OK ||
+				bcntEncr(ct1 + 2 * (cs + tl), buf + 2 * cs, count - 2 * cs,
+					2, TRUE, state, 2) != ERR_OK ||
+				!memEq(ct, ct1, len))
+				return FALSE;
+		}
+		// расшифровать
+		if (bcntDecrStart(state1, header, beltH()) != ERR_OK ||
+			bcntDecr(pt, ct, len, 0, TRUE, state1, 3) != ERR_OK ||
+			!memEq(pt, buf, count))
+			return FALSE;
+		if (n < 2)
+			continue;
+		// расшифровать фрагмент 1
+		if (bcntDecr(pt, ct + cs + tl, MIN2(cs + tl, len - cs - tl), 1,
+				n == 2, state1, 1) != ERR_OK ||
+			!memEq(pt, buf + cs, MIN2(cs, count - cs)))
+			return FALSE;
+		// обрезать контейнер
+		if (bcntDecr(pt, ct, cs + tl, 0, TRUE, state1, 1) != ERR_BAD_MAC ||
+			!memIsZero(pt, cs))
+			return FALSE;
+		// переставить фрагменты
+		if (bcntDecr(pt, ct + cs + tl, cs + tl, 0, FALSE, state1, 1) !=
+			ERR_BAD_MAC)
+			return FALSE;
+		// исказить фрагмент 1
+		ct[cs + tl] ^= 1;
+		if (bcntDecr(pt, ct, len, 0, TRUE, state1, 2) != ERR_BAD_MAC ||
+			!memEq(pt, buf, cs) || !memIsZero(pt + cs, MIN2(cs, count - cs)))
+			return FALSE;
+		ct[cs + tl] ^= 1;
+		// исказить заголовок
+		header[16] ^= 1;
+		if (bcntDecrStart(state1, header, beltH()) != ERR_OK ||
+			bcntDecr(pt, ct, len, 0, TRUE, state1, 1) != ERR_BAD_MAC)
+			return FALSE;
+		header[5] ^= 0x80;
+		if (bcntDecrStart(state1, header, beltH()) != ERR_BAD_FORMAT)
+			return FALSE;
+	}
+	// все нормально
+	return TRUE;
+}
@@ -5,13 +5,14 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.11.18
-\version 2019.05.23
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
 #include <stdio.h>
+#include <bee2/core/blob.h>
 #include <bee2/core/prng.h>
 #include <bee2/core/tm.h>
 #include <bee2/core/util.h>
@@ -28,13 +29,19 @@ version 3. See Copyright Notices in bee2/info.h.
 bool_t beltBench()
 {
 	const size_t reps = 5000;
+	const size_t sizes[] = { 64, 256, 1400 };
 	octet belt_state[512];
 	octet combo_state[256];
 	octet buf[1024];
+	octet keys[64 * 48];
 	octet key[32];
 	octet iv[16];
 	octet hash[32];
-	size_t i;
+	void* states[64];
+	void* bufs[64];
+	size_t counts[64];
+	octet* mem;
+	size_t i, j, k, c;
 	tm_ticks_t ticks;
 	// псевдослучайная генерация объектов
 	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
@@ -103,6 +110,42 @@ bool_t beltBench()
 	printf("beltBench::belt-dwp:  %3u cycles / byte [%5u kBytes / sec]\n",
 		(unsigned)(ticks / 1024 / reps),
 		(unsigned)tmSpeed(reps, ticks));
+	// cкорость belt-dwp: 64 сессии, пакеты по 64, 256 и 1400 октетов
+	mem = (octet*)blobCreate(64 * (beltDWP_keep() + 1400));
+	if (!mem)
+		return FALSE;
+	for (j = 0; j < 64; ++j)
+	{
+		states[j] = mem + j * beltDWP_keep();
+		bufs[j] = mem + 64 * beltDWP_keep() + j * 1400;
+	}
+	for (k = 0; k < COUNT_OF(sizes); ++k)
+	{
+		c = sizes[k];
+		for (j = 0; j < 64; ++j)
+			counts[j] = c;
+		for (i = 0, ticks = tmTicks(); i < reps / 64; ++i)
+			for (j = 0; j < 64; ++j)
+			{
+				beltDWPStart(states[j], key, 32, iv);
+				beltDWPStepE(bufs[j], c, states[j]);
+				beltDWPStepA(bufs[j], c, states[j]);
+				beltDWPStepG(keys + 8 * j, states[j]);
+			}
+		ticks = tmTicks() - ticks;
+		printf("beltBench::belt-dwp [%4u]:         %6u cycles / packet\n",
+			(unsigned)c, (unsigned)(ticks / (reps / 64 * 64)));
+		for (i = 0, ticks = tmTicks(); i < reps / 64; ++i)
+		{
+			for (j = 0; j < 64; ++j)
+				beltDWPStart(states[j], key, 32, iv);
+			beltDWPWrapBurst(bufs, counts, 0, 0, keys, states, 64);
+		}
+		ticks = tmTicks() - ticks;
+		printf("beltBench::belt-dwp [%4u, burst]:  %6u cycles / packet\n",
+			(unsigned)c, (unsigned)(ticks / (reps / 64 * 64)));
+	}
+	blobClose(mem);
 	// cкорость belt-hash
 	ASSERT(beltHash_keep() <= sizeof(belt_state));
 	beltHashStart(belt_state);
@@ -113,6 +156,32 @@ bool_t beltBench()
 	printf("beltBench::belt-hash: %3u cycles / byte [%5u kBytes / sec]\n",
 		(unsigned)(ticks / 1024 / reps),
 		(unsigned)tmSpeed(reps, ticks));
+	// cкорость belt-krp
+	for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		beltKRP(keys + 32 * (i % 64), 32, key, 32, buf, buf + 12 + i % 64);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-krp:  %5u cycles / key [%7u keys / sec]\n",
+		(unsigned)(ticks / reps),
+		(unsigned)tmSpeed(reps, ticks));
+	for (i = 0, ticks = tmTicks(); i < reps / 64; ++i)
+		beltKRPBatch(keys, 32, key, 32, buf + 256, buf, 64, 1);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-krp [batch]: %5u cycles / key [%7u keys / sec]\n",
+		(unsigned)(ticks / (reps / 64 * 64)),
+		(unsigned)tmSpeed(reps / 64 * 64, ticks));
+	// cкорость belt-kwp
+	for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		beltKWPWrap(keys + 48 * (i % 64), buf + i % 64, 32, iv, key, 32);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-kwp:  %5u cycles / key [%7u keys / sec]\n",
+		(unsigned)(ticks / reps),
+		(unsigned)tmSpeed(reps, ticks));
+	for (i = 0, ticks = tmTicks(); i < reps / 16; ++i)
+		beltKWPWrapBatch(keys, buf, 32, 16, buf + 512, key, 32, 1);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-kwp [batch]: %5u cycles / key [%7u keys / sec]\n",
+		(unsigned)(ticks / (reps / 16 * 16)),
+		(unsigned)tmSpeed(reps / 16 * 16, ticks));
 	// все нормально
 	return TRUE;
 }
@@ -5,12 +5,13 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.06.20
-\version 2019.05.29
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/u32.h>
@@ -133,7 +134,7 @@ bool_t beltTest()
 	u32 block[4];
 	octet level[12];
 	octet state[1024];
-	size_t count;
+	size_t count, i;
 	// создать стек
 	ASSERT(sizeof(state) >= 256);
 	ASSERT(sizeof(state) >= beltWBL_keep());
@@ -464,6 +465,48 @@ bool_t beltTest()
 		mac, beltH() + 128 + 32, 32, beltH() + 192 + 16) != ERR_OK ||
 		!memEq(buf, buf1, 16))
 		return FALSE;
+	// belt-dwp: пакетная обработка
+	{
+		octet st[3][512];
+		octet data[3][40];
+		octet macs[24];
+		void* states[3];
+		void* bufs[3];
+		const void* hdrs[3];
+		const size_t counts[3] = { 40, 7, 33 };
+		const size_t hdr_counts[3] = { 5, 0, 16 };
+		bool_t oks[3];
+		ASSERT(sizeof(st[0]) >= beltDWP_keep());
+		for (i = 0; i < 3; ++i)
+		{
+			memCopy(data[i], beltH() + 40 * i, counts[i]);
+			beltDWPStart(st[i], beltH() + 128 + 8 * i, 32,
+				beltH() + 192 + 16 * i);
+			states[i] = st[i], bufs[i] = data[i];
+			hdrs[i] = beltH() + 120 + 16 * i;
+		}
+		if (beltDWPWrapBurst(bufs, counts, hdrs, hdr_counts, macs, states,
+				3) != ERR_OK)
+			return FALSE;
+		for (i = 0; i < 3; ++i)
+			if (beltDWPWrap(buf1, mac1, beltH() + 40 * i, counts[i],
+					hdrs[i], hdr_counts[i], beltH() + 128 + 8 * i, 32,
+					beltH() + 192 + 16 * i) != ERR_OK ||
+				!memEq(buf1, data[i], counts[i]) ||
+				!memEq(mac1, macs + 8 * i, 8))
+				return FALSE;
+		for (i = 0; i < 3; ++i)
+			beltDWPStart(st[i], beltH() + 128 + 8 * i, 32,
+				beltH() + 192 + 16 * i);
+		macs[8] ^= 1;
+		if (beltDWPUnwrapBurst(bufs, counts, hdrs, hdr_counts, macs,
+				states, 3, oks) != ERR_BAD_MAC ||
+			!oks[0] || oks[1] || !oks[2] ||
+			!memEq(data[0], beltH(), counts[0]) ||
+			!memIsZero(data[1], counts[1]) ||
+			!memEq(data[2], beltH() + 80, counts[2]))
+			return FALSE;
+	}
 	// belt-kwp: тест A.27
 	beltKWPStart(state, beltH() + 128, 32);
 	memCopy(buf, beltH(), 32);
@@ -492,6 +535,23 @@ bool_t beltTest()
 		beltH() + 128 + 32, 32) != ERR_OK ||
 		!memEq(buf, buf1, 32))
 		return FALSE;
+	// belt-kwp: пакетная обработка
+	if (beltKWPWrapBatch(state, beltH(), 32, 3, beltH() + 96,
+			beltH() + 128, 32, 2) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 3; ++i)
+		if (beltKWPWrap(buf1, beltH() + 32 * i, 32, beltH() + 96 + 16 * i,
+				beltH() + 128, 32) != ERR_OK ||
+			!memEq(state + 48 * i, buf1, 48))
+			return FALSE;
+	if (beltKWPWrapBatch(state, beltH(), 20, 5, 0, beltH() + 128, 24,
+			3) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 5; ++i)
+		if (beltKWPWrap(buf1, beltH() + 20 * i, 20, 0, beltH() + 128,
+				24) != ERR_OK ||
+			!memEq(state + 36 * i, buf1, 36))
+			return FALSE;
 	// belt-hash: тест A.29
 	beltHashStart(state);
 	beltHashStepH(beltH(), 13, state);
@@ -642,6 +702,43 @@ bool_t beltTest()
 		beltFMTDecr(str1, 49667, str1, 9, beltH() + 128, 32, beltH() + 192);
 		if (!memEq(str, str1, 9 * 2))
 			return FALSE;
+		// пакетная обработка
+		{
+			u16 strs[4 * 21];
+			u16 strs1[4 * 21];
+			for (i = 0; i < 4 * 21; ++i)
+				strs[i] = (u16)(i % 21 + i / 21);
+			if (beltFMTEncrBatch(strs1, 58, strs, 21, 4, beltH() + 128, 32,
+					beltH() + 192, 3) != ERR_OK)
+				return FALSE;
+			for (i = 0; i < 4; ++i)
+			{
+				beltFMTEncr(str1, 58, strs + 21 * i, 21, beltH() + 128, 32,
+					beltH() + 192 + 16 * i);
+				if (!memEq(str1, strs1 + 21 * i, 21 * 2))
+					return FALSE;
+			}
+			if (beltFMTDecrBatch(strs1, 58, strs1, 21, 4, beltH() + 128, 32,
+					beltH() + 192, 2) != ERR_OK ||
+				!memEq(strs, strs1, sizeof(strs)))
+				return FALSE;
+			for (i = 0; i < 3 * 10; ++i)
+				strs[i] = (u16)((7 * i + i / 10) % 10);
+			if (beltFMTEncrBatch(strs1, 10, strs, 10, 3, beltH() + 128, 32,
+					0, 4) != ERR_OK)
+				return FALSE;
+			for (i = 0; i < 3; ++i)
+			{
+				beltFMTEncr(str1, 10, strs + 10 * i, 10, beltH() + 128, 32, 
+					0);
+				if (!memEq(str1, strs1 + 10 * i, 10 * 2))
+					return FALSE;
+			}
+			if (beltFMTDecrBatch(strs1, 10, strs1, 10, 3, beltH() + 128, 32,
+					0, 2) != ERR_OK ||
+				!memEq(strs, strs1, 3 * 10 * 2))
+				return FALSE;
+		}
 	}
 	// belt-keyexpand: тест A.35
 	memSetZero(level, 12);
@@ -672,6 +769,23 @@ bool_t beltTest()
 	beltKRP(buf1, 32, beltH() + 128, 32, level, beltH() + 32);
 	if (!memEq(buf, buf1, 32))
 		return FALSE;
+	// belt-keyrep: пакетная обработка
+	if (beltKRPBatch(state, 24, beltH() + 128, 32, beltH(), beltH() + 64,
+			5, 2) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 5; ++i)
+		if (beltKRP(buf1, 24, beltH() + 128, 32, beltH() + 12 * i,
+				beltH() + 64 + 16 * i) != ERR_OK ||
+			!memEq(state + 24 * i, buf1, 24))
+			return FALSE;
+	if (beltKRPBatch(state, 16, beltH() + 128, 16, beltH(), beltH() + 64,
+			4, 1) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 4; ++i)
+		if (beltKRP(buf1, 16, beltH() + 128, 16, beltH() + 12 * i,
+				beltH() + 64 + 16 * i) != ERR_OK ||
+			!memEq(state + 16 * i, buf1, 16))
+			return FALSE;
 	// belt-hmac: тест Б.1-1
 	beltHMACStart(state, beltH() + 128, 29);
 	beltHMACStepA(beltH() + 128 + 64, 32, state);
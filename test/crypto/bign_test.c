@@ -5,18 +5,21 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.08.27
-\version 2018.08.31
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/str.h>
 #include <bee2/core/util.h>
 #include <bee2/math/ww.h>
 #include <bee2/math/zz.h>
+#include <bee2/crypto/bash.h>
 #include <bee2/crypto/bign.h>
 #include <bee2/crypto/belt.h>
 #include <bee2/crypto/brng.h>
@@ -114,6 +117,18 @@ bool_t bignTest()
 	char pwd[] = "B194BAC80A08F53B";
 	size_t iter = 10000;
 	octet theta[32];
+	octet privkeys[35 * 32];
+	octet pubkeys[35 * 64];
+	err_t codes[40];
+	octet id_hashes[41 * 32];
+	octet id_sigs[40 * 48];
+	octet id_privkeys[40 * 32];
+	octet id_pubkeys[40 * 64];
+	octet tokens[35 * 64];
+	octet keys[35 * 64];
+	word tbl[W_OF_O(34000)];
+	size_t tbl_len;
+	size_t i;
 	// создать стек
 	ASSERT(sizeof(brng_state) >= brngCTRX_keep());
 	ASSERT(sizeof(zz_stack) >= zzMulMod_deep(W_OF_O(32)));
@@ -125,13 +140,34 @@ bool_t bignTest()
 		bignValParams(params) != ERR_OK)
 		return FALSE;
 	if (bignStdParams(params, "1.2.112.0.2.0.34.101.45.3.1") != ERR_OK ||
-		bignValParams(params) != ERR_OK)
+		bignValParams(params) != ERR_OK ||
+		bignValParams2(params, 3, 0) != ERR_OK)
+		return FALSE;
+	params->seed[0] ^= 1;
+	if (bignValParams2(params, 2, 0) == ERR_OK)
 		return FALSE;
+	params->seed[0] ^= 1;
 	// идентификатор объекта
 	oid_len = sizeof(oid_der);
 	if (bignOidToDER(oid_der, &oid_len, "1.2.112.0.2.0.34.101.31.81") 
 		!= ERR_OK || oid_len != 11)
 		return FALSE;
+	// личный ключ выбирается из {1, 2,..., q - 1}: кандидат q < p 
+	// отвергается, принимается следующий кандидат 1
+	{
+		octet echo[64];
+		octet echo_state[64];
+		ASSERT(prngEcho_keep() <= sizeof(echo_state));
+		memCopy(echo, params->q, 32);
+		memSetZero(echo + 32, 32), echo[32] = 1;
+		prngEchoStart(echo_state, echo, sizeof(echo));
+		if (bignGenKeypair(privkey, pubkey, params, prngEchoStepR, 
+				echo_state) != ERR_OK ||
+			!memEq(privkey, echo + 32, 32) ||
+			!memIsZero(pubkey, 32) ||
+			!memEq(pubkey + 32, params->yG, 32))
+			return FALSE;
+	}
 	// инициализировать ГПСЧ
 	brngCTRXStart(beltH() + 128, beltH() + 128 + 64,
 		beltH(), 8 * 32, brng_state);
@@ -168,6 +204,16 @@ bool_t bignTest()
 		"7AC6A60361E8C8173491686D461B2826"
 		"190C2EDA5909054A9AB84D2AB9D99A90"))
 		return FALSE;
+	memSetZero(pubkey, 32);
+	memCopy(pubkey + 32, params->yG, 32);
+	if (bignDHLadder(pubkey, params, privkey, pubkey, 64) != ERR_OK)
+		return FALSE;
+	if (!hexEq(pubkey,
+		"BD1A5650179D79E03FCEE49D4C2BD5DD"
+		"F54CE46D0CF11E4FF87BF7A890857FD0"
+		"7AC6A60361E8C8173491686D461B2826"
+		"190C2EDA5909054A9AB84D2AB9D99A90"))
+		return FALSE;
 	// тест Г.2
 	if (beltHash(hash, beltH(), 13) != ERR_OK)
 		return FALSE;
@@ -348,6 +394,51 @@ bool_t bignTest()
 		id_pubkey, pubkey) == ERR_OK)
 		return FALSE;
 	id_pubkey[0] ^= 1;
+	// пакетные извлечение ключей и проверка идентификационной ЭЦП
+	for (i = 0; i < 41; ++i)
+		beltHash(id_hashes + 32 * i, beltH(), i + 1);
+	for (i = 0; i < 40; ++i)
+		if (bignSign2(id_sigs + 48 * i, params, oid_der, oid_len,
+			id_hashes + 32 * i, privkey, 0, 0) != ERR_OK)
+			return FALSE;
+	id_sigs[48 * 5] ^= 1;
+	if (bignIdExtractBatch(id_privkeys, id_pubkeys, codes, params, oid_der,
+		oid_len, id_hashes, id_sigs, pubkey, 40, 2) != ERR_BAD_SIG)
+		return FALSE;
+	for (i = 0; i < 40; ++i)
+	{
+		if (bignIdExtract(id_privkey, id_pubkey, params, oid_der, oid_len,
+			id_hashes + 32 * i, id_sigs + 48 * i, pubkey) != codes[i])
+			return FALSE;
+		if (codes[i] == ERR_OK &&
+			(!memEq(id_privkeys + 32 * i, id_privkey, 32) ||
+				!memEq(id_pubkeys + 64 * i, id_pubkey, 64)) ||
+			codes[i] != ERR_OK && (i != 5 ||
+				!memIsZero(id_privkeys + 32 * i, 32) ||
+				!memIsZero(id_pubkeys + 64 * i, 64)))
+			return FALSE;
+	}
+	id_sigs[48 * 5] ^= 1;
+	if (bignIdExtractBatch(id_privkeys, id_pubkeys, codes, params, oid_der,
+		oid_len, id_hashes, id_sigs, pubkey, 40, 3) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 40; ++i)
+		if (bignIdSign2(id_sigs + 48 * i, params, oid_der, oid_len,
+			id_hashes + 32 * i, id_hashes + 32 * (i + 1),
+			id_privkeys + 32 * i, 0, 0) != ERR_OK)
+			return FALSE;
+	if (bignIdVerifyBatch(codes, params, oid_der, oid_len, id_hashes,
+		id_hashes + 32, id_sigs, id_pubkeys, pubkey, 40, 2) != ERR_OK)
+		return FALSE;
+	id_sigs[48 * 7] ^= 1, id_pubkeys[64 * 33] ^= 1;
+	if (bignIdVerifyBatch(codes, params, oid_der, oid_len, id_hashes,
+		id_hashes + 32, id_sigs, id_pubkeys, pubkey, 40, 2) != ERR_BAD_SIG)
+		return FALSE;
+	for (i = 0; i < 40; ++i)
+		if (bignIdVerify(params, oid_der, oid_len, id_hashes + 32 * i,
+			id_hashes + 32 * (i + 1), id_sigs + 48 * i, id_pubkeys + 64 * i,
+			pubkey) != codes[i] || (codes[i] == ERR_OK) != (i != 7 && i != 33))
+			return FALSE;
 	// тест E.5
 	beltPBKDF2(theta, (const octet*)pwd, strLen(pwd), iter, 
 		beltH() + 128 + 64, 8);
@@ -381,6 +472,140 @@ bool_t bignTest()
 		"E48329259BC1211DDAC2EF1DADFFC993"
 		"2702A92F1DD66C14A9BA1D7300C8713C"))
 		return FALSE;
+	// пакетная генерация ключей: первая пара -- из теста Г.1
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64,
+		beltH(), 8 * 32, brng_state);
+	if (bignGenKeypairBatch(privkeys, pubkeys, codes, 35, params, 
+			brngCTRXStepR, brng_state, 2) != ERR_OK ||
+		!hexEq(privkeys,
+		"1F66B5B84B7339674533F0329C74F218"
+		"34281FED0732429E0C79235FC273E269") || 
+		!hexEq(pubkeys,
+		"BD1A5650179D79E03FCEE49D4C2BD5DD"
+		"F54CE46D0CF11E4FF87BF7A890857FD0"
+		"7AC6A60361E8C8173491686D461B2826"
+		"190C2EDA5909054A9AB84D2AB9D99A90"))
+		return FALSE;
+	for (i = 0; i < 35; ++i)
+		if (codes[i] != ERR_OK ||
+			bignCalcPubkey(pubkey, params, privkeys + 32 * i) != ERR_OK ||
+			!memEq(pubkey, pubkeys + 64 * i, 64))
+			return FALSE;
+	// пакетная проверка открытых ключей
+	if (bignValPubkeyBatch(codes, params, pubkeys, 35, 2) != ERR_OK)
+		return FALSE;
+	pubkeys[64 * 7] ^= 1;
+	memSet(pubkeys + 64 * 20 + 32, 0xFF, 32);
+	if (bignValPubkeyBatch(codes, params, pubkeys, 35, 2) != ERR_BAD_PUBKEY)
+		return FALSE;
+	for (i = 0; i < 35; ++i)
+		if (codes[i] != ((i == 7 || i == 20) ? ERR_BAD_PUBKEY : ERR_OK) ||
+			codes[i] != bignValPubkey(params, pubkeys + 64 * i))
+			return FALSE;
+	pubkeys[64 * 7] ^= 1;
+	if (bignCalcPubkey(pubkeys + 64 * 20, params, privkeys + 32 * 20) != 
+		ERR_OK)
+		return FALSE;
+	// сжатие и восстановление открытых ключей
+	for (i = 0; i < 16; ++i)
+		if (bignCompressPubkey(tokens + 33 * i, params, pubkeys + 64 * i) != 
+				ERR_OK ||
+			tokens[33 * i + 32] != (pubkeys[64 * i + 32] & 1) ||
+			!memEq(tokens + 33 * i, pubkeys + 64 * i, 32))
+			return FALSE;
+	if (bignDecompressPubkey(pubkey, params, tokens) != ERR_OK ||
+		!memEq(pubkey, pubkeys, 64) ||
+		bignDecompressPubkeyBatch(keys, codes, params, tokens, 16, 2) != 
+			ERR_OK ||
+		!memEq(keys, pubkeys, 16 * 64))
+		return FALSE;
+	memCopy(pubkey, pubkeys, 64);
+	if (bignCompressPubkey(pubkey, params, pubkey) != ERR_OK ||
+		bignDecompressPubkey(pubkey, params, pubkey) != ERR_OK ||
+		!memEq(pubkey, pubkeys, 64))
+		return FALSE;
+	tokens[33 * 3 + 32] = 2;
+	memSet(tokens + 33 * 9, 0xFF, 32);
+	if (bignDecompressPubkeyBatch(keys, codes, params, tokens, 16, 2) != 
+		ERR_BAD_PUBKEY)
+		return FALSE;
+	for (i = 0; i < 16; ++i)
+		if (codes[i] != bignDecompressPubkey(pubkey, params, tokens + 33 * i) ||
+			codes[i] == ERR_OK && !memEq(keys + 64 * i, pubkeys + 64 * i, 64) ||
+			codes[i] != ERR_OK && !memIsZero(keys + 64 * i, 64))
+			return FALSE;
+	if (codes[3] != ERR_BAD_PUBKEY || codes[9] != ERR_BAD_PUBKEY)
+		return FALSE;
+	// образ таблицы предвычислений
+	if (bignTblCreate(0, &tbl_len, params) != ERR_OK ||
+		tbl_len > sizeof(tbl) ||
+		bignTblCreate((octet*)tbl, &tbl_len, params) != ERR_OK ||
+		bignTblVal(params, (octet*)tbl, tbl_len) != ERR_OK)
+		return FALSE;
+	((octet*)tbl)[tbl_len - 1] ^= 1;
+	if (bignTblVal(params, (octet*)tbl, tbl_len) != ERR_BAD_HASH ||
+		bignGenKeypairBatch2(keys, tokens, codes, 16, params, (octet*)tbl,
+			brngCTRXStepR, brng_state, 1) != ERR_BAD_HASH)
+		return FALSE;
+	// образ с пересчитанным тегом и точкой вне кривой
+	if (sizeof(zz_stack) < bashHash_keep())
+		return FALSE;
+	bashHashStart(zz_stack, 128);
+	bashHashStepH(tbl, 64, zz_stack);
+	bashHashStepH((octet*)tbl + 96, tbl_len - 96, zz_stack);
+	bashHashStepG((octet*)tbl + 64, 32, zz_stack);
+	if (bignTblVal(params, (octet*)tbl, tbl_len) != ERR_BAD_POINT ||
+		bignGenKeypairBatch2(keys, tokens, codes, 16, params, (octet*)tbl,
+			brngCTRXStepR, brng_state, 1) != ERR_BAD_POINT ||
+		bignKeyWrapBatch2(tokens, codes, params, (octet*)tbl, beltH(), 1, 
+			16, 0, pubkeys, 35, brngCTRXStepR, brng_state, 1) != 
+			ERR_BAD_POINT)
+		return FALSE;
+	((octet*)tbl)[tbl_len - 1] ^= 1;
+	bashHashStart(zz_stack, 128);
+	bashHashStepH(tbl, 64, zz_stack);
+	bashHashStepH((octet*)tbl + 96, tbl_len - 96, zz_stack);
+	bashHashStepG((octet*)tbl + 64, 32, zz_stack);
+	if (bignTblVal(params, (octet*)tbl, tbl_len) != ERR_OK)
+		return FALSE;
+	// пакетная генерация ключей с образом таблицы
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64,
+		beltH(), 8 * 32, brng_state);
+	if (bignGenKeypairBatch2(keys, tokens, codes, 16, params, (octet*)tbl,
+			brngCTRXStepR, brng_state, 1) != ERR_OK ||
+		!memEq(keys, privkeys, 16 * 32) ||
+		!memEq(tokens, pubkeys, 16 * 64))
+		return FALSE;
+	// пакетный транспорт ключа: один ключ -- разные получатели
+	// (несколько порций, несколько потоков)
+	if (bignKeyWrapBatch2(tokens, codes, params, (octet*)tbl, beltH(), 1, 
+			16, beltH() + 64, pubkeys, 35, brngCTRXStepR, brng_state, 2) != 
+		ERR_OK)
+		return FALSE;
+	for (i = 0; i < 35; ++i)
+		if (codes[i] != ERR_OK ||
+			bignKeyUnwrap(token, params, tokens + 64 * i, 64, beltH() + 64,
+				privkeys + 32 * i) != ERR_OK ||
+			!memEq(token, beltH(), 16))
+			return FALSE;
+	// пакетный транспорт ключа: разные ключи -- один получатель
+	// (ключи -- начальные октеты privkeys)
+	for (i = 0; i < 35; ++i)
+		memCopy(keys + 64 * i, pubkeys, 64);
+	if (bignKeyWrapBatch(tokens, codes, params, privkeys, 35, 16, 0, 
+			keys, 35, brngCTRXStepR, brng_state, 3) != ERR_OK)
+		return FALSE;
+	tokens[64 * 5 + 40] ^= 1;
+	tokens[64 * 33 + 40] ^= 1;
+	if (bignKeyUnwrapBatch(keys, codes, params, tokens, 64, 35, 0, 
+			privkeys, 2) != ERR_BAD_KEYTOKEN)
+		return FALSE;
+	for (i = 0; i < 35; ++i)
+		if ((i == 5 || i == 33) && (codes[i] != ERR_BAD_KEYTOKEN || 
+				!memIsZero(keys + 16 * i, 16)) ||
+			i != 5 && i != 33 && (codes[i] != ERR_OK || 
+				!memEq(keys + 16 * i, privkeys + 16 * i, 16)))
+			return FALSE;
 	// все нормально
 	return TRUE;
 }
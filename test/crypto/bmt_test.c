@@ -0,0 +1,141 @@
+/*
+*******************************************************************************
+\file bmt_test.c
+\brief Tests for Merkle tree hashing
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/blob.h>
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/belt.h>
+#include <bee2/crypto/bmt.h>
+
+/*
+*******************************************************************************
+Самотестирование
+
+Проверяется, что результат хэширования не зависит от числа потоков
+и разбиения данных на фрагменты, а доказательства, построенные по уровням,
+согласуются с результатом инкрементального хэширования. Для дерева
+из двух листьев результат сверяется с явным вычислением через belt-hash.
+*******************************************************************************
+*/
+
+bool_t bmtTest()
+{
+	const size_t counts[] = { 0, 1, 99, 100, 101, 400, 401, 1234, 3000 };
+	const size_t ls[] = { 0, 128, 256 };
+	const size_t pieces[] = { 1, 7, 250, 99, 1000, 3 };
+	const size_t leaf_size = 100;
+	octet buf[3000];
+	octet hash[64];
+	octet hash1[64];
+	octet proof[64 * 16];
+	octet state[1024];
+	void* st;
+	size_t proof_len;
+	size_t i, j, k, n, pos;
+	bool_t ret = TRUE;
+	// подготовить память
+	ASSERT(sizeof(state) >= beltHash_keep());
+	if (!(st = blobCreate(bmtHash_keep())))
+		return FALSE;
+	for (i = 0; i < sizeof(buf); ++i)
+		buf[i] = (octet)(i * 37 + i / 256);
+	// явное вычисление для двух листьев
+	beltHashStart(state);
+	beltHashStepH("\x00", 1, state);
+	beltHashStepH(buf, 100, state);
+	beltHashStepG(hash1, state);
+	beltHashStart(state);
+	beltHashStepH("\x00", 1, state);
+	beltHashStepH(buf + 100, 50, state);
+	beltHashStepG(hash1 + 32, state);
+	beltHashStart(state);
+	beltHashStepH("\x01", 1, state);
+	beltHashStepH(hash1, 64, state);
+	beltHashStepG(hash1, state);
+	beltHashStart(state);
+	beltHashStepH("\x02", 1, state);
+	beltHashStepH("\x64\x00\x00\x00\x00\x00\x00\x00", 8, state);
+	beltHashStepH("\x96\x00\x00\x00\x00\x00\x00\x00", 8, state);
+	beltHashStepH(hash1, 32, state);
+	beltHashStepG(hash1, state);
+	if (bmtHash(hash, 0, leaf_size, buf, 150, 1) != ERR_OK ||
+		!memEq(hash, hash1, 32))
+		ret = FALSE;
+	// цикл по уровням стойкости и длинам данных
+	for (i = 0; ret && i < COUNT_OF(ls); ++i)
+	for (j = 0; ret && j < COUNT_OF(counts); ++j)
+	{
+		const size_t count = counts[j];
+		// хэширование в 1 и 3 потоках
+		if (bmtHash(hash, ls[i], leaf_size, buf, count, 1) != ERR_OK ||
+			bmtHash(hash1, ls[i], leaf_size, buf, count, 3) != ERR_OK ||
+			!memEq(hash, hash1, ls[i] ? ls[i] / 4 : 32))
+		{
+			ret = FALSE;
+			break;
+		}
+		// инкрементальное хэширование в 2 потоках
+		bmtHashStart(st, ls[i], leaf_size, 2);
+		for (pos = k = 0; pos < count; pos += n, ++k)
+		{
+			n = MIN2(pieces[k % COUNT_OF(pieces)], count - pos);
+			bmtHashStepH(buf + pos, n, st);
+		}
+		if (!bmtHashStepV(hash, st))
+		{
+			ret = FALSE;
+			break;
+		}
+		// доказательства
+		n = count ? (count - 1) / leaf_size + 1 : 1;
+		for (k = 0; ret && k < n; ++k)
+		{
+			const size_t leaf_len = MIN2(leaf_size, count - k * leaf_size);
+			if (bmtProve(0, &proof_len, ls[i], leaf_size, buf, count, k,
+					1) != ERR_OK ||
+				proof_len > sizeof(proof) ||
+				bmtProve(proof, &proof_len, ls[i], leaf_size, buf, count, k,
+					2) != ERR_OK ||
+				bmtVerify(hash, ls[i], leaf_size, count, k,
+					buf + k * leaf_size, leaf_len, proof,
+					proof_len) != ERR_OK)
+				ret = FALSE;
+			// искаженный лист
+			else if (leaf_len)
+			{
+				buf[k * leaf_size] ^= 1;
+				if (bmtVerify(hash, ls[i], leaf_size, count, k,
+					buf + k * leaf_size, leaf_len, proof,
+					proof_len) != ERR_BAD_HASH)
+					ret = FALSE;
+				buf[k * leaf_size] ^= 1;
+			}
+			// искаженное доказательство
+			if (ret && proof_len)
+			{
+				proof[proof_len - 1] ^= 1;
+				if (bmtVerify(hash, ls[i], leaf_size, count, k,
+					buf + k * leaf_size, leaf_len, proof,
+					proof_len) != ERR_BAD_HASH)
+					ret = FALSE;
+			}
+		}
+		if (bmtProve(0, &proof_len, ls[i], leaf_size, buf, count, n,
+			1) != ERR_BAD_INPUT)
+			ret = FALSE;
+	}
+	// завершение
+	blobClose(st);
+	return ret;
+}
@@ -5,17 +5,21 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2012.03.01
-\version 2016.07.15
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/blob.h>
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
 #include <bee2/core/util.h>
 #include <bee2/crypto/dstu.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/ww.h>
 
 
 /*
@@ -25,6 +29,54 @@ COMBO-генератор
 */
 #define combo_rng prngCOMBOStepR
 
+/*
+*******************************************************************************
+Точка порядка 2
+
+Проверяется, что point = (0, y), где y^2 == B. Такая точка должна 
+восстанавливаться из нулевого сжатого представления.
+*******************************************************************************
+*/
+
+static bool_t dstuTestIsT(const dstu_params* params, const octet point[])
+{
+	const size_t m = params->p[0];
+	const size_t n = W_OF_B(m);
+	const size_t no = O_OF_B(m);
+	size_t p[4];
+	void* state;
+	qr_o* f;
+	word* y;
+	word* b;
+	void* stack;
+	bool_t ret;
+	// x == 0?
+	if (!memIsZero(point, no))
+		return FALSE;
+	// создать поле
+	p[0] = params->p[0], p[1] = params->p[1];
+	p[2] = params->p[2], p[3] = params->p[3];
+	state = blobCreate(gf2Create_keep(m) + O_OF_W(2 * n) + 
+		gf2Create_deep(m));
+	if (state == 0)
+		return FALSE;
+	f = (qr_o*)state;
+	y = (word*)((octet*)f + gf2Create_keep(m));
+	b = y + n;
+	stack = b + n;
+	// y^2 == B?
+	ret = gf2Create(f, p, stack) &&
+		qrFrom(y, point + no, f, stack) &&
+		qrFrom(b, params->B, f, stack);
+	if (ret)
+	{
+		qrSqr(y, y, f, stack);
+		ret = qrCmp(y, b, f) == 0;
+	}
+	blobClose(state);
+	return ret;
+}
+
 /*
 *******************************************************************************
 Самотестирование
@@ -46,11 +98,18 @@ bool_t dstuTest()
 	octet pubkey[2 * DSTU_SIZE];
 	octet hash[32];
 	octet sig[2 * DSTU_SIZE];
+	octet points[8 * DSTU_SIZE];
+	octet points1[8 * DSTU_SIZE];
+	octet points2[32 * DSTU_SIZE];
+	err_t codes[16];
 	size_t ld;
+	size_t no;
+	size_t i;
 	octet state[512];
 	// тест Б.1 [загрузка параметров]
 	if (dstuStdParams(params, "1.2.804.2.1.1.1.1.3.1.1.1.2.0") != ERR_OK ||
-		dstuValParams(params) != ERR_OK)
+		dstuValParams(params) != ERR_OK ||
+		dstuValParams2(params, 4, 0) != ERR_OK)
 		return FALSE;
 	// тест Б.1 [генерация ключей]
 	hexToRev(buf, 
@@ -86,6 +145,16 @@ bool_t dstuTest()
 			"00000000000000000000000274EA2C0C"
 			"AA014A0D80A424F59ADE7A93068D08A7"))
 		return FALSE;
+	// тест Б.1 [выработка ЭЦП: лесенка Монтгомери]
+	prngEchoStart(state, buf, memNonZeroSize(params->n, O_OF_B(163)));
+	if (dstuSignLadder(sig, params, ld, hash, 21, privkey, prngEchoStepR, 
+			state) != ERR_OK ||
+		!hexEqRev(sig, 
+			"000000000000000000000002100D8695"
+			"7331832B8E8C230F5BD6A332B3615ACA"
+			"00000000000000000000000274EA2C0C"
+			"AA014A0D80A424F59ADE7A93068D08A7"))
+		return FALSE;
 	// тест Б.1 [проверка ЭЦП]
 	if (dstuVerify(params, ld, hash, 21, sig, pubkey) != ERR_OK)
 		return FALSE;
@@ -237,6 +306,67 @@ bool_t dstuTest()
 		dstuVerify(params, ld, hash, 32, sig, pubkey) != ERR_OK ||
 		(sig[0] ^= 1, dstuVerify(params, ld, hash, 32, sig, pubkey) == ERR_OK))
 		return FALSE;
+	// пакетное восстановление точек
+	no = O_OF_B(431);
+	memCopy(points1, params->P, 2 * no);
+	memCopy(points1 + 2 * no, pubkey, 2 * no);
+	if (dstuGenKeypair(privkey, points1 + 4 * no, params, prngCOMBOStepR, 
+			state) != ERR_OK ||
+		dstuGenKeypair(privkey, points1 + 6 * no, params, prngCOMBOStepR, 
+			state) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 4; ++i)
+		if (dstuCompressPoint(points + i * no, params, 
+				points1 + 2 * i * no) != ERR_OK)
+			return FALSE;
+	if (dstuRecoverPointBatch(points, codes, params, points, 4) != ERR_OK ||
+		!memEq(points, points1, 8 * no))
+		return FALSE;
+	// пакетное восстановление: некорректная точка и точка с x == 0
+	for (i = 0; i < 2; ++i)
+		if (dstuCompressPoint(points + i * no, params, 
+				points1 + 2 * i * no) != ERR_OK)
+			return FALSE;
+	memSetZero(points + 2 * no, 2 * no);
+	points[3 * no - 1] = 0xFF;
+	if (dstuRecoverPointBatch(points, codes, params, points, 4) != 
+			ERR_BAD_POINT ||
+		codes[0] != ERR_OK || codes[1] != ERR_OK || 
+		codes[2] != ERR_BAD_POINT || codes[3] != ERR_OK ||
+		!memEq(points, points1, 4 * no) || 
+		!memIsZero(points + 4 * no, 2 * no) ||
+		!dstuTestIsT(params, points + 6 * no))
+		return FALSE;
+	// пакетная проверка точек [cofactor == 2]
+	memSetZero(buf, no);
+	if (dstuRecoverPoint(points1 + 2 * no, params, buf) != ERR_OK ||
+		!dstuTestIsT(params, points1 + 2 * no))
+		return FALSE;
+	points1[4 * no] ^= 1;
+	if (dstuValPointBatch(codes, params, points1, 4, 2) != ERR_BAD_POINT ||
+		codes[0] != ERR_OK || codes[1] != ERR_BAD_POINT ||
+		codes[2] != ERR_BAD_POINT || codes[3] != ERR_OK)
+		return FALSE;
+	// пакетная проверка точек [cofactor == 4]
+	if (dstuStdParams(params, "1.2.804.2.1.1.1.1.3.1.1.1.2.6") != ERR_OK ||
+		dstuGenPoint(params->P, params, prngCOMBOStepR, state) != ERR_OK)
+		return FALSE;
+	no = O_OF_B(257);
+	memSetZero(buf, no);
+	if (dstuGenKeypair(privkey, points2, params, prngCOMBOStepR, 
+			state) != ERR_OK ||
+		dstuRecoverPoint(points2 + 2 * no, params, buf) != ERR_OK)
+		return FALSE;
+	for (i = 2; i < 16; ++i)
+		do
+			combo_rng(buf, no, state), buf[no - 1] &= 1;
+		while (dstuRecoverPoint(points2 + 2 * i * no, params, buf) != ERR_OK);
+	if (dstuValPointBatch(codes, params, points2, 16, 3) == ERR_OK ||
+		codes[0] != ERR_OK || codes[1] != ERR_BAD_POINT)
+		return FALSE;
+	for (i = 0; i < 16; ++i)
+		if (codes[i] != dstuValPoint(params, points2 + 2 * i * no))
+			return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -5,12 +5,14 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.04.07
-\version 2016.07.15
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/blob.h>
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
@@ -23,9 +25,64 @@ version 3. See Copyright Notices in bee2/info.h.
 
 -#	Выполняются тесты из приложения A к ГОСТ Р 34.10-2012.
 -#	Дополнительно проверяются стандартные кривые.
+-#	Проверяется работа с контекстом: подпись, выработанная с помощью 
+	контекста, должна совпадать с подписью g12sSign() (при тех же 
+	одноразовых ключах), при пакетной проверке должна отбраковываться 
+	только искаженная подпись.
 *******************************************************************************
 */
 
+static bool_t g12sTestCtx(const g12s_params* params, const octet hash[], 
+	const octet privkey[], const octet pubkey[], const octet k[],
+	const octet sig[])
+{
+	const size_t mo = params->l / 8;
+	const size_t no = memNonZeroSize(params->p, 
+		sizeof(params->p) * params->l / 512);
+	void* state;
+	octet echo[64];
+	octet hashes[3 * 64];
+	octet sigs[3 * 2 * G12S_ORDER_SIZE];
+	octet pubkeys[3 * 2 * G12S_FIELD_SIZE];
+	err_t codes[3];
+	size_t i;
+	bool_t ret;
+	// создать контекст
+	state = blobCreate(g12sCtx_keep(params->l));
+	if (state == 0)
+		return FALSE;
+	if (g12sCtxStart(state, params) != ERR_OK)
+	{
+		blobClose(state);
+		return FALSE;
+	}
+	// выработать и проверить подпись
+	ASSERT(sizeof(echo) >= prngEcho_keep());
+	prngEchoStart(echo, k, mo);
+	ret = g12sCtxSign(sigs, hash, privkey, prngEchoStepR, echo, state) 
+			== ERR_OK &&
+		memEq(sigs, sig, 2 * mo) &&
+		g12sCtxVerify(hash, sigs, pubkey, state) == ERR_OK;
+	// пакетная проверка: вторая подпись искажена
+	for (i = 0; ret && i < 3; ++i)
+	{
+		memCopy(hashes + i * mo, hash, mo);
+		memCopy(sigs + i * 2 * mo, sig, 2 * mo);
+		memCopy(pubkeys + i * 2 * no, pubkey, 2 * no);
+	}
+	sigs[2 * mo] ^= 1;
+	ret = ret &&
+		g12sCtxVerifyBatch(codes, hashes, sigs, pubkeys, 3, state) 
+			== ERR_BAD_SIG &&
+		codes[0] == ERR_OK && codes[1] == ERR_BAD_SIG && codes[2] == ERR_OK &&
+		g12sCtxVerify(hashes + mo, sigs + 2 * mo, pubkey, state) 
+			== ERR_BAD_SIG &&
+		g12sCtxVerifyBatch(0, hashes, sigs, pubkeys, 1, state) == ERR_OK;
+	// завершение
+	blobClose(state);
+	return ret;
+}
+
 bool_t g12sTest()
 {
 	g12s_params params[1];
@@ -37,7 +94,8 @@ bool_t g12sTest()
 	octet echo[64];
 	// тест A.1 [загрузка параметров]
 	if (g12sStdParams(params, "1.2.643.2.2.35.0") != ERR_OK ||
-		g12sValParams(params) != ERR_OK)
+		g12sValParams(params) != ERR_OK ||
+		g12sValParams2(params, 2, 0) != ERR_OK)
 		return FALSE;
 	// тест A.1 [генерация ключей]
 	hexToRev(buf, 
@@ -74,6 +132,10 @@ bool_t g12sTest()
 	if (g12sVerify(params, hash, sig, pubkey) != ERR_OK ||
 		(sig[0] ^= 1, g12sVerify(params, hash, sig, pubkey) == ERR_OK))
 		return FALSE;
+	// тест A.1 [контекст]
+	sig[0] ^= 1;
+	if (!g12sTestCtx(params, hash, privkey, pubkey, buf, sig))
+		return FALSE;
 	// тест A.2 [загрузка параметров]
 	if (g12sStdParams(params, "1.2.643.7.1.2.1.2.0") != ERR_OK ||
 		g12sValParams(params) != ERR_OK)
@@ -130,10 +192,21 @@ bool_t g12sTest()
 	if (g12sVerify(params, hash, sig, pubkey) != ERR_OK ||
 		(sig[0] ^= 1, g12sVerify(params, hash, sig, pubkey) == ERR_OK))
 		return FALSE;
+	// тест A.2 [контекст]
+	sig[0] ^= 1;
+	if (!g12sTestCtx(params, hash, privkey, pubkey, buf, sig))
+		return FALSE;
 	// проверить кривую cryptoproA
 	if (g12sStdParams(params, "1.2.643.2.2.35.1") != ERR_OK ||
 		g12sValParams(params) != ERR_OK)
 		return FALSE;
+	// cryptoproA [контекст, редукция Крэндалла]
+	prngEchoStart(echo, buf, 32);
+	if (g12sGenKeypair(privkey, pubkey, params, prngEchoStepR, echo) 
+			!= ERR_OK ||
+		g12sSign(sig, params, hash, privkey, prngEchoStepR, echo) != ERR_OK ||
+		!g12sTestCtx(params, hash, privkey, pubkey, buf, sig))
+		return FALSE;
 	// проверить кривую cryptoproB
 	if (g12sStdParams(params, "1.2.643.2.2.35.2") != ERR_OK ||
 		g12sValParams(params) != ERR_OK)
@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.08
-\version 2016.11.10
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -106,7 +106,8 @@ bool_t pfokTest()
 	if (pfokStdParams(params, 0, "test") != ERR_OK ||
 		pfokValParams(params) != ERR_OK ||
 		(params->g[0] += 2) == 0 ||
-		pfokValParams(params) == ERR_OK)
+		pfokValParams(params) == ERR_OK ||
+		pfokValParams2(params, 3, 0) == ERR_OK)
 		return FALSE;
 	// тест PFOK.GENG.2
 	if (pfokStdParams(params, 0, "1.2.112.0.2.0.1176.2.3.3.2") != ERR_OK ||
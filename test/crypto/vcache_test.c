@@ -0,0 +1,101 @@
+/*
+*******************************************************************************
+\file vcache_test.c
+\brief Tests for the cache of validated domain parameters
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bign.h>
+#include <bee2/crypto/vcache.h>
+
+/*
+*******************************************************************************
+Самотестирование
+
+Проверяется, что успешно проверенные параметры попадают в кэш, повторная
+проверка выполняется без вычислений, некорректные параметры в кэш
+не попадают, а ключи вытесняются, удаляются и закрываются ожидаемым
+образом.
+*******************************************************************************
+*/
+
+bool_t vcacheTest()
+{
+	bign_params params[1];
+	tm_ticks_t ticks[BIGN_VAL_CHECKS];
+	octet key[32];
+	octet key1[32];
+	size_t i;
+	// кэш не создан
+	if (vcacheCreate(0) != ERR_BAD_INPUT ||
+		vcacheCreate(VCACHE_MAX_SIZE + 1) != ERR_BAD_INPUT ||
+		vcacheIsValid() ||
+		bignStdParams(params, "1.2.112.0.2.0.34.101.45.3.1") != ERR_OK)
+		return FALSE;
+	vcacheKey(key, "bign", params, sizeof(bign_params));
+	if (vcacheHas(key))
+		return FALSE;
+	vcacheAdd(key);
+	if (vcacheHas(key))
+		return FALSE;
+	// создать кэш
+	if (vcacheCreate(5) != ERR_OK || !vcacheIsValid())
+		return FALSE;
+	// проверить параметры: промах, все проверки выполняются
+	memSetZero(ticks, sizeof(ticks));
+	if (bignValParams2(params, 2, ticks) != ERR_OK || !vcacheHas(key))
+		return FALSE;
+	for (i = 0; i < BIGN_VAL_CHECKS; ++i)
+		if (ticks[i] == 0)
+			return FALSE;
+	// повторно проверить параметры: попадание, проверки не выполняются
+	memSet(ticks, 0xFF, sizeof(ticks));
+	if (bignValParams2(params, 1, ticks) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < BIGN_VAL_CHECKS; ++i)
+		if (ticks[i] != 0)
+			return FALSE;
+	// метка учитывается
+	vcacheKey(key1, "dstu", params, sizeof(bign_params));
+	if (memEq(key, key1, 32) || vcacheHas(key1))
+		return FALSE;
+	// некорректные параметры
+	params->seed[0] ^= 1;
+	vcacheKey(key1, "bign", params, sizeof(bign_params));
+	if (bignValParams2(params, 2, 0) == ERR_OK || vcacheHas(key1))
+		return FALSE;
+	params->seed[0] ^= 1;
+	// вытеснение: последний добавленный ключ всегда в кэше
+	for (i = 0; i < 16; ++i)
+	{
+		key1[0] = (octet)i;
+		vcacheAdd(key1);
+		if (!vcacheHas(key1))
+			return FALSE;
+	}
+	// очистка
+	vcacheWipe();
+	if (vcacheHas(key) || vcacheHas(key1))
+		return FALSE;
+	// повторное создание
+	vcacheAdd(key);
+	if (vcacheCreate(7) != ERR_OK || !vcacheHas(key))
+		return FALSE;
+	vcacheClose();
+	if (!vcacheIsValid() || !vcacheHas(key))
+		return FALSE;
+	vcacheClose();
+	if (vcacheIsValid() || vcacheHas(key))
+		return FALSE;
+	// все нормально
+	return TRUE;
+}
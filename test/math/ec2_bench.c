@@ -0,0 +1,298 @@
+/*
+*******************************************************************************
+\file ec2_bench.c
+\brief Benchmarks for elliptic curves over binary fields
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License 
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/blob.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/dstu.h>
+#include <bee2/math/ec2.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/pp.h>
+#include <math/pp_lcl.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Кратные точки на стандартных кривых ДСТУ
+
+Кратные точки вычисляются также с аффинными малыми кратными (стратегия 4, 
+см. ecMulA()), которая по умолчанию отключена (ec->inv_ratio = 0).
+
+Если поддерживается команда PCLMULQDQ, то кратные точки вычисляются 
+также с программным умножением многочленов (ppUseCLMUL(FALSE)).
+
+Для оценки расширенных LD-координат (X : Y : Z : Z^2) измеряется
+трудоемкость удвоения, сложения с аффинной точкой и возведения в квадрат.
+В расширенных координатах удвоение дороже на одно возведение в квадрат,
+а сложение с аффинной точкой -- дешевле на одно возведение в квадрат.
+
+Дополнительно для базовых полей кривых сравниваются функции обращения:
+обращение в поле, созданном gf2Create(), обращение в поле с таблицами 
+(gf2CreateIT()) и пакетное обращение qrInvBatch() (в пересчете на один 
+элемент пакета).
+*******************************************************************************
+*/
+
+static const char* _curves[] = 
+{
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.0",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.1",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.2",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.3",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.4",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.5",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.6",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.7",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.8",
+	"1.2.804.2.1.1.1.1.3.1.1.1.2.9",
+};
+
+bool_t ec2Bench()
+{
+	// параметры
+	dstu_params params[1];
+	// состояние
+	octet combo_state[256];
+	octet state[16384];
+	size_t i;
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	// создать генератор COMBO
+	prngCOMBOStart(combo_state, 23/*utilNonce32()*/);
+	// цикл по кривым
+	for (i = 0; i < COUNT_OF(_curves); ++i)
+	{
+		size_t m, n;
+		size_t p[4];
+		octet A[DSTU_SIZE];
+		qr_o* f;
+		ec_o* ec;
+		word* pt;
+		word* d;
+		word* q;
+		void* stack;
+		// загрузить параметры и сгенерировать базовую точку
+		if (dstuStdParams(params, _curves[i]) != ERR_OK ||
+			dstuGenPoint(params->P, params, prngCOMBOStepR, 
+				combo_state) != ERR_OK)
+			return FALSE;
+		m = params->p[0], n = W_OF_B(m);
+		p[0] = params->p[0], p[1] = params->p[1];
+		p[2] = params->p[2], p[3] = params->p[3];
+		// раскладка состояния
+		ASSERT(ec2CreateLD_keep(n) + gf2Create_keep(m) + O_OF_W(7 * n) +
+			utilMax(4,
+				gf2Create_deep(m),
+				ec2CreateLD_deep(n, gf2Create_deep(m)),
+				ecCreateGroup_deep(gf2Create_deep(m)),
+				ecMulA_deep(n, 3, ec2CreateLD_deep(n, gf2Create_deep(m)), n),
+				ec2MulLadderA_deep(n, gf2Create_deep(m)))
+			<= sizeof(state));
+		ec = (ec_o*)state;
+		f = (qr_o*)(state + ec2CreateLD_keep(n));
+		pt = (word*)((octet*)f + gf2Create_keep(m));
+		d = pt + 3 * n;
+		q = d + n;
+		stack = q + 3 * n;
+		// создать поле и кривую
+		memSetZero(A, sizeof(A));
+		A[0] = params->A;
+		if (!gf2Create(f, p, stack) ||
+			!ec2CreateLD(ec, f, A, params->B, stack) ||
+			!ecCreateGroup(ec, params->P, params->P + f->no, params->n, 
+				f->no, params->c, stack))
+			return FALSE;
+		// оценить число кратных точек в секунду
+		{
+			const size_t reps = 200;
+			size_t j;
+			tm_ticks_t ticks;
+			// эксперимент
+			for (j = 0, ticks = tmTicks(); j < reps; ++j)
+			{
+				prngCOMBOStepR(d, f->no, combo_state);
+				ecMulA(pt, ec->base, ec, d, n, stack);
+			}
+			ticks = tmTicks() - ticks;
+			// печать результатов
+			printf("ec2Bench[%3u, A = %u]: %u cycles / mulpoint "
+				"[%u mulpoints / sec]\n",
+				(unsigned)m, (unsigned)params->A,
+				(unsigned)(ticks / reps),
+				(unsigned)tmSpeed(reps, ticks));
+		}
+		// оценить число кратных точек в секунду: аффинные малые кратные
+		// (стратегия 4, см. ecMulA())
+		{
+			const size_t reps = 200;
+			size_t j;
+			tm_ticks_t ticks;
+			// контроль
+			ASSERT(ec->inv_ratio == 0);
+			prngCOMBOStepR(d, f->no, combo_state);
+			ecMulA(q, ec->base, ec, d, n, stack);
+			ec->inv_ratio = 1;
+			ecMulA(pt, ec->base, ec, d, n, stack);
+			if (!wwEq(pt, q, 2 * n))
+				return FALSE;
+			// эксперимент
+			for (j = 0, ticks = tmTicks(); j < reps; ++j)
+			{
+				prngCOMBOStepR(d, f->no, combo_state);
+				ecMulA(pt, ec->base, ec, d, n, stack);
+			}
+			ticks = tmTicks() - ticks;
+			ec->inv_ratio = 0;
+			// печать результатов
+			printf("ec2Bench[%3u, A = %u]: %u cycles / mulpoint (affine pre) "
+				"[%u mulpoints / sec]\n",
+				(unsigned)m, (unsigned)params->A,
+				(unsigned)(ticks / reps),
+				(unsigned)tmSpeed(reps, ticks));
+		}
+		// оценить число кратных точек в секунду: без PCLMULQDQ
+		if (ppHasCLMUL())
+		{
+			const size_t reps = 200;
+			size_t j;
+			tm_ticks_t ticks;
+			// эксперимент
+			ppUseCLMUL(FALSE);
+			for (j = 0, ticks = tmTicks(); j < reps; ++j)
+			{
+				prngCOMBOStepR(d, f->no, combo_state);
+				ecMulA(pt, ec->base, ec, d, n, stack);
+			}
+			ticks = tmTicks() - ticks;
+			ppUseCLMUL(TRUE);
+			// печать результатов
+			printf("ec2Bench[%3u, A = %u]: %u cycles / mulpoint (no CLMUL) "
+				"[%u mulpoints / sec]\n",
+				(unsigned)m, (unsigned)params->A,
+				(unsigned)(ticks / reps),
+				(unsigned)tmSpeed(reps, ticks));
+		}
+		// оценить число кратных точек в секунду: лесенка Монтгомери
+		{
+			const size_t reps = 200;
+			const size_t l = wwBitSize(ec->order, n + 1);
+			size_t j;
+			tm_ticks_t ticks;
+			// эксперимент
+			for (j = 0, ticks = tmTicks(); j < reps; ++j)
+			{
+				prngCOMBOStepR(d, f->no, combo_state);
+				wwTrimHi(d, n, l - 1);
+				ec2MulLadderA(pt, ec->base, ec, d, n, stack);
+			}
+			ticks = tmTicks() - ticks;
+			// печать результатов
+			printf("ec2Bench[%3u, A = %u]: %u cycles / mulpoint (ladder) "
+				"[%u mulpoints / sec]\n",
+				(unsigned)m, (unsigned)params->A,
+				(unsigned)(ticks / reps),
+				(unsigned)tmSpeed(reps, ticks));
+		}
+		// оценить трудоемкость удвоения и сложения
+		{
+			const size_t reps = 2000;
+			size_t j;
+			tm_ticks_t ticks_dbl, ticks_add, ticks_sqr;
+			// q <- 2 base (проективная точка)
+			ecFromA(pt, ec->base, ec, stack);
+			ecDbl(q, pt, ec, stack);
+			// эксперименты
+			for (j = 0, ticks_dbl = tmTicks(); j < reps; ++j)
+				ecDbl(q, q, ec, stack);
+			ticks_dbl = tmTicks() - ticks_dbl;
+			for (j = 0, ticks_add = tmTicks(); j < reps; ++j)
+				ecAddA(q, q, ec->base, ec, stack);
+			ticks_add = tmTicks() - ticks_add;
+			for (j = 0, ticks_sqr = tmTicks(); j < reps; ++j)
+				qrSqr(q, q, f, stack);
+			ticks_sqr = tmTicks() - ticks_sqr;
+			// печать результатов
+			printf("ec2Bench[%3u, A = %u]: %u cycles / dbl, %u cycles / adda, "
+				"%u cycles / sqr\n",
+				(unsigned)m, (unsigned)params->A,
+				(unsigned)(ticks_dbl / reps), (unsigned)(ticks_add / reps),
+				(unsigned)(ticks_sqr / reps));
+		}
+		// оценить трудоемкость обращения
+		{
+			const size_t reps = 500;
+			const size_t count = 16;
+			size_t j;
+			tm_ticks_t ticks, ticks_it, ticks_batch;
+			void* blob;
+			qr_o* g;
+			word* a;
+			word* b;
+			word* c;
+			// создать поле с таблицами
+			blob = blobCreate(gf2CreateIT_keep(m) + O_OF_W(3 * count * n) + 
+				utilMax(2,
+					gf2CreateIT_deep(m),
+					qrInvBatch_deep(n, count, gf2CreateIT_deep(m))));
+			if (blob == 0)
+				return FALSE;
+			g = (qr_o*)blob;
+			a = (word*)((octet*)g + gf2CreateIT_keep(m));
+			b = a + count * n;
+			c = b + count * n;
+			if (!gf2CreateIT(g, p, c + count * n))
+			{
+				blobClose(blob);
+				return FALSE;
+			}
+			// элементы и контроль
+			for (j = 0; j < count; ++j)
+			{
+				prngCOMBOStepR(a + j * n, f->no, combo_state);
+				wwTrimHi(a + j * n, n, m - 1);
+				wwSetBit(a + j * n, 0, 1);
+			}
+			qrInvBatch(b, a, count, g, c + count * n);
+			for (j = 0; j < count; ++j)
+			{
+				qrInv(c + j * n, a + j * n, f, stack);
+				if (!wwEq(b + j * n, c + j * n, n))
+				{
+					blobClose(blob);
+					return FALSE;
+				}
+			}
+			// эксперименты
+			for (j = 0, ticks = tmTicks(); j < reps; ++j)
+				qrInv(b, a + j % count * n, f, stack);
+			ticks = tmTicks() - ticks;
+			for (j = 0, ticks_it = tmTicks(); j < reps; ++j)
+				qrInv(b, a + j % count * n, g, c + count * n);
+			ticks_it = tmTicks() - ticks_it;
+			for (j = 0, ticks_batch = tmTicks(); j < reps; j += count)
+				qrInvBatch(b, a, count, g, c + count * n);
+			ticks_batch = tmTicks() - ticks_batch;
+			// печать результатов
+			printf("ec2Bench[%3u]: %u cycles / inv "
+				"[tables: %u, batch of %u: %u]\n",
+				(unsigned)m, (unsigned)(ticks / reps),
+				(unsigned)(ticks_it / reps), (unsigned)count,
+				(unsigned)(ticks_batch / reps));
+			blobClose(blob);
+		}
+	}
+	// все нормально
+	return TRUE;
+}
@@ -5,13 +5,14 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2013.10.17
-\version 2016.07.15
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
 #include <stdio.h>
+#include <bee2/core/blob.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/prng.h>
 #include <bee2/core/stack.h>
@@ -20,6 +21,8 @@ version 3. See Copyright Notices in bee2/info.h.
 #include <crypto/bign_lcl.h>
 #include <bee2/math/ecp.h>
 #include <bee2/math/gfp.h>
+#include <bee2/math/ww.h>
+#include <bee2/math/zz.h>
 
 /*
 *******************************************************************************
@@ -31,7 +34,12 @@ static size_t _ecpBench_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(3 * n) + prngCOMBO_keep() +
-		ecMulA_deep(n, ec_d, ec_deep, n);
+		utilMax(5,
+			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulRegA_deep(n, ec_d, ec_deep, n),
+			ecpMulLadderA_deep(n, f_deep),
+			bignSqrt_deep(n, f_deep),
+			qrPower_deep(n, n, f_deep));
 }
 
 bool_t ecpBench()
@@ -76,6 +84,215 @@ bool_t ecpBench()
 			(unsigned)(ticks / reps),
 			(unsigned)tmSpeed(reps, ticks));
 	}
+	// оценить число кратных точек в секунду: лесенка Монтгомери
+	{
+		const size_t reps = 1000;
+		const size_t l = wwBitSize(ec->order, ec->f->n + 1);
+		size_t i;
+		tm_ticks_t ticks;
+		// эксперимент
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		{
+			prngCOMBOStepR(d, ec->f->no, combo_state);
+			wwTrimHi(d, ec->f->n, l - 1);
+			ecpMulLadderA(pt, ec->base, ec, d, ec->f->n, stack);
+		}
+		ticks = tmTicks() - ticks;
+		// печать результатов
+		printf("ecpBench: %u cycles / mulpoint (ladder) "
+			"[%u mulpoints / sec]\n", 
+			(unsigned)(ticks / reps),
+			(unsigned)tmSpeed(reps, ticks));
+	}
+	// оценить число кратных точек в секунду: стратегии 3 и 4 (см. ecMulA()),
+	// регулярное умножение (см. ecMulRegA())
+	{
+		static const char* curves[] = 
+		{
+			"1.2.112.0.2.0.34.101.45.3.1",
+			"1.2.112.0.2.0.34.101.45.3.2",
+			"1.2.112.0.2.0.34.101.45.3.3",
+		};
+		size_t i;
+		for (i = 0; i < COUNT_OF(curves); ++i)
+		{
+			const size_t reps = 500;
+			size_t j, k;
+			err_t code;
+			void* blob;
+			ec_o* ec1;
+			word* pt1;
+			word* d1;
+			void* stack1;
+			tm_ticks_t ticks, ticks1, ticks2;
+			tm_ticks_t best[3];
+			// создать описание кривой
+			if (bignStdParams(params, curves[i]) != ERR_OK)
+				return FALSE;
+			blob = blobCreate(bignStart_keep(params->l, _ecpBench_deep));
+			if (blob == 0)
+				return FALSE;
+			if (bignStart(blob, params) != ERR_OK)
+			{
+				blobClose(blob);
+				return FALSE;
+			}
+			ec1 = (ec_o*)blob;
+			pt1 = objEnd(ec1, word);
+			d1 = pt1 + 2 * ec1->f->n;
+			stack1 = d1 + ec1->f->n;
+			// стратегии 3, 4 и регулярное умножение
+			// [лучшее из 25 чередующихся серий по reps / 25 умножений]
+			ASSERT(ec1->inv_ratio == 0);
+			best[0] = best[1] = best[2] = (tm_ticks_t)-1;
+			for (k = 0; k < 25; ++k)
+			{
+				// стратегия 3 (ec1->inv_ratio = 0)
+				for (j = 0, ticks = tmTicks(); j < reps / 25; ++j)
+				{
+					prngCOMBOStepR(d1, ec1->f->no, combo_state);
+					ecMulA(pt1, ec1->base, ec1, d1, ec1->f->n, stack1);
+				}
+				ticks = tmTicks() - ticks;
+				best[0] = MIN2(best[0], ticks);
+				// стратегия 4 (аффинные малые кратные)
+				ec1->inv_ratio = 1;
+				for (j = 0, ticks = tmTicks(); j < reps / 25; ++j)
+				{
+					prngCOMBOStepR(d1, ec1->f->no, combo_state);
+					ecMulA(pt1, ec1->base, ec1, d1, ec1->f->n, stack1);
+				}
+				ticks = tmTicks() - ticks;
+				best[1] = MIN2(best[1], ticks);
+				ec1->inv_ratio = 0;
+				// регулярное умножение
+				for (j = 0, ticks = tmTicks(); j < reps / 25; ++j)
+				{
+					prngCOMBOStepR(d1, ec1->f->no, combo_state);
+					ecMulRegA(pt1, ec1->base, ec1, d1, ec1->f->n, stack1);
+				}
+				ticks = tmTicks() - ticks;
+				best[2] = MIN2(best[2], ticks);
+			}
+			// печать результатов
+			printf("ecpBench[%u]: %u cycles / mulpoint "
+				"[affine pre: %u, regular: %u (%+d%%)]\n", 
+				(unsigned)(2 * params->l),
+				(unsigned)(best[0] / (reps / 25)), 
+				(unsigned)(best[1] / (reps / 25)),
+				(unsigned)(best[2] / (reps / 25)),
+				(int)(((double)best[2] - (double)best[0]) * 100 / 
+					(double)best[0]));
+			// квадратный корень (см. bignSqrt()): цепочка и qrPower()
+			// [лучшее из 3 чередующихся измерений]
+			qrSqr(pt1, ecY(ec1->base, ec1->f->n), ec1->f, stack1);
+			wwCopy(d1, ec1->f->mod, ec1->f->n);
+			zzAddW2(d1, ec1->f->n, 1);
+			wwShLo(d1, ec1->f->n, 2);
+			ticks1 = ticks2 = (tm_ticks_t)-1;
+			for (k = 0; k < 3; ++k)
+			{
+				for (j = 0, ticks = tmTicks(); j < 4 * reps; ++j)
+					bignSqrt(pt1 + ec1->f->n, pt1, ec1, stack1);
+				ticks = tmTicks() - ticks;
+				ticks1 = MIN2(ticks1, ticks);
+				for (j = 0, ticks = tmTicks(); j < 4 * reps; ++j)
+					qrPower(pt1 + ec1->f->n, pt1, d1, ec1->f->n, ec1->f, 
+						stack1);
+				ticks = tmTicks() - ticks;
+				ticks2 = MIN2(ticks2, ticks);
+			}
+			printf("ecpBench[%u]: %u cycles / sqrt [qrPower: %u]\n",
+				(unsigned)(2 * params->l),
+				(unsigned)(ticks1 / reps / 4),
+				(unsigned)(ticks2 / reps / 4));
+			// операции с точками: специализированные и общие формулы 
+			// (см. ecpCreateJ(), ecpUseFixed())
+			for (k = 0; k < 2; ++k)
+			{
+				if (k == 1)
+				{
+					ecpUseFixed(FALSE);
+					code = bignStart(blob, params);
+					ecpUseFixed(TRUE);
+					if (code != ERR_OK)
+					{
+						blobClose(blob);
+						return FALSE;
+					}
+				}
+				ecFromA(stack1, ec1->base, ec1, (word*)stack1 + 3 * ec1->f->n);
+				ecFromA(pt1, ec1->base, ec1, (word*)stack1 + 3 * ec1->f->n);
+				for (j = 0, ticks = tmTicks(); j < 20 * reps; ++j)
+					ecDbl(stack1, stack1, ec1, (word*)stack1 + 3 * ec1->f->n);
+				ticks = tmTicks() - ticks;
+				for (j = 0, ticks1 = tmTicks(); j < 20 * reps; ++j)
+					ecAdd(pt1, pt1, stack1, ec1, 
+						(word*)stack1 + 3 * ec1->f->n);
+				ticks1 = tmTicks() - ticks1;
+				for (j = 0, ticks2 = tmTicks(); j < 20 * reps; ++j)
+					ecAddA(pt1, pt1, ec1->base, ec1, 
+						(word*)stack1 + 3 * ec1->f->n);
+				ticks2 = tmTicks() - ticks2;
+				printf("ecpBench[%u]: %u cycles / dbl, %u cycles / add, "
+					"%u cycles / adda (%s formulas)\n", 
+					(unsigned)(2 * params->l),
+					(unsigned)(ticks / reps / 20),
+					(unsigned)(ticks1 / reps / 20),
+					(unsigned)(ticks2 / reps / 20),
+					k == 0 ? "fixed" : "generic");
+			}
+			blobClose(blob);
+		}
+	}
+	// оценить трудоемкость суммы кратных (в пересчете на одно слагаемое)
+	{
+		const size_t ks[] = { 16, 256, 1024, 1024 };
+		const size_t ts[] = { 1, 1, 1, 4 };
+		const size_t n = ec->f->n;
+		const size_t k = 1024;
+		size_t i, j;
+		void* blob;
+		word* pts;
+		word* ds;
+		void* stack1;
+		// выделить память
+		blob = blobCreate(O_OF_W(3 * n + 2 * n * k + n * k) + 
+			utilMax(4,
+				ec->deep,
+				ecAddMulArrA_deep(n, ec->d, ec->deep, ks[0], n, ts[0]),
+				ecAddMulArrA_deep(n, ec->d, ec->deep, ks[1], n, ts[1]),
+				ecAddMulArrA_deep(n, ec->d, ec->deep, ks[3], n, ts[3])));
+		if (blob == 0)
+			return FALSE;
+		pts = (word*)blob + 3 * n;
+		ds = pts + 2 * n * k;
+		stack1 = ds + n * k;
+		// pts[i] <- (i + 1)base, ds[i] <- random
+		ecFromA((word*)blob, ec->base, ec, stack1);
+		wwCopy(pts, ec->base, 2 * n);
+		for (i = 1; i < k; ++i)
+		{
+			ecAddA((word*)blob, (word*)blob, ec->base, ec, stack1);
+			ecToA(pts + i * 2 * n, (word*)blob, ec, stack1);
+		}
+		prngCOMBOStepR(ds, O_OF_W(n * k), combo_state);
+		// эксперименты
+		for (j = 0; j < COUNT_OF(ks); ++j)
+		{
+			const size_t reps = 20;
+			tm_ticks_t ticks;
+			for (i = 0, ticks = tmTicks(); i < reps; ++i)
+				ecAddMulArrA(pt, pts, ds, ks[j], n, ec, ts[j], stack1);
+			ticks = tmTicks() - ticks;
+			printf("ecpBench: %u cycles / term (k = %u, threads = %u) "
+				"[%u terms / sec]\n", 
+				(unsigned)(ticks / reps / ks[j]),
+				(unsigned)ks[j], (unsigned)ts[j],
+				(unsigned)tmSpeed(reps * ks[j], ticks));
+		}
+		blobClose(blob);
+	}
 	// все нормально
 	return TRUE;
 }
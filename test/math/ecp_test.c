@@ -5,17 +5,25 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2017.05.29
-\version 2017.08.23
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/blob.h>
+#include <bee2/core/err.h>
 #include <bee2/core/hex.h>
+#include <bee2/core/mem.h>
 #include <bee2/core/obj.h>
+#include <bee2/core/prng.h>
 #include <bee2/core/util.h>
+#include <bee2/core/word.h>
 #include <bee2/math/gfp.h>
 #include <bee2/math/ecp.h>
+#include <bee2/math/ww.h>
+#include <bee2/math/zz.h>
+#include <bee2/crypto/bign.h>
 
 /*
 *******************************************************************************
@@ -37,6 +45,86 @@ static char xbase[] =
 static char ybase[] = 
 	"B0E9804939D7C2E931D4CE052CCC6B6B692514CCADBA44940484EEA5F52D9268";
 static u32 cofactor = 1;
+/*
+*******************************************************************************
+Регулярная кратная точка на кривых bign
+
+Результаты ecMulRegA() сравниваются с результатами ecMulA() на кривых bign
+всех уровней стойкости. Используются кратности 2^{l - 3} + 129, 
+2^{l - 2} + 129, 2^{l - 1} + 129 (l = 256, 384, 512), при которых 
+задействуется старшая цифра регулярной записи, и случайные кратности.
+*******************************************************************************
+*/
+
+static bool_t ecpTestMulReg(const char* name, octet combo_state[])
+{
+	bign_params params[1];
+	size_t no, n, f_keep, f_deep, ec_keep, ec_deep, i;
+	void* state;
+	qr_o* f;
+	ec_o* ec;
+	word* d;
+	word* pt;
+	word* pt1;
+	void* stack;
+	bool_t ret = TRUE;
+	// загрузить параметры
+	if (bignStdParams(params, name) != ERR_OK)
+		return FALSE;
+	no = O_OF_B(2 * params->l), n = W_OF_O(no);
+	f_keep = gfpCreate_keep(no);
+	f_deep = gfpCreate_deep(no);
+	ec_keep = ecpCreateJ_keep(n);
+	ec_deep = ecpCreateJ_deep(n, f_deep);
+	// выделить память
+	state = blobCreate(f_keep + ec_keep + O_OF_W(5 * n) + 
+		utilMax(6,
+			f_deep,
+			ec_deep,
+			ecCreateGroup_deep(f_deep),
+			zzMod_deep(2 * n, n),
+			ecMulA_deep(n, 3, ec_deep, n),
+			ecMulRegA_deep(n, 3, ec_deep, n)));
+	if (state == 0)
+		return FALSE;
+	ec = (ec_o*)state;
+	f = (qr_o*)((octet*)ec + ec_keep);
+	d = (word*)((octet*)f + f_keep);
+	pt = d + n;
+	pt1 = pt + 2 * n;
+	stack = pt1 + 2 * n;
+	// создать кривую (базовая точка (0, yG))
+	memSetZero(pt, no);
+	if (!gfpCreate(f, params->p, no, stack) ||
+		!ecpCreateJ(ec, f, params->a, params->b, stack) ||
+		!ecCreateGroup(ec, (octet*)pt, params->yG, params->q, no, 1, stack))
+	{
+		blobClose(state);
+		return FALSE;
+	}
+	objAppend(ec, f, 0);
+	// кратности с установленными старшими битами
+	for (i = 3; ret && i > 0; --i)
+	{
+		wwSetW(d, n, 129);
+		wwSetBit(d, B_OF_W(n) - i, 1);
+		ret = ecMulA(pt, ec->base, ec, d, n, stack) &&
+			ecMulRegA(pt1, ec->base, ec, d, n, stack) &&
+			wwEq(pt, pt1, 2 * n);
+	}
+	// случайные кратности
+	for (i = 0; ret && i < 8; ++i)
+	{
+		prngCOMBOStepR(pt, O_OF_W(2 * n), combo_state);
+		zzMod(d, pt, 2 * n, ec->order, n, stack);
+		ret = ecMulA(pt, ec->base, ec, d, n, stack) &&
+			ecMulRegA(pt1, ec->base, ec, d, n, stack) &&
+			wwEq(pt, pt1, 2 * n);
+	}
+	blobClose(state);
+	return ret;
+}
+
 /*
 *******************************************************************************
 Тестирование
@@ -53,7 +141,7 @@ bool_t ecpTest()
 	const size_t ec_deep = ecpCreateJ_deep(n, f_deep);
 	// состояние и стек
 	octet state[2048];
-	octet stack[2048];
+	octet stack[4096];
 	octet t[96];
 	// поле и эк
 	qr_o* f;
@@ -93,6 +181,166 @@ bool_t ecpTest()
 	ASSERT(ecHasOrderA_deep(n, ec->d, ec_deep, n) <= sizeof(stack));
 	if (!ecHasOrderA(ec->base, ec, ec->order, n, stack))
 		return FALSE;
+	// лесенка Монтгомери: (q - 1)base == -base, (q - 2)base == ecMulA()?
+	ASSERT(O_OF_W(5 * n) + utilMax(3,
+		ecpMulLadderA_deep(n, f_deep),
+		ecMulA_deep(n, ec->d, ec_deep, n),
+		ecMulRegA_deep(n, ec->d, ec_deep, n)) <= sizeof(stack));
+	{
+		size_t inv_ratio;
+		bool_t ret;
+		word* d = (word*)stack;
+		word* pt = d + n;
+		word* pt1 = pt + 2 * n;
+		wwCopy(d, ec->order, n);
+		zzSubW2(d, n, 1);
+		ecpNegA(pt1, ec->base, ec);
+		if (!ecpMulLadderA(pt, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!wwEq(pt, pt1, 2 * n))
+			return FALSE;
+		zzSubW2(d, n, 1);
+		if (!ecpMulLadderA(pt, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!ecMulA(pt1, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!wwEq(pt, pt1, 2 * n))
+			return FALSE;
+		// ecMulA(): аффинные малые кратные
+		inv_ratio = ec->inv_ratio, ec->inv_ratio = 1;
+		ret = ecMulA(pt1, ec->base, ec, d, n, pt1 + 2 * n) &&
+			wwEq(pt, pt1, 2 * n);
+		ec->inv_ratio = inv_ratio;
+		if (!ret)
+			return FALSE;
+		// ecMulRegA(): (q - 2)base, (q - 1)base, 2base, base, O
+		if (!ecMulRegA(pt1, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!wwEq(pt, pt1, 2 * n))
+			return FALSE;
+		zzAddW2(d, n, 1);
+		ecpNegA(pt, ec->base, ec);
+		if (!ecMulRegA(pt1, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!wwEq(pt, pt1, 2 * n))
+			return FALSE;
+		wwSetW(d, n, 2);
+		if (!ecMulA(pt, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!ecMulRegA(pt1, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!wwEq(pt, pt1, 2 * n))
+			return FALSE;
+		wwSetW(d, n, 1);
+		if (!ecMulRegA(pt1, ec->base, ec, d, n, pt1 + 2 * n) ||
+			!wwEq(ec->base, pt1, 2 * n))
+			return FALSE;
+		wwSetZero(d, n);
+		if (ecMulRegA(pt1, ec->base, ec, d, n, pt1 + 2 * n))
+			return FALSE;
+		// ecMulRegA(): нулевые старшие цифры записи d (q >> 8, q >> 64, 
+		// 2^6 + 1, 2^6 - 1), сравнение с ecMulA()
+		{
+			const size_t shifts[] = { 8, 64 };
+			const word smalls[] = { 65, 63 };
+			size_t i;
+			for (i = 0; i < COUNT_OF(shifts) + COUNT_OF(smalls); ++i)
+			{
+				if (i < COUNT_OF(shifts))
+				{
+					wwCopy(d, ec->order, n);
+					wwShLo(d, n, shifts[i]);
+				}
+				else
+					wwSetW(d, n, smalls[i - COUNT_OF(shifts)]);
+				if (!ecMulA(pt, ec->base, ec, d, n, pt1 + 2 * n) ||
+					!ecMulRegA(pt1, ec->base, ec, d, n, pt1 + 2 * n) ||
+					!wwEq(pt, pt1, 2 * n))
+					return FALSE;
+			}
+		}
+		// лесенка Монтгомери: короткая кратность (m == 1), слова за ней
+		// не читаются
+		wwSetW(d, n, 3);
+		wwRepW(d + 1, n - 1, WORD_MAX);
+		if (!ecMulA(pt, ec->base, ec, d, 1, pt1 + 2 * n) ||
+			!ecpMulLadderA(pt1, ec->base, ec, d, 1, pt1 + 2 * n) ||
+			!wwEq(pt, pt1, 2 * n))
+			return FALSE;
+	}
+	// сумма кратных: \sum d[i] (i + 1)base == (\sum d[i] (i + 1))base?
+	// [k = 3: метод Штрауса, k = 400: граница, k = 2000: метод Пиппенджера]
+	{
+		const size_t ks[] = { 3, 400, 400, 2000 };
+		const size_t ts[] = { 1, 1, 3, 2 };
+		const size_t k = 2000;
+		size_t i, j;
+		word* pts;
+		word* ds;
+		word* e;
+		word* r;
+		word* pt;
+		word* pt1;
+		octet* combo_state;
+		void* stack1;
+		bool_t ret = TRUE;
+		// выделить память
+		pt = (word*)blobCreate(O_OF_W(2 * n + 2 * n + 3 * n + 2 * n * k + 
+			n * k + n + 2 + n) + prngCOMBO_keep() + 
+			utilMax(6,
+				ec_deep,
+				zzMod_deep(n + 2, n),
+				ecMulA_deep(n, ec->d, ec_deep, n),
+				ecAddMulArrA_deep(n, ec->d, ec_deep, ks[0], n, ts[0]),
+				ecAddMulArrA_deep(n, ec->d, ec_deep, ks[2], n, ts[2]),
+				ecAddMulArrA_deep(n, ec->d, ec_deep, ks[3], n, ts[3])));
+		if (pt == 0)
+			return FALSE;
+		pt1 = pt + 2 * n;
+		pts = pt1 + 2 * n + 3 * n;
+		ds = pts + 2 * n * k;
+		e = ds + n * k;
+		r = e + n + 2;
+		combo_state = (octet*)(r + n);
+		stack1 = combo_state + prngCOMBO_keep();
+		// pts[i] <- (i + 1)base
+		ecFromA(pt1 + 2 * n, ec->base, ec, stack1);
+		wwCopy(pts, ec->base, 2 * n);
+		for (i = 1; i < k; ++i)
+		{
+			ecAddA(pt1 + 2 * n, pt1 + 2 * n, ec->base, ec, stack1);
+			ecToA(pts + i * 2 * n, pt1 + 2 * n, ec, stack1);
+		}
+		// ds[i] <- random
+		prngCOMBOStart(combo_state, 31);
+		prngCOMBOStepR(ds, O_OF_W(n * k), combo_state);
+		// тесты
+		for (j = 0; ret && j < COUNT_OF(ks); ++j)
+		{
+			// r <- \sum d[i] (i + 1) \bmod q
+			wwSetZero(e, n + 2);
+			for (i = 0; i < ks[j]; ++i)
+				zzAddW2(e + n, 2, zzAddMulW(e, ds + i * n, n, i + 1));
+			zzMod(r, e, n + 2, ec->order, n, stack1);
+			// сравнение
+			ret = ecAddMulArrA(pt, pts, ds, ks[j], n, ec, ts[j], stack1) &&
+				ecMulA(pt1, ec->base, ec, r, n, stack1) &&
+				wwEq(pt, pt1, 2 * n);
+		}
+		blobClose(pt);
+		if (!ret)
+			return FALSE;
+	}
+	// регулярная кратная точка на кривых bign
+	{
+		octet combo_state[256];
+		bool_t ret;
+		ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+		prngCOMBOStart(combo_state, 37);
+		if (!ecpTestMulReg("1.2.112.0.2.0.34.101.45.3.1", combo_state) ||
+			!ecpTestMulReg("1.2.112.0.2.0.34.101.45.3.2", combo_state) ||
+			!ecpTestMulReg("1.2.112.0.2.0.34.101.45.3.3", combo_state))
+			return FALSE;
+		// общие формулы (см. ecpUseFixed())
+		ecpUseFixed(FALSE);
+		ret = ecpTestMulReg("1.2.112.0.2.0.34.101.45.3.1", combo_state);
+		ecpUseFixed(TRUE);
+		if (!ret)
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
@@ -0,0 +1,299 @@
+/*
+*******************************************************************************
+\file gf2_test.c
+\brief Tests for binary fields
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/blob.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/pp.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Стандартные многочлены ДСТУ 4145-2002
+*******************************************************************************
+*/
+
+static const size_t _polys[][4] =
+{
+	{163, 7, 6, 3},
+	{167, 6, 0, 0},
+	{173, 10, 2, 1},
+	{179, 4, 2, 1},
+	{191, 9, 0, 0},
+	{233, 9, 4, 1},
+	{257, 12, 0, 0},
+	{307, 8, 4, 2},
+	{367, 21, 0, 0},
+	{431, 5, 3, 1},
+};
+
+/*
+*******************************************************************************
+Умножение и возведение в квадрат
+
+Результаты специальных функций умножения и возведения в квадрат
+(с зафиксированными параметрами p(x)) сравниваются с результатами
+ppMul() + ppMod().
+*******************************************************************************
+*/
+
+static bool_t gf2TestMul(const size_t p[4], octet combo_state[])
+{
+	const size_t m = p[0];
+	const size_t n = W_OF_B(m);
+	const size_t n1 = W_OF_B(m + 1);
+	const size_t reps = 16;
+	void* blob;
+	qr_o* f;
+	word* a;
+	word* b;
+	word* c;
+	word* t;
+	word* r;
+	word* mod;
+	void* stack;
+	size_t i;
+	bool_t ret = TRUE;
+	// выделить память
+	blob = blobCreate(gf2Create_keep(m) + O_OF_W(3 * n + 2 * n + n1 + n1) +
+		utilMax(3,
+			gf2Create_deep(m),
+			ppMul_deep(n, n),
+			ppMod_deep(2 * n, n1)));
+	if (blob == 0)
+		return FALSE;
+	f = (qr_o*)blob;
+	a = (word*)((octet*)f + gf2Create_keep(m));
+	b = a + n;
+	c = b + n;
+	t = c + n;
+	r = t + 2 * n;
+	mod = r + n1;
+	stack = mod + n1;
+	// создать поле и модуль
+	if (!gf2Create(f, p, stack))
+	{
+		blobClose(blob);
+		return FALSE;
+	}
+	wwSetZero(mod, n1);
+	wwSetBit(mod, p[0], 1);
+	wwSetBit(mod, p[1], 1);
+	wwSetBit(mod, p[2], 1);
+	wwSetBit(mod, p[3], 1);
+	wwSetBit(mod, 0, 1);
+	// эксперименты
+	for (i = 0; ret && i < reps; ++i)
+	{
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		prngCOMBOStepR(b, O_OF_W(n), combo_state);
+		wwTrimHi(a, n, m);
+		wwTrimHi(b, n, m);
+		// умножение
+		qrMul(c, a, b, f, stack);
+		ppMul(t, a, n, b, n, stack);
+		ppMod(r, t, 2 * n, mod, n1, stack);
+		ret = wwEq(c, r, n) && (n1 == n || r[n] == 0);
+		// возведение в квадрат
+		qrSqr(c, a, f, stack);
+		ppMul(t, a, n, a, n, stack);
+		ppMod(r, t, 2 * n, mod, n1, stack);
+		ret = ret && wwEq(c, r, n) && (n1 == n || r[n] == 0);
+	}
+	blobClose(blob);
+	return ret;
+}
+
+/*
+*******************************************************************************
+Обращение
+
+Обратные элементы, найденные в поле без таблиц обращения (gf2Create(),
+алгоритм Итоха -- Цудзии), в поле с таблицами (gf2CreateIT()) 
+и пакетным обращением qrInvBatch(), сравниваются между собой 
+и с результатами ppInvMod() и проверяются умножением.
+*******************************************************************************
+*/
+
+static bool_t gf2TestInv(const size_t p[4], octet combo_state[])
+{
+	const size_t m = p[0];
+	const size_t n = W_OF_B(m);
+	const size_t count = 5;
+	void* blob;
+	qr_o* f;
+	qr_o* g;
+	word* a;
+	word* b;
+	word* c;
+	word* t;
+	void* stack;
+	size_t i;
+	bool_t ret = TRUE;
+	// выделить память
+	blob = blobCreate(gf2Create_keep(m) + gf2CreateIT_keep(m) + 
+		O_OF_W(3 * count * n + n) + 
+		utilMax(4,
+			gf2CreateIT_deep(m),
+			gf2Create_deep(m),
+			ppInvMod_deep(n),
+			qrInvBatch_deep(n, count, gf2CreateIT_deep(m))));
+	if (blob == 0)
+		return FALSE;
+	f = (qr_o*)blob;
+	g = (qr_o*)((octet*)f + gf2Create_keep(m));
+	a = (word*)((octet*)g + gf2CreateIT_keep(m));
+	b = a + count * n;
+	c = b + count * n;
+	t = c + count * n;
+	stack = t + n;
+	// создать поля
+	if (!gf2Create(f, p, stack) || !gf2CreateIT(g, p, stack))
+	{
+		blobClose(blob);
+		return FALSE;
+	}
+	// ненулевые элементы (a_0 == 1)
+	for (i = 0; i < count; ++i)
+		do
+		{
+			prngCOMBOStepR(a + i * n, O_OF_W(n), combo_state);
+			wwTrimHi(a + i * n, n, m);
+		}
+		while (qrIsZero(a + i * n, f));
+	qrSetUnity(a, f);
+	// обращение
+	qrInvBatch(c, a, count, g, stack);
+	for (i = 0; ret && i < count; ++i)
+	{
+		qrInv(b + i * n, a + i * n, f, stack);
+		qrInv(t, a + i * n, g, stack);
+		ret = wwEq(t, b + i * n, n) && wwEq(t, c + i * n, n);
+		ppInvMod(t, a + i * n, f->mod, n, stack);
+		ret = ret && wwEq(t, b + i * n, n);
+		qrMul(t, t, a + i * n, f, stack);
+		ret = ret && qrIsUnity(t, f);
+	}
+	// пакетное обращение на месте
+	qrInvBatch(a, a, count, f, stack);
+	ret = ret && wwEq(a, b, count * n);
+	blobClose(blob);
+	return ret;
+}
+
+/*
+*******************************************************************************
+Квадратные уравнения
+
+Решения x^2 + a x + b == 0, найденные в поле с таблицей решений 
+(gf2CreateQT()) и без нее (gf2Create()), проверяются подстановкой. 
+Проверяется также, что уравнения решаются или не решаются одновременно.
+*******************************************************************************
+*/
+
+static bool_t gf2TestQSolve(const size_t p[4], octet combo_state[])
+{
+	const size_t m = p[0];
+	const size_t n = W_OF_B(m);
+	const size_t reps = 16;
+	void* blob;
+	qr_o* f;
+	qr_o* g;
+	word* a;
+	word* b;
+	word* x;
+	word* y;
+	word* t;
+	void* stack;
+	size_t i;
+	bool_t ret = TRUE;
+	// выделить память
+	blob = blobCreate(gf2Create_keep(m) + gf2CreateQT_keep(m) + 
+		O_OF_W(5 * n) + 
+		utilMax(3,
+			gf2CreateQT_deep(m),
+			gf2Create_deep(m),
+			gf2QSolve_deep(n, gf2Create_deep(m))));
+	if (blob == 0)
+		return FALSE;
+	f = (qr_o*)blob;
+	g = (qr_o*)((octet*)f + gf2Create_keep(m));
+	a = (word*)((octet*)g + gf2CreateQT_keep(m));
+	b = a + n;
+	x = b + n;
+	y = x + n;
+	t = y + n;
+	stack = t + n;
+	// создать поля
+	if (!gf2Create(f, p, stack) || !gf2CreateQT(g, p, stack))
+	{
+		blobClose(blob);
+		return FALSE;
+	}
+	// эксперименты (a == 0, b == 0, a == 1, a и b случайные)
+	for (i = 0; ret && i < reps; ++i)
+	{
+		bool_t sf, sg;
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		prngCOMBOStepR(b, O_OF_W(n), combo_state);
+		wwTrimHi(a, n, m);
+		wwTrimHi(b, n, m);
+		if (i == 0)
+			qrSetZero(a, f);
+		else if (i == 1)
+			qrSetZero(b, f);
+		else if (i == 2)
+			qrSetUnity(a, f);
+		sf = gf2QSolve(x, a, b, f, stack);
+		sg = gf2QSolve(y, a, b, g, stack);
+		ret = sf == sg;
+		if (ret && sf)
+		{
+			// t <- x^2 + a x + b
+			qrSqr(t, x, f, stack);
+			gf2Add2(t, b, f);
+			qrMul(x, x, a, f, stack);
+			gf2Add2(t, x, f);
+			ret = qrIsZero(t, f);
+			// t <- y^2 + a y + b
+			qrSqr(t, y, f, stack);
+			gf2Add2(t, b, f);
+			qrMul(y, y, a, f, stack);
+			gf2Add2(t, y, f);
+			ret = ret && qrIsZero(t, f);
+		}
+	}
+	blobClose(blob);
+	return ret;
+}
+
+/*
+*******************************************************************************
+Тестирование
+*******************************************************************************
+*/
+
+bool_t gf2Test()
+{
+	octet combo_state[256];
+	size_t i;
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, 19);
+	for (i = 0; i < COUNT_OF(_polys); ++i)
+		if (!gf2TestMul(_polys[i], combo_state) ||
+			!gf2TestInv(_polys[i], combo_state) ||
+			!gf2TestQSolve(_polys[i], combo_state))
+			return FALSE;
+	return TRUE;
+}
@@ -0,0 +1,100 @@
+/*
+*******************************************************************************
+\file pp_test.c
+\brief Tests for binary polynomials
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.17
+\version 2026.10.17
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/math/pp.h>
+#include <math/pp_lcl.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Тестирование
+
+Произведения многочленов сравниваются с результатами наивного умножения
+(сдвиги и сложения). Проверка выполняется дважды: с командой PCLMULQDQ
+(если она поддерживается) и с программной реализацией, которая
+включается вызовом ppUseCLMUL(FALSE).
+*******************************************************************************
+*/
+
+static void ppMulNaive(word c[], const word a[], size_t n, const word b[],
+	size_t m)
+{
+	size_t i, j;
+	wwSetZero(c, n + m);
+	for (i = 0; i < B_PER_W * n; ++i)
+		if (wwTestBit(a, i))
+			for (j = 0; j < B_PER_W * m; ++j)
+				if (wwTestBit(b, j))
+					wwFlipBit(c, i + j);
+}
+
+static bool_t ppTestMul(octet combo_state[])
+{
+	enum { n_max = 12 };
+	word a[n_max];
+	word b[n_max];
+	word c[2 * n_max];
+	word c1[2 * n_max];
+	word t[n_max + 1];
+	word stack[2048];
+	size_t n, m, reps;
+	ASSERT(ppMul_deep(n_max, n_max) <= sizeof(stack));
+	ASSERT(ppMulW_deep(n_max) <= sizeof(stack));
+	for (n = 1; n <= n_max; ++n)
+	for (reps = 0; reps < 4; ++reps)
+	{
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		prngCOMBOStepR(b, O_OF_W(n), combo_state);
+		// многочлены одинаковой длины (ppMul1,..., ppMul9, Карацуба)
+		ppMul(c, a, n, b, n, stack);
+		ppMulNaive(c1, a, n, b, n);
+		if (!wwEq(c, c1, 2 * n))
+			return FALSE;
+		// многочлены разной длины
+		m = n / 2 + 1;
+		ppMul(c, a, n, b, m, stack);
+		ppMulNaive(c1, a, n, b, m);
+		if (!wwEq(c, c1, n + m))
+			return FALSE;
+		// умножение на слово
+		t[n] = ppMulW(t, a, n, b[0], stack);
+		ppMulNaive(c1, a, n, b, 1);
+		if (!wwEq(t, c1, n + 1))
+			return FALSE;
+		// сложение с произведением на слово
+		wwCopy(t, b, n);
+		t[n] = ppAddMulW(t, a, n, b[n - 1], stack);
+		ppMulNaive(c1, a, n, b + n - 1, 1);
+		wwXor2(c1, b, n);
+		if (!wwEq(t, c1, n + 1))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+bool_t ppTest()
+{
+	octet combo_state[256];
+	bool_t ret;
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, 17);
+	// PCLMULQDQ (если поддерживается)
+	ret = ppTestMul(combo_state);
+	// программная реализация
+	ppUseCLMUL(FALSE);
+	ret = ret && !ppHasCLMUL() && ppTestMul(combo_state);
+	ppUseCLMUL(TRUE);
+	return ret;
+}
@@ -5,16 +5,18 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.07.15
-\version 2016.09.12
+\version 2026.10.17
 \license This program is released under the GNU General Public License 
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/blob.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/prng.h>
 #include <bee2/core/util.h>
 #include <bee2/core/word.h>
+#include <bee2/math/zm.h>
 #include <bee2/math/zz.h>
 #include <bee2/math/ww.h>
 
@@ -478,6 +480,142 @@ static bool_t zzTestRed()
 		if (!FAST(wwEq)(t1, t, n))
 			return FALSE;
 	}
+	// кольцо Барретта: модули длины 256 (специализированное умножение),
+	// модули с неполным старшим словом
+	{
+		const size_t nos[] = { 32, 31, 25, 20 };
+		octet r_state[256];
+		octet mod_oct[32];
+		qr_o* r = (qr_o*)r_state;
+		size_t no, m;
+		ASSERT(zmCreateBarr_keep(32) <= sizeof(r_state));
+		ASSERT(zmCreateBarr_deep(32) <= sizeof(stack));
+		for (reps = 0; reps < 1000; ++reps)
+		{
+			no = nos[reps % COUNT_OF(nos)];
+			m = W_OF_O(no);
+			prngCOMBOStepR(mod_oct, no, combo_state);
+			// старший октет: полный или короткий (1..15)
+			if (reps / COUNT_OF(nos) % 2)
+				mod_oct[no - 1] |= 0x80;
+			else
+				mod_oct[no - 1] = (mod_oct[no - 1] >> 4) | 1;
+			zmCreateBarr(r, mod_oct, no, stack);
+			prngCOMBOStepR(a, O_OF_W(2 * m), combo_state);
+			zzMod(a, a, m, r->mod, m, stack);
+			zzMod(a + m, a + m, m, r->mod, m, stack);
+			// zzMul + zzRed / qrMul
+			zzMul(t, a, m, a + m, m, stack);
+			zzRed(t, r->mod, m, stack);
+			qrMul(t1, a, a + m, r, stack);
+			if (!wwEq(t1, t, m))
+				return FALSE;
+			// zzSqr + zzRed / qrSqr
+			zzSqr(t, a, m, stack);
+			zzRed(t, r->mod, m, stack);
+			qrSqr(t1, a, r, stack);
+			if (!wwEq(t1, t, m))
+				return FALSE;
+		}
+	}
+	// все нормально
+	return TRUE;
+}
+
+static bool_t zzTestRand()
+{
+	const size_t n = 4;
+	word mod[4];
+	word a[4];
+	word t[4];
+	octet seed[3 * O_PER_W * 4];
+	octet echo_state[64];
+	octet combo_state[32];
+	// pre
+	ASSERT(COUNT_OF(mod) >= n);
+	ASSERT(prngEcho_keep() <= sizeof(echo_state));
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	// модуль
+	prngCOMBOStart(combo_state, 19);
+	prngCOMBOStepR(mod, O_OF_W(n), combo_state);
+	mod[n - 1] |= WORD_BIT_HI;
+	// zzRandMod(): кандидат mod отвергается, кандидат mod - 1 принимается
+	wwTo(seed, O_OF_W(n), mod);
+	wwCopy(t, mod, n), zzSubW2(t, n, 1);
+	wwTo(seed + O_OF_W(n), O_OF_W(n), t);
+	prngEchoStart(echo_state, seed, 2 * O_OF_W(n));
+	if (!zzRandMod(a, mod, n, prngEchoStepR, echo_state) ||
+		!wwEq(a, t, n))
+		return FALSE;
+	// zzRandNZMod(): кандидаты 0 и mod отвергаются, кандидат 1 принимается
+	memSetZero(seed, O_OF_W(n));
+	wwTo(seed + O_OF_W(n), O_OF_W(n), mod);
+	memSetZero(seed + 2 * O_OF_W(n), O_OF_W(n)), seed[2 * O_OF_W(n)] = 1;
+	prngEchoStart(echo_state, seed, 3 * O_OF_W(n));
+	if (!zzRandNZMod(a, mod, n, prngEchoStepR, echo_state) ||
+		!wwIsW(a, n, 1))
+		return FALSE;
+	// все нормально
+	return TRUE;
+}
+
+static bool_t zzTestRingDeep()
+{
+	const size_t nos[] = { 8, 24, 32, 40, 64 };
+	const size_t guard = 64;
+	size_t i, k;
+	octet mod[64];
+	octet combo_state[32];
+	// инициализировать генератор COMBO
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, 17);
+	// кольца Барретта (k == 0) и Монтгомери (k == 1): операциям с кольцом 
+	// достаточно r->deep октетов стека, октеты за ними не затрагиваются
+	for (i = 0; i < COUNT_OF(nos); ++i)
+		for (k = 0; k < 2; ++k)
+		{
+			const size_t no = nos[i];
+			const size_t n = W_OF_O(no);
+			void* blob;
+			void* stack;
+			qr_o* r;
+			word* a;
+			word* b;
+			bool_t ret;
+			// описание кольца
+			ASSERT(no <= sizeof(mod));
+			prngCOMBOStepR(mod, no, combo_state);
+			mod[no - 1] |= 0x80, mod[0] |= 1;
+			blob = blobCreate(O_OF_W(2 * n) + utilMax(2,
+				zmCreateBarr_keep(no) + zmCreateBarr_deep(no),
+				zmCreateMont_keep(no) + zmCreateMont_deep(no)));
+			if (!blob)
+				return FALSE;
+			a = (word*)blob, b = a + n;
+			r = (qr_o*)(b + n);
+			if (k == 0)
+				zmCreateBarr(r, mod, no, (octet*)r + zmCreateBarr_keep(no));
+			else
+				zmCreateMont(r, mod, no, (octet*)r + zmCreateMont_keep(no));
+			// стек [r->deep] и охранная зона [guard]
+			stack = blobCreate(r->deep + guard);
+			if (!stack)
+			{
+				blobClose(blob);
+				return FALSE;
+			}
+			memSet(stack, 0xA5, r->deep + guard);
+			// умножение и возведение в квадрат
+			prngCOMBOStepR(a, O_OF_W(2 * n), combo_state);
+			a[n - 1] = b[n - 1] = 0;
+			qrMul(a, a, b, r, stack);
+			qrSqr(b, a, r, stack);
+			ret = memIsRep((octet*)stack + r->deep, guard, 0xA5);
+			blobClose(stack);
+			blobClose(blob);
+			if (!ret)
+				return FALSE;
+		}
 	// все нормально
 	return TRUE;
 }
@@ -488,6 +626,8 @@ bool_t zzTest()
 		zzTestMul() && 
 		zzTestMod() && 
 		zzTestGCD() && 
-		zzTestRed();
+		zzTestRed() &&
+		zzTestRingDeep() &&
+		zzTestRand();
 }
 
@@ -5,7 +5,7 @@
 \project bee2/test
 \author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
 \created 2014.04.02
-\version 2017.07.11
+\version 2026.10.17
 \license This program is released under the GNU General Public License
 version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
@@ -62,21 +62,27 @@ int testCore()
 *******************************************************************************
 */
 
+extern bool_t gf2Test();
+extern bool_t ppTest();
 extern bool_t priTest();
 extern bool_t zzTest();
 extern bool_t wordTest();
 extern bool_t ecpTest();
 extern bool_t ecpBench();
+extern bool_t ec2Bench();
 
 int testMath()
 {
 	bool_t code;
 	int ret = 0;
+	printf("gf2Test: %s\n", (code = gf2Test()) ? "OK" : "Err"), ret |= !code;
+	printf("ppTest: %s\n", (code = ppTest()) ? "OK" : "Err"), ret |= !code;
 	printf("priTest: %s\n", (code = priTest()) ? "OK" : "Err"), ret |= !code;
 	printf("zzTest: %s\n", (code = zzTest()) ? "OK" : "Err"), ret |= !code;
 	printf("wordTest: %s\n", (code = wordTest()) ? "OK" : "Err"), ret |= !code;
 	printf("ecpTest: %s\n", (code = ecpTest()) ? "OK" : "Err"), ret |= !code;
 	code = ecpBench(), ret |= !code;
+	code = ec2Bench(), ret |= !code;
 	return ret;
 }
 
@@ -99,7 +105,10 @@ extern bool_t pfokTestStdParams();
 extern bool_t bakeDemo();
 extern bool_t bashTest();
 extern bool_t bashBench();
+extern bool_t bmtTest();
+extern bool_t bcntTest();
 extern bool_t botpTest();
+extern bool_t vcacheTest();
 
 int testCrypto()
 {
@@ -109,6 +118,8 @@ int testCrypto()
 	printf("bashTest: %s\n", (code = bashTest()) ? "OK" : "Err"), ret |= !code;
 	code = beltBench(),	ret |= !code;
 	code = bashBench(),	ret |= !code;
+	printf("bmtTest: %s\n", (code = bmtTest()) ? "OK" : "Err"), ret |= !code;
+	printf("bcntTest: %s\n", (code = bcntTest()) ? "OK" : "Err"), ret |= !code;
 	printf("botpTest: %s\n", (code = botpTest()) ? "OK" : "Err"), ret |= !code;
 	printf("bignTest: %s\n", (code = bignTest()) ? "OK" : "Err"), ret |= !code;
 	printf("brngTest: %s\n", (code = brngTest()) ? "OK" : "Err"), ret |= !code;
@@ -117,6 +128,8 @@ int testCrypto()
 	printf("dstuTest: %s\n", (code = dstuTest()) ? "OK" : "Err"), ret |= !code;
 	printf("g12sTest: %s\n", (code = g12sTest()) ? "OK" : "Err"), ret |= !code;
 	printf("pfokTest: %s\n", (code = pfokTest()) ? "OK" : "Err"), ret |= !code;
+	printf("vcacheTest: %s\n", (code = vcacheTest()) ? "OK" : "Err"),
+		ret |= !code;
 	return ret;
 }
 